@@ -38,6 +38,7 @@
 #include <OpenMS/METADATA/ID/IdentificationData.h>
 #include <OpenMS/METADATA/PeptideIdentification.h>
 #include <OpenMS/METADATA/ProteinIdentification.h>
+#include <OpenMS/METADATA/PSMTable.h>
 #include <OpenMS/KERNEL/ConsensusMap.h>
 
 #include <boost/unordered_map.hpp>
@@ -96,6 +97,16 @@ public:
     */
     void apply(std::vector<PeptideIdentification>& id) const;
 
+    /**
+    @brief Calculates the FDR of one run from a concatenated sequence DB search, for peptide identifications stored in a PSMTable
+
+    Same parameters and results as apply(std::vector<PeptideIdentification>&), without converting the table back to objects.
+    If @p use_all_hits is false, peptide identifications without hits stay empty (instead of receiving a default hit).
+
+    @param psms peptide identifications, containing target and decoy hits
+    */
+    void apply(PSMTable& psms) const;
+
     /**
     @brief Calculates the FDR of two runs, a forward run and decoy run on protein level
 
@@ -172,6 +183,25 @@ private:
     /// Not implemented
     FalseDiscoveryRate& operator=(const FalseDiscoveryRate&);
 
+    /**
+      @brief Target-decoy FDR/q-value computation shared by the PSM containers
+
+      Works on flat per-hit arrays, so that the container overloads of apply() only have to gather and write back the columns.
+      Hits are grouped by charge and run according to the parameters.
+
+      @param scores Score of each hit, replaced by its FDR/q-value where @p rescored is set
+      @param hit_class Target/decoy state of each hit (1 = target, -1 = decoy, 0 = unannotated)
+      @param runs Index into @p run_names of each hit
+      @param run_names Sorted identifiers of the search runs
+      @param charges Charge of each hit
+      @param higher_score_better Whether higher original scores are better
+      @param rescored Output: whether the hit's score was replaced
+      @param keep Output: whether the hit is kept
+
+      @exception Exception::InvalidValue An unannotated hit is in a group without targets or decoys
+    */
+    void calculatePSMFDRs_(std::vector<double>& scores, const std::vector<Int>& hit_class, const std::vector<Size>& runs, const std::vector<String>& run_names, const std::vector<Int>& charges, bool higher_score_better, std::vector<bool>& rescored, std::vector<bool>& keep) const;
+
     /// calculates the FDR, given two vectors of scores
     void calculateFDRs_(std::map<double, double>& score_to_fdr, std::vector<double>& target_scores, std::vector<double>& decoy_scores, bool q_value, bool higher_score_better) const;
 
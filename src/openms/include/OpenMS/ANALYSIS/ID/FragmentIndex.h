@@ -0,0 +1,236 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/ANALYSIS/ID/PeptideDatabase.h>
+#include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/StandardTypes.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <vector>
+
+namespace boost
+{
+  namespace iostreams
+  {
+    class mapped_file_source;
+  }
+}
+
+namespace OpenMS
+{
+
+  /**
+    @brief Inverted index from fragment ion m/z to the entries of a PeptideDatabase
+
+    build() generates the theoretical fragments of every entry (modified
+    peptide) of a PeptideDatabase and stores them as flat (fragment m/z,
+    entry index) records, grouped by fragment m/z bin and, inside each bin,
+    sorted by entry index. As the entries of a PeptideDatabase are sorted by
+    mass, the peptides of a bin within a precursor mass range form a
+    contiguous block.
+
+    A query with an experimental spectrum and a range of entries (see
+    PeptideDatabase::getEntries()) then only touches the bins of the
+    experimental peaks and reports the entries sharing the most peaks with
+    the spectrum. Only these have to be scored in detail, which makes
+    searches with wide (or open) precursor tolerances feasible.
+
+    Like the PeptideDatabase, the index only depends on the database and the
+    search settings. It can be stored with store() (typically next to the
+    stored PeptideDatabase and with the same key) and memory-mapped by later
+    searches with load().
+
+    @note Fragment m/z values are stored in single precision, which is more
+    than sufficient to preselect candidates. Files are written in the byte
+    order of the host (see PeptideDatabase).
+
+    @ingroup Analysis_ID
+  */
+  class OPENMS_DLLAPI FragmentIndex
+  {
+public:
+    /// A fragment of an entry
+    struct Fragment
+    {
+      float mz; ///< fragment m/z
+      UInt32 entry; ///< index of the entry in the PeptideDatabase
+    };
+
+    /// An entry from a query together with the number of experimental peaks that matched one of its fragments
+    struct Candidate
+    {
+      Size entry; ///< index of the entry in the PeptideDatabase
+      Size shared_peaks; ///< number of experimental peaks matching a fragment of the entry
+    };
+
+    /**
+      @brief Constructor
+
+      @param bin_size Width of the fragment m/z bins (in Th). Choose about the fragment mass tolerance.
+
+      @exception Exception::InvalidValue is thrown if @p bin_size is not positive
+    */
+    explicit FragmentIndex(double bin_size = 0.02);
+
+    /// Copy constructor
+    FragmentIndex(const FragmentIndex& rhs);
+
+    /// Assignment operator
+    FragmentIndex& operator=(const FragmentIndex& rhs);
+
+    /// Destructor
+    ~FragmentIndex();
+
+    /**
+      @brief Index the fragments of all entries of a peptide database
+
+      The fragments of an entry are the peaks of the theoretical spectrum
+      generated by @p spectrum_generator (charge 1) for its modified sequence
+      (see PeptideDatabase::getModifiedVariants()). The result does not depend
+      on the number of threads.
+
+      @param peptide_db The peptide database
+      @param fasta_db The protein database @p peptide_db was built from
+      @param spectrum_generator Generator of the theoretical spectra
+      @param fixed_modifications Fixed modifications @p peptide_db was built with
+      @param variable_modifications Variable modifications @p peptide_db was built with
+      @param max_variable_mods_per_peptide Maximal number of variable modifications @p peptide_db was built with
+    */
+    void build(const PeptideDatabase& peptide_db,
+               const std::vector<FASTAFile::FASTAEntry>& fasta_db,
+               const TheoreticalSpectrumGenerator& spectrum_generator,
+               const ModifiedPeptideGenerator::MapToResidueType& fixed_modifications,
+               const ModifiedPeptideGenerator::MapToResidueType& variable_modifications,
+               Size max_variable_mods_per_peptide);
+
+    /**
+      @brief Store the index in a binary file
+
+      @exception Exception::UnableToCreateFile is thrown if the file could not be written
+    */
+    void store(const String& filename, UInt64 key) const;
+
+    /**
+      @brief Load an index stored with store()
+
+      @param filename Input file
+      @param key Expected key (e.g. that of the PeptideDatabase, see PeptideDatabase::computeKey())
+      @param nr_entries Number of entries of the PeptideDatabase the index was built from
+      @param memory_map Whether to memory-map the file instead of reading it into memory
+      @return False (and leaves the index unchanged) if the file does not exist or was stored with a different key, bin size, format version or byte order
+
+      @exception Exception::ParseError is thrown if the file is truncated or corrupt (the index is left unchanged)
+    */
+    bool load(const String& filename, UInt64 key, Size nr_entries, bool memory_map = true);
+
+    /// Whether the data is memory-mapped from a file
+    bool isMemoryMapped() const;
+
+    /// Width of a fragment bin
+    double getBinSize() const;
+
+    /// Number of indexed entries
+    Size size() const;
+
+    /// Number of indexed fragments
+    Size getNrFragments() const;
+
+    /**
+      @brief Find the entries that share the most peaks with an experimental spectrum
+
+      Only entries in [@p entry_first, @p entry_last) are considered. An entry
+      matches an experimental peak if one of its fragments is within the
+      fragment tolerance of the peak.
+
+      @param spectrum Experimental spectrum
+      @param entry_first First entry to consider
+      @param entry_last One past the last entry to consider
+      @param fragment_mass_tolerance Fragment mass tolerance
+      @param fragment_mass_tolerance_unit_ppm Whether the tolerance is in ppm (otherwise Da)
+      @param min_shared_peaks Minimal number of matched experimental peaks of a reported entry
+      @param max_candidates Maximal number of reported entries (those with the most matched peaks, lower entry indices first on ties)
+      @param candidates Output, sorted by decreasing number of shared peaks
+      @param workspace Buffer reused between calls (e.g. one per thread) to avoid reallocation. Must be empty or come from a previous call.
+
+      @exception Exception::Precondition is thrown if the index was neither built nor loaded
+    */
+    void query(const PeakSpectrum& spectrum,
+               Size entry_first,
+               Size entry_last,
+               double fragment_mass_tolerance,
+               bool fragment_mass_tolerance_unit_ppm,
+               Size min_shared_peaks,
+               Size max_candidates,
+               std::vector<Candidate>& candidates,
+               std::vector<UInt32>& workspace) const;
+
+protected:
+    /// Point the data pointers to the in-memory arrays
+    void useOwnData_();
+
+    /// Index of the bin containing @p mz
+    Size getBin_(double mz) const;
+
+    /// Width of a fragment bin
+    double bin_size_;
+
+    /// Whether the index was built or loaded
+    bool built_;
+
+    /// Number of indexed entries
+    Size nr_entries_;
+
+    /// Start of each bin in fragments_ (plus one past the end, in-memory data)
+    std::vector<UInt64> bin_offsets_;
+
+    /// Fragments of all entries, grouped by bin and sorted by entry inside each bin (in-memory data)
+    std::vector<Fragment> fragments_;
+
+    /// Read-only memory mapping of a stored index (in-memory arrays are empty if set)
+    boost::shared_ptr<boost::iostreams::mapped_file_source> mapped_file_;
+
+    /// @name Data pointers (either to the in-memory arrays or into the memory-mapped file)
+    //@{
+    const UInt64* bin_offsets_data_;
+    Size nr_bins_;
+    const Fragment* fragments_data_;
+    Size nr_fragments_;
+    //@}
+  };
+
+} // namespace OpenMS
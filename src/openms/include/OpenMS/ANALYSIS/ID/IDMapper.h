@@ -44,8 +44,10 @@
 #include <OpenMS/CONCEPT/LogStream.h>
 
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
+#include <OpenMS/METADATA/PSMTable.h>
 
 #include <algorithm>
+#include <functional>
 #include <limits>
 
 namespace OpenMS
@@ -132,6 +134,16 @@ public:
     */
     void annotate(FeatureMap& map, const std::vector<PeptideIdentification>& ids, const std::vector<ProteinIdentification>& protein_ids, bool use_centroid_rt = false, bool use_centroid_mz = false, const PeakMap& spectra = PeakMap());
 
+    /**
+      @brief Mapping method for feature maps, taking peptide identifications from a PSMTable
+
+      Same matching as the variant for vectors of peptide identifications (without annotation of unidentified precursors).
+      The table is converted to PeptideIdentification objects one identification at a time, so the full vector never needs to be held in memory.
+
+      @exception Exception::MissingInformation is thrown if entries of @p psms do not contain 'MZ' and 'RT' information.
+    */
+    void annotate(FeatureMap& map, const PSMTable& psms, const std::vector<ProteinIdentification>& protein_ids, bool use_centroid_rt = false, bool use_centroid_mz = false);
+
     /**
       @brief Mapping method for consensus maps
 
@@ -264,6 +276,11 @@ protected:
     /// - one m/z value is returned if "mz_reference" is set to "precursor"
     void getIDDetails_(const PeptideIdentification& id, double& rt_pep, DoubleList& mz_values, IntList& charges, bool use_avg_mass = false) const;
 
+    /// implementation of the feature map annotation, @p get_id provides the peptide identification at an index
+    void annotateFeatures_(FeatureMap& map, Size nr_ids, const std::function<const PeptideIdentification&(Size)>& get_id,
+                           const std::vector<ProteinIdentification>& protein_ids, bool use_centroid_rt, bool use_centroid_mz,
+                           const PeakMap& spectra, const std::vector<Size>& unidentified);
+
     /// increase a bounding box by the given RT and m/z tolerances
     void increaseBoundingBox_(DBoundingBox<2>& box);
 
@@ -0,0 +1,246 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/ANALYSIS/RNPXL/ModifiedPeptideGenerator.h>
+#include <OpenMS/CHEMISTRY/ProteaseDigestion.h>
+#include <OpenMS/DATASTRUCTURES/ListUtils.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+#include <OpenMS/FORMAT/FASTAFile.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <vector>
+
+namespace boost
+{
+  namespace iostreams
+  {
+    class mapped_file_source;
+  }
+}
+
+namespace OpenMS
+{
+
+  /**
+    @brief Digested and modified peptides of a protein database, sorted by mass
+
+    Digesting a FASTA database and enumerating the modified variants of all
+    peptides takes a considerable part of the run time of a database search.
+    As the result only depends on the database and the digestion and
+    modification settings, it can be computed once with build(), stored in a
+    binary file with store() and reloaded (in a fraction of the time) with
+    load() by all later searches with the same settings.
+
+    The database consists of
+    - the unique unmodified peptides (see Peptide). A peptide refers to its
+      first occurrence in the FASTA database, so the sequence itself is not
+      stored (see getSequence()). The indices of all proteins containing it
+      are available via getProteins().
+    - one Entry (mass, peptide, modification variant) for every modified
+      variant of every peptide, sorted by mass. The modification index
+      enumerates the variants in the order produced by
+      ModifiedPeptideGenerator::applyVariableModifications() after applying
+      the fixed modifications, so a variant is recreated as in
+      SimpleSearchEngineAlgorithm.
+
+    Stored files consist of a header and flat arrays of fixed-size records,
+    so they can be memory-mapped (see load()) instead of being read. Every
+    file carries a key (see computeKey()) that identifies the database and
+    the settings it was built from; load() rejects files with a different
+    key.
+
+    @note Files are written in the byte order of the host and are not
+    exchangeable between platforms of different endianness (load() treats
+    them as incompatible).
+
+    @ingroup Analysis_ID
+  */
+  class OPENMS_DLLAPI PeptideDatabase
+  {
+public:
+    /// A unique unmodified peptide, located at its first occurrence in the FASTA database
+    struct Peptide
+    {
+      UInt32 protein; ///< index of the first protein containing the peptide
+      UInt32 offset; ///< start of the peptide in the protein sequence
+      UInt32 length; ///< length of the peptide
+    };
+
+    /// A modified variant of a peptide
+    struct Entry
+    {
+      double mass; ///< monoisotopic mass of the (modified) peptide
+      UInt32 peptide; ///< index of the unmodified peptide
+      UInt32 modification; ///< index of the modification variant (see class documentation)
+    };
+
+    /// Default constructor (empty database)
+    PeptideDatabase();
+
+    /// Copy constructor
+    PeptideDatabase(const PeptideDatabase& rhs);
+
+    /// Assignment operator
+    PeptideDatabase& operator=(const PeptideDatabase& rhs);
+
+    /// Destructor
+    ~PeptideDatabase();
+
+    /**
+      @brief Key identifying a protein database and the settings a PeptideDatabase is built with
+
+      @param fasta_db The protein database (identifiers and sequences are considered)
+      @param settings All settings influencing build(), e.g. "enzyme=Trypsin" (order matters)
+    */
+    static UInt64 computeKey(const std::vector<FASTAFile::FASTAEntry>& fasta_db, const StringList& settings);
+
+    /**
+      @brief Digest all proteins and enumerate the modified variants of all unique peptides
+
+      Peptides containing ambiguous amino acids (B, X, Z) are skipped.
+
+      @param fasta_db The protein database
+      @param digestor Digestion settings
+      @param min_size Minimal peptide length
+      @param max_size Maximal peptide length (0 = no restriction)
+      @param fixed_modifications Fixed modifications
+      @param variable_modifications Variable modifications
+      @param max_variable_mods_per_peptide Maximal number of variable modifications per peptide
+      @param peptide_motif If not empty, only peptides matching this regular expression are kept
+
+      @exception Exception::InvalidSize is thrown if the database is too large to be indexed with 32 bit
+    */
+    void build(const std::vector<FASTAFile::FASTAEntry>& fasta_db,
+               const ProteaseDigestion& digestor,
+               Size min_size,
+               Size max_size,
+               const ModifiedPeptideGenerator::MapToResidueType& fixed_modifications,
+               const ModifiedPeptideGenerator::MapToResidueType& variable_modifications,
+               Size max_variable_mods_per_peptide,
+               const String& peptide_motif = "");
+
+    /**
+      @brief Store the database in a binary file
+
+      @exception Exception::UnableToCreateFile is thrown if the file could not be written
+    */
+    void store(const String& filename, UInt64 key) const;
+
+    /**
+      @brief Load a database stored with store()
+
+      All indices and sequence positions in the file are checked against
+      @p fasta_db, so that a corrupt file cannot cause out-of-bounds accesses
+      later on.
+
+      @param filename Input file
+      @param key Expected key (see computeKey())
+      @param fasta_db The protein database the file was built from
+      @param memory_map Whether to memory-map the file instead of reading it into memory
+      @return False (and leaves the database unchanged) if the file does not exist or was stored with a different key, format version or byte order
+
+      @exception Exception::ParseError is thrown if the file is truncated or corrupt (the database is left unchanged)
+    */
+    bool load(const String& filename, UInt64 key, const std::vector<FASTAFile::FASTAEntry>& fasta_db, bool memory_map = true);
+
+    /// Whether the data is memory-mapped from a file
+    bool isMemoryMapped() const;
+
+    /// Number of entries (modified variants of all peptides)
+    Size size() const;
+
+    /// Entry @p index (entries are sorted by mass)
+    const Entry& getEntry(Size index) const;
+
+    /// Range [first, last) of the entries with a mass in [@p mass_low, @p mass_high]
+    std::pair<Size, Size> getEntries(double mass_low, double mass_high) const;
+
+    /// Number of unique unmodified peptides
+    Size getNrPeptides() const;
+
+    /// Unmodified peptide @p peptide
+    const Peptide& getPeptide(Size peptide) const;
+
+    /// Sequence of peptide @p peptide, a view into the sequence of its first protein in @p fasta_db
+    StringView getSequence(const std::vector<FASTAFile::FASTAEntry>& fasta_db, Size peptide) const;
+
+    /// Range of the (ascending) indices of all proteins containing peptide @p peptide
+    std::pair<const UInt32*, const UInt32*> getProteins(Size peptide) const;
+
+    /**
+      @brief All modified variants of peptide @p peptide, indexed by Entry::modification
+
+      The modification settings have to be those passed to build().
+    */
+    void getModifiedVariants(const std::vector<FASTAFile::FASTAEntry>& fasta_db,
+                             Size peptide,
+                             const ModifiedPeptideGenerator::MapToResidueType& fixed_modifications,
+                             const ModifiedPeptideGenerator::MapToResidueType& variable_modifications,
+                             Size max_variable_mods_per_peptide,
+                             std::vector<AASequence>& variants) const;
+
+protected:
+    /// Point the data pointers to the in-memory arrays
+    void useOwnData_();
+
+    /// Entries sorted by mass (in-memory data)
+    std::vector<Entry> entries_;
+
+    /// Unique unmodified peptides (in-memory data)
+    std::vector<Peptide> peptides_;
+
+    /// Start of the protein indices of each peptide in proteins_ (plus one past the end, in-memory data)
+    std::vector<UInt64> protein_offsets_;
+
+    /// Protein indices of all peptides (in-memory data)
+    std::vector<UInt32> proteins_;
+
+    /// Read-only memory mapping of a stored database (in-memory arrays are empty if set)
+    boost::shared_ptr<boost::iostreams::mapped_file_source> mapped_file_;
+
+    /// @name Data pointers (either to the in-memory arrays or into the memory-mapped file)
+    //@{
+    const Entry* entries_data_;
+    Size nr_entries_;
+    const Peptide* peptides_data_;
+    Size nr_peptides_;
+    const UInt64* protein_offsets_data_;
+    const UInt32* proteins_data_;
+    //@}
+  };
+
+} // namespace OpenMS
@@ -35,6 +35,8 @@
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
 
+#include <OpenMS/ANALYSIS/ID/FragmentIndex.h>
+#include <OpenMS/ANALYSIS/ID/PeptideDatabase.h>
 #include <OpenMS/ANALYSIS/ID/PeptideIndexing.h>
 #include <OpenMS/ANALYSIS/RNPXL/ModifiedPeptideGenerator.h>
 #include <OpenMS/ANALYSIS/RNPXL/HyperScore.h>
@@ -114,6 +116,67 @@ class OPENMS_DLLAPI SimpleSearchEngineAlgorithm :
     /// @brief filter, deisotope, decharge spectra
     static void preprocessSpectra_(PeakMap& exp, double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm);
 
+    /**
+      @brief load the modified peptides from the database cache file (database:cache)
+
+      If the file is missing or was built from a different database or with
+      different settings, the peptides are computed and the file is (re)written.
+      Without a cache file, the peptides are only computed.
+
+      @return The key of the database and settings (see PeptideDatabase::computeKey())
+    */
+    UInt64 getPeptideDatabase_(const std::vector<FASTAFile::FASTAEntry>& fasta_db,
+      const ModifiedPeptideGenerator::MapToResidueType& fixed_modifications,
+      const ModifiedPeptideGenerator::MapToResidueType& variable_modifications,
+      PeptideDatabase& peptide_db) const;
+
+    /**
+      @brief select the modified peptides with at least one matching precursor
+
+      @param peptide_db Peptide database
+      @param multimap_mass_2_scan_index Precursor masses
+      @param candidates Output: matching database entries, sorted by peptide and modification index
+      @param candidate_groups Output: start of the entries of each peptide in @p candidates (plus one past the end)
+    */
+    void selectCandidates_(const PeptideDatabase& peptide_db,
+      const std::multimap<double, Size>& multimap_mass_2_scan_index,
+      std::vector<PeptideDatabase::Entry>& candidates,
+      std::vector<Size>& candidate_groups) const;
+
+    /**
+      @brief load the fragment index of the peptide database from its cache file (database:cache + ".fragments")
+
+      The index is stored with the key of the peptide database. If the file is
+      missing, was built for a different database or with a different bin
+      size, the index is built and the file is (re)written. Without a cache
+      file, the index is only built.
+    */
+    void getFragmentIndex_(const std::vector<FASTAFile::FASTAEntry>& fasta_db,
+      const PeptideDatabase& peptide_db,
+      UInt64 key,
+      const TheoreticalSpectrumGenerator& spectrum_generator,
+      const ModifiedPeptideGenerator::MapToResidueType& fixed_modifications,
+      const ModifiedPeptideGenerator::MapToResidueType& variable_modifications,
+      FragmentIndex& fragment_index) const;
+
+    /**
+      @brief score spectra against the peptide database using its fragment ion index
+
+      Each spectrum is scored only against the database entries within the
+      precursor tolerance that share the most fragment peaks with it (see
+      FragmentIndex). The theoretical spectra of these candidates are generated
+      on the fly. No locking is needed since spectra are processed independently.
+    */
+    void searchFragmentIndex_(const PeakMap& spectra,
+      const std::multimap<double, Size>& multimap_mass_2_scan_index,
+      const std::vector<FASTAFile::FASTAEntry>& fasta_db,
+      const PeptideDatabase& peptide_db,
+      const FragmentIndex& fragment_index,
+      const TheoreticalSpectrumGenerator& spectrum_generator,
+      const ModifiedPeptideGenerator::MapToResidueType& fixed_modifications,
+      const ModifiedPeptideGenerator::MapToResidueType& variable_modifications,
+      std::vector<std::vector<AnnotatedHit_> >& annotated_hits) const;
+
     /// @brief filter and annotate search results
     /// most of the parameters are used to properly add meta data to the id objects
     static void postProcessHits_(const PeakMap& exp, 
@@ -163,6 +226,12 @@ class OPENMS_DLLAPI SimpleSearchEngineAlgorithm :
     String peptide_motif_;
 
     Size report_top_hits_;
+
+    String database_cache_;
+
+    bool fragment_index_enabled_;
+    Size fragment_index_min_shared_peaks_;
+    Size fragment_index_candidates_;
 };
 
 } // namespace
@@ -19,6 +19,7 @@ ConsensusIDAlgorithmSimilarity.h
 ConsensusIDAlgorithmWorst.h
 ConsensusMapMergerAlgorithm.h
 FalseDiscoveryRate.h
+FragmentIndex.h
 HiddenMarkovModel.h
 IDBoostGraph.h
 IDDecoyProbability.h
@@ -29,6 +30,7 @@ IDRipper.h
 IDScoreGetterSetter.h
 MessagePasserFactory.h
 MetaboliteSpectralMatching.h
+PeptideDatabase.h
 PeptideProteinResolution.h
 PrecursorPurity.h
 ProtonDistributionModel.h
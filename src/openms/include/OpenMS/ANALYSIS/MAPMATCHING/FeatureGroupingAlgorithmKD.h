@@ -42,6 +42,8 @@
 namespace OpenMS
 {
 
+class MapAlignmentAlgorithmKD;
+
 ///
 /**
     @brief Proxy for a (potential) cluster.
@@ -171,6 +173,23 @@ private:
       The algorithm takes a number of feature or consensus maps and searches
       for corresponding (consensus) features across different maps.
 
+      The input is split into m/z partitions at gaps larger than the m/z
+      tolerance (see @p nr_partitions), which are linked independently. For
+      very large numbers of input maps or very dense data, partitions can
+      become too large to be held in a single kd-tree. If @p link:tile_size is
+      set, such partitions are further split into overlapping m/z tiles of
+      (approximately) that many features, which are linked independently and
+      in parallel. Every tile keeps only the clusters whose center lies in its
+      core region; overlapping clusters of neighboring tiles are resolved by
+      keeping the better one (larger, then smaller average distance) and the
+      features that end up in no cluster are linked once more. The result is
+      deterministic, but may differ slightly from untiled linking near tile
+      boundaries.
+
+      @note Tiling only bounds the size of the kd-trees. The input maps are
+      passed (and held) in memory as a whole, so this is not an out-of-core
+      mode.
+
       @htmlinclude OpenMS_FeatureGroupingAlgorithmKD.parameters
 
       @ingroup FeatureGrouping
@@ -231,8 +250,12 @@ private:
     template <typename MapType>
     void group_(const std::vector<MapType>& input_maps, ConsensusMap& out);
 
-    /// Run the actual clustering algorithm
-    void runClustering_(const KDTreeFeatureMaps& kd_data, ConsensusMap& out);
+    /// Links the features of @p input_maps in the m/z range spanned by @p tile_boundaries, using one (overlapping) tile per pair of consecutive boundaries
+    template <typename MapType>
+    void linkTiles_(const std::vector<MapType>& input_maps, const std::vector<double>& tile_boundaries, const MapAlignmentAlgorithmKD* aligner, ConsensusMap& out);
+
+    /// Run the actual clustering algorithm, store the clusters (indices into @p kd_data) and corresponding proxies in the order they were found
+    void runClustering_(const KDTreeFeatureMaps& kd_data, std::vector<std::vector<Size> >& clusters, std::vector<ClusterProxyKD>& proxies);
 
     /// Update maximum possible sizes of potential consensus features for indices specified in @p update_these
     void updateClusterProxies_(std::set<ClusterProxyKD>& potential_clusters, std::vector<ClusterProxyKD>& cluster_for_idx, const std::set<Size>& update_these, const std::vector<Int>& assigned, const KDTreeFeatureMaps& kd_data);
@@ -243,6 +266,9 @@ private:
     /// Construct consensus feature and add to out map
     void addConsensusFeature_(const std::vector<Size>& indices, const KDTreeFeatureMaps& kd_data, ConsensusMap& out) const;
 
+    /// Construct consensus feature from (map index, feature) pairs and add to out map
+    void addConsensusFeature_(const std::vector<std::pair<Size, const BaseFeature*> >& elements, ConsensusMap& out) const;
+
     /// Current progress for logging
     SignedSize progress_;
 
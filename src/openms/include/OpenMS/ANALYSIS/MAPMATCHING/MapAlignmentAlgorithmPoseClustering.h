@@ -62,6 +62,13 @@ namespace OpenMS
     @n A Geometric Approach for the Alignment of Liquid Chromatography-Mass Spectrometry Data
     @n ISMB/ECCB 2007
 
+    The reference-side data (the selected reference points and their
+    preprocessed form for the superimposer) is computed once in
+    setReference(). The @p align functions only read it, so several maps can
+    be aligned to the same reference in parallel, using the same object. Only
+    a small projection of each aligned map (its most intense points) is
+    created internally.
+
     @htmlinclude OpenMS_MapAlignmentAlgorithmPoseClustering.parameters
 
     @ingroup MapAlignment
@@ -86,20 +93,38 @@ public:
     template <typename MapType>
     void setReference(const MapType& map)
     {
-      MapType map2 = map; // todo: avoid copy (MSExperiment version of convert() demands non-const version)
-      MapConversion::convert(0, map2, reference_, max_num_peaks_considered_);
+      MapConversion::convert(0, map, reference_, max_num_peaks_considered_);
+      prepareReference_();
     }
 
+    /**
+      @brief Returns the reference (the data points of the reference map that are used for the alignment)
+
+      Storing this (e.g. as featureXML) and passing it to setReference()
+      later allows aligning further maps to the same reference without the
+      original reference map.
+    */
+    const ConsensusMap& getReference() const;
+
 protected:
 
     void updateMembers_() override;
 
+    /// Precomputes the superimposer data for the current reference
+    void prepareReference_();
+
+    /// Aligns @p map_scene (modified in the process) to the reference
+    void alignScene_(ConsensusMap& map_scene, TransformationDescription& trafo);
+
     PoseClusteringAffineSuperimposer superimposer_;
 
     StablePairFinder pairfinder_;
 
     ConsensusMap reference_;
 
+    /// Superimposer data for the reference (computed once, read-only during alignment)
+    PoseClusteringAffineSuperimposer::PreparedModel reference_model_;
+
     Int max_num_peaks_considered_;
 
 private:
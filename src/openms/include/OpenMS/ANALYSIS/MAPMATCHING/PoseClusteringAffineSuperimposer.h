@@ -100,6 +100,38 @@ public:
     /// Perform alignment on vector of 1D peaks
     virtual void run(const std::vector<Peak2D> & map_model, const std::vector<Peak2D> & map_scene, TransformationDescription & transformation);
 
+    /**
+      @brief Model map data that can be computed once and reused
+
+      When many scene maps are aligned to the same model map, the model-side
+      preprocessing (selection of the most abundant points and sorting) can be
+      done once using prepareModel(). The result is only read by run(), so it
+      can be shared between threads.
+    */
+    struct PreparedModel
+    {
+      /// The most abundant points of the model map (see @p num_used_points), sorted by m/z
+      std::vector<Peak2D> points;
+      /// Minimal RT of the (complete) model map
+      double min_rt;
+      /// Maximal RT of the (complete) model map
+      double max_rt;
+
+      PreparedModel() :
+        points(), min_rt(0.0), max_rt(0.0)
+      {}
+    };
+
+    /**
+      @brief Preprocesses the model map for (repeated) use in run()
+
+      @exception IllegalArgument is thrown if @p map_model is empty.
+    */
+    void prepareModel(const std::vector<Peak2D> & map_model, PreparedModel & model) const;
+
+    /// Perform alignment of @p map_scene against a model map that was preprocessed with prepareModel()
+    void run(const PreparedModel & model, const std::vector<Peak2D> & map_scene, TransformationDescription & transformation);
+
     /// Returns an instance of this class
     static BaseSuperimposer * create()
     {
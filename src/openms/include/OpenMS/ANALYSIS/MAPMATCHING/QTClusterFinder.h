@@ -44,6 +44,7 @@
 #include <boost/unordered_map.hpp>
 
 #include <list>
+#include <queue>
 #include <vector>
 #include <set>
 #include <utility> // for pair<>
@@ -91,7 +92,11 @@ namespace OpenMS
    This algorithm includes a number of optimizations to reduce run-time:
    @li two-dimensional hashing of features,
    @li a look-up table for feature distances,
-   @li a variant of QT clustering that requires only one round of clustering.
+   @li a variant of QT clustering that requires only one round of clustering,
+   @li a priority queue of cluster qualities, so that only the clusters
+       affected by the extraction of a consensus feature need to be updated,
+   @li parallel (OpenMP) computation of the initial clusters and of the
+       cluster updates (the result does not depend on the number of threads).
 
    @see FeatureGroupingAlgorithmQT
 
@@ -116,6 +121,35 @@ private:
 
     typedef HashGrid<OpenMS::GridFeature*> Grid;
 
+    /// Entry in the priority queue used to find the best cluster
+    struct ClusterQueueEntry_
+    {
+      ClusterQueueEntry_(double q, Size i, QTCluster* c) :
+        quality(q), index(i), cluster(c)
+      {}
+
+      /// Quality of the cluster at the time the entry was created
+      double quality;
+      /// Position of the cluster in the clustering (used to break ties)
+      Size index;
+      QTCluster* cluster;
+
+      /// Higher quality comes first; on ties, the cluster created first wins
+      bool operator<(const ClusterQueueEntry_& other) const
+      {
+        if (quality != other.quality) return quality < other.quality;
+        return index > other.index;
+      }
+    };
+
+    /**
+       @brief Priority queue of clusters
+
+       Entries are not removed when a cluster changes - a new entry is added
+       instead and outdated entries are skipped when they reach the top.
+    */
+    typedef std::priority_queue<ClusterQueueEntry_> ClusterQueue;
+
     /// Number of input maps
     Size num_maps_;
 
@@ -147,12 +181,13 @@ private:
     void setParameters_(double max_intensity, double max_mz);
 
     /// Generates a consensus feature from the best cluster and updates the clustering
-    void makeConsensusFeature_(std::list<QTCluster>& clustering,
+    void makeConsensusFeature_(std::vector<QTCluster>& clustering,
+                               ClusterQueue& cluster_queue,
                                ConsensusFeature& feature,
                                ElementMapping& element_mapping, Grid&);
 
     /// Computes an initial QT clustering of the points in the hash grid
-    void computeClustering_(Grid& grid, std::list<QTCluster>& clustering);
+    void computeClustering_(Grid& grid, std::vector<QTCluster>& clustering);
 
     /// Runs the algorithm on feature maps or consensus maps
     template <typename MapType>
@@ -144,6 +144,18 @@ public:
     void run(const std::vector<ConsensusMap>& input_maps,
              ConsensusMap& result_map) override;
 
+    /**
+      @brief Run the algorithm on two maps
+
+      Same as run() above, but avoids copying the maps into a vector (e.g.
+      when many maps are matched against the same reference). This function
+      does not modify the object, so it can be called from several threads.
+
+      @exception Exception::IllegalArgument is thrown if the input data is not valid.
+    */
+    void run(const ConsensusMap& map_model, const ConsensusMap& map_scene,
+             ConsensusMap& result_map) const;
+
 protected:
 
     ///@name Internal helper classes and enums
@@ -96,7 +96,15 @@ public:
      * dimension in Th or ppm (e.g. a window of 50 ppm means an extraction of
      * 25 ppm on either side)
      * @param ppm Whether mz_extraction_window is in ppm or in Th
-     * @param filter Which function to apply in m/z space (currently "tophat" only)
+     * @param im_extraction_window Extracts a window of this size in ion
+     * mobility dimension (no ion mobility filtering if not positive)
+     * @param filter Which function to apply in m/z space ("tophat" or "bartlett")
+     *
+     * The sorted extraction coordinates are merged with each (sorted)
+     * spectrum in a single pass, the intensities inside each window are then
+     * summed over the contiguous intensity array. The "tophat" filter gives
+     * the same result as calling extract_value_tophat for each coordinate,
+     * "bartlett" weights each peak by 1 - |mz - target| / (window / 2).
      *
     */
     void extractChromatograms(const OpenSwath::SpectrumAccessPtr input,
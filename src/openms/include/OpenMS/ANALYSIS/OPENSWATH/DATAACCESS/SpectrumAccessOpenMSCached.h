@@ -55,10 +55,12 @@ namespace OpenMS
     (ISpectrumAccess) using the CachedmzML class which is able to read and
     write a cached mzML file.
 
-    @note This implementation is @a not thread-safe since it keeps internally a
-    single file access pointer which it moves when accessing a specific
-    data item. The caller is responsible to ensure that access is performed
-    atomically.
+    @note By default, this implementation is @a not thread-safe since it keeps
+    internally a single file access pointer which it moves when accessing a
+    specific data item. The caller is responsible to ensure that access is
+    performed atomically. If the cached file is memory-mapped (see
+    SpectrumAccessOpenMSCached(const String&, bool)), data is read directly
+    from the mapped memory and concurrent access is safe.
 
   */
   class OPENMS_DLLAPI SpectrumAccessOpenMSCached :
@@ -81,6 +83,19 @@ public:
     */
     explicit SpectrumAccessOpenMSCached(const String& filename);
 
+    /**
+      @brief Constructor, opens the file stream and optionally memory-maps the cached data
+
+      @param filename The filename of the .mzML file (it is assumed a second
+      file .mzML.cached exists).
+      @param memory_map Whether to memory-map the cached data file
+
+      @throws Exception::FileNotFound is thrown if the file is not found
+      @throws Exception::FileNotReadable is thrown if the file cannot be memory-mapped
+      @throws Exception::ParseError is thrown if the file cannot be parsed
+    */
+    SpectrumAccessOpenMSCached(const String& filename, bool memory_map);
+
     /**
       @brief Destructor
     */
@@ -119,13 +119,8 @@ protected:
     /** @brief Constructor
      *
      *  @param use_ms1_traces Whether to use MS1 data
-     *  @param threads_outer_loop How many threads should be used for the outer
-     *  loop (-1 will use all threads in the outer loop)
-     *
-     *  @note The total number of threads should be divisible by this number
-     *  (e.g. use 8 in outer loop if you have 24 threads in total and 3 will be
-     *  used for the inner loop).
-     *
+     *  @param threads_outer_loop How many SWATH windows may be processed (and
+     *  held in memory) at the same time (-1 for no limit)
      *
      **/
     OpenSwathWorkflowBase(bool use_ms1_traces, bool use_ms1_ion_mobility, bool prm, int threads_outer_loop) :
@@ -203,13 +198,12 @@ protected:
     /// Whether data is acquired in targeted DIA (e.g. PRM mode) with potentially overlapping windows
     bool prm_;
 
-    /** @brief How many threads should be used for the outer loop
+    /** @brief How many SWATH windows may be processed (and held in memory) at the same time
      *
-     *  @note A value of -1 will use all threads in the outer loop
+     *  @note A value of -1 places no limit on the number of open windows
      *
-     *  @note The total number of threads should be divisible by this number
-     *  (e.g. use 8 in outer loop if you have 24 threads in total and 3 will be
-     *  used for the inner loop).
+     *  @note All threads share the batches of the open windows, so this
+     *  limits memory usage without having to match the number of threads.
      *
      **/
     int threads_outer_loop_;
@@ -394,15 +388,10 @@ protected:
      *
      *  @param use_ms1_traces Whether to use MS1 data
      *  @param use_ms1_ion_mobility Whether to use ion mobility extraction on MS1 traces
-     *  @param threads_outer_loop How many threads should be used for the outer
-     *  loop (-1 will use all threads in the outer loop)
+     *  @param threads_outer_loop How many SWATH windows may be processed (and
+     *  held in memory) at the same time (-1 for no limit)
      *  @param prm Whether data is acquired in targeted DIA (e.g. PRM mode) with potentially overlapping windows
      *
-     *  @note The total number of threads should be divisible by this number
-     *  (e.g. use 8 in outer loop if you have 24 threads in total and 3 will be
-     *  used for the inner loop).
-     *
-     *
      **/
     OpenSwathWorkflow(bool use_ms1_traces, bool use_ms1_ion_mobility, bool prm, int threads_outer_loop) :
       OpenSwathWorkflowBase(use_ms1_traces, use_ms1_ion_mobility, prm, threads_outer_loop)
@@ -433,6 +422,11 @@ protected:
      * potentially decrease the utility of parallelization while loading data
      * into memory will increase memory usage but decrease execution time.
      *
+     * @note Each batch of each SWATH window is an independent task. All
+     * threads take tasks from a common queue (ordered by window), so windows
+     * with many transitions are shared between threads. The time spent on
+     * each task is written to the log.
+     *
     */
     void performExtraction(const std::vector< OpenSwath::SwathMap > & swath_maps,
                            const TransformationDescription trafo,
@@ -93,6 +93,33 @@ public:
     optimizeTree();
   }
 
+  /**
+    @brief Add those features of @p maps for which @p accept returns true and balance kd-tree
+
+    Features are referenced, not copied, so @p maps must outlive this object.
+    The predicate is called with a <tt>const BaseFeature&</tt>. This allows
+    restricting the kd-tree to a region (e.g. an m/z partition) without
+    creating temporary copies of the input maps.
+  */
+  template <typename MapType, typename UnaryPredicate>
+  void addMaps(const std::vector<MapType>& maps, UnaryPredicate accept)
+  {
+    num_maps_ = maps.size();
+
+    for (Size i = 0; i < num_maps_; ++i)
+    {
+      const MapType& m = maps[i];
+      for (typename MapType::const_iterator it = m.begin(); it != m.end(); ++it)
+      {
+        if (accept(*it))
+        {
+          addFeature(i, &(*it));
+        }
+      }
+    }
+    optimizeTree();
+  }
+
   /// Add feature
   void addFeature(Size mt_map_index, const BaseFeature* feature);
 
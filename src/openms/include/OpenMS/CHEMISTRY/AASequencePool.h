@@ -0,0 +1,238 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CHEMISTRY/AASequence.h>
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace OpenMS
+{
+  class AASequencePool;
+
+  /**
+      @brief Handle to an immutable, shared (interned) peptide sequence
+
+      Obtained from an AASequencePool. All handles for the same sequence that
+      come from the same pool share one representation, which stores the
+      AASequence, its string form, a hash value and the cumulative residue
+      masses. Comparisons and hashing therefore do not need to walk the
+      residues, and masses of the full sequence and of all prefix and suffix
+      fragments are computed in constant time.
+
+      Handles are cheap to copy and stay valid as long as the pool that
+      created them exists. A default-constructed handle refers to the empty
+      sequence.
+
+      @note Masses are computed from the cumulative residue masses and may
+      differ from AASequence::getMonoWeight() by floating point rounding.
+
+      @ingroup Chemistry
+  */
+  class OPENMS_DLLAPI InternedAASequence
+  {
+public:
+    /// Default constructor (empty sequence)
+    InternedAASequence();
+
+    /// returns the shared AASequence
+    inline const AASequence& getSequence() const
+    {
+      return entry_->sequence;
+    }
+
+    /// returns the (cached) string form, see AASequence::toString()
+    inline const String& toString() const
+    {
+      return entry_->string;
+    }
+
+    /// returns the number of residues
+    inline Size size() const
+    {
+      return entry_->sequence.size();
+    }
+
+    /// returns true if the sequence is empty
+    inline bool empty() const
+    {
+      return entry_->sequence.empty();
+    }
+
+    /// returns the hash value of the string form
+    inline std::size_t hash() const
+    {
+      return entry_->hash;
+    }
+
+    /// returns the monoisotopic weight of the sequence, see AASequence::getMonoWeight()
+    double getMonoWeight(Residue::ResidueType type = Residue::Full, Int charge = 0) const;
+
+    /// returns the monoisotopic weight of the prefix with @p length residues (same as getSequence().getPrefix(length).getMonoWeight(type, charge))
+    double getPrefixMonoWeight(Size length, Residue::ResidueType type = Residue::BIon, Int charge = 0) const;
+
+    /// returns the monoisotopic weight of the suffix with @p length residues (same as getSequence().getSuffix(length).getMonoWeight(type, charge))
+    double getSuffixMonoWeight(Size length, Residue::ResidueType type = Residue::YIon, Int charge = 0) const;
+
+    /// returns the (cached) formula of the full, uncharged sequence
+    const EmpiricalFormula& getFormula() const;
+
+    /**
+      @brief returns the cumulative internal residue masses (size() + 1 entries, starting with 0)
+
+      The internal mass of the residues [i, j) is getPrefixMasses()[j] - getPrefixMasses()[i],
+      terminal modifications are not included. Empty if the sequence contains residues of
+      unknown mass ('X').
+    */
+    inline const std::vector<double>& getPrefixMasses() const
+    {
+      return entry_->prefix_masses;
+    }
+
+    /// equality operator (constant time for handles from the same pool)
+    inline bool operator==(const InternedAASequence& rhs) const
+    {
+      return (entry_ == rhs.entry_) ||
+        ((entry_->hash == rhs.entry_->hash) && (entry_->string == rhs.entry_->string));
+    }
+
+    /// inequality operator
+    inline bool operator!=(const InternedAASequence& rhs) const
+    {
+      return !(*this == rhs);
+    }
+
+    /// lexicographical comparison of the string forms
+    inline bool operator<(const InternedAASequence& rhs) const
+    {
+      return (entry_ != rhs.entry_) && (entry_->string < rhs.entry_->string);
+    }
+
+protected:
+    friend class AASequencePool;
+
+    /// shared representation of a sequence
+    struct Entry_
+    {
+      AASequence sequence;
+      String string;
+      std::size_t hash;
+      /// cumulative internal residue masses (size() + 1 entries, starting with 0)
+      std::vector<double> prefix_masses;
+      double n_term_mass;
+      double c_term_mass;
+      /// false if the sequence contains residues of unknown mass ('X'), in which case AASequence computes (and rejects) the masses
+      bool has_mass;
+      EmpiricalFormula formula;
+    };
+
+    /// returns the shared representation of the empty sequence
+    static const Entry_* emptyEntry_();
+
+    /// computes the weight of the residues [begin, end) for an ion @p type
+    double getMonoWeight_(Size begin, Size end, bool n_term, bool c_term, Residue::ResidueType type, Int charge) const;
+
+    explicit InternedAASequence(const Entry_* entry);
+
+    const Entry_* entry_;
+  };
+
+  /**
+      @brief Pool of interned (hash-consed) peptide sequences
+
+      Sequences are parsed and analyzed only once per pool: fromString()
+      caches its input strings, so repeated parsing of the same string (and
+      ResidueDB/ModificationsDB lookups) are avoided, and different
+      notations of the same sequence map to the same InternedAASequence.
+
+      A pool is not thread-safe. Parallel code should use one pool per
+      thread, so that lookups do not need any locking.
+
+      @ingroup Chemistry
+  */
+  class OPENMS_DLLAPI AASequencePool
+  {
+public:
+    /// Default constructor
+    AASequencePool();
+
+    /// Destructor (invalidates all handles created by this pool)
+    ~AASequencePool();
+
+    /// returns the interned sequence for a string, see AASequence::fromString()
+    InternedAASequence fromString(const String& s, bool permissive = true);
+
+    /// returns the interned version of @p seq
+    InternedAASequence intern(const AASequence& seq);
+
+    /// returns the number of distinct sequences in the pool
+    Size size() const;
+
+    /// removes all sequences from the pool (invalidates all handles created by this pool)
+    void clear();
+
+protected:
+    /// returns the entry for the canonical string form of @p seq, creating it if necessary
+    const InternedAASequence::Entry_* intern_(const AASequence& seq);
+
+    /// distinct sequences, by canonical string form
+    std::unordered_map<std::string, std::unique_ptr<InternedAASequence::Entry_> > entries_;
+
+    /// input strings of fromString()
+    std::unordered_map<std::string, const InternedAASequence::Entry_*> aliases_;
+
+private:
+    /// Not implemented
+    AASequencePool(const AASequencePool&);
+
+    /// Not implemented
+    AASequencePool& operator=(const AASequencePool&);
+  };
+
+} // namespace OpenMS
+
+namespace std
+{
+  /// hash for InternedAASequence
+  template <> struct hash<OpenMS::InternedAASequence>
+  {
+    std::size_t operator()(const OpenMS::InternedAASequence& s) const
+    {
+      return s.hash();
+    }
+  };
+} // namespace std
@@ -82,8 +82,94 @@ namespace OpenMS
   {
 
 protected:
-	  /// Internal typedef for the used map type
-	  typedef std::map<const Element*, SignedSize> MapType_;
+    /**
+      @brief Flat map from elements to their counts
+
+      Stores the (element, count) pairs contiguously and sorted by element
+      pointer, i.e. in the same order as a @p std::map keyed by element would.
+      Up to @p INLINE_CAPACITY entries (enough for CHNOPS and one additional
+      element) are kept inside the object itself, so creating, copying and
+      combining typical (peptide) formulae does not touch the heap.
+
+      Only the subset of the @p std::map interface used by EmpiricalFormula is
+      provided. Inserting or erasing invalidates iterators.
+    */
+    class OPENMS_DLLAPI MapType_
+    {
+public:
+      typedef std::pair<const Element*, SignedSize> value_type;
+      typedef value_type* iterator;
+      typedef const value_type* const_iterator;
+
+      MapType_();
+
+      MapType_(const MapType_& rhs);
+
+      MapType_(MapType_&& rhs) noexcept;
+
+      ~MapType_();
+
+      MapType_& operator=(const MapType_& rhs);
+
+      MapType_& operator=(MapType_&& rhs) noexcept;
+
+      inline iterator begin() { return data_; }
+
+      inline iterator end() { return data_ + size_; }
+
+      inline const_iterator begin() const { return data_; }
+
+      inline const_iterator end() const { return data_ + size_; }
+
+      inline Size size() const { return size_; }
+
+      inline bool empty() const { return size_ == 0; }
+
+      inline void clear() { size_ = 0; }
+
+      /// returns the entry of @p element or end() if not present
+      iterator find(const Element* element);
+
+      /// returns the entry of @p element or end() if not present
+      const_iterator find(const Element* element) const;
+
+      /// inserts @p value unless its element is already present (like std::map::insert)
+      std::pair<iterator, bool> insert(const value_type& value);
+
+      /// returns the count of @p element, inserting a zero count if not present
+      SignedSize& operator[](const Element* element);
+
+      /// returns the count of @p element, throws std::out_of_range if not present
+      SignedSize& at(const Element* element);
+
+      /// removes the entry at @p pos and returns an iterator to the following entry
+      iterator erase(iterator pos);
+
+      bool operator==(const MapType_& rhs) const;
+
+      bool operator!=(const MapType_& rhs) const;
+
+private:
+      /// number of entries stored without heap allocation
+      static const Size INLINE_CAPACITY = 6;
+
+      /// first entry not ordered before @p element
+      iterator lowerBound_(const Element* element) const;
+
+      /// grows the storage to hold at least @p capacity entries
+      void reserve_(Size capacity);
+
+      /// releases heap storage (if any) and switches back to the inline buffer
+      void reset_();
+
+      value_type inline_[INLINE_CAPACITY];
+
+      value_type* data_;
+
+      Size size_;
+
+      Size capacity_;
+    };
 
 public:
     /** @name Typedefs
@@ -286,7 +372,7 @@ protected:
 
     Int charge_;
 
-    Int parseFormula_(std::map<const Element*, SignedSize>& ef, const String& formula) const;
+    Int parseFormula_(MapType_& ef, const String& formula) const;
 
   };
 
@@ -128,7 +128,7 @@ public:
      determine e.g. missing ones. @todo could be set of pairs.
 
      @param sequence Sequence to digest
-     @param output Digestion products as vector of pairs of start and end positions
+     @param output Digestion products as vector of pairs of start position and length
      @param min_length Minimal length of reported products
      @param max_length Maximal length of reported products (0 = no restriction)
      @return Number of discarded digestion products (which are not matching length restrictions)
@@ -38,6 +38,7 @@
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsotopeDistribution.h>
 
 #include <set>
+#include <vector>
 
 namespace OpenMS
 {
@@ -331,6 +332,17 @@ namespace OpenMS
     /// fill a gapped isotope pattern (i.e. certain masses are missing), with zero probability masses
     IsotopeDistribution::ContainerType fillGaps_(const IsotopeDistribution::ContainerType& id) const;
 
+    /**
+      @brief Same as run(), but memoized in a per-thread cache keyed by element composition
+
+      Used by the averagine estimates (e.g. estimateFromPeptideWeight()): they round the
+      element counts, so all weights mapping to the same composition share one entry.
+    */
+    IsotopeDistribution runCached_(const EmpiricalFormula& formula) const;
+
+    /// returns the probabilities of @p id as a contiguous array (for vectorizable convolution loops)
+    std::vector<Peak1D::IntensityType> intensities_(const IsotopeDistribution::ContainerType& id) const;
+
  protected:
     /// maximal isotopes which is used to calculate the distribution
     Size max_isotope_;
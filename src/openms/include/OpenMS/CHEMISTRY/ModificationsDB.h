@@ -38,6 +38,7 @@
 #include <OpenMS/DATASTRUCTURES/String.h>
 #include <OpenMS/CHEMISTRY/ResidueModification.h>
 
+#include <atomic>
 #include <set>
 
 namespace OpenMS
@@ -68,6 +69,12 @@ namespace OpenMS
       In some scenarios, it might be useful to define different modification
       databases. This can be done by providing a path when initializing
       ModificationsDB.
+
+      All queries are lock-free and can be issued from many threads at once:
+      modifications and their names are never changed or removed once added,
+      so readers traverse insert-only lookup tables which writers extend
+      atomically. Only adding modifications (e.g. user-defined ones via
+      addModification()) is synchronized.
   */
   class OPENMS_DLLAPI ModificationsDB
   {
@@ -123,9 +130,17 @@ public:
 
     /**
        @brief Add a new modification to ModificationsDB.
-       Will skip adding if modification already exists (based on its fullID)
+
+       Will skip adding if modification already exists (based on its fullID).
+       The check and the addition are atomic, so threads adding the same
+       modification concurrently all receive the same instance.
+
+       @return The modification registered under the fullID of @p new_mod:
+       @p new_mod itself if it was added (ownership is transferred to the
+       database), otherwise the existing modification (the caller keeps
+       ownership of @p new_mod and should delete it)
     */
-    void addModification(ResidueModification * new_mod);
+    const ResidueModification* addModification(ResidueModification * new_mod);
 
     /**
        @brief Returns the index of the modification in the mods_ vector; a unique name must be given
@@ -175,11 +190,56 @@ protected:
     /// Stores whether ModificationsDB was instantiated before
     static bool is_instantiated_;
 
-    /// Stores the modifications
-    std::vector<ResidueModification*> mods_;
+    /// Entry of the (insert-only) name index: one name of one modification
+    struct NameEntry_
+    {
+      /// name (e.g. "Oxidation (M)", "Oxidation", "UniMod:35")
+      String name;
+      /// modification with this name
+      const ResidueModification* mod;
+      /// next entry in the same hash bucket
+      NameEntry_* next;
+    };
+
+    /// number of hash buckets of the name index
+    static const Size NR_NAME_BUCKETS = 16384;
+    /// number of modifications per block of the modification list
+    static const Size MODS_BLOCK_SIZE = 1024;
+    /// maximal number of blocks of the modification list
+    static const Size MAX_MODS_BLOCKS = 4096;
+
+    /// Lock-free: collects all modifications with the given name
+    void findModificationsByName_(const String& name, std::set<const ResidueModification*>& mods) const;
+
+    /// Lock-free: returns true if a modification with the given name exists
+    bool hasName_(const String& name) const;
+
+    /// Lock-free: returns the first modification linked to the given name, or nullptr
+    const ResidueModification* findName_(const String& name) const;
+
+    /// Lock-free: returns the number of modifications
+    Size size_() const;
+
+    /// Lock-free: returns the modification with the given index (index must be smaller than size_())
+    const ResidueModification* at_(Size index) const;
+
+    /// Adds a modification and takes ownership (caller must hold the "OpenMS_ModificationsDB" critical section or be constructing)
+    void addMod_(ResidueModification* mod);
+
+    /// Links a name to a modification, unless already linked (caller must hold the "OpenMS_ModificationsDB" critical section or be constructing)
+    void addName_(const String& name, const ResidueModification* mod);
+
+    /// Deletes all modifications and names (not thread-safe)
+    void clear_();
+
+    /// Stores the modifications (in blocks, which never move once allocated)
+    ResidueModification** mods_blocks_[MAX_MODS_BLOCKS];
+
+    /// Number of modifications visible to readers
+    std::atomic<Size> mods_size_;
 
-    /// Stores the mappings of (unique) names to the modifications
-    Map<String, std::set<const ResidueModification*> > modification_names_;
+    /// Stores the mappings of names to the modifications (hash chains)
+    std::atomic<NameEntry_*> name_buckets_[NR_NAME_BUCKETS];
 
     /// Helper function to check if a residue matches the origin for a modification
     bool residuesMatch_(const String& residue, const ResidueModification* origin) const;
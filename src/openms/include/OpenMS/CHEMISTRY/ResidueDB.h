@@ -38,6 +38,7 @@
 #include <boost/unordered_map.hpp>
 #include <OpenMS/DATASTRUCTURES/String.h>
 
+#include <atomic>
 #include <set>
 
 namespace OpenMS
@@ -56,6 +57,12 @@ namespace OpenMS
       By default no modified residues are stored in an instance. However, if one
       queries the instance with getModifiedResidue, a new modified residue is
       added.
+
+      All queries are lock-free and can be issued from many threads at once:
+      the unmodified residues (and all lookup tables for them) are frozen after
+      construction, and modified residues are never changed or removed once
+      added, so they are found via insert-only hash chains which writers
+      extend atomically. Only creating a new modified residue is synchronized.
   */
   class OPENMS_DLLAPI ResidueDB
   {
@@ -157,7 +164,7 @@ public:
     //@}
 
 protected:
-    /// sets the residues from given file
+    /// sets the residues from given file (not thread-safe, invalidates all residue pointers)
     void setResidues_(const String& filename);
 
     /** @name Private Constructors
@@ -199,22 +206,45 @@ protected:
     /// builds an index of residue names for fast access, synonyms are also considered
     void buildResidueNames_();
 
-    void addResidue_(Residue* residue);
+    /// Entry of the (insert-only) index of modified residues
+    struct ModifiedResidueEntry_
+    {
+      /// name of the unmodified residue
+      String residue_name;
+      /// ID of the modification (or full ID, if the ID is empty)
+      String modification_id;
+      /// the modified residue (owned)
+      Residue* residue;
+      /// next entry in the same hash bucket
+      ModifiedResidueEntry_* next;
+    };
+
+    /// number of hash buckets of the modified residue index
+    static const Size NR_MODIFIED_BUCKETS = 1024;
+
+    /// Lock-free lookup of a modified residue, returns nullptr if not present
+    const Residue* findModifiedResidue_(const String& residue_name, const String& modification_id) const;
+
+    /// Adds a modified residue and takes ownership (caller must hold the "ResidueDB" critical section)
+    void addModifiedResidue_(Residue* residue, const String& modification_id);
+
+    /// Returns the ID under which a modified residue is stored
+    static const String& getModificationId_(const ResidueModification* mod);
 
     boost::unordered_map<String, Residue*> residue_names_;
 
     // fast lookup table for residues
     Residue* residue_by_one_letter_code_[256];
 
-    Map<String, Map<String, Residue*> > residue_mod_names_;
-
     std::set<Residue*> residues_;
 
     std::set<const Residue*> const_residues_;
 
-    std::set<Residue*> modified_residues_;
+    /// modified residues (hash chains by residue name and modification ID)
+    std::atomic<ModifiedResidueEntry_*> modified_buckets_[NR_MODIFIED_BUCKETS];
 
-    std::set<const Residue*> const_modified_residues_;
+    /// number of modified residues
+    std::atomic<Size> number_of_modified_residues_;
 
     Map<String, std::set<const Residue*> > residues_by_set_;
 
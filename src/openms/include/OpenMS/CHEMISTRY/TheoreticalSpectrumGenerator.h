@@ -43,6 +43,7 @@
 namespace OpenMS
 {
   class AASequence;
+  class InternedAASequence;
 
   /**
       @brief Generates theoretical spectra for peptides with various options
@@ -92,14 +93,27 @@ namespace OpenMS
     /// Generates a spectrum for a peptide sequence, with the ion types that are set in the tool parameters
     virtual void getSpectrum(PeakSpectrum& spec, const AASequence& peptide, Int min_charge, Int max_charge) const;
 
+    /**
+      @brief Generates a spectrum for an interned peptide sequence
+
+      Same as getSpectrum(spec, peptide.getSequence(), min_charge, max_charge), but the
+      masses of the fragment ions (without isotope peaks) are taken from the cached prefix
+      masses of the sequence (see InternedAASequence::getPrefixMasses()) instead of being
+      summed up over the residues. They may differ by floating point rounding.
+    */
+    void getSpectrum(PeakSpectrum& spec, const InternedAASequence& peptide, Int min_charge, Int max_charge) const;
+
     /// overwrite
     void updateMembers_() override;
     //@}
 
     protected:
 
-    /// adds peaks to a spectrum of the given ion-type, peptide, charge, and intensity, also adds charges and ion names to the DataArrays, if the add_metainfo parameter is set to true
-    virtual void addPeaks_(PeakSpectrum& spectrum, const AASequence& peptide, DataArrays::StringDataArray& ion_names, DataArrays::IntegerDataArray& charges, Residue::ResidueType res_type, Int charge = 1) const;
+    /// implementation of getSpectrum(), @p prefix_masses are the cumulative internal residue masses of @p peptide (or nullptr)
+    void getSpectrum_(PeakSpectrum& spec, const AASequence& peptide, const double* prefix_masses, Int min_charge, Int max_charge) const;
+
+    /// adds peaks to a spectrum of the given ion-type, peptide, charge, and intensity, also adds charges and ion names to the DataArrays, if the add_metainfo parameter is set to true. Fragment masses are taken from @p prefix_masses (cumulative internal residue masses) if given.
+    virtual void addPeaks_(PeakSpectrum& spectrum, const AASequence& peptide, DataArrays::StringDataArray& ion_names, DataArrays::IntegerDataArray& charges, Residue::ResidueType res_type, Int charge = 1, const double* prefix_masses = nullptr) const;
 
     /// adds the precursor peaks to the spectrum, also adds charges and ion names to the DataArrays, if the add_metainfo parameter is set to true
     virtual void addPrecursorPeaks_(PeakSpectrum& spec, const AASequence& peptide, DataArrays::StringDataArray& ion_names, DataArrays::IntegerDataArray& charges, Int charge = 1) const;
@@ -5,6 +5,7 @@ set(directory include/OpenMS/CHEMISTRY)
 set(sources_list_h
 AAIndex.h
 AASequence.h
+AASequencePool.h
 CrossLinksDB.h
 Element.h
 ElementDB.h
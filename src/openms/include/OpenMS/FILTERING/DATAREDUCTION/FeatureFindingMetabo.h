@@ -158,6 +158,13 @@ public:
     metabolites with only a monoisotopic mass trace to observe are left in the
     resulting @ref FeatureMap as singletons with the undefined charge state of 0.
 
+    Hypotheses are formulated in parallel for all mass traces and reference
+    the traces by their index. They are accepted greedily in order of
+    decreasing score (ties are broken by the index of the monoisotopic trace)
+    if none of their traces has been used by a better hypothesis. The isotope
+    filter and the construction of the features are run in parallel, so the
+    result does not depend on the number of threads.
+
     Reference: Kenar et al., doi: 10.1074/mcp.M113.031278
 
     @htmlinclude OpenMS_FeatureFindingMetabo.parameters
@@ -252,15 +259,20 @@ e conditions are fulfilled. Mainly the
     */
     double computeAveragineSimScore_(const std::vector<double>& intensities, const double& molecular_weight) const;
 
+    /// Compact, index-based feature hypotheses of one thread (defined in the .cpp file)
+    struct HypothesisBuffer_;
+
     /** @brief Identify groupings of mass traces based on a set of reasonable candidates
      *
      * Takes a set of reasonable candidates for mass trace grouping and checks
      * all combinations of charge and isotopic positions on the candidates. It
      * is assumed that candidates[0] is the monoisotopic trace.
      *
-     * The resulting possible groupings are appended to output_hypotheses.
+     * The candidates are indices into @p traces. The resulting possible
+     * groupings are appended to @p output_hypotheses, which references the
+     * traces by index only (i.e. no FeatureHypothesis objects are created).
     */
-    void findLocalFeatures_(const std::vector<const MassTrace*>& candidates, double total_intensity, std::vector<FeatureHypothesis>& output_hypotheses) const;
+    void findLocalFeatures_(const std::vector<MassTrace>& traces, const std::vector<Size>& candidates, double total_intensity, HypothesisBuffer_& output_hypotheses) const;
 
     /// SVM parameters
     svm_model* isotope_filt_svm_;
@@ -39,6 +39,7 @@
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
 #include <OpenMS/CONCEPT/ProgressLogger.h>
+#include <OpenMS/INTERFACES/IMSDataConsumer.h>
 
 namespace OpenMS
 {
@@ -65,6 +66,22 @@ namespace OpenMS
       length as well as having the minimal sample rate criterion fulfilled) get
       added to the result.
 
+      Mass traces far apart in m/z do not interact, so the detection can be
+      split into m/z partitions (see the mz_partitions parameter) that are
+      processed in parallel. Each partition holds the peaks of its m/z range
+      plus an overlap (mz_partition_overlap) and extends the traces of the
+      apices in its range. The partition results are merged in the global
+      apex order: an extension is taken over if it saw the same peaks and
+      visited flags as the sequential algorithm would have, otherwise (e.g.
+      for traces at partition borders or competing for peaks with a trace
+      from another partition) it is repeated on all peaks. The result is
+      therefore identical to the sequential detection and independent of
+      the number of threads.
+
+      The input can also be streamed through a PeakCollector (an
+      IMSDataConsumer), which keeps only the peaks above the noise threshold
+      instead of the whole experiment.
+
       @htmlinclude OpenMS_MassTraceDetection.parameters
 
       @ingroup Quantitation
@@ -80,6 +97,66 @@ namespace OpenMS
         /// Default destructor
         ~MassTraceDetection() override;
 
+        /**
+          @brief Collects the MS1 peaks above the noise threshold of a stream of spectra for run()
+
+          Only the retention time, the peaks above noise_threshold_int and
+          (if present) their FWHM_ppm meta data are kept, so the full
+          experiment does not have to be held in memory. The noise parameters
+          are taken from the MassTraceDetection instance at construction.
+          Spectra that are not sorted by m/z are sorted in place.
+        */
+        class OPENMS_DLLAPI PeakCollector :
+          public Interfaces::IMSDataConsumer
+        {
+        public:
+          /// Constructor, using the noise parameters of @p mtd
+          explicit PeakCollector(const MassTraceDetection& mtd);
+
+          void setExperimentalSettings(const ExperimentalSettings& settings) override;
+
+          void setExpectedSize(Size expected_spectra, Size expected_chromatograms) override;
+
+          void consumeSpectrum(SpectrumType& s) override;
+
+          /// Chromatograms are ignored
+          void consumeChromatogram(ChromatogramType& c) override;
+
+          /// Number of collected (MS1) spectra
+          Size getNrSpectra() const;
+
+          /// Number of collected peaks
+          Size getNrPeaks() const;
+
+        private:
+          friend class MassTraceDetection;
+
+          /// A potential chromatographic apex
+          struct Apex
+          {
+            double intensity;
+            Size scan;
+            Size peak;
+          };
+
+          /// Adds the peaks of @p spectrum above the noise threshold (if it is an MS1 spectrum)
+          void addSpectrum_(const MSSpectrum& spectrum);
+
+          double noise_threshold_int_;
+          double chrom_peak_snr_;
+
+          /// Collected spectra (retention time, peaks and FWHM_ppm meta data)
+          PeakMap work_exp_;
+
+          /// Start of each spectrum in the global peak index
+          std::vector<Size> spec_offsets_;
+
+          /// Peaks intense enough to be an apex
+          std::vector<Apex> apices_;
+
+          Size total_peak_count_;
+        };
+
         /** @name Helper methods
         */
 
@@ -92,6 +169,9 @@ namespace OpenMS
         /// Main method of MassTraceDetection. Extracts mass traces of a @ref MSExperiment and gathers them into a vector container.
         void run(const PeakMap &, std::vector<MassTrace> &, const Size max_traces = 0);
 
+        /// Extracts mass traces from the peaks gathered by a PeakCollector.
+        void run(const PeakCollector& peaks, std::vector<MassTrace>& found_masstraces, const Size max_traces = 0);
+
         /// Invokes the run method (see above) on merely a subregion of a @ref MSExperiment map.
         void run(PeakMap::ConstAreaIterator & begin, PeakMap::ConstAreaIterator & end, std::vector<MassTrace> & found_masstraces);
 
@@ -102,16 +182,45 @@ namespace OpenMS
 
     private:
 
-        typedef std::multimap<double, std::pair<Size, Size> > MapIdxSortedByInt;
+        /// Peaks of an m/z range of all spectra together with their visited flags
+        struct Partition_;
+
+        /// A trace detected in a partition, before merging
+        struct PartitionTrace_;
 
         /// The internal run method
-        void run_(const MapIdxSortedByInt& chrom_apices,
-                  const Size peak_count,
-                  const PeakMap & work_exp,
-                  const std::vector<Size>& spec_offsets,
+        void run_(const PeakCollector& peaks,
                   std::vector<MassTrace> & found_masstraces,
                   const Size max_traces = 0);
 
+        /// Detection in m/z partitions processed in parallel (see class documentation)
+        void runPartitioned_(const PeakCollector& peaks,
+                             const std::vector<Size>& apex_order,
+                             const int fwhm_meta_idx,
+                             std::vector<MassTrace> & found_masstraces,
+                             const Size max_traces);
+
+        /**
+          @brief Extends a mass trace from an apex in both RT directions
+
+          Only unvisited peaks of @p partition are gathered. Returns whether the
+          trace meets the length and quality criteria; in this case @p trace is
+          set. @p gathered_idx receives the scan and peak index of all gathered
+          peaks, @p visited_idx those of the peaks that were missed only because
+          they were visited. @p confined is set if the nearest peak of each
+          examined spectrum was found in the partition, i.e. the extension on
+          all peaks with the same visited flags gives the same result.
+        */
+        bool extendTrace_(const PeakMap& work_exp,
+                          const Partition_& partition,
+                          const int fwhm_meta_idx,
+                          const Size apex_scan_idx,
+                          const Size apex_peak_idx,
+                          MassTrace& trace,
+                          std::vector<std::pair<Size, Size> >& gathered_idx,
+                          std::vector<std::pair<Size, Size> >& visited_idx,
+                          bool& confined);
+
         // parameter stuff
         double mass_error_ppm_;
         double noise_threshold_int_;
@@ -125,5 +234,8 @@ namespace OpenMS
         double max_trace_length_;
 
         bool reestimate_mt_sd_;
+
+        Size mz_partitions_;
+        double mz_partition_overlap_;
     };
 }
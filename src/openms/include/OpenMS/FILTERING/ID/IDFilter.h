@@ -43,6 +43,7 @@
 #include <OpenMS/METADATA/PeptideIdentification.h>
 #include <OpenMS/METADATA/PeptideEvidence.h>
 #include <OpenMS/METADATA/ProteinIdentification.h>
+#include <OpenMS/METADATA/PSMTable.h>
 #include <OpenMS/METADATA/ID/IdentificationData.h>
 
 #include <algorithm>
@@ -1308,6 +1309,30 @@ public:
     static void removeDecoys(IdentificationData& id_data);
     ///@}
 
+
+    /**
+       @name Filter functions for class PSMTable
+
+       Same semantics as the corresponding functions for vectors of peptide identifications, but operating on the columns of a PSMTable.
+    */
+    ///@{
+    /// Removes peptide identifications that have no hits in them
+    static void removeEmptyIdentifications(PSMTable& psms);
+
+    /// Keeps only peptide hits with a score at least as good as @p threshold_score (score orientation is taken into account)
+    static void filterHitsByScore(PSMTable& psms, double threshold_score);
+
+    /// Keeps the @p n best hits per peptide identification (hits are sorted by score)
+    static void keepNBestHits(PSMTable& psms, Size n);
+
+    /**
+       @brief Removes hits annotated as decoys (meta values "target_decoy" == "decoy" or "isDecoy" == "true")
+
+       @note The ranks of the hits may be invalidated.
+    */
+    static void removeDecoyHits(PSMTable& psms);
+    ///@}
+
   };
 
 } // namespace OpenMS
@@ -37,6 +37,7 @@
 
 
 #include <OpenMS/FILTERING/NOISEESTIMATION/SignalToNoiseEstimator.h>
+#include <OpenMS/KERNEL/ColumnarSpectrum.h>
 #include <OpenMS/CONCEPT/LogStream.h>
 #include <OpenMS/CONCEPT/Exception.h>
 #include <OpenMS/DATASTRUCTURES/ListUtils.h>
@@ -199,76 +200,7 @@ protected:
       stn_estimates_.clear();
 
       // maximal range of histogram needs to be calculated first
-      if (auto_mode_ == AUTOMAXBYSTDEV)
-      {
-        // use MEAN+auto_max_intensity_*STDEV as threshold
-        GaussianEstimate gauss_global = SignalToNoiseEstimator<Container>::estimate_(scan_first_, scan_last_);
-        max_intensity_ = gauss_global.mean + std::sqrt(gauss_global.variance) * auto_max_stdev_Factor_;
-      }
-      else if (auto_mode_ == AUTOMAXBYPERCENT)
-      {
-        // get value at "auto_max_percentile_"th percentile
-        // we use a histogram approach here as well.
-        if ((auto_max_percentile_ < 0) || (auto_max_percentile_ > 100))
-        {
-          String s = auto_max_percentile_;
-          throw Exception::InvalidValue(__FILE__,
-                                        __LINE__,
-                                        OPENMS_PRETTY_FUNCTION,
-                                        "auto_mode is on AUTOMAXBYPERCENT! auto_max_percentile is not in [0,100]. Use setAutoMaxPercentile(<value>) to change it!",
-                                        s);
-        }
-
-        std::vector<int> histogram_auto(100, 0);
-
-        // find maximum of current scan
-        int size = 0;
-        typename PeakType::IntensityType maxInt = 0;
-        PeakIterator run = scan_first_;
-        while (run != scan_last_)
-        {
-          maxInt = std::max(maxInt, (*run).getIntensity());
-          ++size;
-          ++run;
-        }
-
-        double bin_size = maxInt / 100;
-
-        // fill histogram
-        run = scan_first_;
-        while (run != scan_last_)
-        {
-          ++histogram_auto[(int) (((*run).getIntensity() - 1) / bin_size)];
-          ++run;
-        }
-
-        // add up element counts in histogram until ?th percentile is reached
-        int elements_below_percentile = (int) (auto_max_percentile_ * size / 100);
-        int elements_seen = 0;
-        int i = -1;
-        run = scan_first_;
-
-        while (run != scan_last_ && elements_seen < elements_below_percentile)
-        {
-          ++i;
-          elements_seen += histogram_auto[i];
-          ++run;
-        }
-
-        max_intensity_ = (((double)i) + 0.5) * bin_size;
-      }
-      else //if (auto_mode_ == MANUAL)
-      {
-        if (max_intensity_ <= 0)
-        {
-          String s = max_intensity_;
-          throw Exception::InvalidValue(__FILE__,
-                                        __LINE__,
-                                        OPENMS_PRETTY_FUNCTION,
-                                        "auto_mode is on MANUAL! max_intensity is <=0. Needs to be positive! Use setMaxIntensity(<value>) or enable auto_mode!",
-                                        s);
-        }
-      }
+      computeMaxIntensity_(scan_first_, scan_last_);
 
       if (max_intensity_ < 0)
       {
@@ -276,9 +208,15 @@ protected:
         return;
       }
 
-      PeakIterator window_pos_center  = scan_first_;
-      PeakIterator window_pos_borderleft = scan_first_;
-      PeakIterator window_pos_borderright = scan_first_;
+      // the sliding window only needs m/z and intensity, which are scanned in contiguous arrays
+      const ColumnarSpectrum<typename PeakType::CoordinateType, typename PeakType::IntensityType> columns(scan_first_, scan_last_);
+      const auto& mz = columns.getMZArray();
+      const auto& intensity = columns.getIntensityArray();
+      const Size nr_peaks = columns.size();
+
+      PeakIterator window_pos_center = scan_first_;
+      Size window_pos_borderleft = 0;
+      Size window_pos_borderright = 0;
 
       double window_half_size = win_len_ / 2;
       double bin_size = std::max(1.0, max_intensity_ / bin_count_); // at least size of 1 for intensity bins
@@ -310,35 +248,26 @@ protected:
 
       double noise;    // noise value of a datapoint
 
-      // determine how many elements we need to estimate (for progress estimation)
-      int windows_overall = 0;
-      PeakIterator run = scan_first_;
-      while (run != scan_last_)
-      {
-        ++windows_overall;
-        ++run;
-      }
-      SignalToNoiseEstimator<Container>::startProgress(0, windows_overall, "noise estimation of data");
+      SignalToNoiseEstimator<Container>::startProgress(0, nr_peaks, "noise estimation of data");
 
       // MAIN LOOP
-      while (window_pos_center != scan_last_)
+      for (Size center = 0; center < nr_peaks; ++center, ++window_pos_center)
       {
 
         // erase all elements from histogram that will leave the window on the LEFT side
-        while ((*window_pos_borderleft).getMZ() <  (*window_pos_center).getMZ() - window_half_size)
+        while (mz[window_pos_borderleft] < mz[center] - window_half_size)
         {
-          to_bin = std::max(std::min<int>((int)((*window_pos_borderleft).getIntensity() / bin_size), bin_count_minus_1), 0);
+          to_bin = std::max(std::min<int>((int)(intensity[window_pos_borderleft] / bin_size), bin_count_minus_1), 0);
           --histogram[to_bin];
           --elements_in_window;
           ++window_pos_borderleft;
         }
 
         // add all elements to histogram that will enter the window on the RIGHT side
-        while ((window_pos_borderright != scan_last_)
-              && ((*window_pos_borderright).getMZ() <= (*window_pos_center).getMZ() + window_half_size))
+        while ((window_pos_borderright != nr_peaks)
+              && (mz[window_pos_borderright] <= mz[center] + window_half_size))
         {
-          //std::cerr << (*window_pos_borderright).getIntensity() << " " << bin_size << " " << bin_count_minus_1 << std::endl;
-          to_bin = std::max(std::min<int>((int)((*window_pos_borderright).getIntensity() / bin_size), bin_count_minus_1), 0);
+          to_bin = std::max(std::min<int>((int)(intensity[window_pos_borderright] / bin_size), bin_count_minus_1), 0);
           ++histogram[to_bin];
           ++elements_in_window;
           ++window_pos_borderright;
@@ -369,11 +298,8 @@ protected:
         }
 
         // store result
-        stn_estimates_[*window_pos_center] = (*window_pos_center).getIntensity() / noise;
-
+        stn_estimates_[*window_pos_center] = intensity[center] / noise;
 
-        // advance the window center by one datapoint
-        ++window_pos_center;
         ++window_count;
         // update progress
         SignalToNoiseEstimator<Container>::setProgress(window_count);
@@ -382,6 +308,92 @@ protected:
 
       SignalToNoiseEstimator<Container>::endProgress();
 
+      reportWindowStatistics_(window_count);
+
+    } // end of shiftWindow_
+
+    /**
+      @brief Computes (or checks) the maximal intensity used for the histogram, according to 'auto_mode'
+
+      @exception Throws Exception::InvalidValue
+    */
+    void computeMaxIntensity_(const PeakIterator & scan_first_, const PeakIterator & scan_last_)
+    {
+      if (auto_mode_ == AUTOMAXBYSTDEV)
+      {
+        // use MEAN+auto_max_intensity_*STDEV as threshold
+        GaussianEstimate gauss_global = SignalToNoiseEstimator<Container>::estimate_(scan_first_, scan_last_);
+        max_intensity_ = gauss_global.mean + std::sqrt(gauss_global.variance) * auto_max_stdev_Factor_;
+      }
+      else if (auto_mode_ == AUTOMAXBYPERCENT)
+      {
+        // get value at "auto_max_percentile_"th percentile
+        // we use a histogram approach here as well.
+        if ((auto_max_percentile_ < 0) || (auto_max_percentile_ > 100))
+        {
+          String s = auto_max_percentile_;
+          throw Exception::InvalidValue(__FILE__,
+                                        __LINE__,
+                                        OPENMS_PRETTY_FUNCTION,
+                                        "auto_mode is on AUTOMAXBYPERCENT! auto_max_percentile is not in [0,100]. Use setAutoMaxPercentile(<value>) to change it!",
+                                        s);
+        }
+
+        std::vector<int> histogram_auto(100, 0);
+
+        // find maximum of current scan
+        int size = 0;
+        typename PeakType::IntensityType maxInt = 0;
+        PeakIterator run = scan_first_;
+        while (run != scan_last_)
+        {
+          maxInt = std::max(maxInt, (*run).getIntensity());
+          ++size;
+          ++run;
+        }
+
+        double bin_size = maxInt / 100;
+
+        // fill histogram
+        run = scan_first_;
+        while (run != scan_last_)
+        {
+          ++histogram_auto[(int) (((*run).getIntensity() - 1) / bin_size)];
+          ++run;
+        }
+
+        // add up element counts in histogram until ?th percentile is reached
+        int elements_below_percentile = (int) (auto_max_percentile_ * size / 100);
+        int elements_seen = 0;
+        int i = -1;
+        run = scan_first_;
+
+        while (run != scan_last_ && elements_seen < elements_below_percentile)
+        {
+          ++i;
+          elements_seen += histogram_auto[i];
+          ++run;
+        }
+
+        max_intensity_ = (((double)i) + 0.5) * bin_size;
+      }
+      else //if (auto_mode_ == MANUAL)
+      {
+        if (max_intensity_ <= 0)
+        {
+          String s = max_intensity_;
+          throw Exception::InvalidValue(__FILE__,
+                                        __LINE__,
+                                        OPENMS_PRETTY_FUNCTION,
+                                        "auto_mode is on MANUAL! max_intensity is <=0. Needs to be positive! Use setMaxIntensity(<value>) or enable auto_mode!",
+                                        s);
+        }
+      }
+    }
+
+    /// Converts the sparse window and histogram overflow counters into percentages and writes warnings (if enabled)
+    void reportWindowStatistics_(int window_count)
+    {
       sparse_window_percent_ = sparse_window_percent_ * 100 / window_count;
       histogram_oob_percent_ = histogram_oob_percent_ * 100 / window_count;
 
@@ -403,8 +415,7 @@ protected:
                  << "You should consider increasing 'max_intensity' (and maybe 'bin_count' with it, to keep bin width reasonable)"
                  << std::endl;
       }
-
-    } // end of shiftWindow_
+    }
 
     /// overridden function from DefaultParamHandler to keep members up to date, when a parameter is changed
     void updateMembers_() override
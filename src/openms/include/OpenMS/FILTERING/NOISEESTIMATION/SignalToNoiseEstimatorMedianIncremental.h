@@ -0,0 +1,225 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+//
+
+#pragma once
+
+#include <OpenMS/FILTERING/NOISEESTIMATION/SignalToNoiseEstimatorMedian.h>
+
+namespace OpenMS
+{
+  /**
+    @brief Estimates the signal/noise (S/N) ratio of each data point in a scan
+    by using the median (histogram based), updating the median incrementally
+
+    Gives the same S/N values as SignalToNoiseEstimatorMedian (and uses the
+    same parameters), but avoids searching the whole histogram for the median
+    of every window: since consecutive windows differ only by the few data
+    points entering and leaving the window, the median bin is tracked together
+    with the number of elements up to (and including) it and only moved by
+    the required number of bins. The estimates are stored in m/z order, so
+    each is inserted in constant time.
+
+    This makes the computation essentially linear in the number of data points
+    (instead of scaling with data points times 'bin_count'), which matters for
+    long profile spectra and for callers which use many bins.
+
+    @note The data points must be sorted by position (as for SignalToNoiseEstimatorMedian).
+
+    @htmlinclude OpenMS_SignalToNoiseEstimatorMedian.parameters
+
+    @ingroup SignalProcessing
+  */
+  template <typename Container = MSSpectrum>
+  class SignalToNoiseEstimatorMedianIncremental :
+    public SignalToNoiseEstimatorMedian<Container>
+  {
+
+public:
+
+    typedef SignalToNoiseEstimatorMedian<Container> BaseType;
+    typedef typename BaseType::PeakIterator PeakIterator;
+    typedef typename BaseType::PeakType PeakType;
+
+    using BaseType::stn_estimates_;
+    using BaseType::max_intensity_;
+    using BaseType::win_len_;
+    using BaseType::bin_count_;
+    using BaseType::min_required_elements_;
+    using BaseType::noise_for_empty_window_;
+    using BaseType::sparse_window_percent_;
+    using BaseType::histogram_oob_percent_;
+
+    /// default constructor
+    inline SignalToNoiseEstimatorMedianIncremental() :
+      BaseType()
+    {
+      //set the name for DefaultParamHandler error messages
+      this->setName("SignalToNoiseEstimatorMedianIncremental");
+    }
+
+    /// Copy Constructor
+    inline SignalToNoiseEstimatorMedianIncremental(const SignalToNoiseEstimatorMedianIncremental & source) :
+      BaseType(source)
+    {}
+
+    /// Assignment operator
+    inline SignalToNoiseEstimatorMedianIncremental & operator=(const SignalToNoiseEstimatorMedianIncremental & source)
+    {
+      if (&source == this) return *this;
+
+      BaseType::operator=(source);
+      return *this;
+    }
+
+    /// Destructor
+    ~SignalToNoiseEstimatorMedianIncremental() override
+    {}
+
+protected:
+
+    /** Calculate signal-to-noise values for all data points given, by using a sliding window approach
+
+        @param scan_first_ first element in the scan
+        @param scan_last_ last element in the scan (disregarded)
+        @exception Throws Exception::InvalidValue
+    */
+    void computeSTN_(const PeakIterator & scan_first_, const PeakIterator & scan_last_) override
+    {
+      // reset counter for sparse windows
+      sparse_window_percent_ = 0;
+      // reset counter for histogram overflow
+      histogram_oob_percent_ = 0;
+
+      // reset the results
+      stn_estimates_.clear();
+
+      // maximal range of histogram needs to be calculated first
+      BaseType::computeMaxIntensity_(scan_first_, scan_last_);
+
+      if (max_intensity_ < 0)
+      {
+        OPENMS_LOG_WARN << "WARNING in SignalToNoiseEstimatorMedianIncremental: the max_intensity_ value should be positive! " << max_intensity_ << std::endl;
+        return;
+      }
+
+      double window_half_size = win_len_ / 2;
+      double bin_size = std::max(1.0, max_intensity_ / bin_count_); // at least size of 1 for intensity bins
+      int bin_count_minus_1 = bin_count_ - 1;
+
+      std::vector<int> histogram(bin_count_, 0);
+
+      // index of bin where the median is located (always kept valid, also for sparse windows)
+      int median_bin = 0;
+      // number of elements in histogram[0..median_bin]
+      int elements_up_to_median = 0;
+      // tracks elements in current window, which may vary because of unevenly spaced data
+      int elements_in_window = 0;
+      // number of windows
+      int window_count = 0;
+
+      SignalToNoiseEstimator<Container>::startProgress(0, std::distance(scan_first_, scan_last_), "noise estimation of data");
+
+      PeakIterator window_pos_borderleft = scan_first_;
+      PeakIterator window_pos_borderright = scan_first_;
+      for (PeakIterator window_pos_center = scan_first_; window_pos_center != scan_last_; ++window_pos_center)
+      {
+        // erase all elements from histogram that will leave the window on the LEFT side
+        while ((*window_pos_borderleft).getMZ() < (*window_pos_center).getMZ() - window_half_size)
+        {
+          int to_bin = std::max(std::min<int>((int)((*window_pos_borderleft).getIntensity() / bin_size), bin_count_minus_1), 0);
+          --histogram[to_bin];
+          if (to_bin <= median_bin) --elements_up_to_median;
+          --elements_in_window;
+          ++window_pos_borderleft;
+        }
+
+        // add all elements to histogram that will enter the window on the RIGHT side
+        while ((window_pos_borderright != scan_last_)
+              && ((*window_pos_borderright).getMZ() <= (*window_pos_center).getMZ() + window_half_size))
+        {
+          int to_bin = std::max(std::min<int>((int)((*window_pos_borderright).getIntensity() / bin_size), bin_count_minus_1), 0);
+          ++histogram[to_bin];
+          if (to_bin <= median_bin) ++elements_up_to_median;
+          ++elements_in_window;
+          ++window_pos_borderright;
+        }
+
+        double noise; // noise value of a datapoint
+        if (elements_in_window < min_required_elements_)
+        {
+          noise = noise_for_empty_window_;
+          ++sparse_window_percent_;
+        }
+        else
+        {
+          // move to the first bin i where ceil[elements_in_window/2] <= sum_c(0..i){ histogram[c] }
+          int element_in_window_half = (elements_in_window + 1) / 2;
+          while (median_bin < bin_count_minus_1 && elements_up_to_median < element_in_window_half)
+          {
+            ++median_bin;
+            elements_up_to_median += histogram[median_bin];
+          }
+          while (median_bin > 0 && elements_up_to_median - histogram[median_bin] >= element_in_window_half)
+          {
+            elements_up_to_median -= histogram[median_bin];
+            --median_bin;
+          }
+
+          // increase the error count
+          if (median_bin == bin_count_minus_1) {++histogram_oob_percent_; }
+
+          // just avoid division by 0
+          noise = std::max(1.0, (median_bin + 0.5) * bin_size);
+        }
+
+        // store result (data points arrive in sorted order, so insert at the end)
+        typename std::map<PeakType, double, typename PeakType::PositionLess>::iterator it =
+          stn_estimates_.emplace_hint(stn_estimates_.end(), *window_pos_center, 0.0);
+        it->second = (*window_pos_center).getIntensity() / noise;
+
+        // update progress
+        ++window_count;
+        SignalToNoiseEstimator<Container>::setProgress(window_count);
+      }
+
+      SignalToNoiseEstimator<Container>::endProgress();
+
+      BaseType::reportWindowStatistics_(window_count);
+    }
+
+  };
+
+} // namespace OpenMS
+
@@ -6,6 +6,7 @@ set(sources_list_h
 SignalToNoiseEstimator.h
 SignalToNoiseEstimatorMeanIterative.h
 SignalToNoiseEstimatorMedian.h
+SignalToNoiseEstimatorMedianIncremental.h
 SignalToNoiseEstimatorMedianRapid.h
 )
 
@@ -48,6 +48,8 @@
 #include <algorithm>
 #include <iterator>
 #include <cmath>
+#include <cstring>
+#include <type_traits>
 #include <vector>
 
 #include <QByteArray>
@@ -97,6 +99,28 @@ public:
     template <typename ToType>
     static void decode(const String & in, ByteOrder from_byte_order, std::vector<ToType> & out, bool zlib_compression = false);
 
+    /**
+        @brief Decodes a Base64 string of @p FromType values to a vector of @p ToType values
+
+        The input is interpreted as an array of @p FromType (float or double)
+        values which are converted to @p ToType in the same pass as the byte
+        order conversion, e.g. to decode 32 bit data directly into a vector of
+        doubles without an intermediate vector of floats.
+
+        You have to specify the byte order of the input and if it is zlib-compressed.
+    */
+    template <typename FromType, typename ToType>
+    static void decodeAndConvert(const String & in, ByteOrder from_byte_order, std::vector<ToType> & out, bool zlib_compression = false);
+
+    /**
+        @brief Enables or disables the vectorized Base64 decoder
+
+        The vectorized decoder is used by default if the CPU supports it.
+        Disabling it forces the scalar implementation, e.g. to test it on
+        machines with SIMD support.
+    */
+    static void setVectorizedDecoding(bool enabled);
+
     /**
         @brief Encodes a vector of integer point numbers to a Base64 string
 
@@ -167,12 +191,39 @@ private:
 
     static const char encoder_[];
     static const char decoder_[];
+
+    /**
+        @brief Decodes the Base64 characters in @p in to raw bytes
+
+        Uses a vectorized implementation (SSSE3 or AVX2, selected at runtime)
+        if supported by the CPU and a table-driven scalar implementation
+        otherwise. Input containing characters outside of the Base64 alphabet
+        (e.g. whitespace) is decoded by skipping these characters.
+
+        @param in The Base64 characters
+        @param in_size The number of characters
+        @param out Output buffer, needs to have room for at least (in_size + 3) / 4 * 3 bytes
+
+        @return The number of bytes written to @p out
+    */
+    static Size decodeBytes_(const char * in, Size in_size, unsigned char * out);
+
+    /// Reads a float from (possibly unaligned) memory, optionally swapping the byte order
+    static inline void readValue_(const unsigned char * in, bool swap_bytes, float & value);
+
+    /// Reads a double from (possibly unaligned) memory, optionally swapping the byte order
+    static inline void readValue_(const unsigned char * in, bool swap_bytes, double & value);
+
+    /// Converts @p count values of type @p FromType stored in @p in to @p ToType (byte order swap and conversion in one pass)
+    template <typename FromType, typename ToType>
+    static void convertBytes_(const unsigned char * in, Size count, bool swap_bytes, ToType * out);
+
     /// Decodes a Base64 string to a vector of floating point numbers
-    template <typename ToType>
+    template <typename FromType, typename ToType>
     static void decodeUncompressed_(const String & in, ByteOrder from_byte_order, std::vector<ToType> & out);
 
     ///Decodes a compressed Base64 string to a vector of floating point numbers
-    template <typename ToType>
+    template <typename FromType, typename ToType>
     static void decodeCompressed_(const String & in, ByteOrder from_byte_order, std::vector<ToType> & out);
 
     /// Decodes a Base64 string to a vector of integer numbers
@@ -333,52 +384,77 @@ private:
     out.resize(written);         //no more space is needed
   }
 
+  inline void Base64::readValue_(const unsigned char * in, bool swap_bytes, float & value)
+  {
+    Reinterpreter32_ tmp;
+    std::memcpy(&tmp.i, in, sizeof(tmp.i));
+    if (swap_bytes) tmp.i = endianize32(tmp.i);
+    value = tmp.f;
+  }
+
+  inline void Base64::readValue_(const unsigned char * in, bool swap_bytes, double & value)
+  {
+    Reinterpreter64_ tmp;
+    std::memcpy(&tmp.i, in, sizeof(tmp.i));
+    if (swap_bytes) tmp.i = endianize64(tmp.i);
+    value = tmp.f;
+  }
+
+  template <typename FromType, typename ToType>
+  void Base64::convertBytes_(const unsigned char * in, Size count, bool swap_bytes, ToType * out)
+  {
+    FromType value;
+    for (Size i = 0; i < count; ++i)
+    {
+      readValue_(in + i * sizeof(FromType), swap_bytes, value);
+      out[i] = static_cast<ToType>(value);
+    }
+  }
+
   template <typename ToType>
   void Base64::decode(const String & in, ByteOrder from_byte_order, std::vector<ToType> & out, bool zlib_compression)
+  {
+    decodeAndConvert<ToType, ToType>(in, from_byte_order, out, zlib_compression);
+  }
+
+  template <typename FromType, typename ToType>
+  void Base64::decodeAndConvert(const String & in, ByteOrder from_byte_order, std::vector<ToType> & out, bool zlib_compression)
   {
     if (zlib_compression)
     {
-      decodeCompressed_(in, from_byte_order, out);
+      decodeCompressed_<FromType>(in, from_byte_order, out);
     }
     else
     {
-      decodeUncompressed_(in, from_byte_order, out);
+      decodeUncompressed_<FromType>(in, from_byte_order, out);
     }
   }
 
-  template <typename ToType>
+  template <typename FromType, typename ToType>
   void Base64::decodeCompressed_(const String & in, ByteOrder from_byte_order, std::vector<ToType> & out)
   {
     out.clear();
     if (in == "") return;
 
-    const Size element_size = sizeof(ToType);
-
-    String decompressed;
+    const Size element_size = sizeof(FromType);
 
-    QByteArray qt_byte_array = QByteArray::fromRawData(in.c_str(), (int) in.size());
-    QByteArray bazip = QByteArray::fromBase64(qt_byte_array);
+    // decode Base64 directly behind the 4 byte length header expected by qUncompress
     QByteArray czip;
-    czip.resize(4);
-    czip[0] = (bazip.size() & 0xff000000) >> 24;
-    czip[1] = (bazip.size() & 0x00ff0000) >> 16;
-    czip[2] = (bazip.size() & 0x0000ff00) >> 8;
-    czip[3] = (bazip.size() & 0x000000ff);
-    czip += bazip;
+    czip.resize(4 + (int) ((in.size() + 3) / 4 * 3));
+    Size bazip_size = decodeBytes_(in.c_str(), in.size(), reinterpret_cast<unsigned char *>(czip.data() + 4));
+    czip.resize(4 + (int) bazip_size);
+    czip[0] = (bazip_size & 0xff000000) >> 24;
+    czip[1] = (bazip_size & 0x00ff0000) >> 16;
+    czip[2] = (bazip_size & 0x0000ff00) >> 8;
+    czip[3] = (bazip_size & 0x000000ff);
     QByteArray base64_uncompressed = qUncompress(czip);
 
     if (base64_uncompressed.isEmpty())
     {
       throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Decompression error?");
     }
-    decompressed.resize(base64_uncompressed.size());
-
-    std::copy(base64_uncompressed.begin(), base64_uncompressed.end(), decompressed.begin());
-
-    void* byte_buffer = reinterpret_cast<void *>(&decompressed[0]);
-    Size buffer_size = decompressed.size();
 
-    const ToType * float_buffer = reinterpret_cast<const ToType *>(byte_buffer);
+    Size buffer_size = base64_uncompressed.size();
     if (buffer_size % element_size != 0)
     {
       throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Bad BufferCount?");
@@ -386,26 +462,14 @@ private:
     
     Size float_count = buffer_size / element_size;
     
-    // change endianness if necessary
-    if ((OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_LITTLEENDIAN) || (!OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_BIGENDIAN))
-    {
-      if (element_size == 4) // 32 bit
-      {
-        UInt32 * p = reinterpret_cast<UInt32 *>(byte_buffer);
-        std::transform(p, p + float_count, p, endianize32);
-      }
-      else // 64 bit
-      {
-        UInt64 * p = reinterpret_cast<UInt64 *>(byte_buffer);
-        std::transform(p, p + float_count, p, endianize64);
-      }
-    }
-
-    // copy values
-    out.assign(float_buffer, float_buffer + float_count);
+    // change endianness if necessary and copy values
+    const bool swap_bytes = (OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_LITTLEENDIAN) || 
+                            (!OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_BIGENDIAN);
+    out.resize(float_count);
+    convertBytes_<FromType>(reinterpret_cast<const unsigned char *>(base64_uncompressed.constData()), float_count, swap_bytes, out.data());
   }
 
-  template <typename ToType>
+  template <typename FromType, typename ToType>
   void Base64::decodeUncompressed_(const String & in, ByteOrder from_byte_order, std::vector<ToType> & out)
   {
     out.clear();
@@ -421,103 +485,26 @@ private:
       throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Malformed base64 input, length is not a multiple of 4.");
     }
 
-    Size src_size = in.size();
-    // last one or two '=' are skipped if contained
-    int padding = 0;
-    if (in[src_size - 1] == '=') padding++;
-    if (in[src_size - 2] == '=') padding++;
-
-    src_size -= padding;
-
-    UInt a;
-    UInt b;
-
-    UInt offset = 0;
-    int inc = 1;
-    UInt written = 0;
-
-    const Size element_size = sizeof(ToType);
-
-    // enough for either float or double
-    char element[8] = "\x00\x00\x00\x00\x00\x00\x00";
+    const Size element_size = sizeof(FromType);
+    const Size max_bytes = (in.size() + 3) / 4 * 3;
 
     // Parse little endian data in big endian OpenMS (or other way round)
-    if ((OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_LITTLEENDIAN) || 
-       (!OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_BIGENDIAN))
+    const bool swap_bytes = (OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_LITTLEENDIAN) || 
+                            (!OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_BIGENDIAN);
+
+    if (std::is_same<FromType, ToType>::value && !swap_bytes)
     {
-      offset = (element_size - 1);              // other endian
-      inc = -1;
+      // no conversion needed: decode directly into the output vector
+      out.resize((max_bytes + element_size - 1) / element_size);
+      Size written = decodeBytes_(in.c_str(), in.size(), reinterpret_cast<unsigned char *>(out.data()));
+      out.resize(written / element_size);
     }
     else
     {
-      offset = 0;
-      inc = 1;
-    }
-
-    //reserve enough space in the output vector
-    out.reserve((UInt)(std::ceil((4.0 * src_size) / 3.0) + 6.0));
-
-    // sort all read bytes correctly into a char[4] (double) or
-    // char[8] (float) and push_back when necessary.
-    for (Size i = 0; i < src_size; i += 4)
-    {
-      // decode 4 Base64-Chars to 3 Byte
-      // -------------------------------
-
-      // decode the first two chars
-      a = decoder_[(int)in[i] - 43] - 62;
-      b = decoder_[(int)in[i + 1] - 43] - 62;
-      if (i + 1 >= src_size)
-      {
-        b = 0;
-      }
-      // write first byte (6 bits from a and 2 highest bits from b)
-      element[offset] = (unsigned char) ((a << 2) | (b >> 4));
-      written++;
-      offset = (offset + inc) % element_size;
-
-      if (written % element_size == 0)
-      {
-        ToType * to_type = reinterpret_cast<ToType *>(&element[0]);
-        out.push_back((*to_type));
-        strcpy(element, "");
-      }
-
-      // decode the third char
-      a = decoder_[(int)in[i + 2] - 43] - 62;
-      if (i + 2 >= src_size)
-      {
-        a = 0;
-      }
-      // write second byte (4 lowest bits from b and 4 highest bits from a)
-      element[offset] = (unsigned char) (((b & 15) << 4) | (a >> 2));
-      written++;
-      offset = (offset + inc) % element_size;
-
-      if (written % element_size == 0)
-      {
-        ToType * to_type = reinterpret_cast<ToType *>(&element[0]);
-        out.push_back((*to_type));
-        strcpy(element, "");
-      }
-
-      // decode the fourth char
-      b = decoder_[(int)in[i + 3] - 43] - 62;
-      if (i + 3 >= src_size)
-      {
-        b = 0;
-      }
-      // write third byte (2 lowest bits from a and 6 bits from b)
-      element[offset] = (unsigned char) (((a & 3) << 6) | b);
-      written++;
-      offset = (offset + inc) % element_size;
-
-      if (written % element_size == 0)
-      {
-        ToType * to_type = reinterpret_cast<ToType *>(&element[0]);
-        out.push_back((*to_type));
-        strcpy(element, "");
-      }
+      std::vector<unsigned char> buffer(max_bytes);
+      Size written = decodeBytes_(in.c_str(), in.size(), buffer.data());
+      out.resize(written / element_size);
+      convertBytes_<FromType>(buffer.data(), out.size(), swap_bytes, out.data());
     }
   }
 
@@ -35,9 +35,20 @@
 #pragma once
 
 #include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/FORMAT/HANDLERS/CachedMzMLHandler.h>
+
+#include <boost/shared_ptr.hpp>
 
 #include <fstream>
 
+namespace boost
+{
+  namespace iostreams
+  {
+    class mapped_file_source;
+  }
+}
+
 namespace OpenMS
 {
 
@@ -49,6 +60,14 @@ namespace OpenMS
     be very fast and done in random order (once the in-memory index is built
     for the file).
 
+    Optionally, the cached data file can be memory-mapped (see
+    CachedmzML(const String&, bool)). In this mode, spectra and chromatograms
+    are read directly from the mapped memory without any seek or read calls
+    on a file stream, so that multiple threads can access the same object
+    (or its copies, which share the mapping) concurrently. In addition,
+    getSpectrumView() and getChromatogramView() provide zero-copy access to
+    the stored data arrays.
+
   */
   class OPENMS_DLLAPI CachedmzML
   {
@@ -63,6 +82,14 @@ public:
 
     CachedmzML(const String& filename);
 
+    /**
+      @brief Constructor, optionally memory-mapping the cached data
+
+      @param filename The data location (ends in .mzML, expects an adjacent .mzML.cached file)
+      @param memory_map Whether to memory-map the cached data file instead of reading it through a file stream
+    */
+    CachedmzML(const String& filename, bool memory_map);
+
     /// Copy constructor
     CachedmzML(const CachedmzML & rhs);
 
@@ -74,6 +101,31 @@ public:
 
     MSChromatogram getChromatogram(Size id);
 
+    /**
+      @brief Zero-copy access to the m/z and intensity data of a spectrum
+
+      The returned view points into the memory-mapped file and stays valid
+      as long as this object (or a copy of it) exists. This function is
+      thread-safe.
+
+      @throws Exception::IllegalArgument is thrown if the data is not memory-mapped
+    */
+    Internal::CachedMzMLHandler::SpectrumView getSpectrumView(Size id) const;
+
+    /**
+      @brief Zero-copy access to the RT and intensity data of a chromatogram
+
+      The returned view points into the memory-mapped file and stays valid
+      as long as this object (or a copy of it) exists. This function is
+      thread-safe.
+
+      @throws Exception::IllegalArgument is thrown if the data is not memory-mapped
+    */
+    Internal::CachedMzMLHandler::ChromatogramView getChromatogramView(Size id) const;
+
+    /// Whether the cached data is memory-mapped
+    bool isMemoryMapped() const;
+
     size_t getNrSpectra() const;
 
     size_t getNrChromatograms() const;
@@ -98,15 +150,22 @@ public:
 
       @p filename The data location (ends in .mzML, expects an adjacent .mzML.cached file)
       @p map A CachedmzML result object
+      @p memory_map Whether to memory-map the cached data file
 
       @exception Exception::FileNotFound is thrown if the file could not be opened
       @exception Exception::ParseError is thrown if an error occurs during parsing
     */
-    static void load(const String& filename, CachedmzML& map);
+    static void load(const String& filename, CachedmzML& map, bool memory_map = false);
 
 protected:
 
-    void load_(const String& filename);
+    void load_(const String& filename, bool memory_map = false);
+
+    /// Start of the memory-mapped cached data (nullptr if not memory-mapped)
+    const char* mappedData_() const;
+
+    /// Size of the memory-mapped cached data in bytes
+    Size mappedSize_() const;
 
     /// Meta data
     MSExperiment meta_ms_experiment_;
@@ -114,6 +173,9 @@ protected:
     /// Internal filestream 
     std::ifstream ifs_;
 
+    /// Read-only memory mapping of the cached data (shared between copies)
+    boost::shared_ptr<boost::iostreams::mapped_file_source> mapped_file_;
+
     /// Name of the mzML file
     String filename_;
 
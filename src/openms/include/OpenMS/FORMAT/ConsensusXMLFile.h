@@ -38,6 +38,7 @@
 #include <OpenMS/FORMAT/HANDLERS/XMLHandler.h>
 #include <OpenMS/FORMAT/OPTIONS/PeakFileOptions.h>
 #include <OpenMS/FORMAT/XMLFile.h>
+#include <OpenMS/INTERFACES/IFeatureDataConsumer.h>
 #include <OpenMS/KERNEL/ConsensusMap.h>
 #include <OpenMS/METADATA/PeptideEvidence.h>
 #include <OpenMS/METADATA/ProteinIdentification.h>
@@ -88,6 +89,24 @@ public:
     */
     void store(const String& filename, const ConsensusMap& consensus_map);
 
+    /**
+    @brief Reads the file with name @p filename and passes its content to @p consumer, one consensus feature at a time
+
+    In contrast to load(), the consensus features are never collected in a
+    map, so arbitrarily large files can be processed with constant memory.
+    The meta data of the map (everything but the consensus features,
+    including the column headers) is passed to the consumer before the first
+    consensus feature. The number of consensus features is not stored in the
+    file, so setExpectedSize() of the consumer is not called. Options (e.g.
+    RT/m/z/intensity ranges) are applied as for load().
+
+    Use ConsensusXMLWritingConsumer to write consensus features one at a time.
+
+    @exception Exception::FileNotFound is thrown if the file could not be opened
+    @exception Exception::ParseError is thrown if an error occurs during parsing
+    */
+    void transform(const String& filename, Interfaces::IConsensusDataConsumer* consumer);
+
     /// Mutable access to the options for loading/storing
     PeakFileOptions& getOptions();
 
@@ -106,6 +125,18 @@ protected:
     void characters(const XMLCh* const chars, const XMLSize_t length) override;
 
 
+    /// Writes everything up to the first consensus feature to a stream
+    void writeHeader_(const String& filename, std::ostream& os, const ConsensusMap& consensus_map);
+
+    /// Writes a consensus feature to a stream
+    void writeConsensusElement_(const String& filename, std::ostream& os, const ConsensusFeature& elem);
+
+    /// Writes the end of the file to a stream
+    void writeFooter_(std::ostream& os);
+
+    /// Resets the temporary variables after parsing
+    void resetMembers_();
+
     /// Writes a peptide identification to a stream (for assigned/unassigned peptide identifications)
     void writePeptideIdentification_(const String& filename, std::ostream& os, const PeptideIdentification& id, const String& tag_name, UInt indentation_level);
 
@@ -116,6 +147,8 @@ protected:
     ///@name Temporary variables for parsing
     //@{
     ConsensusMap* consensus_map_;
+    /// Consumer of consensus features for transform() (or null)
+    Interfaces::IConsensusDataConsumer* consumer_;
     ConsensusFeature act_cons_element_;
     DPosition<2> pos_;
     double it_;
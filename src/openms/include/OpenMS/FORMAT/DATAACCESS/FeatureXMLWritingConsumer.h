@@ -0,0 +1,117 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/INTERFACES/IFeatureDataConsumer.h>
+
+#include <OpenMS/FORMAT/FeatureXMLFile.h>
+#include <OpenMS/KERNEL/FeatureMap.h>
+
+#include <fstream>
+
+namespace OpenMS
+{
+    /**
+      @brief Consumer class that writes features to disk using the featureXML format
+
+      Counterpart of FeatureXMLFile::transform(): features are written as soon as they
+      are consumed, so a featureXML file can be filtered or transformed in a single
+      pass without holding the complete map in memory.
+
+      Example usage:
+
+      @code
+      FeatureXMLWritingConsumer consumer(out_file);
+      FeatureXMLFile().transform(in_file, &consumer); // calls setMapMetaData() and consumeFeature()
+      consumer.close(); // optional, also done by the destructor
+      @endcode
+
+      @note The first call of consumeFeature() (or close()) starts writing the
+      header, so the meta data has to be set before.
+
+      @note The count attribute of the featureList is written as a fixed-width
+      placeholder and set to the number of features actually written by close().
+    */
+    class OPENMS_DLLAPI FeatureXMLWritingConsumer :
+      public Interfaces::IFeatureDataConsumer,
+      protected FeatureXMLFile
+    {
+    public:
+      /**
+        @brief Constructor
+
+        @exception Exception::UnableToCreateFile is thrown if the file could not be created
+      */
+      explicit FeatureXMLWritingConsumer(const String& filename);
+
+      /// Destructor, calls close()
+      ~FeatureXMLWritingConsumer() override;
+
+      /// @name IFeatureDataConsumer interface
+      //@{
+      /// Writes a feature (its unique id must be valid and unique)
+      void consumeFeature(Feature& feature) override;
+
+      /// Ignored, the count attribute of the featureList is set by close()
+      void setExpectedSize(Size expected_features) override;
+
+      /// Sets the meta data (data processing, identifications, ...) written to the header of the file
+      void setMapMetaData(const FeatureMap& map) override;
+      //@}
+
+      /// Returns the number of features written
+      Size getNrFeaturesWritten() const;
+
+      /// Writes the remaining tags and closes the file (no effect if already closed)
+      void close();
+
+    protected:
+      /// Writes the header if that did not happen yet
+      void startWriting_();
+
+      /// Returns the count attribute of the featureList for @p count features, padded with leading whitespace to a fixed width
+      static String countAttribute_(Size count);
+
+      String filename_;
+      std::ofstream ofs_;
+      /// meta data of the map (without features)
+      FeatureMap meta_data_;
+      /// stream position of the (padded) count attribute of the featureList
+      std::streampos count_pos_;
+      Size features_written_;
+      bool started_writing_;
+    };
+
+} //end namespace OpenMS
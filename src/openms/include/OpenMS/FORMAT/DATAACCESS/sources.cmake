@@ -3,7 +3,9 @@ set(directory include/OpenMS/FORMAT/DATAACCESS)
 
 ### list all header files of the directory here
 set(sources_list_h
+  ConsensusXMLWritingConsumer.h
   CsiFingerIdMzTabWriter.h
+  FeatureXMLWritingConsumer.h
   MSDataAggregatingConsumer.h
   MSDataCachedConsumer.h
   MSDataChainingConsumer.h
@@ -43,6 +43,7 @@
 #include <OpenMS/DATASTRUCTURES/ConvexHull2D.h>
 #include <OpenMS/DATASTRUCTURES/Param.h>
 #include <OpenMS/DATASTRUCTURES/Map.h>
+#include <OpenMS/INTERFACES/IFeatureDataConsumer.h>
 
 #include <iosfwd>
 
@@ -98,6 +99,22 @@ public:
     */
     void store(const String& filename, const FeatureMap& feature_map);
 
+    /**
+        @brief Reads the file with name @p filename and passes its content to @p consumer, one feature at a time
+
+        In contrast to load(), the features are never collected in a map, so
+        arbitrarily large files can be processed with constant memory. The
+        meta data of the map (everything but the features) is passed to the
+        consumer before the first feature. Options (e.g. RT/m/z/intensity
+        ranges) are applied as for load().
+
+        Use FeatureXMLWritingConsumer to write features one at a time.
+
+        @exception Exception::FileNotFound is thrown if the file could not be opened
+        @exception Exception::ParseError is thrown if an error occurs during parsing
+    */
+    void transform(const String& filename, Interfaces::IFeatureDataConsumer* consumer);
+
     /// Mutable access to the options for loading/storing
     FeatureFileOptions& getOptions();
 
@@ -121,6 +138,12 @@ protected:
     // Docu in base class
     void characters(const XMLCh* const chars, const XMLSize_t length) override;
 
+    /// Writes everything up to the featureList tag (which has to be written by the caller) to a stream
+    void writeHeader_(const String& filename, std::ostream& os, const FeatureMap& feature_map);
+
+    /// Writes the end of the file to a stream
+    void writeFooter_(std::ostream& os);
+
     /// Writes a feature to a stream
     void writeFeature_(const String& filename, std::ostream& os, const Feature& feat, const String& identifier_prefix, UInt64 identifier, UInt indentation_level);
 
@@ -144,6 +167,8 @@ protected:
     Feature* current_feature_;
     /// Feature map pointer for reading
     FeatureMap* map_;
+    /// Consumer of features for transform() (or null)
+    Interfaces::IFeatureDataConsumer* consumer_;
     /// Options that can be set
     FeatureFileOptions options_;
     /// only parse until "count" tag is reached (used in loadSize())
@@ -44,6 +44,7 @@
 #include <OpenMS/KERNEL/StandardTypes.h>
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 
+#include <cstring>
 #include <fstream>
 
 #define CACHED_MZML_FILE_IDENTIFIER 8094
@@ -80,6 +81,66 @@ public:
 
     typedef std::vector<DatumSingleton> Datavector;
 
+    /**
+      @brief Read-only view of a data array inside a memory-mapped cached file
+
+      The view does not own any data, it merely points into the mapped
+      memory and stays valid as long as the mapping is alive. Since the
+      cached format does not guarantee alignment of the stored doubles,
+      elements are accessed through operator[] which performs an
+      alignment-safe load.
+    */
+    struct DataArrayView
+    {
+      DataArrayView() :
+        data(nullptr),
+        size(0)
+      {
+      }
+
+      /// Number of elements in the array
+      Size getSize() const
+      {
+        return size;
+      }
+
+      /// Access to element @p i (no bounds checking)
+      DatumSingleton operator[](Size i) const
+      {
+        DatumSingleton value;
+        std::memcpy(&value, data + i * sizeof(DatumSingleton), sizeof(DatumSingleton));
+        return value;
+      }
+
+      /// Start of the raw array in the mapped memory (not necessarily aligned)
+      const char* data;
+
+      /// Number of elements in the array
+      Size size;
+    };
+
+    /// Read-only view of the m/z and intensity arrays of a cached spectrum
+    struct SpectrumView
+    {
+      SpectrumView() :
+        ms_level(-1),
+        rt(-1.0)
+      {
+      }
+
+      DataArrayView mz;
+      DataArrayView intensity;
+      int ms_level;
+      double rt;
+    };
+
+    /// Read-only view of the RT and intensity arrays of a cached chromatogram
+    struct ChromatogramView
+    {
+      DataArrayView rt;
+      DataArrayView intensity;
+    };
+
     /** @name Constructors and Destructor
     */
     //@{
@@ -185,6 +246,78 @@ public:
     static std::vector<OpenSwath::BinaryDataArrayPtr> readChromatogramFast(std::ifstream& ifs);
     //@}
 
+    /** @name Direct access to a single Spectrum or Chromatogram in memory
+
+      These functions operate on a memory buffer holding the complete cached
+      file (e.g. a read-only memory mapping) instead of a file stream. They
+      do not modify any shared state, so that multiple threads can read from
+      the same buffer concurrently without any locking.
+
+      The @p offset of a spectrum or chromatogram is the position recorded in
+      the index (see getSpectraIndex() and getChromatogramIndex()).
+    */
+    //@{
+
+    /**
+      @brief Fast access to a spectrum stored in memory
+
+      @param buffer Start of the memory holding the cached file
+      @param buffer_size Size of the memory holding the cached file (in bytes)
+      @param offset Position of the spectrum in the buffer
+      @param ms_level Output parameter to store the MS level of the spectrum (1, 2, 3 ...)
+      @param rt Output parameter to store the retention time of the spectrum
+
+      @throws Exception::ParseError is thrown if the spectrum cannot be read
+    */
+    static std::vector<OpenSwath::BinaryDataArrayPtr> readSpectrumFast(const char* buffer, Size buffer_size, Size offset,
+                                                                       int& ms_level, double& rt);
+
+    /**
+      @brief Fast access to a chromatogram stored in memory
+
+      @param buffer Start of the memory holding the cached file
+      @param buffer_size Size of the memory holding the cached file (in bytes)
+      @param offset Position of the chromatogram in the buffer
+
+      @throws Exception::ParseError is thrown if the chromatogram cannot be read
+    */
+    static std::vector<OpenSwath::BinaryDataArrayPtr> readChromatogramFast(const char* buffer, Size buffer_size, Size offset);
+
+    /**
+      @brief Zero-copy access to the m/z and intensity arrays of a spectrum stored in memory
+
+      No data is copied, the returned view points directly into @p buffer.
+      Additional data arrays are not part of the view.
+
+      @throws Exception::ParseError is thrown if the spectrum cannot be read
+    */
+    static SpectrumView readSpectrumView(const char* buffer, Size buffer_size, Size offset);
+
+    /**
+      @brief Zero-copy access to the RT and intensity arrays of a chromatogram stored in memory
+
+      No data is copied, the returned view points directly into @p buffer.
+      Additional data arrays are not part of the view.
+
+      @throws Exception::ParseError is thrown if the chromatogram cannot be read
+    */
+    static ChromatogramView readChromatogramView(const char* buffer, Size buffer_size, Size offset);
+
+    /**
+      @brief Read a single spectrum stored in memory directly into an OpenMS MSSpectrum
+
+      @throws Exception::ParseError is thrown if the spectrum cannot be read
+    */
+    static void readSpectrum(SpectrumType& spectrum, const char* buffer, Size buffer_size, Size offset);
+
+    /**
+      @brief Read a single chromatogram stored in memory directly into an OpenMS MSChromatogram
+
+      @throws Exception::ParseError is thrown if the chromatogram cannot be read
+    */
+    static void readChromatogram(ChromatogramType& chromatogram, const char* buffer, Size buffer_size, Size offset);
+    //@}
+
     /**
       @brief Read a single spectrum directly into an OpenMS MSSpectrum (assuming file is already at the correct position)
 
@@ -217,6 +350,12 @@ protected:
     static inline void readDataFast_(std::ifstream& ifs, std::vector<OpenSwath::BinaryDataArrayPtr>& data, const Size& data_size, 
       const Size& nr_float_arrays);
 
+    /// helper method to fill a spectrum from data arrays (m/z, intensity and additional float arrays)
+    static void fillSpectrum_(SpectrumType& spectrum, const std::vector<OpenSwath::BinaryDataArrayPtr>& data);
+
+    /// helper method to fill a chromatogram from data arrays (RT, intensity and additional float arrays)
+    static void fillChromatogram_(ChromatogramType& chromatogram, const std::vector<OpenSwath::BinaryDataArrayPtr>& data);
+
     /// Members
     std::vector<std::streampos> spectra_index_;
     std::vector<std::streampos> chrom_index_;
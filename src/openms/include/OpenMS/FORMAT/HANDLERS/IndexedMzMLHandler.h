@@ -42,9 +42,19 @@
 #include <OpenMS/KERNEL/MSSpectrum.h>
 #include <OpenMS/KERNEL/MSChromatogram.h>
 
+#include <boost/shared_ptr.hpp>
+
 #include <string>
 #include <fstream>
 
+namespace boost
+{
+  namespace iostreams
+  {
+    class mapped_file_source;
+  }
+}
+
 namespace OpenMS
 {
 
@@ -69,10 +79,18 @@ namespace Internal
     extracting all the offsets of the <chromatogram> and <spectrum> tags. These
     offsets are stored as members of this class as well as the offset to the <indexList> element
 
-    @note This implementation is @a not thread-safe since it keeps internally a
-    single file access pointer which it moves when accessing a specific
-    data item. The caller is responsible to ensure that access is performed
-    atomically.
+    The file is memory-mapped (read-only) when it is opened, so that the XML
+    of each spectrum or chromatogram is read using positional access into the
+    mapped memory and decoded in a per-thread buffer. In this mode (see
+    isMemoryMapped()), multiple threads can retrieve and decode different
+    spectra from the same object concurrently and copies of this object
+    share the mapping.
+
+    @note If the file cannot be memory-mapped (e.g. very large files on 32
+    bit systems), a single file access pointer is used instead which is moved
+    when accessing a specific data item. In this case the implementation is
+    @a not thread-safe and the caller is responsible to ensure that access is
+    performed atomically (e.g. by providing a separate copy to each thread).
 
   */
   class OPENMS_DLLAPI IndexedMzMLHandler
@@ -87,8 +105,10 @@ namespace Internal
       std::streampos index_offset_;
       /// Whether spectra are written before chromatograms in this file
       bool spectra_before_chroms_;
-      /// The current filestream (opened by openFile)
+      /// The current filestream (opened by openFile, only used if the file is not memory-mapped)
       std::ifstream filestream_;
+      /// Read-only memory mapping of the file (shared between copies)
+      boost::shared_ptr<boost::iostreams::mapped_file_source> mapped_file_;
       /// Whether parsing the indexedmzML file was successful
       bool parsing_success_;
       /// Whether to skip XML checks
@@ -104,9 +124,24 @@ namespace Internal
     */
     void parseFooter_(String filename);
 
-    std::string getChromatogramById_helper_(int id);
+    /**
+      @brief Read the XML of the chromatogram at position @p id into @p text
 
-    std::string getSpectrumById_helper_(int id);
+      Reads from the memory-mapped file if available (thread-safe), otherwise
+      from the file stream.
+    */
+    void getChromatogramById_helper_(int id, std::string& text);
+
+    /**
+      @brief Read the XML of the spectrum at position @p id into @p text
+
+      Reads from the memory-mapped file if available (thread-safe), otherwise
+      from the file stream.
+    */
+    void getSpectrumById_helper_(int id, std::string& text);
+
+    /// Read the bytes in [startidx, endidx) of the file into @p text
+    void readRange_(std::streampos startidx, std::streampos endidx, std::string& text);
 
     public:
 
@@ -146,6 +181,14 @@ namespace Internal
     */
     bool getParsingSuccess() const;
 
+    /**
+      @brief Returns whether the file is memory-mapped
+
+      If true, concurrent calls to getSpectrumById, getChromatogramById and
+      their MSSpectrum / MSChromatogram variants are safe.
+    */
+    bool isMemoryMapped() const;
+
     /// Returns the number of spectra available
     size_t getNrSpectra() const;
 
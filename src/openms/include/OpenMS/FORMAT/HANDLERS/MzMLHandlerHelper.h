@@ -149,8 +149,11 @@ namespace OpenMS
 
         @param data_ The input and output
         @param skipXMLCheck whether to skip cleaning the Base64 arrays and remove whitespaces
+        @param convert_to_64bit whether 32 bit float arrays should be widened
+          to 64 bit during decoding (stored in floats_64, precision is set to
+          PRE_64). This avoids a second pass when the caller needs doubles.
       */
-      static void decodeBase64Arrays(std::vector<BinaryData> & data_, const bool skipXMLCheck = false);
+      static void decodeBase64Arrays(std::vector<BinaryData> & data_, const bool skipXMLCheck = false, const bool convert_to_64bit = false);
 
       /**
         @brief Identify a data array from a list.
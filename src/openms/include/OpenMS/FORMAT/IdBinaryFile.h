@@ -0,0 +1,220 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CHEMISTRY/AASequencePool.h>
+#include <OpenMS/CONCEPT/ProgressLogger.h>
+#include <OpenMS/METADATA/PeptideIdentification.h>
+#include <OpenMS/METADATA/ProteinIdentification.h>
+
+#include <fstream>
+#include <map>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Binary file format for peptide and protein identifications (idBin)
+
+    Stores the same information as idXML - protein and peptide
+    identifications round-trip without loss - but in a binary layout that is
+    read without XML parsing and String-number conversions.
+
+    The file consists of a header, the protein identifications, the peptide
+    identifications in blocks of a fixed number of entries, and a table of
+    the meta value names used in the file. Within a block, the data is split
+    into sections (see Section), so sections that are not needed can be
+    skipped when reading. Blocks can be processed one at a time with a
+    Reader and written one at a time with a Writer, so files larger than the
+    available memory can be processed (a Reader additionally caches up to
+    100000 distinct parsed peptide sequences).
+
+    Files are written in the byte order of the machine; files with a
+    different byte order are rejected.
+
+    @note Data processing information of the data arrays of protein groups is
+    not stored (as for idXML).
+
+    @ingroup FileIO
+  */
+  class OPENMS_DLLAPI IdBinaryFile :
+    public ProgressLogger
+  {
+public:
+    /// Sections of the peptide identification data, which can be selected for reading
+    enum Section
+    {
+      POSITIONS = 1, ///< RT and m/z of peptide identifications (always read)
+      IDENTIFICATIONS = 2, ///< identifier, score type and orientation, significance threshold and base name of peptide identifications
+      HITS = 4, ///< peptide hits with sequence, score, rank and charge
+      EVIDENCES = 8, ///< peptide evidences of hits (only read together with HITS)
+      META_VALUES = 16, ///< meta values of identifications and hits (the latter only read together with HITS), peak annotations and analysis results of hits
+      ALL_SECTIONS = 31
+    };
+
+    /// Number of peptide identifications per block written by store()
+    static const Size DEFAULT_BLOCK_SIZE = 4096;
+
+    /**
+      @brief Reads an idBin file block by block
+
+      The protein identifications are read on construction.
+
+      @exception Exception::FileNotFound is thrown if the file does not exist
+      @exception Exception::ParseError is thrown if the file is not a (valid) idBin file
+    */
+    class OPENMS_DLLAPI Reader
+    {
+public:
+      /// Opens @p filename, only the given @p sections (see Section) will be read
+      explicit Reader(const String& filename, UInt sections = ALL_SECTIONS);
+
+      /// Returns the protein identifications
+      const std::vector<ProteinIdentification>& getProteinIdentifications() const;
+
+      /// Returns the total number of peptide identifications in the file
+      Size getNrPeptideIdentifications() const;
+
+      /// Reads the next block of peptide identifications into @p peptide_ids (replacing its content), returns false if all blocks were read
+      bool readBlock(std::vector<PeptideIdentification>& peptide_ids);
+
+protected:
+      String filename_;
+      UInt sections_;
+      std::ifstream ifs_;
+      Size nr_peptide_ids_;
+      Size nr_blocks_;
+      Size blocks_read_;
+      /// file offset where the blocks end (and the meta value names start)
+      UInt64 blocks_end_;
+      /// meta value keys (in MetaInfoRegistry) for the key indices in the file
+      std::vector<UInt> keys_;
+      std::vector<ProteinIdentification> protein_ids_;
+      /// peptide sequences repeat across identifications - parse each only once (emptied between blocks once it holds more than 100000 sequences, so its memory stays bounded)
+      AASequencePool sequences_;
+      /// buffer for one section of a block
+      std::vector<char> buffer_;
+
+private:
+      /// Not implemented
+      Reader(const Reader&);
+
+      /// Not implemented
+      Reader& operator=(const Reader&);
+    };
+
+    /**
+      @brief Writes an idBin file block by block
+
+      The protein identifications are written on construction, peptide
+      identifications are collected until a block is complete. The file is
+      finished by close() (or the destructor).
+
+      @exception Exception::UnableToCreateFile is thrown if the file cannot be written
+    */
+    class OPENMS_DLLAPI Writer
+    {
+public:
+      /// Creates @p filename and writes the protein identifications
+      Writer(const String& filename, const std::vector<ProteinIdentification>& protein_ids, Size block_size = DEFAULT_BLOCK_SIZE);
+
+      /// Destructor, calls close()
+      ~Writer();
+
+      /// Adds a peptide identification
+      void add(const PeptideIdentification& peptide_id);
+
+      /// Writes the remaining data and closes the file (no effect if already closed)
+      void close();
+
+protected:
+      /// writes the current block
+      void writeBlock_();
+
+      String filename_;
+      Size block_size_;
+      std::ofstream ofs_;
+      Size nr_peptide_ids_;
+      Size nr_blocks_;
+      /// file key indices for meta value keys (in MetaInfoRegistry)
+      std::map<UInt, UInt> key_indices_;
+      /// peptide identifications and hits in the current block
+      Size block_ids_;
+      Size block_hits_;
+      /// data of the sections of the current block
+      std::vector<std::vector<char> > sections_;
+
+private:
+      /// Not implemented
+      Writer(const Writer&);
+
+      /// Not implemented
+      Writer& operator=(const Writer&);
+    };
+
+    /// Default constructor
+    IdBinaryFile();
+
+    /**
+      @brief Loads an idBin file
+
+      Only the sections selected with setSections() are read.
+
+      @exception Exception::FileNotFound is thrown if the file does not exist
+      @exception Exception::ParseError is thrown if the file is not a (valid) idBin file
+    */
+    void load(const String& filename, std::vector<ProteinIdentification>& protein_ids, std::vector<PeptideIdentification>& peptide_ids);
+
+    /**
+      @brief Stores identifications in an idBin file
+
+      @exception Exception::UnableToCreateFile is thrown if the file cannot be written
+    */
+    void store(const String& filename, const std::vector<ProteinIdentification>& protein_ids, const std::vector<PeptideIdentification>& peptide_ids);
+
+    /// Sets the sections (see Section) read by load()
+    void setSections(UInt sections);
+
+    /// Returns the sections (see Section) read by load()
+    UInt getSections() const;
+
+    /// Returns true if @p filename starts with the idBin file signature
+    static bool isIdBinaryFile(const String& filename);
+
+protected:
+    UInt sections_;
+  };
+
+} // namespace OpenMS
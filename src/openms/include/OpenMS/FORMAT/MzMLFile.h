@@ -74,6 +74,9 @@ public:
     /**
       @brief Loads a map from a MzML file. Spectra and chromatograms are sorted by default (this can be disabled using PeakFileOptions).
 
+      Large indexed mzML files are parsed by several threads (see
+      PeakFileOptions::setParallelChunkSize).
+
       @p filename The filename with the data
       @p map Is an MSExperiment
 
@@ -183,6 +186,19 @@ protected:
     /// Safe parse that catches exceptions and handles them accordingly
     void safeParse_(const String & filename, Internal::XMLHandler * handler);
 
+    /**
+      @brief Loads an indexed mzML file using multiple threads
+
+      The spectrum offsets from the index are used to split the spectrum list
+      into one block per thread. Each block is parsed independently and the
+      spectra are appended to @p map in file order.
+
+      @return false if the file cannot be loaded in parallel (not indexed, compressed,
+      invalid index, too small or only a single thread available), in which
+      case @p map is left untouched.
+    */
+    bool loadParallel_(const String & filename, PeakMap & map);
+
 private:
 
     /// Options for loading / storing
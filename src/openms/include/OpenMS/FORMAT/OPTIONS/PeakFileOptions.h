@@ -221,6 +221,22 @@ public:
     void setMaxDataPoolSize(Size size);
     //@}
 
+    /**
+        @name Parallel loading options
+
+        [mzML only!] Indexed mzML files can be parsed by several threads at
+        once, each thread working on a contiguous block of spectra. This
+        parameter specifies the minimal amount of spectrum data (in bytes) a
+        single thread should parse; files with less data are read by a single
+        thread. Setting it to 0 disables parallel loading.
+    */
+    //@{
+    /// Get minimal size (in bytes) of a block of spectra parsed by one thread
+    Size getParallelChunkSize() const;
+    /// Set minimal size (in bytes) of a block of spectra parsed by one thread (0 disables parallel loading)
+    void setParallelChunkSize(Size size);
+    //@}
+
     /// [mzML only!] Whether to use the "selected ion m/z" value as the precursor m/z value (alternative: use the "isolation window target m/z" value)
     bool getPrecursorMZSelectedIon() const;
 
@@ -255,6 +271,7 @@ private:
     MSNumpressCoder::NumpressConfig np_config_int_;
     MSNumpressCoder::NumpressConfig np_config_fda_;
     Size maximal_data_pool_size_;
+    Size parallel_chunk_size_;
     bool precursor_mz_selected_ion_;
   };
 
@@ -0,0 +1,105 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/config.h>
+#include <OpenMS/CONCEPT/Types.h>
+
+namespace OpenMS
+{
+  class Feature;
+  class FeatureMap;
+  class ConsensusFeature;
+  class ConsensusMap;
+
+namespace Interfaces
+{
+
+    /**
+      @brief The interface of a consumer of features or consensus features
+
+      The feature equivalent of IMSDataConsumer: features are passed to the
+      consumer one at a time (e.g. while reading a featureXML or consensusXML
+      file) and may be modified, filtered or written out, so that the complete
+      map never needs to be held in memory.
+
+      The consumer expects to be informed about the number of features and the
+      meta data of the map (data processing, protein identifications,
+      unassigned peptide identifications, column headers etc.) @a before
+      consuming any features.
+
+      @note The member functions setExpectedSize and setMapMetaData are
+      expected to be called before consuming starts.
+    */
+    template <typename MapT, typename FeatureT>
+    class IFeatureMapDataConsumer
+    {
+    public:
+      typedef MapT MapType;
+      typedef FeatureT FeatureType;
+
+      virtual ~IFeatureMapDataConsumer() {}
+
+      /**
+        @brief Consume a feature
+
+        The feature will be consumed by the implementation and possibly modified.
+      */
+      virtual void consumeFeature(FeatureType& feature) = 0;
+
+      /**
+        @brief Set expected number of features to be consumed
+
+        @note Calling this method is optional but good practice. A size of
+        zero means that the number of features is not known.
+      */
+      virtual void setExpectedSize(Size expected_features) = 0;
+
+      /**
+        @brief Set the meta data of the map the features belong to
+
+        @p map holds the meta data only, i.e. it contains no features.
+      */
+      virtual void setMapMetaData(const MapType& map) = 0;
+    };
+
+    /// Consumer of features (from a FeatureMap)
+    typedef IFeatureMapDataConsumer<FeatureMap, Feature> IFeatureDataConsumer;
+
+    /// Consumer of consensus features (from a ConsensusMap)
+    typedef IFeatureMapDataConsumer<ConsensusMap, ConsensusFeature> IConsensusDataConsumer;
+
+} //end namespace Interfaces
+} //end namespace OpenMS
@@ -6,6 +6,7 @@ set(sources_list_h
 DataStructures.h
 ISpectrumAccess.h
 IMSDataConsumer.h
+IFeatureDataConsumer.h
 )
 
 ### add path to the filenames
@@ -0,0 +1,406 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/CONCEPT/Exception.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <numeric>
+#include <vector>
+
+namespace OpenMS
+{
+
+  /**
+    @brief Peak data of a spectrum stored as separate m/z and intensity arrays (structure of arrays)
+
+    MSSpectrum stores its peaks as an array of Peak1D (an m/z double and an
+    intensity float, padded to 16 bytes). This class keeps the same
+    information in two contiguous arrays instead, which saves 25% of the
+    memory with double precision m/z values (50% with @p MZT = float) and
+    allows tight, vectorizable loops over the m/z or intensity values alone.
+    The intensity storage type @p IntensityT can be changed as well, e.g. to
+    hold the double precision intensities of a chromatogram without loss.
+
+    Only the peak data, the retention time and the MS level are stored. Use
+    the constructor taking an MSSpectrum and toMSSpectrum() to convert from and
+    to the full representation.
+
+    Read-only iteration is compatible with code written for MSSpectrum: the
+    ConstIterator is a random access iterator which yields Peak1D objects (by
+    value), so that generic algorithms and range-based for loops work
+    unchanged. Peaks are modified through setMZ() and setIntensity() or by
+    working on the arrays directly.
+
+    @note As for MSSpectrum, the search functions require the peaks to be
+    sorted by m/z (see sortByPosition()).
+
+    @ingroup Kernel
+  */
+  template <typename MZT = double, typename IntensityT = Peak1D::IntensityType>
+  class ColumnarSpectrum
+  {
+public:
+
+    ///@name Type definitions
+    //@{
+    /// Peak type returned by the iterators
+    typedef Peak1D PeakType;
+    /// Storage type of the m/z values
+    typedef MZT MZType;
+    /// Storage type of the intensity values
+    typedef IntensityT IntensityType;
+    /// Coordinate (m/z) type used in the interface
+    typedef Peak1D::CoordinateType CoordinateType;
+    //@}
+
+    /// Non-mutable random access iterator yielding Peak1D objects
+    class ConstIterator
+    {
+public:
+      /// Helper which allows it->getMZ() on a peak that is created on the fly
+      struct PeakPointer
+      {
+        PeakType peak;
+        const PeakType* operator->() const { return &peak; }
+      };
+
+      typedef std::random_access_iterator_tag iterator_category;
+      typedef PeakType value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef PeakPointer pointer;
+      typedef PeakType reference;
+
+      ConstIterator() :
+        spec_(nullptr), i_(0)
+      {}
+
+      ConstIterator(const ColumnarSpectrum* spec, Size i) :
+        spec_(spec), i_(i)
+      {}
+
+      /// Returns the current peak (by value)
+      PeakType operator*() const { return spec_->getPeak(i_); }
+      PeakType operator[](difference_type n) const { return spec_->getPeak(i_ + n); }
+      PeakPointer operator->() const { return PeakPointer{spec_->getPeak(i_)}; }
+
+      /// Returns the m/z of the current peak
+      CoordinateType getMZ() const { return spec_->getMZ(i_); }
+      /// Returns the intensity of the current peak
+      IntensityType getIntensity() const { return spec_->getIntensity(i_); }
+      /// Returns the index of the current peak
+      Size getIndex() const { return i_; }
+
+      ConstIterator& operator++() { ++i_; return *this; }
+      ConstIterator operator++(int) { ConstIterator tmp(*this); ++i_; return tmp; }
+      ConstIterator& operator--() { --i_; return *this; }
+      ConstIterator operator--(int) { ConstIterator tmp(*this); --i_; return tmp; }
+      ConstIterator& operator+=(difference_type n) { i_ += n; return *this; }
+      ConstIterator& operator-=(difference_type n) { i_ -= n; return *this; }
+      ConstIterator operator+(difference_type n) const { return ConstIterator(spec_, i_ + n); }
+      ConstIterator operator-(difference_type n) const { return ConstIterator(spec_, i_ - n); }
+      difference_type operator-(const ConstIterator& rhs) const { return difference_type(i_) - difference_type(rhs.i_); }
+
+      bool operator==(const ConstIterator& rhs) const { return i_ == rhs.i_ && spec_ == rhs.spec_; }
+      bool operator!=(const ConstIterator& rhs) const { return !(*this == rhs); }
+      bool operator<(const ConstIterator& rhs) const { return i_ < rhs.i_; }
+      bool operator>(const ConstIterator& rhs) const { return i_ > rhs.i_; }
+      bool operator<=(const ConstIterator& rhs) const { return i_ <= rhs.i_; }
+      bool operator>=(const ConstIterator& rhs) const { return i_ >= rhs.i_; }
+
+protected:
+      const ColumnarSpectrum* spec_;
+      Size i_;
+    };
+
+    /// Constructor
+    ColumnarSpectrum() :
+      rt_(-1.0),
+      ms_level_(1)
+    {}
+
+    /// Constructor from an MSSpectrum (copies peaks, retention time and MS level)
+    explicit ColumnarSpectrum(const MSSpectrum& spectrum) :
+      rt_(spectrum.getRT()),
+      ms_level_(spectrum.getMSLevel())
+    {
+      mz_.reserve(spectrum.size());
+      intensity_.reserve(spectrum.size());
+      for (MSSpectrum::ConstIterator it = spectrum.begin(); it != spectrum.end(); ++it)
+      {
+        mz_.push_back(static_cast<MZType>(it->getMZ()));
+        intensity_.push_back(static_cast<IntensityType>(it->getIntensity()));
+      }
+    }
+
+    /**
+      @brief Constructor from a range of peaks sorted by m/z
+
+      Works for any peak type providing getMZ() and getIntensity() (e.g.
+      Peak1D or ChromatogramPeak).
+    */
+    template <typename PeakIteratorType>
+    ColumnarSpectrum(PeakIteratorType first, PeakIteratorType last) :
+      rt_(-1.0),
+      ms_level_(1)
+    {
+      const Size n = std::distance(first, last);
+      mz_.reserve(n);
+      intensity_.reserve(n);
+      for (; first != last; ++first)
+      {
+        mz_.push_back(static_cast<MZType>(first->getMZ()));
+        intensity_.push_back(static_cast<IntensityType>(first->getIntensity()));
+      }
+    }
+
+    /// Equality operator
+    bool operator==(const ColumnarSpectrum& rhs) const
+    {
+      return rt_ == rhs.rt_ && ms_level_ == rhs.ms_level_ &&
+             mz_ == rhs.mz_ && intensity_ == rhs.intensity_;
+    }
+
+    /// Equality operator
+    bool operator!=(const ColumnarSpectrum& rhs) const
+    {
+      return !(operator==(rhs));
+    }
+
+    /**
+      @brief Writes the peaks into an MSSpectrum
+
+      Existing peaks of @p spectrum are replaced, retention time and MS level
+      are set. All other meta data of @p spectrum is left untouched.
+    */
+    void toMSSpectrum(MSSpectrum& spectrum) const
+    {
+      spectrum.clear(false);
+      spectrum.reserve(size());
+      for (Size i = 0; i < size(); ++i)
+      {
+        spectrum.push_back(getPeak(i));
+      }
+      spectrum.setRT(rt_);
+      spectrum.setMSLevel(ms_level_);
+    }
+
+    ///@name Accessors
+    //@{
+    /// Returns the absolute retention time (in seconds)
+    double getRT() const { return rt_; }
+    /// Sets the absolute retention time (in seconds)
+    void setRT(double rt) { rt_ = rt; }
+    /// Returns the MS level
+    UInt getMSLevel() const { return ms_level_; }
+    /// Sets the MS level
+    void setMSLevel(UInt ms_level) { ms_level_ = ms_level; }
+
+    /// Returns the contiguous m/z array
+    const std::vector<MZType>& getMZArray() const { return mz_; }
+    /// Returns the contiguous m/z array (mutable, keep the size in sync with the intensity array!)
+    std::vector<MZType>& getMZArray() { return mz_; }
+    /// Returns the contiguous intensity array
+    const std::vector<IntensityType>& getIntensityArray() const { return intensity_; }
+    /// Returns the contiguous intensity array (mutable, keep the size in sync with the m/z array!)
+    std::vector<IntensityType>& getIntensityArray() { return intensity_; }
+
+    /// Returns the m/z of peak @p i
+    CoordinateType getMZ(Size i) const { return mz_[i]; }
+    /// Sets the m/z of peak @p i
+    void setMZ(Size i, CoordinateType mz) { mz_[i] = static_cast<MZType>(mz); }
+    /// Returns the intensity of peak @p i
+    IntensityType getIntensity(Size i) const { return intensity_[i]; }
+    /// Sets the intensity of peak @p i
+    void setIntensity(Size i, IntensityType intensity) { intensity_[i] = intensity; }
+    /// Returns peak @p i
+    PeakType getPeak(Size i) const { return PeakType(mz_[i], static_cast<Peak1D::IntensityType>(intensity_[i])); }
+    /// Returns peak @p i
+    PeakType operator[](Size i) const { return getPeak(i); }
+    //@}
+
+    ///@name Container interface
+    //@{
+    Size size() const { return mz_.size(); }
+    bool empty() const { return mz_.empty(); }
+    void reserve(Size n) { mz_.reserve(n); intensity_.reserve(n); }
+    void resize(Size n) { mz_.resize(n); intensity_.resize(n); }
+    void clear() { mz_.clear(); intensity_.clear(); }
+    void push_back(const PeakType& peak) { push_back(peak.getMZ(), static_cast<IntensityType>(peak.getIntensity())); }
+    void push_back(CoordinateType mz, IntensityType intensity)
+    {
+      mz_.push_back(static_cast<MZType>(mz));
+      intensity_.push_back(intensity);
+    }
+    ConstIterator begin() const { return ConstIterator(this, 0); }
+    ConstIterator end() const { return ConstIterator(this, size()); }
+    //@}
+
+    ///@name Sorting
+    //@{
+    /// Checks if all peaks are sorted with respect to ascending m/z
+    bool isSorted() const
+    {
+      return std::is_sorted(mz_.begin(), mz_.end());
+    }
+
+    /// Sorts the peaks by ascending m/z (stable)
+    void sortByPosition()
+    {
+      if (isSorted()) return;
+
+      std::vector<Size> order(size());
+      std::iota(order.begin(), order.end(), 0);
+      std::stable_sort(order.begin(), order.end(), [this](Size a, Size b) { return mz_[a] < mz_[b]; });
+
+      std::vector<MZType> mz(size());
+      std::vector<IntensityType> intensity(size());
+      for (Size i = 0; i < order.size(); ++i)
+      {
+        mz[i] = mz_[order[i]];
+        intensity[i] = intensity_[order[i]];
+      }
+      mz_.swap(mz);
+      intensity_.swap(intensity);
+    }
+    //@}
+
+    ///@name Searching a peak or peak range
+    //@{
+    /// Returns the index of the first peak with m/z >= @p mz (binary search over the m/z array)
+    Size MZBegin(CoordinateType mz) const
+    {
+      return std::lower_bound(mz_.begin(), mz_.end(), mz,
+                              [](MZType a, CoordinateType b) { return a < b; }) - mz_.begin();
+    }
+
+    /// Returns the index of the first peak with m/z > @p mz (binary search over the m/z array)
+    Size MZEnd(CoordinateType mz) const
+    {
+      return std::upper_bound(mz_.begin(), mz_.end(), mz,
+                              [](CoordinateType a, MZType b) { return a < b; }) - mz_.begin();
+    }
+
+    /**
+      @brief Binary search for the peak nearest to a specific m/z
+
+      Same semantics as MSSpectrum::findNearest(CoordinateType).
+
+      @exception Exception::Precondition is thrown if the spectrum is empty
+    */
+    Size findNearest(CoordinateType mz) const
+    {
+      if (empty())
+      {
+        throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "There must be at least one peak to determine the nearest peak!");
+      }
+      Size i = MZBegin(mz);
+      if (i == 0) return 0;
+      if (i == size()) return size() - 1;
+      return (std::fabs(mz_[i] - mz) < std::fabs(mz_[i - 1] - mz)) ? i : i - 1;
+    }
+
+    /**
+      @brief Binary search for the peak nearest to a specific m/z given a +/- tolerance window in Th
+
+      Same semantics as MSSpectrum::findNearest(CoordinateType, CoordinateType).
+
+      @return Returns the index of the peak or -1 if no peak is present in the tolerance window
+    */
+    Int findNearest(CoordinateType mz, CoordinateType tolerance) const
+    {
+      if (empty()) return -1;
+      Size i = findNearest(mz);
+      return (mz_[i] >= mz - tolerance && mz_[i] <= mz + tolerance) ? static_cast<Int>(i) : -1;
+    }
+
+    /**
+      @brief Sums up the intensities of all peaks in the closed interval [@p mz_start, @p mz_end]
+
+      The range is located by binary search, the summation runs over the
+      contiguous intensity array only.
+    */
+    double sumIntensity(CoordinateType mz_start, CoordinateType mz_end) const
+    {
+      const Size first = MZBegin(mz_start);
+      const Size last = MZEnd(mz_end);
+      if (first >= last) return 0.0;
+
+      // independent partial sums allow the compiler to vectorize the loop
+      const IntensityType* it = intensity_.data() + first;
+      const Size n = last - first;
+      double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+      Size k = 0;
+      for (; k + 4 <= n; k += 4)
+      {
+        s0 += it[k];
+        s1 += it[k + 1];
+        s2 += it[k + 2];
+        s3 += it[k + 3];
+      }
+      for (; k < n; ++k)
+      {
+        s0 += it[k];
+      }
+      return (s0 + s1) + (s2 + s3);
+    }
+    //@}
+
+protected:
+
+    /// Retention time
+    double rt_;
+
+    /// MS level
+    UInt ms_level_;
+
+    /// Contiguous m/z values
+    std::vector<MZType> mz_;
+
+    /// Contiguous intensity values
+    std::vector<IntensityType> intensity_;
+  };
+
+  /// Columnar spectrum with double precision m/z values
+  typedef ColumnarSpectrum<double> ColumnarSpectrumD;
+
+  /// Columnar spectrum with single precision m/z values (only suitable if the reduced m/z precision is acceptable)
+  typedef ColumnarSpectrum<float> ColumnarSpectrumF;
+
+} // namespace OpenMS
+
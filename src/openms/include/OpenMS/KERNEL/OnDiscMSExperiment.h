@@ -56,9 +56,13 @@ namespace OpenMS
 
     @ingroup Kernel
 
-    @note This implementation is @a not thread-safe since it keeps internally a
-    single file access pointer which it moves when accessing a specific
-    data item. Please provide a separate copy to each thread, e.g. 
+    @note The underlying file is memory-mapped if possible (see
+    Internal::IndexedMzMLHandler), in which case multiple threads can access
+    spectra and chromatograms of the same object concurrently. Otherwise, this
+    implementation is @a not thread-safe since it keeps internally a single
+    file access pointer which it moves when accessing a specific data item. To
+    be safe in either case, provide a separate copy to each thread (copies
+    are cheap and share the memory mapping), e.g.
 
     @code
     #pragma omp parallel for firstprivate(ondisc_map) 
@@ -221,6 +225,12 @@ public:
       return indexed_mzml_file_.getChromatogramById(id);
     }
 
+    /// returns whether the underlying file is memory-mapped (allowing concurrent access)
+    bool isMemoryMapped() const
+    {
+      return indexed_mzml_file_.isMemoryMapped();
+    }
+
     ///sets whether to skip some XML checks and be fast instead
     void setSkipXMLChecks(bool skip)
     {
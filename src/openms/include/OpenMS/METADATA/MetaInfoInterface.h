@@ -124,5 +124,45 @@ protected:
     MetaInfo* meta_;
   };
 
+  /**
+    @brief Name of a meta value that is registered once and afterwards used by index.
+
+    Accessing meta values by name looks the name up in the registry on every
+    call. For names used in hot (e.g. parallel) loops, register the name once
+    and pass the key wherever MetaInfoInterface accepts an index:
+
+    @code
+    static const MetaValueKey scan_index("scan_index");
+    peptide_id.setMetaValue(scan_index, 42);
+    @endcode
+
+    @note Keys are registered in MetaInfoInterface::metaRegistry(). Define them
+    as function-local statics or members, not as namespace-scope globals, as
+    the registry may not yet be initialized during static initialization.
+
+    @ingroup Metadata
+  */
+  class OPENMS_DLLAPI MetaValueKey
+  {
+public:
+    /// Registers @p name (or looks up its index, if it is already registered)
+    explicit MetaValueKey(const String& name, const String& description = "", const String& unit = "");
+
+    /// Returns the index of the name in the registry
+    UInt getIndex() const
+    {
+      return index_;
+    }
+
+    /// Conversion to the index, e.g. for MetaInfoInterface::getMetaValue(UInt)
+    operator UInt() const
+    {
+      return index_;
+    }
+
+private:
+    UInt index_;
+  };
+
 } // namespace OpenMS
 
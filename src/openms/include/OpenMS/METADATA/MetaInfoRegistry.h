@@ -41,6 +41,7 @@
 #include <OpenMS/CONCEPT/Types.h>
 #include <OpenMS/DATASTRUCTURES/String.h>
 
+#include <atomic>
 #include <unordered_map>
 
 #ifdef OPENMS_COMPILER_MSVC
@@ -70,6 +71,13 @@ namespace OpenMS
       12 - low_quality<BR>
       13 - charge<BR>
 
+      Looking up indices (getIndex()) and names (getName()) is lock-free:
+      registered names are never changed or removed, so readers traverse
+      insert-only hash chains that writers extend atomically. Only
+      registering a new name and accessing descriptions or units is
+      synchronized. Assigning to a registry that is concurrently read from is
+      not thread-safe.
+
       @ingroup Metadata
   */
   class OPENMS_DLLAPI MetaInfoRegistry
@@ -161,19 +169,43 @@ public:
     String getUnit(const String& name) const;
 
 private:
+    /// A registered name; name and index never change after registration
+    struct Entry_
+    {
+      std::string name;
+      UInt index;
+      /// description, guarded by the "MetaInfoRegistry" critical section
+      std::string description;
+      /// unit, guarded by the "MetaInfoRegistry" critical section
+      std::string unit;
+      /// next entry in the same name bucket
+      Entry_* next_by_name;
+      /// next entry in the same index bucket
+      Entry_* next_by_index;
+    };
+
+    /// number of hash buckets (for names and indices)
+    static const Size NR_BUCKETS = 4096;
+
+    /// Lock-free lookup of a name, returns nullptr if not registered
+    Entry_* findByName_(const std::string& name) const;
+
+    /// Lock-free lookup of an index, returns nullptr if not registered
+    Entry_* findByIndex_(UInt index) const;
+
+    /// Publishes a new entry (caller must hold the "MetaInfoRegistry" critical section)
+    void insert_(const std::string& name, UInt index, const std::string& description, const std::string& unit);
+
+    /// Deletes all entries (not thread-safe)
+    void clear_();
+
     /// internal counter, that stores the next index to assign
     UInt next_index_;
-    using MapString2IndexType = std::unordered_map<std::string, UInt>;
-    using MapIndex2StringType = std::unordered_map<UInt, std::string>;
-    
-    /// map from name to index
-    MapString2IndexType name_to_index_;
-    /// map from index to name
-    MapIndex2StringType index_to_name_;
-    /// map from index to description
-    MapIndex2StringType index_to_description_;
-    /// map from index to unit
-    MapIndex2StringType index_to_unit_;
+
+    /// hash chains by name
+    std::atomic<Entry_*> name_buckets_[NR_BUCKETS];
+    /// hash chains by index
+    std::atomic<Entry_*> index_buckets_[NR_BUCKETS];
   };
 
 } // namespace OpenMS
@@ -0,0 +1,282 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/METADATA/PeptideIdentification.h>
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Compact, column-oriented storage of peptide-spectrum matches
+
+    Holds the same information as a vector of PeptideIdentification, but
+    column by column instead of as one object per identification and hit:
+    every property (RT, score, charge, ...) is a plain vector indexed by the
+    identification or hit number, and the hits of identification @em i are
+    the rows getHitsBegin(i) to getHitsEnd(i) - 1.
+
+    Strings that repeat across PSMs (peptide sequences, protein accessions,
+    score types, run identifiers and string meta values) are interned, i.e.
+    stored only once. Meta values are stored in one column per name; a column
+    holds integers, doubles or interned strings as long as all its values have
+    that type (without a unit) and falls back to DataValue otherwise. Fragment
+    annotations and analysis results are kept on the side, as only few hits
+    carry them.
+
+    Conversion from and to PeptideIdentification is lossless. The table can be
+    filtered with IDFilter, processed with FalseDiscoveryRate and mapped to
+    features with IDMapper without converting it back.
+
+    @ingroup Metadata
+  */
+  class OPENMS_DLLAPI PSMTable
+  {
+public:
+    /// @name Constructors
+    //@{
+    /// Default constructor (empty table)
+    PSMTable();
+
+    /// Constructor from peptide identifications
+    explicit PSMTable(const std::vector<PeptideIdentification>& ids);
+    //@}
+
+    /// @name Conversion
+    //@{
+    /// Appends a peptide identification
+    void add(const PeptideIdentification& id);
+
+    /// Appends peptide identifications
+    void add(const std::vector<PeptideIdentification>& ids);
+
+    /// Converts identification @p index back to a PeptideIdentification
+    PeptideIdentification getIdentification(Size index) const;
+
+    /// Converts identification @p index back, reusing the memory of @p id
+    void getIdentification(Size index, PeptideIdentification& id) const;
+
+    /// Converts the whole table back (replaces the content of @p ids)
+    void getIdentifications(std::vector<PeptideIdentification>& ids) const;
+    //@}
+
+    /// Number of identifications (spectra)
+    Size getNrIdentifications() const;
+
+    /// Number of hits (PSMs)
+    Size getNrHits() const;
+
+    /// Returns whether the table has no identifications
+    bool empty() const;
+
+    /// Removes everything
+    void clear();
+
+    /// @name Identification columns
+    //@{
+    double getRT(Size index) const;
+    double getMZ(Size index) const;
+    double getSignificanceThreshold(Size index) const;
+    const String& getIdentifier(Size index) const;
+    const String& getBaseName(Size index) const;
+    const String& getScoreType(Size index) const;
+    void setScoreType(Size index, const String& type);
+    bool isHigherScoreBetter(Size index) const;
+    void setHigherScoreBetter(Size index, bool value);
+
+    /// Index of the first hit of identification @p index
+    Size getHitsBegin(Size index) const;
+    /// Index after the last hit of identification @p index
+    Size getHitsEnd(Size index) const;
+    /// Index of the identification that @p hit belongs to
+    Size getIdentificationIndex(Size hit) const;
+
+    /// Returns whether identification @p index has a meta value with the given registry index
+    bool identificationMetaValueExists(Size index, UInt key) const;
+    /// Returns a meta value of identification @p index (DataValue::EMPTY if not set)
+    DataValue getIdentificationMetaValue(Size index, UInt key) const;
+    /// Sets a meta value of identification @p index
+    void setIdentificationMetaValue(Size index, UInt key, const DataValue& value);
+    //@}
+
+    /// @name Hit columns
+    //@{
+    double getScore(Size hit) const;
+    void setScore(Size hit, double score);
+    UInt getRank(Size hit) const;
+    void setRank(Size hit, UInt rank);
+    Int getCharge(Size hit) const;
+
+    /// String representation of the peptide sequence (see AASequence::toString())
+    const String& getSequence(Size hit) const;
+    /// Interned id of the peptide sequence (hits with the same sequence have the same id)
+    UInt32 getSequenceId(Size hit) const;
+
+    std::vector<PeptideEvidence> getPeptideEvidences(Size hit) const;
+
+    /// Returns whether @p hit has a meta value with the given registry index
+    bool hitMetaValueExists(Size hit, UInt key) const;
+    /// Returns a meta value of @p hit (DataValue::EMPTY if not set)
+    DataValue getHitMetaValue(Size hit, UInt key) const;
+    /// Sets a meta value of @p hit
+    void setHitMetaValue(Size hit, UInt key, const DataValue& value);
+    /// Removes a meta value of @p hit
+    void removeHitMetaValue(Size hit, UInt key);
+    //@}
+
+    /// @name Bulk operations
+    //@{
+    /**
+      @brief Sorts the hits of every identification by score
+
+      The score orientation of the identification is taken into account,
+      hits with equal scores keep their order (cf. PeptideIdentification::sort()).
+    */
+    void sortHits();
+
+    /// Assigns ranks (starting at 1) by score within every identification (cf. PeptideIdentification::assignRanks())
+    void assignRanks();
+
+    /**
+      @brief Keeps only the hits with @p keep[hit] == true
+
+      Identifications that lose all hits are kept (see removeEmptyIdentifications()).
+
+      @exception Exception::InvalidSize is thrown if @p keep does not have one entry per hit
+    */
+    void filterHits(const std::vector<bool>& keep);
+
+    /// Removes identifications without hits
+    void removeEmptyIdentifications();
+    //@}
+
+protected:
+    /// Strings that are stored only once
+    struct StringPool_
+    {
+      std::vector<String> strings;
+      std::unordered_map<std::string, UInt32> ids;
+
+      UInt32 intern(const String& s);
+    };
+
+    /// One meta value for all rows, stored with a common type if possible
+    struct MetaColumn_
+    {
+      enum Type {INT, DOUBLE, STRING, GENERIC};
+
+      Type type;
+      std::vector<bool> present;
+      std::vector<SignedSize> ints;
+      std::vector<double> doubles;
+      std::vector<UInt32> strings;
+      std::vector<DataValue> generic;
+
+      /// type of column that can store @p value
+      static Type typeOf(const DataValue& value);
+
+      /// resets the column to @p rows absent values of type @p t
+      void init(Type t, Size rows);
+      void appendAbsent();
+      DataValue get(Size row, const StringPool_& pool) const;
+      void set(Size row, const DataValue& value, StringPool_& pool);
+      void remove(Size row);
+      /// converts the column to type GENERIC
+      void toGeneric(const StringPool_& pool);
+      /// keeps the given rows (in the given order)
+      void select(const std::vector<Size>& rows);
+    };
+
+    /// Meta values of all rows (hits or identifications)
+    struct MetaTable_
+    {
+      /// columns by meta info registry index
+      std::map<UInt, MetaColumn_> columns;
+      Size rows = 0;
+
+      void appendRow(const MetaInfoInterface& meta, StringPool_& pool);
+      bool exists(Size row, UInt key) const;
+      DataValue get(Size row, UInt key, const StringPool_& pool) const;
+      void set(Size row, UInt key, const DataValue& value, StringPool_& pool);
+      void remove(Size row, UInt key);
+      void copyTo(Size row, MetaInfoInterface& meta, const StringPool_& pool) const;
+      /// keeps the given rows (in the given order)
+      void select(const std::vector<Size>& rows);
+      void clear();
+    };
+
+    /// Converts identification @p index back, parsing every sequence only once per call of getIdentifications()
+    void getIdentification_(Size index, PeptideIdentification& id, std::unordered_map<UInt32, AASequence>& sequences) const;
+
+    /// Keeps the given hits (in the given order); @p hit_counts holds the new number of hits per identification
+    void selectHits_(const std::vector<Size>& hits, const std::vector<Size>& hit_counts);
+
+    StringPool_ strings_;
+
+    // identification columns
+    std::vector<double> rt_;
+    std::vector<double> mz_;
+    std::vector<double> significance_threshold_;
+    std::vector<UInt32> identifier_;
+    std::vector<UInt32> base_name_;
+    std::vector<UInt32> score_type_;
+    std::vector<bool> higher_score_better_;
+    /// hits of identification i are [hits_begin_[i], hits_begin_[i + 1])
+    std::vector<Size> hits_begin_;
+    MetaTable_ identification_meta_;
+
+    // hit columns
+    std::vector<UInt32> sequence_;
+    std::vector<double> score_;
+    std::vector<UInt> rank_;
+    std::vector<Int> charge_;
+    /// evidences of hit h are [evidences_begin_[h], evidences_begin_[h + 1])
+    std::vector<Size> evidences_begin_;
+    MetaTable_ hit_meta_;
+    std::map<Size, std::vector<PeptideHit::PeakAnnotation> > peak_annotations_;
+    std::map<Size, std::vector<PeptideHit::PepXMLAnalysisResult> > analysis_results_;
+
+    // peptide evidence columns
+    std::vector<UInt32> evidence_accession_;
+    std::vector<Int> evidence_start_;
+    std::vector<Int> evidence_end_;
+    std::vector<char> evidence_aa_before_;
+    std::vector<char> evidence_aa_after_;
+  };
+
+} // namespace OpenMS
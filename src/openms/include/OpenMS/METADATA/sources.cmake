@@ -41,6 +41,7 @@ Precursor.h
 Product.h
 ProteinHit.h
 ProteinIdentification.h
+PSMTable.h
 Sample.h
 SampleTreatment.h
 ScanWindow.h
@@ -132,8 +132,9 @@ public:
 
     /**
      * @brief Applies the peak-picking algorithm to a map (MSExperiment). This
-     * method picks peaks for each scan in the map consecutively. The resulting
-     * picked peaks are written to the output map.
+     * method picks peaks for each scan in the map (in parallel, if OpenMP is
+     * enabled). The resulting picked peaks are written to the output map, in
+     * the order of the input.
      *
      * @param input  input map in profile mode
      * @param output  output map with picked peaks
@@ -143,8 +144,9 @@ public:
 
     /**
      * @brief Applies the peak-picking algorithm to a map (MSExperiment). This
-     * method picks peaks for each scan in the map consecutively. The resulting
-     * picked peaks are written to the output map.
+     * method picks peaks for each scan in the map (in parallel, if OpenMP is
+     * enabled). The resulting picked peaks are written to the output map, in
+     * the order of the input.
      *
      * @param input  input map in profile mode
      * @param output  output map with picked peaks
@@ -156,8 +158,11 @@ public:
 
     /**
       @brief Applies the peak-picking algorithm to a map (MSExperiment). This
-      method picks peaks for each scan in the map consecutively. The resulting
-      picked peaks are written to the output map.
+      method picks peaks for each scan in the map. The resulting picked peaks
+      are written to the output map.
+
+      Spectra are read from disc in blocks (100 spectra per thread), which are
+      then picked in parallel (if OpenMP is enabled).
 
       Currently we have to give up const-correctness but we know that everything on disc is constant
     */
@@ -67,120 +67,65 @@ namespace OpenMS
 
   }
 
-  void FalseDiscoveryRate::apply(vector<PeptideIdentification>& ids) const
+  /// target/decoy state of a hit: 1 = target, -1 = decoy, 0 = unannotated
+  static Int targetDecoyClass_(const String& target_decoy)
   {
-    bool q_value = !param_.getValue("no_qvalues").toBool();
-    bool use_all_hits = param_.getValue("use_all_hits").toBool();
-    bool treat_runs_separately = param_.getValue("treat_runs_separately").toBool();
-    bool split_charge_variants = param_.getValue("split_charge_variants").toBool();
-    bool add_decoy_peptides = param_.getValue("add_decoy_peptides").toBool();
-#ifdef FALSE_DISCOVERY_RATE_DEBUG
-    cerr << "Parameters: no_qvalues=" << !q_value << ", use_all_hits=" << use_all_hits << ", treat_runs_separately=" << treat_runs_separately << ", split_charge_variants=" << split_charge_variants << endl;
-#endif
-
-    if (ids.empty())
+    if (target_decoy == "target" || target_decoy == "target+decoy")
     {
-      OPENMS_LOG_WARN << "No peptide identifications given to FalseDiscoveryRate! No calculation performed.\n";
-      return;
+      return 1;
     }
-
-    bool higher_score_better = ids.begin()->isHigherScoreBetter();
-
-    // first search for all identifiers and charge variants
-    set<String> identifiers;
-    set<SignedSize> charge_variants;
-    for (auto it = ids.begin(); it != ids.end(); ++it)
+    if (target_decoy == "decoy")
     {
-      identifiers.insert(it->getIdentifier());
-      it->sort();
-
-      if (!use_all_hits)
-      {
-        it->getHits().resize(1);
-      }
-
-      for (auto pit = it->getHits().begin(); pit != it->getHits().end(); ++pit)
-      {
-        charge_variants.insert(pit->getCharge());
-      }
+      return -1;
     }
-
-#ifdef FALSE_DISCOVERY_RATE_DEBUG
-    cerr << "#id-runs: " << identifiers.size() << " ";
-    for (auto it = identifiers.begin(); it != identifiers.end(); ++it)
+    if (target_decoy != "")
     {
-      cerr << "," << *it;
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unknown value of meta value 'target_decoy'", target_decoy);
     }
-    cerr << endl;
+    return 0;
+  }
 
+  void FalseDiscoveryRate::calculatePSMFDRs_(vector<double>& scores, const vector<Int>& hit_class, const vector<Size>& runs, const vector<String>& run_names, const vector<Int>& charges, bool higher_score_better, vector<bool>& rescored, vector<bool>& keep) const
+  {
+    bool q_value = !param_.getValue("no_qvalues").toBool();
+    bool treat_runs_separately = param_.getValue("treat_runs_separately").toBool();
+    bool split_charge_variants = param_.getValue("split_charge_variants").toBool();
+    bool add_decoy_peptides = param_.getValue("add_decoy_peptides").toBool();
 
-    cerr << "#of charge states: " << charge_variants.size() << " ";
-    for (auto it = charge_variants.begin(); it != charge_variants.end(); ++it)
-    {
-      cerr << "," << *it;
-    }
-    cerr << endl;
-#endif
+    rescored.assign(scores.size(), false);
+    keep.assign(scores.size(), true);
 
+    set<Int> charge_variants(charges.begin(), charges.end());
     for (auto zit = charge_variants.begin(); zit != charge_variants.end(); ++zit)
     {
 #ifdef FALSE_DISCOVERY_RATE_DEBUG
       cerr << "Charge variant=" << *zit << endl;
 #endif
-
-      // for all identifiers
-      for (auto iit = identifiers.begin(); iit != identifiers.end(); ++iit)
+      for (Size run = 0; run < run_names.size(); ++run)
       {
-        if (!treat_runs_separately && iit != identifiers.begin())
+        if (!treat_runs_separately && run != 0)
         {
-          continue; //only take the first run
+          break; //only take the first run
         }
 
-#ifdef FALSE_DISCOVERY_RATE_DEBUG
-        cerr << "Id-run: " << *iit << endl;
-#endif
-        // get the scores of all peptide hits
+        // collect the hits of this group and their scores
+        vector<Size> group;
         vector<double> target_scores, decoy_scores;
-        for (auto it = ids.begin(); it != ids.end(); ++it)
+        for (Size h = 0; h < scores.size(); ++h)
         {
-          // if runs should be treated separately, the identifiers must be the same
-          if (treat_runs_separately && it->getIdentifier() != *iit)
+          if ((treat_runs_separately && runs[h] != run) ||
+              (split_charge_variants && charges[h] != *zit))
           {
             continue;
           }
-
-          for (Size i = 0; i < it->getHits().size(); ++i)
+          group.push_back(h);
+          if (hit_class[h] > 0)
           {
-            if (split_charge_variants && it->getHits()[i].getCharge() != *zit)
-            {
-              continue;
-            }
-
-            if (!it->getHits()[i].metaValueExists("target_decoy"))
-            {
-              OPENMS_LOG_FATAL_ERROR << "Meta value 'target_decoy' does not exists, reindex the idXML file with 'PeptideIndexer' first (run-id='" << it->getIdentifier() << ", rank=" << i + 1 << " of " << it->getHits().size() << ")!" << endl;
-              throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Meta value 'target_decoy' does not exist!");
-            }
-
-            String target_decoy(it->getHits()[i].getMetaValue("target_decoy"));
-            if (target_decoy == "target" || target_decoy == "target+decoy")
-            {
-              target_scores.push_back(it->getHits()[i].getScore());
-            }
-            else
-            {
-              if (target_decoy == "decoy")
-              {
-                decoy_scores.push_back(it->getHits()[i].getScore());
-              }
-              else
-              {
-                if (target_decoy != "")
-                {
-                  throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unknown value of meta value 'target_decoy'", target_decoy);
-                }
-              }
-            }
+            target_scores.push_back(scores[h]);
+          }
+          else if (hit_class[h] < 0)
+          {
+            decoy_scores.push_back(scores[h]);
           }
         }
 
@@ -188,90 +133,47 @@ namespace OpenMS
         cerr << "#target-scores=" << target_scores.size() << ", #decoy-scores=" << decoy_scores.size() << endl;
 #endif
 
-        // check decoy scores
-        if (decoy_scores.empty())
+        String group_string;
+        if (split_charge_variants || treat_runs_separately)
         {
-          String error_string = "FalseDiscoveryRate: #decoy sequences is zero! Setting all target sequences to q-value/FDR 0! ";
-          if (split_charge_variants || treat_runs_separately)
+          group_string += "(";
+          if (split_charge_variants)
           {
-            error_string += "(";
-            if (split_charge_variants)
-            {
-              error_string += "charge_variant=" + String(*zit) + " ";
-            }
-            if (treat_runs_separately)
-            {
-              error_string += "run-id=" + *iit;
-            }
-            error_string += ")";
+            group_string += "charge_variant=" + String(*zit) + " ";
+          }
+          if (treat_runs_separately)
+          {
+            group_string += "run-id=" + run_names[run];
           }
-          OPENMS_LOG_ERROR << error_string << std::endl;
+          group_string += ")";
+        }
+        if (decoy_scores.empty())
+        {
+          OPENMS_LOG_ERROR << "FalseDiscoveryRate: #decoy sequences is zero! Setting all target sequences to q-value/FDR 0! " << group_string << std::endl;
         }
-
-        // check target scores
         if (target_scores.empty())
         {
-          String error_string = "FalseDiscoveryRate: #target sequences is zero! Ignoring. ";
-          if (split_charge_variants || treat_runs_separately)
-          {
-            error_string += "(";
-            if (split_charge_variants)
-            {
-              error_string += "charge_variant=" + String(*zit) + " ";
-            }
-            if (treat_runs_separately)
-            {
-              error_string += "run-id=" + *iit;
-            }
-            error_string += ")";
-          }
-          OPENMS_LOG_ERROR << error_string << std::endl;
+          OPENMS_LOG_ERROR << "FalseDiscoveryRate: #target sequences is zero! Ignoring. " << group_string << std::endl;
         }
 
         if (target_scores.empty() || decoy_scores.empty())
         {
-          // no remove the the relevant entries, or put 'pseudo-scores' in
-          for (auto it = ids.begin(); it != ids.end(); ++it)
+          // targets get q-value/FDR 0, decoys are removed
+          for (Size h : group)
           {
-            // if runs should be treated separately, the identifiers must be the same
-            if (treat_runs_separately && it->getIdentifier() != *iit)
+            if (hit_class[h] > 0)
             {
-              continue;
+              rescored[h] = true;
+              scores[h] = 0;
             }
-
-            vector<PeptideHit> hits(it->getHits()), new_hits;
-            for (Size i = 0; i < hits.size(); ++i)
+            else if (hit_class[h] < 0)
             {
-              if (split_charge_variants && hits[i].getCharge() != *zit)
-              {
-                new_hits.push_back(hits[i]);
-                continue;
-              }
-
-              if (!hits[i].metaValueExists("target_decoy"))
-              {
-                OPENMS_LOG_FATAL_ERROR << "Meta value 'target_decoy' does not exists, reindex the idXML file with 'PeptideIndexer' (run-id='" << it->getIdentifier() << ", rank=" << i + 1 << " of " << hits.size() << ")!" << endl;
-                throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Meta value 'target_decoy' does not exist!");
-              }
-
-              String target_decoy(hits[i].getMetaValue("target_decoy"));
-              if (target_decoy == "target" || target_decoy == "target+decoy")
-              {
-                // if it is a target hit, there are now decoys, fdr/q-value should be zero then
-                new_hits.push_back(hits[i]);
-                String score_type = it->getScoreType() + "_score";
-                new_hits.back().setMetaValue(score_type, new_hits.back().getScore());
-                new_hits.back().setScore(0);
-              }
-              else
-              {
-                if (target_decoy != "decoy")
-                {
-                  throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unknown value of meta value 'target_decoy'", target_decoy);
-                }
-              }
+              keep[h] = false;
+            }
+            else
+            {
+              throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unknown value of meta value 'target_decoy'", "");
             }
-            it->setHits(new_hits);
           }
           continue;
         }
@@ -281,38 +183,15 @@ namespace OpenMS
         calculateFDRs_(score_to_fdr, target_scores, decoy_scores, q_value, higher_score_better);
 
         // annotate fdr
-        for (auto it = ids.begin(); it != ids.end(); ++it)
+        for (Size h : group)
         {
-          // if runs should be treated separately, the identifiers must be the same
-          if (treat_runs_separately && it->getIdentifier() != *iit)
+          if (hit_class[h] < 0 && !add_decoy_peptides)
           {
+            keep[h] = false;
             continue;
           }
-
-          String score_type = it->getScoreType() + "_score";
-          vector<PeptideHit> hits;
-          for (vector<PeptideHit>::const_iterator pit = it->getHits().begin(); pit != it->getHits().end(); ++pit)
-          {
-            PeptideHit hit = *pit;
-
-            if (split_charge_variants && pit->getCharge() != *zit)
-            {
-              hits.push_back(*pit);
-              continue;
-            }
-            if (hit.metaValueExists("target_decoy"))
-            {
-              String meta_value = (String)hit.getMetaValue("target_decoy");
-              if (meta_value == "decoy" && !add_decoy_peptides)
-              {
-                continue;
-              }
-            }
-            hit.setMetaValue(score_type, pit->getScore());
-            hit.setScore(score_to_fdr[pit->getScore()]);
-            hits.push_back(hit);
-          }
-          it->getHits().swap(hits);
+          rescored[h] = true;
+          scores[h] = score_to_fdr[scores[h]];
         }
       }
       if (!split_charge_variants)
@@ -320,6 +199,84 @@ namespace OpenMS
         break;
       }
     }
+  }
+
+  void FalseDiscoveryRate::apply(vector<PeptideIdentification>& ids) const
+  {
+    bool q_value = !param_.getValue("no_qvalues").toBool();
+    bool use_all_hits = param_.getValue("use_all_hits").toBool();
+#ifdef FALSE_DISCOVERY_RATE_DEBUG
+    cerr << "Parameters: no_qvalues=" << !q_value << ", use_all_hits=" << use_all_hits << endl;
+#endif
+
+    if (ids.empty())
+    {
+      OPENMS_LOG_WARN << "No peptide identifications given to FalseDiscoveryRate! No calculation performed.\n";
+      return;
+    }
+
+    bool higher_score_better = ids.begin()->isHigherScoreBetter();
+
+    // first search for all identifiers
+    set<String> identifiers;
+    for (auto it = ids.begin(); it != ids.end(); ++it)
+    {
+      identifiers.insert(it->getIdentifier());
+      it->sort();
+
+      if (!use_all_hits)
+      {
+        it->getHits().resize(1);
+      }
+    }
+    vector<String> run_names(identifiers.begin(), identifiers.end());
+
+    // flatten the hits for the shared computation
+    vector<double> scores;
+    vector<Int> hit_class, charges;
+    vector<Size> runs;
+    for (auto it = ids.begin(); it != ids.end(); ++it)
+    {
+      Size run = lower_bound(run_names.begin(), run_names.end(), it->getIdentifier()) - run_names.begin();
+      const vector<PeptideHit>& hits = it->getHits();
+      for (Size i = 0; i < hits.size(); ++i)
+      {
+        if (!hits[i].metaValueExists("target_decoy"))
+        {
+          OPENMS_LOG_FATAL_ERROR << "Meta value 'target_decoy' does not exists, reindex the idXML file with 'PeptideIndexer' first (run-id='" << it->getIdentifier() << ", rank=" << i + 1 << " of " << hits.size() << ")!" << endl;
+          throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Meta value 'target_decoy' does not exist!");
+        }
+        scores.push_back(hits[i].getScore());
+        hit_class.push_back(targetDecoyClass_(hits[i].getMetaValue("target_decoy")));
+        charges.push_back(hits[i].getCharge());
+        runs.push_back(run);
+      }
+    }
+
+    vector<bool> rescored, keep;
+    calculatePSMFDRs_(scores, hit_class, runs, run_names, charges, higher_score_better, rescored, keep);
+
+    // write the results back, removing the dropped hits
+    Size h = 0;
+    for (auto it = ids.begin(); it != ids.end(); ++it)
+    {
+      String score_type = it->getScoreType() + "_score";
+      vector<PeptideHit> hits;
+      for (auto pit = it->getHits().begin(); pit != it->getHits().end(); ++pit, ++h)
+      {
+        if (!keep[h])
+        {
+          continue;
+        }
+        hits.push_back(*pit);
+        if (rescored[h])
+        {
+          hits.back().setMetaValue(score_type, pit->getScore());
+          hits.back().setScore(scores[h]);
+        }
+      }
+      it->getHits().swap(hits);
+    }
 
     // higher-score-better can be set now, calculations are finished
     for (vector<PeptideIdentification>::iterator it = ids.begin(); it != ids.end(); ++it)
@@ -345,6 +302,82 @@ namespace OpenMS
     return;
   }
 
+  void FalseDiscoveryRate::apply(PSMTable& psms) const
+  {
+    bool q_value = !param_.getValue("no_qvalues").toBool();
+    bool use_all_hits = param_.getValue("use_all_hits").toBool();
+
+    if (psms.empty())
+    {
+      OPENMS_LOG_WARN << "No peptide identifications given to FalseDiscoveryRate! No calculation performed.\n";
+      return;
+    }
+
+    static const MetaValueKey target_decoy_key("target_decoy");
+    bool higher_score_better = psms.isHigherScoreBetter(0);
+
+    psms.sortHits();
+    if (!use_all_hits)
+    {
+      vector<bool> keep(psms.getNrHits(), false);
+      for (Size i = 0; i < psms.getNrIdentifications(); ++i)
+      {
+        if (psms.getHitsBegin(i) != psms.getHitsEnd(i)) keep[psms.getHitsBegin(i)] = true;
+      }
+      psms.filterHits(keep);
+    }
+
+    set<String> identifiers;
+    for (Size i = 0; i < psms.getNrIdentifications(); ++i)
+    {
+      identifiers.insert(psms.getIdentifier(i));
+    }
+    vector<String> run_names(identifiers.begin(), identifiers.end());
+
+    // gather the columns for the shared computation
+    vector<double> scores(psms.getNrHits());
+    vector<Int> hit_class(psms.getNrHits()), charges(psms.getNrHits());
+    vector<Size> runs(psms.getNrHits());
+    for (Size i = 0; i < psms.getNrIdentifications(); ++i)
+    {
+      Size run = lower_bound(run_names.begin(), run_names.end(), psms.getIdentifier(i)) - run_names.begin();
+      for (Size h = psms.getHitsBegin(i); h < psms.getHitsEnd(i); ++h)
+      {
+        if (!psms.hitMetaValueExists(h, target_decoy_key))
+        {
+          OPENMS_LOG_FATAL_ERROR << "Meta value 'target_decoy' does not exists, reindex the idXML file with 'PeptideIndexer' first (run-id='" << psms.getIdentifier(i) << ", rank=" << h - psms.getHitsBegin(i) + 1 << " of " << psms.getHitsEnd(i) - psms.getHitsBegin(i) << ")!" << endl;
+          throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Meta value 'target_decoy' does not exist!");
+        }
+        scores[h] = psms.getScore(h);
+        hit_class[h] = targetDecoyClass_(psms.getHitMetaValue(h, target_decoy_key).toString());
+        charges[h] = psms.getCharge(h);
+        runs[h] = run;
+      }
+    }
+
+    vector<bool> rescored, keep;
+    calculatePSMFDRs_(scores, hit_class, runs, run_names, charges, higher_score_better, rescored, keep);
+
+    for (Size h = 0; h < psms.getNrHits(); ++h)
+    {
+      if (rescored[h])
+      {
+        UInt score_key = MetaInfoInterface::metaRegistry().registerName(psms.getScoreType(psms.getIdentificationIndex(h)) + "_score");
+        psms.setHitMetaValue(h, score_key, psms.getScore(h));
+        psms.setScore(h, scores[h]);
+      }
+    }
+    psms.filterHits(keep);
+
+    // higher-score-better can be set now, calculations are finished
+    for (Size i = 0; i < psms.getNrIdentifications(); ++i)
+    {
+      psms.setScoreType(i, q_value ? "q-value" : "FDR");
+      psms.setHigherScoreBetter(i, false);
+    }
+    psms.assignRanks();
+  }
+
   void FalseDiscoveryRate::apply(vector<PeptideIdentification>& fwd_ids, vector<PeptideIdentification>& rev_ids) const
   {
     if (fwd_ids.empty() || rev_ids.empty())
@@ -0,0 +1,474 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/ANALYSIS/ID/FragmentIndex.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <numeric>
+
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+using namespace std;
+
+namespace OpenMS
+{
+
+  namespace
+  {
+    const char FRAGMENT_INDEX_MAGIC[8] = {'O', 'M', 'S', 'F', 'R', 'A', 'G', 'I'};
+    const UInt64 FRAGMENT_INDEX_VERSION = 1;
+
+    static_assert(sizeof(FragmentIndex::Fragment) == 8, "unexpected padding of FragmentIndex records");
+
+    /// Header of stored indices, followed by the bin offsets and the fragments
+    struct FragmentIndexHeader
+    {
+      char magic[8];
+      UInt64 version;
+      UInt64 key;
+      double bin_size;
+      UInt64 nr_entries;
+      UInt64 nr_bins;
+      UInt64 nr_fragments;
+    };
+
+    /// Throws Exception::ParseError if the data of a stored index refers to fragments or entries that do not exist
+    void checkRanges(const FragmentIndexHeader& header, const UInt64* bin_offsets, const FragmentIndex::Fragment* fragments, const String& filename)
+    {
+      if (bin_offsets[0] != 0 || bin_offsets[header.nr_bins] != header.nr_fragments)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Inconsistent bin offsets in fragment index file: " + filename);
+      }
+      for (UInt64 i = 0; i < header.nr_bins; ++i)
+      {
+        if (bin_offsets[i] > bin_offsets[i + 1])
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String(i), "Inconsistent bin offsets in fragment index file: " + filename);
+        }
+      }
+      for (UInt64 i = 0; i < header.nr_fragments; ++i)
+      {
+        if (fragments[i].entry >= header.nr_entries)
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String(i), "Entry index out of range in fragment index file: " + filename);
+        }
+      }
+    }
+
+    bool hasLowerEntry(const FragmentIndex::Fragment& a, const FragmentIndex::Fragment& b)
+    {
+      if (a.entry != b.entry) return a.entry < b.entry;
+      return a.mz < b.mz;
+    }
+  }
+
+  FragmentIndex::FragmentIndex(double bin_size) :
+    bin_size_(bin_size),
+    built_(false),
+    nr_entries_(0)
+  {
+    if (!(bin_size_ > 0.0))
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Fragment bin size needs to be positive.", String(bin_size));
+    }
+    useOwnData_();
+  }
+
+  FragmentIndex::FragmentIndex(const FragmentIndex& rhs)
+  {
+    *this = rhs;
+  }
+
+  FragmentIndex& FragmentIndex::operator=(const FragmentIndex& rhs)
+  {
+    if (this == &rhs) return *this;
+
+    bin_size_ = rhs.bin_size_;
+    built_ = rhs.built_;
+    nr_entries_ = rhs.nr_entries_;
+    bin_offsets_ = rhs.bin_offsets_;
+    fragments_ = rhs.fragments_;
+    mapped_file_ = rhs.mapped_file_;
+    if (mapped_file_)
+    {
+      // copies share the mapping
+      bin_offsets_data_ = rhs.bin_offsets_data_;
+      nr_bins_ = rhs.nr_bins_;
+      fragments_data_ = rhs.fragments_data_;
+      nr_fragments_ = rhs.nr_fragments_;
+    }
+    else
+    {
+      useOwnData_();
+    }
+    return *this;
+  }
+
+  FragmentIndex::~FragmentIndex()
+  {
+  }
+
+  void FragmentIndex::useOwnData_()
+  {
+    if (bin_offsets_.empty()) bin_offsets_.push_back(0);
+    bin_offsets_data_ = bin_offsets_.data();
+    nr_bins_ = bin_offsets_.size() - 1;
+    fragments_data_ = fragments_.data();
+    nr_fragments_ = fragments_.size();
+  }
+
+  void FragmentIndex::build(const PeptideDatabase& peptide_db,
+                            const vector<FASTAFile::FASTAEntry>& fasta_db,
+                            const TheoreticalSpectrumGenerator& spectrum_generator,
+                            const ModifiedPeptideGenerator::MapToResidueType& fixed_modifications,
+                            const ModifiedPeptideGenerator::MapToResidueType& variable_modifications,
+                            Size max_variable_mods_per_peptide)
+  {
+    if (peptide_db.size() > (Size)numeric_limits<UInt32>::max())
+    {
+      throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, peptide_db.size());
+    }
+
+    // group the entries by peptide, so the modified variants of each peptide are generated only once
+    vector<UInt32> by_peptide(peptide_db.size());
+    iota(by_peptide.begin(), by_peptide.end(), 0);
+    sort(by_peptide.begin(), by_peptide.end(), [&peptide_db](UInt32 a, UInt32 b)
+    {
+      const PeptideDatabase::Entry& ea = peptide_db.getEntry(a);
+      const PeptideDatabase::Entry& eb = peptide_db.getEntry(b);
+      return ea.peptide != eb.peptide ? ea.peptide < eb.peptide : ea.modification < eb.modification;
+    });
+    vector<Size> groups;
+    for (Size i = 0; i < by_peptide.size(); ++i)
+    {
+      if (i == 0 || peptide_db.getEntry(by_peptide[i]).peptide != peptide_db.getEntry(by_peptide[i - 1]).peptide) { groups.push_back(i); }
+    }
+    groups.push_back(by_peptide.size());
+
+    // generate the fragments into one buffer per thread (no locking)
+#ifdef _OPENMP
+    vector<vector<Fragment> > thread_fragments(omp_get_max_threads());
+#else
+    vector<vector<Fragment> > thread_fragments(1);
+#endif
+
+#pragma omp parallel for schedule(dynamic, 100)
+    for (SignedSize group = 0; group < (SignedSize)groups.size() - 1; ++group)
+    {
+#ifdef _OPENMP
+      vector<Fragment>& fragments = thread_fragments[omp_get_thread_num()];
+#else
+      vector<Fragment>& fragments = thread_fragments[0];
+#endif
+      vector<AASequence> variants;
+      peptide_db.getModifiedVariants(fasta_db, peptide_db.getEntry(by_peptide[groups[group]]).peptide,
+        fixed_modifications, variable_modifications, max_variable_mods_per_peptide, variants);
+
+      PeakSpectrum theo_spectrum;
+      for (Size i = groups[group]; i < groups[group + 1]; ++i)
+      {
+        theo_spectrum.clear(true);
+        spectrum_generator.getSpectrum(theo_spectrum, variants[peptide_db.getEntry(by_peptide[i]).modification], 1, 1);
+        for (const Peak1D& peak : theo_spectrum)
+        {
+          Fragment f;
+          f.mz = (float)peak.getMZ();
+          f.entry = by_peptide[i];
+          fragments.push_back(f);
+        }
+      }
+    }
+    vector<UInt32>().swap(by_peptide);
+
+    // counting sort of the fragments into their bins
+    float max_mz = 0.0;
+    Size nr_fragments = 0;
+    for (const vector<Fragment>& fragments : thread_fragments)
+    {
+      for (const Fragment& f : fragments) { max_mz = max(max_mz, f.mz); }
+      nr_fragments += fragments.size();
+    }
+    const Size nr_bins = (Size)(max_mz / bin_size_) + 1;
+    auto getBin = [this, nr_bins](float mz) { return mz <= 0 ? 0 : min((Size)(mz / bin_size_), nr_bins - 1); };
+    vector<UInt64> bin_offsets(nr_bins + 1, 0);
+    vector<Fragment> all_fragments(nr_fragments);
+    for (const vector<Fragment>& fragments : thread_fragments)
+    {
+      for (const Fragment& f : fragments) { ++bin_offsets[getBin(f.mz) + 1]; }
+    }
+    partial_sum(bin_offsets.begin(), bin_offsets.end(), bin_offsets.begin());
+    vector<UInt64> insert_pos(bin_offsets.begin(), bin_offsets.end() - 1);
+    for (vector<Fragment>& fragments : thread_fragments)
+    {
+      for (const Fragment& f : fragments) { all_fragments[insert_pos[getBin(f.mz)]++] = f; }
+      vector<Fragment>().swap(fragments);
+    }
+
+    // the order inside a bin depends on the thread scheduling - sort by entry (i.e. by mass)
+#pragma omp parallel for schedule(dynamic, 1000)
+    for (SignedSize bin = 0; bin < (SignedSize)bin_offsets.size() - 1; ++bin)
+    {
+      sort(all_fragments.begin() + bin_offsets[bin], all_fragments.begin() + bin_offsets[bin + 1], hasLowerEntry);
+    }
+
+    bin_offsets_.swap(bin_offsets);
+    fragments_.swap(all_fragments);
+    nr_entries_ = peptide_db.size();
+    built_ = true;
+    mapped_file_.reset();
+    useOwnData_();
+  }
+
+  void FragmentIndex::store(const String& filename, UInt64 key) const
+  {
+    ofstream ofs(filename.c_str(), ios::out | ios::binary);
+    if (!ofs)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+
+    FragmentIndexHeader header;
+    memcpy(header.magic, FRAGMENT_INDEX_MAGIC, sizeof(header.magic));
+    header.version = FRAGMENT_INDEX_VERSION;
+    header.key = key;
+    header.bin_size = bin_size_;
+    header.nr_entries = nr_entries_;
+    header.nr_bins = nr_bins_;
+    header.nr_fragments = nr_fragments_;
+
+    ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    ofs.write(reinterpret_cast<const char*>(bin_offsets_data_), (header.nr_bins + 1) * sizeof(UInt64));
+    ofs.write(reinterpret_cast<const char*>(fragments_data_), header.nr_fragments * sizeof(Fragment));
+    ofs.close();
+    if (!ofs)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+  }
+
+  bool FragmentIndex::load(const String& filename, UInt64 key, Size nr_entries, bool memory_map)
+  {
+    if (!File::exists(filename)) return false;
+
+    ifstream ifs(filename.c_str(), ios::in | ios::binary);
+    if (!ifs)
+    {
+      throw Exception::FileNotReadable(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+
+    FragmentIndexHeader header;
+    if (!ifs.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        memcmp(header.magic, FRAGMENT_INDEX_MAGIC, sizeof(header.magic)) != 0)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Not a fragment index file: " + filename);
+    }
+    // also rejects files written with a different byte order
+    if (header.version != FRAGMENT_INDEX_VERSION || header.key != key || header.bin_size != bin_size_) return false;
+    if (header.nr_entries != nr_entries)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String(header.nr_entries), "Unexpected number of entries in fragment index file: " + filename);
+    }
+
+    // the record counts are checked against the file size before computing the section sizes (which could overflow)
+    ifs.seekg(0, ios::end);
+    const UInt64 file_size = ifs.tellg();
+    if (header.nr_bins >= file_size / sizeof(UInt64) || header.nr_fragments > file_size / sizeof(Fragment) ||
+        file_size != sizeof(header) + (header.nr_bins + 1) * sizeof(UInt64) + header.nr_fragments * sizeof(Fragment))
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Truncated or corrupt fragment index file: " + filename);
+    }
+    const UInt64 fragments_offset = sizeof(header) + (header.nr_bins + 1) * sizeof(UInt64);
+
+    if (memory_map)
+    {
+      boost::shared_ptr<boost::iostreams::mapped_file_source> mapped_file;
+      try
+      {
+        mapped_file = boost::shared_ptr<boost::iostreams::mapped_file_source>(new boost::iostreams::mapped_file_source(filename));
+      }
+      catch (std::exception& e)
+      {
+        throw Exception::FileNotReadable(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename + " (memory mapping failed: " + e.what() + ")");
+      }
+      const char* data = mapped_file->data();
+      checkRanges(header, reinterpret_cast<const UInt64*>(data + sizeof(header)), reinterpret_cast<const Fragment*>(data + fragments_offset), filename);
+
+      bin_offsets_.clear();
+      fragments_.clear();
+      mapped_file_ = mapped_file;
+      bin_offsets_data_ = reinterpret_cast<const UInt64*>(data + sizeof(header));
+      nr_bins_ = header.nr_bins;
+      fragments_data_ = reinterpret_cast<const Fragment*>(data + fragments_offset);
+      nr_fragments_ = header.nr_fragments;
+      nr_entries_ = header.nr_entries;
+      built_ = true;
+      return true;
+    }
+
+    vector<UInt64> bin_offsets(header.nr_bins + 1);
+    vector<Fragment> fragments(header.nr_fragments);
+    ifs.seekg(sizeof(header));
+    ifs.read(reinterpret_cast<char*>(bin_offsets.data()), bin_offsets.size() * sizeof(UInt64));
+    ifs.read(reinterpret_cast<char*>(fragments.data()), fragments.size() * sizeof(Fragment));
+    if (!ifs)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Error while reading fragment index file: " + filename);
+    }
+    checkRanges(header, bin_offsets.data(), fragments.data(), filename);
+
+    bin_offsets_.swap(bin_offsets);
+    fragments_.swap(fragments);
+    nr_entries_ = header.nr_entries;
+    built_ = true;
+    mapped_file_.reset();
+    useOwnData_();
+    return true;
+  }
+
+  bool FragmentIndex::isMemoryMapped() const
+  {
+    return mapped_file_ != nullptr;
+  }
+
+  double FragmentIndex::getBinSize() const
+  {
+    return bin_size_;
+  }
+
+  Size FragmentIndex::size() const
+  {
+    return nr_entries_;
+  }
+
+  Size FragmentIndex::getNrFragments() const
+  {
+    return nr_fragments_;
+  }
+
+  Size FragmentIndex::getBin_(double mz) const
+  {
+    if (mz <= 0.0) return 0;
+    return min((Size)(mz / bin_size_), nr_bins_ - 1);
+  }
+
+  void FragmentIndex::query(const PeakSpectrum& spectrum,
+                            Size entry_first,
+                            Size entry_last,
+                            double fragment_mass_tolerance,
+                            bool fragment_mass_tolerance_unit_ppm,
+                            Size min_shared_peaks,
+                            Size max_candidates,
+                            vector<Candidate>& candidates,
+                            vector<UInt32>& workspace) const
+  {
+    if (!built_)
+    {
+      throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "FragmentIndex::build() or load() needs to be called before querying the index.");
+    }
+    candidates.clear();
+
+    entry_last = min(entry_last, nr_entries_);
+    if (entry_first >= entry_last || nr_bins_ == 0) return;
+
+    // per entry in the range: number of shared peaks and (1-based) index of
+    // the last peak that matched, so a peak is counted at most once per entry
+    const Size nr_range = entry_last - entry_first;
+    if (workspace.size() < 2 * nr_range)
+    {
+      workspace.resize(2 * nr_range, 0);
+    }
+    vector<UInt32> touched;
+    const double max_indexed_mz = nr_bins_ * bin_size_;
+
+    for (Size i = 0; i < spectrum.size(); ++i)
+    {
+      const double mz = spectrum[i].getMZ();
+      const double tolerance = fragment_mass_tolerance_unit_ppm ? mz * fragment_mass_tolerance * 1e-6 : fragment_mass_tolerance;
+      if (mz - tolerance >= max_indexed_mz) continue; // beyond the heaviest fragment
+      const Size bin_last = getBin_(mz + tolerance);
+      const UInt32 peak_mark = (UInt32)i + 1;
+      for (Size bin = getBin_(mz - tolerance); bin <= bin_last; ++bin)
+      {
+        const Fragment* end = fragments_data_ + bin_offsets_data_[bin + 1];
+        const Fragment* it = lower_bound(fragments_data_ + bin_offsets_data_[bin], end, entry_first,
+          [](const Fragment& f, Size entry) { return f.entry < entry; });
+        for (; it != end && it->entry < entry_last; ++it)
+        {
+          if (fabs(it->mz - mz) > tolerance) continue;
+          const UInt32 e = it->entry - (UInt32)entry_first;
+          UInt32& count = workspace[2 * e];
+          UInt32& last_peak = workspace[2 * e + 1];
+          if (last_peak == peak_mark) continue;
+          if (count == 0) touched.push_back(e);
+          ++count;
+          last_peak = peak_mark;
+        }
+      }
+    }
+
+    for (UInt32 e : touched)
+    {
+      if (workspace[2 * e] >= min_shared_peaks)
+      {
+        Candidate c;
+        c.entry = entry_first + e;
+        c.shared_peaks = workspace[2 * e];
+        candidates.push_back(c);
+      }
+      workspace[2 * e] = 0;
+      workspace[2 * e + 1] = 0;
+    }
+
+    // keep the candidates with the most shared peaks (lower entries, i.e. lighter peptides, first on ties)
+    auto more_shared_peaks = [](const Candidate& a, const Candidate& b)
+    {
+      return a.shared_peaks != b.shared_peaks ? a.shared_peaks > b.shared_peaks : a.entry < b.entry;
+    };
+    Size n = min(max_candidates, candidates.size());
+    partial_sort(candidates.begin(), candidates.begin() + n, candidates.end(), more_shared_peaks);
+    candidates.resize(n);
+  }
+
+} // namespace OpenMS
@@ -35,6 +35,8 @@
 #include <OpenMS/ANALYSIS/ID/IDMapper.h>
 #include <OpenMS/MATH/MISC/MathFunctions.h>
 
+#include <boost/math/special_functions/fpclassify.hpp>
+
 using namespace std;
 
 namespace OpenMS
@@ -508,6 +510,37 @@ namespace OpenMS
     // cout << "Starting annotation..." << endl;
     checkHits_(ids); // check RT and m/z are present
 
+    vector<Size> unidentified = mapPrecursorsToIdentifications(spectra, ids).unidentified;
+    annotateFeatures_(map, ids.size(), [&ids](Size i) -> const PeptideIdentification& { return ids[i]; },
+                      protein_ids, use_centroid_rt, use_centroid_mz, spectra, unidentified);
+  }
+
+  void IDMapper::annotate(FeatureMap& map, const PSMTable& psms, const vector<ProteinIdentification>& protein_ids,
+                          bool use_centroid_rt, bool use_centroid_mz)
+  {
+    for (Size i = 0; i < psms.getNrIdentifications(); ++i)
+    {
+      if (boost::math::isnan(psms.getRT(i)))
+      {
+        throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "IDMapper: 'RT' information missing for peptide identification!");
+      }
+      if (boost::math::isnan(psms.getMZ(i)))
+      {
+        throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "IDMapper: 'MZ' information missing for peptide identification!");
+      }
+    }
+
+    // identifications are materialized one at a time, only when they are needed
+    PeptideIdentification buffer;
+    annotateFeatures_(map, psms.getNrIdentifications(),
+                      [&psms, &buffer](Size i) -> const PeptideIdentification& { psms.getIdentification(i, buffer); return buffer; },
+                      protein_ids, use_centroid_rt, use_centroid_mz, PeakMap(), vector<Size>());
+  }
+
+  void IDMapper::annotateFeatures_(FeatureMap& map, Size nr_ids, const std::function<const PeptideIdentification&(Size)>& get_id,
+                                   const vector<ProteinIdentification>& protein_ids, bool use_centroid_rt, bool use_centroid_mz,
+                                   const PeakMap& spectra, const vector<Size>& unidentified)
+  {
     // append protein identifications
     map.getProteinIdentifications().insert(map.getProteinIdentifications().end(), protein_ids.begin(), protein_ids.end());
 
@@ -600,21 +633,20 @@ namespace OpenMS
 
     // cout << "Finding matches..." << endl;
     // iterate over peptide IDs:
-    for (vector<PeptideIdentification>::const_iterator id_it =
-         ids.begin(); id_it != ids.end(); ++id_it)
+    for (Size id_index = 0; id_index < nr_ids; ++id_index)
     {
-      // cout << "Peptide ID: " << id_it - ids.begin() << endl;
+      const PeptideIdentification& id = get_id(id_index);
 
-      if (id_it->getHits().empty()) continue;
+      if (id.getHits().empty()) continue;
 
       DoubleList mz_values;
       double rt_value;
       IntList charges;
-      getIDDetails_(*id_it, rt_value, mz_values, charges, use_avg_mass);
+      getIDDetails_(id, rt_value, mz_values, charges, use_avg_mass);
 
       if ((rt_value < min_rt) || (rt_value > max_rt)) // RT out of bounds
       {
-        map.getUnassignedPeptideIdentifications().push_back(*id_it);
+        map.getUnassignedPeptideIdentifications().push_back(id);
         ++matches_none;
         continue;
       }
@@ -653,7 +685,7 @@ namespace OpenMS
             {
               // only one m/z value to check, which was already incorporated
               // into the overall bounding box -> success!
-              feat.getPeptideIdentifications().push_back(*id_it);
+              feat.getPeptideIdentifications().push_back(id);
               ++matching_features;
               break;                     // "mz_it" loop
             }
@@ -672,7 +704,7 @@ namespace OpenMS
               increaseBoundingBox_(box);
               if (box.encloses(id_pos)) // success!
               {
-                feat.getPeptideIdentifications().push_back(*id_it);
+                feat.getPeptideIdentifications().push_back(id);
                 ++matching_features;
                 found_match = true;
                 break; // "ch_it" loop
@@ -684,7 +716,7 @@ namespace OpenMS
       }
       if (matching_features == 0)
       {
-        map.getUnassignedPeptideIdentifications().push_back(*id_it);
+        map.getUnassignedPeptideIdentifications().push_back(id);
         ++matches_none;
       }
       else if (matching_features == 1)
@@ -697,8 +729,6 @@ namespace OpenMS
       }
     }
 
-    vector<Size> unidentified = mapPrecursorsToIdentifications(spectra, ids).unidentified;
-
     // map all unidentified precursor to features
     Size spectrum_matches_none(0);
     Size spectrum_matches(0);
@@ -0,0 +1,519 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/ANALYSIS/ID/PeptideDatabase.h>
+
+#include <OpenMS/CHEMISTRY/AASequence.h>
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/regex.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+
+using namespace std;
+
+namespace OpenMS
+{
+
+  namespace
+  {
+    const char PEPTIDE_DATABASE_MAGIC[8] = {'O', 'M', 'S', 'P', 'E', 'P', 'D', 'B'};
+    const UInt64 PEPTIDE_DATABASE_VERSION = 1;
+
+    static_assert(sizeof(PeptideDatabase::Entry) == 16 && sizeof(PeptideDatabase::Peptide) == 12, "unexpected padding of PeptideDatabase records");
+
+    /// Header of stored databases, followed by the entries, peptides, protein offsets and proteins
+    struct PeptideDatabaseHeader
+    {
+      char magic[8];
+      UInt64 version;
+      UInt64 key;
+      UInt64 nr_entries;
+      UInt64 nr_peptides;
+      UInt64 nr_proteins;
+    };
+
+    /// Byte offsets of the sections of a stored database (each section aligned to 8 bytes)
+    struct PeptideDatabaseLayout
+    {
+      explicit PeptideDatabaseLayout(const PeptideDatabaseHeader& h)
+      {
+        entries = sizeof(PeptideDatabaseHeader);
+        peptides = entries + h.nr_entries * sizeof(PeptideDatabase::Entry);
+        protein_offsets = align(peptides + h.nr_peptides * sizeof(PeptideDatabase::Peptide));
+        proteins = protein_offsets + (h.nr_peptides + 1) * sizeof(UInt64);
+        end = proteins + h.nr_proteins * sizeof(UInt32);
+      }
+
+      static UInt64 align(UInt64 offset)
+      {
+        return (offset + 7) / 8 * 8;
+      }
+
+      UInt64 entries, peptides, protein_offsets, proteins, end;
+    };
+
+    /// 64 bit FNV-1a hash, updated with @p size bytes at @p data
+    void hashBytes(UInt64& hash, const char* data, Size size)
+    {
+      for (Size i = 0; i < size; ++i)
+      {
+        hash ^= (unsigned char)data[i];
+        hash *= 1099511628211ULL;
+      }
+    }
+
+    void hashString(UInt64& hash, const String& s)
+    {
+      hashBytes(hash, s.c_str(), s.size() + 1); // including the terminator, so "ab"+"c" != "a"+"bc"
+    }
+
+    /// Throws Exception::ParseError if the data of a stored database refers to peptides, proteins or sequence positions that do not exist
+    void checkRanges(const vector<FASTAFile::FASTAEntry>& fasta_db, const PeptideDatabaseHeader& header,
+                     const PeptideDatabase::Entry* entries, const PeptideDatabase::Peptide* peptides,
+                     const UInt64* protein_offsets, const UInt32* proteins, const String& filename)
+    {
+      for (UInt64 i = 0; i < header.nr_peptides; ++i)
+      {
+        const PeptideDatabase::Peptide& p = peptides[i];
+        if (p.protein >= fasta_db.size() || (UInt64)p.offset + p.length > fasta_db[p.protein].sequence.size())
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String(i), "Peptide out of range in peptide database file: " + filename);
+        }
+      }
+      if (protein_offsets[0] != 0 || protein_offsets[header.nr_peptides] != header.nr_proteins)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Inconsistent protein offsets in peptide database file: " + filename);
+      }
+      for (UInt64 i = 0; i < header.nr_peptides; ++i)
+      {
+        if (protein_offsets[i] > protein_offsets[i + 1])
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String(i), "Inconsistent protein offsets in peptide database file: " + filename);
+        }
+      }
+      for (UInt64 i = 0; i < header.nr_proteins; ++i)
+      {
+        if (proteins[i] >= fasta_db.size())
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String(i), "Protein index out of range in peptide database file: " + filename);
+        }
+      }
+      for (UInt64 i = 0; i < header.nr_entries; ++i)
+      {
+        if (entries[i].peptide >= header.nr_peptides)
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String(i), "Peptide index out of range in peptide database file: " + filename);
+        }
+      }
+    }
+
+    void generateVariants(const String& sequence,
+                          const ModifiedPeptideGenerator::MapToResidueType& fixed_modifications,
+                          const ModifiedPeptideGenerator::MapToResidueType& variable_modifications,
+                          Size max_variable_mods_per_peptide,
+                          vector<AASequence>& variants)
+    {
+      variants.clear();
+      AASequence aas = AASequence::fromString(sequence);
+      ModifiedPeptideGenerator::applyFixedModifications(fixed_modifications, aas);
+      ModifiedPeptideGenerator::applyVariableModifications(variable_modifications, aas, max_variable_mods_per_peptide, variants);
+    }
+
+    bool hasLowerMass(const PeptideDatabase::Entry& a, const PeptideDatabase::Entry& b)
+    {
+      if (a.mass != b.mass) return a.mass < b.mass;
+      if (a.peptide != b.peptide) return a.peptide < b.peptide;
+      return a.modification < b.modification;
+    }
+  }
+
+  PeptideDatabase::PeptideDatabase()
+  {
+    useOwnData_();
+  }
+
+  PeptideDatabase::PeptideDatabase(const PeptideDatabase& rhs)
+  {
+    *this = rhs;
+  }
+
+  PeptideDatabase& PeptideDatabase::operator=(const PeptideDatabase& rhs)
+  {
+    if (this == &rhs) return *this;
+
+    entries_ = rhs.entries_;
+    peptides_ = rhs.peptides_;
+    protein_offsets_ = rhs.protein_offsets_;
+    proteins_ = rhs.proteins_;
+    mapped_file_ = rhs.mapped_file_;
+    if (mapped_file_)
+    {
+      // copies share the mapping
+      entries_data_ = rhs.entries_data_;
+      nr_entries_ = rhs.nr_entries_;
+      peptides_data_ = rhs.peptides_data_;
+      nr_peptides_ = rhs.nr_peptides_;
+      protein_offsets_data_ = rhs.protein_offsets_data_;
+      proteins_data_ = rhs.proteins_data_;
+    }
+    else
+    {
+      useOwnData_();
+    }
+    return *this;
+  }
+
+  PeptideDatabase::~PeptideDatabase()
+  {
+  }
+
+  void PeptideDatabase::useOwnData_()
+  {
+    if (protein_offsets_.empty()) protein_offsets_.push_back(0);
+    entries_data_ = entries_.data();
+    nr_entries_ = entries_.size();
+    peptides_data_ = peptides_.data();
+    nr_peptides_ = peptides_.size();
+    protein_offsets_data_ = protein_offsets_.data();
+    proteins_data_ = proteins_.data();
+  }
+
+  UInt64 PeptideDatabase::computeKey(const vector<FASTAFile::FASTAEntry>& fasta_db, const StringList& settings)
+  {
+    UInt64 hash = 14695981039346656037ULL;
+    hashBytes(hash, reinterpret_cast<const char*>(&PEPTIDE_DATABASE_VERSION), sizeof(PEPTIDE_DATABASE_VERSION));
+    for (const FASTAFile::FASTAEntry& entry : fasta_db)
+    {
+      hashString(hash, entry.identifier);
+      hashString(hash, entry.sequence);
+    }
+    for (const String& setting : settings)
+    {
+      hashString(hash, setting);
+    }
+    return hash;
+  }
+
+  void PeptideDatabase::build(const vector<FASTAFile::FASTAEntry>& fasta_db,
+                              const ProteaseDigestion& digestor,
+                              Size min_size,
+                              Size max_size,
+                              const ModifiedPeptideGenerator::MapToResidueType& fixed_modifications,
+                              const ModifiedPeptideGenerator::MapToResidueType& variable_modifications,
+                              Size max_variable_mods_per_peptide,
+                              const String& peptide_motif)
+  {
+    if (fasta_db.size() > (Size)numeric_limits<UInt32>::max())
+    {
+      throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, fasta_db.size());
+    }
+    boost::regex peptide_motif_regex(peptide_motif);
+
+    // digest all proteins: (start, length) of the valid peptides
+    vector<vector<pair<Size, Size> > > digests(fasta_db.size());
+#pragma omp parallel for schedule(dynamic, 100)
+    for (SignedSize fasta_index = 0; fasta_index < (SignedSize)fasta_db.size(); ++fasta_index)
+    {
+      const String& sequence = fasta_db[fasta_index].sequence;
+      vector<pair<Size, Size> > current_digest;
+      digestor.digestUnmodified(sequence, current_digest, min_size, max_size);
+      for (const pair<Size, Size>& c : current_digest)
+      {
+        const String current_peptide = sequence.substr(c.first, c.second);
+        if (current_peptide.find_first_of("XBZ") != std::string::npos) { continue; }
+
+        // if a peptide motif is provided skip all peptides without match
+        if (!peptide_motif.empty() && !boost::regex_match(current_peptide, peptide_motif_regex)) { continue; }
+
+        digests[fasta_index].push_back(c);
+      }
+    }
+
+    // unique peptides (in order of their first occurrence) and the proteins containing them
+    vector<Peptide> peptides;
+    vector<vector<UInt32> > peptide_proteins;
+    map<StringView, UInt32> peptide_indices;
+    for (Size fasta_index = 0; fasta_index < fasta_db.size(); ++fasta_index)
+    {
+      const StringView sequence(fasta_db[fasta_index].sequence);
+      for (const pair<Size, Size>& c : digests[fasta_index])
+      {
+        pair<map<StringView, UInt32>::iterator, bool> it = peptide_indices.insert(make_pair(sequence.substr(c.first, c.second), (UInt32)peptides.size()));
+        if (it.second)
+        {
+          if (peptides.size() == (Size)numeric_limits<UInt32>::max())
+          {
+            throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, peptides.size());
+          }
+          Peptide p;
+          p.protein = (UInt32)fasta_index;
+          p.offset = (UInt32)c.first;
+          p.length = (UInt32)c.second;
+          peptides.push_back(p);
+          peptide_proteins.push_back(vector<UInt32>());
+        }
+        vector<UInt32>& proteins = peptide_proteins[it.first->second];
+        if (proteins.empty() || proteins.back() != fasta_index) proteins.push_back((UInt32)fasta_index);
+      }
+      vector<pair<Size, Size> >().swap(digests[fasta_index]);
+    }
+    peptide_indices.clear();
+
+    // masses of all modification variants
+    vector<vector<double> > variant_masses(peptides.size());
+#pragma omp parallel for schedule(dynamic, 1000)
+    for (SignedSize peptide_index = 0; peptide_index < (SignedSize)peptides.size(); ++peptide_index)
+    {
+      const Peptide& p = peptides[peptide_index];
+      vector<AASequence> all_modified_peptides;
+      generateVariants(fasta_db[p.protein].sequence.substr(p.offset, p.length), fixed_modifications, variable_modifications, max_variable_mods_per_peptide, all_modified_peptides);
+
+      for (const AASequence& candidate : all_modified_peptides)
+      {
+        variant_masses[peptide_index].push_back(candidate.getMonoWeight());
+      }
+    }
+
+    entries_.clear();
+    for (Size peptide_index = 0; peptide_index < peptides.size(); ++peptide_index)
+    {
+      for (Size mod_index = 0; mod_index < variant_masses[peptide_index].size(); ++mod_index)
+      {
+        Entry e;
+        e.mass = variant_masses[peptide_index][mod_index];
+        e.peptide = (UInt32)peptide_index;
+        e.modification = (UInt32)mod_index;
+        entries_.push_back(e);
+      }
+    }
+    sort(entries_.begin(), entries_.end(), hasLowerMass);
+
+    peptides_.swap(peptides);
+    protein_offsets_.assign(1, 0);
+    proteins_.clear();
+    for (const vector<UInt32>& proteins : peptide_proteins)
+    {
+      proteins_.insert(proteins_.end(), proteins.begin(), proteins.end());
+      protein_offsets_.push_back(proteins_.size());
+    }
+
+    mapped_file_.reset();
+    useOwnData_();
+  }
+
+  void PeptideDatabase::store(const String& filename, UInt64 key) const
+  {
+    ofstream ofs(filename.c_str(), ios::out | ios::binary);
+    if (!ofs)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+
+    PeptideDatabaseHeader header;
+    memcpy(header.magic, PEPTIDE_DATABASE_MAGIC, sizeof(header.magic));
+    header.version = PEPTIDE_DATABASE_VERSION;
+    header.key = key;
+    header.nr_entries = nr_entries_;
+    header.nr_peptides = nr_peptides_;
+    header.nr_proteins = protein_offsets_data_[nr_peptides_];
+    const PeptideDatabaseLayout layout(header);
+
+    const char padding[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    ofs.write(reinterpret_cast<const char*>(entries_data_), header.nr_entries * sizeof(Entry));
+    ofs.write(reinterpret_cast<const char*>(peptides_data_), header.nr_peptides * sizeof(Peptide));
+    ofs.write(padding, layout.protein_offsets - (layout.peptides + header.nr_peptides * sizeof(Peptide)));
+    ofs.write(reinterpret_cast<const char*>(protein_offsets_data_), (header.nr_peptides + 1) * sizeof(UInt64));
+    ofs.write(reinterpret_cast<const char*>(proteins_data_), header.nr_proteins * sizeof(UInt32));
+    ofs.close();
+    if (!ofs)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+  }
+
+  bool PeptideDatabase::load(const String& filename, UInt64 key, const vector<FASTAFile::FASTAEntry>& fasta_db, bool memory_map)
+  {
+    if (!File::exists(filename)) return false;
+
+    ifstream ifs(filename.c_str(), ios::in | ios::binary);
+    if (!ifs)
+    {
+      throw Exception::FileNotReadable(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+
+    PeptideDatabaseHeader header;
+    if (!ifs.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        memcmp(header.magic, PEPTIDE_DATABASE_MAGIC, sizeof(header.magic)) != 0)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Not a peptide database file: " + filename);
+    }
+    // also rejects files written with a different byte order
+    if (header.version != PEPTIDE_DATABASE_VERSION || header.key != key) return false;
+
+    // the record counts are checked against the file size before computing the layout (which could overflow)
+    ifs.seekg(0, ios::end);
+    const UInt64 file_size = ifs.tellg();
+    if (header.nr_entries > file_size / sizeof(Entry) || header.nr_peptides > file_size / sizeof(Peptide) ||
+        header.nr_proteins > file_size / sizeof(UInt32))
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Truncated or corrupt peptide database file: " + filename);
+    }
+    const PeptideDatabaseLayout layout(header);
+    if (file_size != layout.end)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Truncated or corrupt peptide database file: " + filename);
+    }
+
+    if (memory_map)
+    {
+      boost::shared_ptr<boost::iostreams::mapped_file_source> mapped_file;
+      try
+      {
+        mapped_file = boost::shared_ptr<boost::iostreams::mapped_file_source>(new boost::iostreams::mapped_file_source(filename));
+      }
+      catch (std::exception& e)
+      {
+        throw Exception::FileNotReadable(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename + " (memory mapping failed: " + e.what() + ")");
+      }
+      const char* data = mapped_file->data();
+      checkRanges(fasta_db, header,
+                  reinterpret_cast<const Entry*>(data + layout.entries),
+                  reinterpret_cast<const Peptide*>(data + layout.peptides),
+                  reinterpret_cast<const UInt64*>(data + layout.protein_offsets),
+                  reinterpret_cast<const UInt32*>(data + layout.proteins), filename);
+
+      entries_.clear();
+      peptides_.clear();
+      protein_offsets_.clear();
+      proteins_.clear();
+      mapped_file_ = mapped_file;
+      entries_data_ = reinterpret_cast<const Entry*>(data + layout.entries);
+      nr_entries_ = header.nr_entries;
+      peptides_data_ = reinterpret_cast<const Peptide*>(data + layout.peptides);
+      nr_peptides_ = header.nr_peptides;
+      protein_offsets_data_ = reinterpret_cast<const UInt64*>(data + layout.protein_offsets);
+      proteins_data_ = reinterpret_cast<const UInt32*>(data + layout.proteins);
+      return true;
+    }
+
+    vector<Entry> entries(header.nr_entries);
+    vector<Peptide> peptides(header.nr_peptides);
+    vector<UInt64> protein_offsets(header.nr_peptides + 1);
+    vector<UInt32> proteins(header.nr_proteins);
+    ifs.seekg(layout.entries);
+    ifs.read(reinterpret_cast<char*>(entries.data()), entries.size() * sizeof(Entry));
+    ifs.read(reinterpret_cast<char*>(peptides.data()), peptides.size() * sizeof(Peptide));
+    ifs.seekg(layout.protein_offsets);
+    ifs.read(reinterpret_cast<char*>(protein_offsets.data()), protein_offsets.size() * sizeof(UInt64));
+    ifs.read(reinterpret_cast<char*>(proteins.data()), proteins.size() * sizeof(UInt32));
+    if (!ifs)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Error while reading peptide database file: " + filename);
+    }
+    checkRanges(fasta_db, header, entries.data(), peptides.data(), protein_offsets.data(), proteins.data(), filename);
+
+    entries_.swap(entries);
+    peptides_.swap(peptides);
+    protein_offsets_.swap(protein_offsets);
+    proteins_.swap(proteins);
+    mapped_file_.reset();
+    useOwnData_();
+    return true;
+  }
+
+  bool PeptideDatabase::isMemoryMapped() const
+  {
+    return mapped_file_ != nullptr;
+  }
+
+  Size PeptideDatabase::size() const
+  {
+    return nr_entries_;
+  }
+
+  const PeptideDatabase::Entry& PeptideDatabase::getEntry(Size index) const
+  {
+    return entries_data_[index];
+  }
+
+  pair<Size, Size> PeptideDatabase::getEntries(double mass_low, double mass_high) const
+  {
+    const Entry* begin = entries_data_;
+    const Entry* end = entries_data_ + nr_entries_;
+    const Entry* first = lower_bound(begin, end, mass_low, [](const Entry& e, double mass) { return e.mass < mass; });
+    const Entry* last = upper_bound(first, end, mass_high, [](double mass, const Entry& e) { return mass < e.mass; });
+    return make_pair(Size(first - begin), Size(last - begin));
+  }
+
+  Size PeptideDatabase::getNrPeptides() const
+  {
+    return nr_peptides_;
+  }
+
+  const PeptideDatabase::Peptide& PeptideDatabase::getPeptide(Size peptide) const
+  {
+    return peptides_data_[peptide];
+  }
+
+  StringView PeptideDatabase::getSequence(const vector<FASTAFile::FASTAEntry>& fasta_db, Size peptide) const
+  {
+    const Peptide& p = peptides_data_[peptide];
+    return StringView(fasta_db[p.protein].sequence).substr(p.offset, p.length);
+  }
+
+  pair<const UInt32*, const UInt32*> PeptideDatabase::getProteins(Size peptide) const
+  {
+    return make_pair(proteins_data_ + protein_offsets_data_[peptide], proteins_data_ + protein_offsets_data_[peptide + 1]);
+  }
+
+  void PeptideDatabase::getModifiedVariants(const vector<FASTAFile::FASTAEntry>& fasta_db,
+                                            Size peptide,
+                                            const ModifiedPeptideGenerator::MapToResidueType& fixed_modifications,
+                                            const ModifiedPeptideGenerator::MapToResidueType& variable_modifications,
+                                            Size max_variable_mods_per_peptide,
+                                            vector<AASequence>& variants) const
+  {
+    const Peptide& p = peptides_data_[peptide];
+    generateVariants(fasta_db[p.protein].sequence.substr(p.offset, p.length), fixed_modifications, variable_modifications, max_variable_mods_per_peptide, variants);
+  }
+
+} // namespace OpenMS
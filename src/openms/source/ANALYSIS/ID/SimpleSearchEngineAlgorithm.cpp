@@ -36,10 +36,13 @@
 
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
 
+#include <OpenMS/ANALYSIS/ID/FragmentIndex.h>
+#include <OpenMS/ANALYSIS/ID/PeptideDatabase.h>
 #include <OpenMS/ANALYSIS/ID/PeptideIndexing.h>
 #include <OpenMS/ANALYSIS/RNPXL/ModifiedPeptideGenerator.h>
 #include <OpenMS/ANALYSIS/RNPXL/HyperScore.h>
 
+#include <OpenMS/CHEMISTRY/AASequencePool.h>
 #include <OpenMS/CHEMISTRY/ModificationsDB.h>
 #include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
 #include <OpenMS/CHEMISTRY/ResidueModification.h>
@@ -69,7 +72,9 @@
 #include <OpenMS/METADATA/SpectrumSettings.h>
 
 #include <map>
+#include <unordered_map>
 #include <algorithm>
+#include <tuple>
 
 #ifdef _OPENMP
   #include <omp.h>
@@ -136,6 +141,17 @@ namespace OpenMS
     defaults_.setValue("report:top_hits", 1, "Maximum number of top scoring hits per spectrum that are reported.");
     defaults_.setSectionDescription("report", "Reporting Options");
 
+    defaults_.setValue("database:cache", "", "Binary cache file of the digested and modified database (e.g. 'database.peptides'). It is loaded if it was built from the same database and digestion/modification settings, and (re)built otherwise. Saves the digestion in repeated searches against the same database.");
+    defaults_.setSectionDescription("database", "Database Options");
+
+    defaults_.setValue("fragment_index:enabled", "false", "Index the fragment ions of all database peptides and score each spectrum only against the peptides sharing the most fragment peaks with it (much faster for wide or open precursor mass tolerances). With a database cache (database:cache), the index is stored next to it (with suffix '.fragments') and reused.");
+    defaults_.setValidStrings("fragment_index:enabled", ListUtils::create<String>("true,false"));
+    defaults_.setValue("fragment_index:min_shared_peaks", 3, "Minimum number of spectrum peaks that need to match a fragment of a candidate peptide for it to be scored.");
+    defaults_.setMinInt("fragment_index:min_shared_peaks", 1);
+    defaults_.setValue("fragment_index:candidates", 50, "Number of candidate peptides per spectrum (those with the most shared peaks) that are scored.");
+    defaults_.setMinInt("fragment_index:candidates", 1);
+    defaults_.setSectionDescription("fragment_index", "Fragment Ion Index Options");
+
     defaultsToParam_();
   }
 
@@ -167,6 +183,12 @@ namespace OpenMS
     peptide_motif_ = param_.getValue("peptide:motif");
 
     report_top_hits_ = param_.getValue("report:top_hits");
+
+    database_cache_ = param_.getValue("database:cache");
+
+    fragment_index_enabled_ = param_.getValue("fragment_index:enabled").toBool();
+    fragment_index_min_shared_peaks_ = param_.getValue("fragment_index:min_shared_peaks");
+    fragment_index_candidates_ = param_.getValue("fragment_index:candidates");
   }
 
   // static
@@ -216,6 +238,280 @@ namespace OpenMS
     }
   }
 
+  UInt64 SimpleSearchEngineAlgorithm::getPeptideDatabase_(const vector<FASTAFile::FASTAEntry>& fasta_db,
+    const ModifiedPeptideGenerator::MapToResidueType& fixed_modifications,
+    const ModifiedPeptideGenerator::MapToResidueType& variable_modifications,
+    PeptideDatabase& peptide_db) const
+  {
+    StringList settings;
+    settings.push_back("enzyme=" + enzyme_);
+    settings.push_back("missed_cleavages=" + String(peptide_missed_cleavages_));
+    settings.push_back("min_size=" + String(peptide_min_size_));
+    settings.push_back("max_size=" + String(peptide_max_size_));
+    settings.push_back("motif=" + peptide_motif_);
+    settings.push_back("fixed=" + ListUtils::concatenate(modifications_fixed_, ";"));
+    settings.push_back("variable=" + ListUtils::concatenate(modifications_variable_, ";"));
+    settings.push_back("variable_max_per_peptide=" + String(modifications_max_variable_mods_per_peptide_));
+    UInt64 key = PeptideDatabase::computeKey(fasta_db, settings);
+
+    bool loaded = false;
+    if (!database_cache_.empty())
+    {
+      startProgress(0, 1, "Loading peptide database cache...");
+      try
+      {
+        loaded = peptide_db.load(database_cache_, key, fasta_db);
+      }
+      catch (Exception::BaseException& e)
+      {
+        OPENMS_LOG_WARN << "Warning: Ignoring unusable peptide database cache file '" << database_cache_ << "': " << e.what() << endl;
+      }
+      endProgress();
+    }
+    if (loaded)
+    {
+      OPENMS_LOG_INFO << "Peptide database loaded from cache file '" << database_cache_ << "'." << endl;
+    }
+    else
+    {
+      if (!database_cache_.empty())
+      {
+        OPENMS_LOG_INFO << "Peptide database cache file '" << database_cache_ << "' is missing or was built with different settings." << endl;
+      }
+
+      ProteaseDigestion digestor;
+      digestor.setEnzyme(enzyme_);
+      digestor.setMissedCleavages(peptide_missed_cleavages_);
+
+      startProgress(0, 1, "Digesting database...");
+      peptide_db.build(fasta_db, digestor, peptide_min_size_, peptide_max_size_, fixed_modifications, variable_modifications, modifications_max_variable_mods_per_peptide_, peptide_motif_);
+      endProgress();
+
+      if (!database_cache_.empty())
+      {
+        try
+        {
+          peptide_db.store(database_cache_, key);
+          OPENMS_LOG_INFO << "Peptide database stored in cache file '" << database_cache_ << "'." << endl;
+        }
+        catch (Exception::BaseException& e)
+        {
+          // the search works without the cache, it just cannot be reused
+          OPENMS_LOG_WARN << "Warning: Peptide database could not be stored in cache file '" << database_cache_ << "': " << e.what() << endl;
+        }
+      }
+    }
+
+    OPENMS_LOG_INFO << "Peptides: " << peptide_db.getNrPeptides() << endl;
+    OPENMS_LOG_INFO << "Modified peptides: " << peptide_db.size() << endl;
+    return key;
+  }
+
+  void SimpleSearchEngineAlgorithm::getFragmentIndex_(const vector<FASTAFile::FASTAEntry>& fasta_db,
+    const PeptideDatabase& peptide_db,
+    UInt64 key,
+    const TheoreticalSpectrumGenerator& spectrum_generator,
+    const ModifiedPeptideGenerator::MapToResidueType& fixed_modifications,
+    const ModifiedPeptideGenerator::MapToResidueType& variable_modifications,
+    FragmentIndex& fragment_index) const
+  {
+    const String cache = database_cache_.empty() ? "" : database_cache_ + ".fragments";
+
+    bool loaded = false;
+    if (!cache.empty())
+    {
+      startProgress(0, 1, "Loading fragment index cache...");
+      try
+      {
+        loaded = fragment_index.load(cache, key, peptide_db.size());
+      }
+      catch (Exception::BaseException& e)
+      {
+        OPENMS_LOG_WARN << "Warning: Ignoring unusable fragment index cache file '" << cache << "': " << e.what() << endl;
+      }
+      endProgress();
+    }
+    if (loaded)
+    {
+      OPENMS_LOG_INFO << "Fragment index loaded from cache file '" << cache << "'." << endl;
+    }
+    else
+    {
+      startProgress(0, 1, "Building fragment index...");
+      fragment_index.build(peptide_db, fasta_db, spectrum_generator, fixed_modifications, variable_modifications, modifications_max_variable_mods_per_peptide_);
+      endProgress();
+
+      if (!cache.empty())
+      {
+        try
+        {
+          fragment_index.store(cache, key);
+          OPENMS_LOG_INFO << "Fragment index stored in cache file '" << cache << "'." << endl;
+        }
+        catch (Exception::BaseException& e)
+        {
+          OPENMS_LOG_WARN << "Warning: Fragment index could not be stored in cache file '" << cache << "': " << e.what() << endl;
+        }
+      }
+    }
+
+    OPENMS_LOG_INFO << "Indexed fragments: " << fragment_index.getNrFragments() << endl;
+  }
+
+  void SimpleSearchEngineAlgorithm::selectCandidates_(const PeptideDatabase& peptide_db,
+    const multimap<double, Size>& multimap_mass_2_scan_index,
+    vector<PeptideDatabase::Entry>& candidates,
+    vector<Size>& candidate_groups) const
+  {
+    bool precursor_mass_tolerance_unit_ppm = (precursor_mass_tolerance_unit_ == "ppm");
+
+    candidates.clear();
+    for (Size i = 0; i < peptide_db.size(); ++i)
+    {
+      const PeptideDatabase::Entry& e = peptide_db.getEntry(i);
+
+      // determine MS2 precursors that match to the current peptide mass
+      double tolerance = precursor_mass_tolerance_unit_ppm ? 0.5 * e.mass * precursor_mass_tolerance_ * 1e-6 : 0.5 * precursor_mass_tolerance_;
+      if (multimap_mass_2_scan_index.lower_bound(e.mass - tolerance) == multimap_mass_2_scan_index.upper_bound(e.mass + tolerance)) { continue; }
+
+      candidates.push_back(e);
+    }
+
+    // group by peptide, so the modified variants of each peptide are generated only once
+    sort(candidates.begin(), candidates.end(), [](const PeptideDatabase::Entry& a, const PeptideDatabase::Entry& b)
+    {
+      return a.peptide != b.peptide ? a.peptide < b.peptide : a.modification < b.modification;
+    });
+    candidate_groups.clear();
+    for (Size i = 0; i < candidates.size(); ++i)
+    {
+      if (i == 0 || candidates[i].peptide != candidates[i - 1].peptide) { candidate_groups.push_back(i); }
+    }
+    candidate_groups.push_back(candidates.size());
+
+    OPENMS_LOG_INFO << "Modified peptides with matching precursors: " << candidates.size() << endl;
+  }
+
+  namespace
+  {
+    /// maximal number of candidate sequences kept per thread in searchFragmentIndex_()
+    const Size MAX_POOLED_SEQUENCES = 100000;
+  }
+
+  void SimpleSearchEngineAlgorithm::searchFragmentIndex_(const PeakMap& spectra,
+    const multimap<double, Size>& multimap_mass_2_scan_index,
+    const vector<FASTAFile::FASTAEntry>& fasta_db,
+    const PeptideDatabase& peptide_db,
+    const FragmentIndex& fragment_index,
+    const TheoreticalSpectrumGenerator& spectrum_generator,
+    const ModifiedPeptideGenerator::MapToResidueType& fixed_modifications,
+    const ModifiedPeptideGenerator::MapToResidueType& variable_modifications,
+    vector<vector<AnnotatedHit_> >& annotated_hits) const
+  {
+    bool precursor_mass_tolerance_unit_ppm = (precursor_mass_tolerance_unit_ == "ppm");
+    bool fragment_mass_tolerance_unit_ppm = (fragment_mass_tolerance_unit_ == "ppm");
+
+    // precursor masses (one per isotope hypothesis) of each scan
+    vector<vector<double> > scan_precursor_masses(spectra.size());
+    for (multimap<double, Size>::const_iterator it = multimap_mass_2_scan_index.begin(); it != multimap_mass_2_scan_index.end(); ++it)
+    {
+      scan_precursor_masses[it->second].push_back(it->first);
+    }
+
+    startProgress(0, spectra.size(), "Scoring spectra against fragment index...");
+    Size count_spectra(0);
+
+    // spectra are scored independently, no locking of the hits is needed
+#pragma omp parallel default(none) shared(spectra, scan_precursor_masses, fasta_db, peptide_db, fragment_index, spectrum_generator, fixed_modifications, variable_modifications, annotated_hits, precursor_mass_tolerance_unit_ppm, fragment_mass_tolerance_unit_ppm, count_spectra)
+    {
+      vector<UInt32> workspace;
+      vector<FragmentIndex::Candidate> candidates;
+      vector<AASequence> all_modified_peptides;
+      PeakSpectrum theo_spectrum;
+
+      // the same entries are candidates for many spectra: keep their modified sequences (with
+      // cached prefix masses for the fragment ions) in a pool per thread, which needs no locking
+      AASequencePool sequence_pool;
+      unordered_map<Size, InternedAASequence> entry_sequences;
+
+#pragma omp for schedule(dynamic, 10)
+      for (SignedSize scan_index = 0; scan_index < (SignedSize)spectra.size(); ++scan_index)
+      {
+#pragma omp atomic
+        ++count_spectra;
+
+        IF_MASTERTHREAD
+        {
+          setProgress(count_spectra);
+        }
+
+        const PeakSpectrum& exp_spectrum = spectra[scan_index];
+        set<Size> scored_entries; // an entry may match several isotope hypotheses
+        for (double precursor_mass : scan_precursor_masses[scan_index])
+        {
+          // entries with precursor_mass in their (peptide mass dependent) tolerance window
+          double mass_low, mass_high;
+          if (precursor_mass_tolerance_unit_ppm)
+          {
+            mass_low = precursor_mass / (1.0 + 0.5 * precursor_mass_tolerance_ * 1e-6);
+            mass_high = precursor_mass / (1.0 - 0.5 * precursor_mass_tolerance_ * 1e-6);
+          }
+          else
+          {
+            mass_low = precursor_mass - 0.5 * precursor_mass_tolerance_;
+            mass_high = precursor_mass + 0.5 * precursor_mass_tolerance_;
+          }
+          const pair<Size, Size> entries = peptide_db.getEntries(mass_low, mass_high);
+
+          fragment_index.query(exp_spectrum, entries.first, entries.second, fragment_mass_tolerance_, fragment_mass_tolerance_unit_ppm,
+            fragment_index_min_shared_peaks_, fragment_index_candidates_, candidates, workspace);
+
+          for (const FragmentIndex::Candidate& candidate : candidates)
+          {
+            if (!scored_entries.insert(candidate.entry).second) { continue; }
+
+            // create theoretical spectrum
+            const PeptideDatabase::Entry& entry = peptide_db.getEntry(candidate.entry);
+            unordered_map<Size, InternedAASequence>::const_iterator seq_it = entry_sequences.find(candidate.entry);
+            if (seq_it == entry_sequences.end())
+            {
+              // bound the memory of the pool
+              if (entry_sequences.size() >= MAX_POOLED_SEQUENCES)
+              {
+                entry_sequences.clear();
+                sequence_pool.clear();
+              }
+              peptide_db.getModifiedVariants(fasta_db, entry.peptide, fixed_modifications, variable_modifications, modifications_max_variable_mods_per_peptide_, all_modified_peptides);
+              seq_it = entry_sequences.emplace(candidate.entry, sequence_pool.intern(all_modified_peptides[entry.modification])).first;
+            }
+            theo_spectrum.clear(true);
+            spectrum_generator.getSpectrum(theo_spectrum, seq_it->second, 1, 1);
+            theo_spectrum.sortByPosition();
+
+            const double score = HyperScore::compute(fragment_mass_tolerance_, fragment_mass_tolerance_unit_ppm, exp_spectrum, theo_spectrum);
+
+            if (score == 0) { continue; } // no hit?
+
+            // add peptide hit
+            AnnotatedHit_ ah;
+            ah.sequence = peptide_db.getSequence(fasta_db, entry.peptide);
+            ah.peptide_mod_index = entry.modification;
+            ah.score = score;
+            annotated_hits[scan_index].push_back(ah);
+
+            // prevent vector from growing indefinitly (memory) but don't shrink the vector every time
+            if (annotated_hits[scan_index].size() >= 2 * report_top_hits_)
+            {
+              std::partial_sort(annotated_hits[scan_index].begin(), annotated_hits[scan_index].begin() + report_top_hits_, annotated_hits[scan_index].end(), AnnotatedHit_::hasBetterScore);
+              annotated_hits[scan_index].resize(report_top_hits_);
+            }
+          }
+        }
+      }
+    }
+    endProgress();
+  }
+
   // static
 void SimpleSearchEngineAlgorithm::postProcessHits_(const PeakMap& exp, 
       std::vector<std::vector<SimpleSearchEngineAlgorithm::AnnotatedHit_> >& annotated_hits, 
@@ -248,11 +544,25 @@ void SimpleSearchEngineAlgorithm::postProcessHits_(const PeakMap& exp,
       annotated_hits.shrink_to_fit();
     }
 
-#pragma omp parallel for default(none) shared(annotated_hits, exp, fixed_modifications, variable_modifications, peptide_ids, max_variable_mods_per_peptide)
+    // the same peptides are reported for many spectra - parse each of them
+    // only once (per thread, so the pools need no locking)
+#ifdef _OPENMP
+    vector<AASequencePool> sequence_pools(omp_get_max_threads());
+#else
+    vector<AASequencePool> sequence_pools(1);
+#endif
+
+#pragma omp parallel for default(none) shared(annotated_hits, exp, fixed_modifications, variable_modifications, peptide_ids, max_variable_mods_per_peptide, sequence_pools)
     for (SignedSize scan_index = 0; scan_index < (SignedSize)annotated_hits.size(); ++scan_index)
     {
       if (!annotated_hits[scan_index].empty())
       {
+#ifdef _OPENMP
+        AASequencePool& sequence_pool = sequence_pools[omp_get_thread_num()];
+#else
+        AASequencePool& sequence_pool = sequence_pools[0];
+#endif
+
         // create empty PeptideIdentification object and fill meta data
         PeptideIdentification pi{};
         pi.setMetaValue("scan_index", static_cast<unsigned int>(scan_index));
@@ -270,7 +580,7 @@ void SimpleSearchEngineAlgorithm::postProcessHits_(const PeakMap& exp,
           ph.setCharge(charge);
 
           // get unmodified string
-          AASequence aas = AASequence::fromString(a_it->sequence.getString());
+          AASequence aas = sequence_pool.fromString(a_it->sequence.getString()).getSequence();
 
           // reapply modifications (because for memory reasons we only stored the index and recreation is fast)
           vector<AASequence> all_modified_peptides;
@@ -413,73 +723,111 @@ void SimpleSearchEngineAlgorithm::postProcessHits_(const PeakMap& exp,
     FASTAFile::load(in_db, fasta_db);
     endProgress();
 
+    // with a database cache or a fragment index, the candidate peptides are taken from the (stored)
+    // peptide database. Otherwise every protein is digested (and its peptides scored) on the fly.
+    const bool use_peptide_db = !database_cache_.empty() || fragment_index_enabled_;
+    PeptideDatabase peptide_db;
+    vector<PeptideDatabase::Entry> candidates;
+    vector<Size> candidate_groups(1, 0);
+    if (use_peptide_db)
+    {
+      const UInt64 key = getPeptideDatabase_(fasta_db, fixed_modifications, variable_modifications, peptide_db);
+      if (fragment_index_enabled_)
+      {
+        // bins about as wide as the fragment tolerance (in ppm: at 1000 Th)
+        FragmentIndex fragment_index(fragment_mass_tolerance_unit_ppm ? fragment_mass_tolerance_ * 1e-3 : fragment_mass_tolerance_);
+        getFragmentIndex_(fasta_db, peptide_db, key, spectrum_generator, fixed_modifications, variable_modifications, fragment_index);
+        searchFragmentIndex_(spectra, multimap_mass_2_scan_index, fasta_db, peptide_db, fragment_index, spectrum_generator, fixed_modifications, variable_modifications, annotated_hits);
+      }
+      else
+      {
+        selectCandidates_(peptide_db, multimap_mass_2_scan_index, candidates, candidate_groups);
+      }
+    }
+
     ProteaseDigestion digestor;
     digestor.setEnzyme(enzyme_);
     digestor.setMissedCleavages(peptide_missed_cleavages_);
 
-    startProgress(0, fasta_db.size(), "Scoring peptide models against spectra...");
+    // a group is a protein, or a candidate peptide from the database (none if the fragment index was searched)
+    const SignedSize nr_groups = use_peptide_db ? (SignedSize)candidate_groups.size() - 1 : (SignedSize)fasta_db.size();
+
+    startProgress(0, nr_groups, "Scoring peptide models against spectra...");
 
     // lookup for processed peptides. must be defined outside of omp section and synchronized
     set<StringView> processed_petides;
 
-    Size count_proteins(0), count_peptides(0);
+    Size count_groups(0), count_peptides(0);
 
-#pragma omp parallel for schedule(static) default(none) shared(annotated_hits, spectrum_generator, multimap_mass_2_scan_index, fixed_modifications, variable_modifications, fasta_db, digestor, processed_petides, count_proteins, precursor_mass_tolerance_unit_ppm, fragment_mass_tolerance_unit_ppm, count_peptides, peptide_motif_regex, spectra, annotated_hits_lock)
-      for (SignedSize fasta_index = 0; fasta_index < (SignedSize)fasta_db.size(); ++fasta_index)
-      {
+#pragma omp parallel for schedule(dynamic, 10) default(none) shared(annotated_hits, spectrum_generator, multimap_mass_2_scan_index, fixed_modifications, variable_modifications, fasta_db, digestor, processed_petides, peptide_db, candidates, candidate_groups, count_groups, count_peptides, precursor_mass_tolerance_unit_ppm, fragment_mass_tolerance_unit_ppm, peptide_motif_regex, spectra, annotated_hits_lock)
+    for (SignedSize group = 0; group < nr_groups; ++group)
+    {
 
 #pragma omp atomic
-      ++count_proteins;
+      ++count_groups;
 
       IF_MASTERTHREAD
       {
-        setProgress(count_proteins);
+        setProgress(count_groups);
       }
 
       vector<StringView> current_digest;
-      digestor.digestUnmodified(fasta_db[fasta_index].sequence, current_digest, peptide_min_size_, peptide_max_size_);
-
-      for (auto const & c : current_digest)
-      { 
-        const String current_peptide = c.getString();
-        if (current_peptide.find_first_of("XBZ") != std::string::npos) { continue; }
-
-        // if a peptide motif is provided skip all peptides without match
-        if (!peptide_motif_.empty() && !boost::regex_match(current_peptide, peptide_motif_regex)) { continue; }          
-      
-        bool already_processed = false;
-        #pragma omp critical (processed_peptides_access)
+      if (use_peptide_db)
+      {
+        current_digest.push_back(peptide_db.getSequence(fasta_db, candidates[candidate_groups[group]].peptide));
+      }
+      else
+      {
+        digestor.digestUnmodified(fasta_db[group].sequence, current_digest, peptide_min_size_, peptide_max_size_);
+      }
+
+      for (auto const & sequence : current_digest)
+      {
+        const String current_peptide = sequence.getString();
+
+        // peptides from the database are already filtered and unique
+        if (!use_peptide_db)
         {
-          // peptide (and all modified variants) already processed so skip it
-          if (processed_petides.find(c) != processed_petides.end())
-          {
-            already_processed = true;
-          }
-          else
+          if (current_peptide.find_first_of("XBZ") != std::string::npos) { continue; }
+
+          // if a peptide motif is provided skip all peptides without match
+          if (!peptide_motif_.empty() && !boost::regex_match(current_peptide, peptide_motif_regex)) { continue; }
+
+          bool already_processed = false;
+          #pragma omp critical (processed_peptides_access)
           {
-            processed_petides.insert(c);
+            // peptide (and all modified variants) already processed so skip it
+            if (processed_petides.find(sequence) != processed_petides.end())
+            {
+              already_processed = true;
+            }
+            else
+            {
+              processed_petides.insert(sequence);
+            }
           }
-        }
 
-        // skip peptides that have already been processed
-        if (already_processed) { continue; }
+          // skip peptides that have already been processed
+          if (already_processed) { continue; }
+        }
 
+#pragma omp atomic
         ++count_peptides;
 
         vector<AASequence> all_modified_peptides;
 
-        // this critial section is because ResidueDB is not thread safe and new residues are created based on the PTMs
-        #pragma omp critical (residuedb_access)
-        {
-          AASequence aas = AASequence::fromString(current_peptide);
-          ModifiedPeptideGenerator::applyFixedModifications(fixed_modifications, aas);
-          ModifiedPeptideGenerator::applyVariableModifications(variable_modifications, aas, modifications_max_variable_mods_per_peptide_, all_modified_peptides);
-        }
+        AASequence aas = AASequence::fromString(current_peptide);
+        ModifiedPeptideGenerator::applyFixedModifications(fixed_modifications, aas);
+        ModifiedPeptideGenerator::applyVariableModifications(variable_modifications, aas, modifications_max_variable_mods_per_peptide_, all_modified_peptides);
 
-        for (SignedSize mod_pep_idx = 0; mod_pep_idx < (SignedSize)all_modified_peptides.size(); ++mod_pep_idx)
+        // the candidate variants of a database peptide, otherwise all variants
+        const Size first = use_peptide_db ? candidate_groups[group] : 0;
+        const Size last = use_peptide_db ? candidate_groups[group + 1] : all_modified_peptides.size();
+        for (Size i = first; i < last; ++i)
         {
+          const SignedSize mod_pep_idx = use_peptide_db ? (SignedSize)candidates[i].modification : (SignedSize)i;
           const AASequence& candidate = all_modified_peptides[mod_pep_idx];
-          double current_peptide_mass = candidate.getMonoWeight();
+          double current_peptide_mass = use_peptide_db ? candidates[i].mass : candidate.getMonoWeight();
 
           // determine MS2 precursors that match to the current peptide mass
           multimap<double, Size>::const_iterator low_it;
@@ -519,7 +867,7 @@ void SimpleSearchEngineAlgorithm::postProcessHits_(const PeakMap& exp,
 
             // add peptide hit
             AnnotatedHit_ ah;
-            ah.sequence = c;
+            ah.sequence = sequence;
             ah.peptide_mod_index = mod_pep_idx;
             ah.score = score;
 
@@ -545,9 +893,8 @@ void SimpleSearchEngineAlgorithm::postProcessHits_(const PeakMap& exp,
     }
     endProgress();
 
-    OPENMS_LOG_INFO << "Proteins: " << count_proteins << endl;
-    OPENMS_LOG_INFO << "Peptides: " << count_peptides << endl;
-    OPENMS_LOG_INFO << "Processed peptides: " << processed_petides.size() << endl;
+    OPENMS_LOG_INFO << "Proteins: " << fasta_db.size() << endl;
+    OPENMS_LOG_INFO << "Processed peptides: " << count_peptides << endl;
 
     startProgress(0, 1, "Post-processing PSMs...");
     SimpleSearchEngineAlgorithm::postProcessHits_(spectra, 
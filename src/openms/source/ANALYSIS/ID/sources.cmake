@@ -19,6 +19,7 @@ ConsensusIDAlgorithmSimilarity.cpp
 ConsensusIDAlgorithmWorst.cpp
 ConsensusMapMergerAlgorithm.cpp
 FalseDiscoveryRate.cpp
+FragmentIndex.cpp
 HiddenMarkovModel.cpp
 IDBoostGraph.cpp
 IDConflictResolverAlgorithm.cpp
@@ -29,6 +30,7 @@ IDDecoyProbability.cpp
 IDScoreGetterSetter.cpp
 MessagePasserFactory.cpp
 MetaboliteSpectralMatching.cpp
+PeptideDatabase.cpp
 PeptideProteinResolution.cpp
 PrecursorPurity.cpp
 ProtonDistributionModel.cpp
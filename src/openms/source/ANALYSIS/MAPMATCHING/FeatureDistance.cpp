@@ -179,12 +179,14 @@ namespace OpenMS
     // check m/z difference constraint:
     double left_mz = left.getMZ(), right_mz = right.getMZ();
     double dist_mz = fabs(left_mz - right_mz);
-    double max_diff_mz = params_mz_.max_difference;
-    if (params_mz_.max_diff_ppm) // compute absolute difference (in Da/Th)
+    // work on a local copy of the m/z parameters, so that concurrent calls
+    // (e.g. from QTClusterFinder) do not interfere with each other:
+    DistanceParams_ params_mz = params_mz_;
+    double max_diff_mz = params_mz.max_difference;
+    if (params_mz.max_diff_ppm) // compute absolute difference (in Da/Th)
     {
       max_diff_mz *= left_mz * 1e-6;
-      // overwrite this parameter - it will be recomputed each time anyway:
-      params_mz_.norm_factor = 1 / max_diff_mz;
+      params_mz.norm_factor = 1 / max_diff_mz;
     }
 
     if (dist_mz > max_diff_mz)
@@ -208,7 +210,7 @@ namespace OpenMS
     }
 
     dist_rt = distance_(dist_rt, params_rt_);
-    dist_mz = distance_(dist_mz, params_mz_);
+    dist_mz = distance_(dist_mz, params_mz);
 
     double dist_intensity = 0.0;
     if (params_intensity_.relevant)     // not by default, so worth checking
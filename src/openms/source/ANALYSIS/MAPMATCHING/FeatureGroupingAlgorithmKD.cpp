@@ -38,11 +38,35 @@
 #include <OpenMS/METADATA/PeptideIdentification.h>
 #include <OpenMS/FORMAT/FeatureXMLFile.h>
 
+#include <boost/unordered_set.hpp>
+
 using namespace std;
 
 namespace OpenMS
 {
 
+  namespace
+  {
+    /// Cluster found in a tile (features are identified by their address in the input maps)
+    struct TileCluster
+    {
+      Size size;
+      double avg_distance;
+      Size center_map_index;
+      const BaseFeature* center;
+      vector<pair<Size, const BaseFeature*> > elements;
+
+      /// Same preference as in ClusterProxyKD (larger, then tighter clusters first), made unambiguous via the center
+      bool operator<(const TileCluster& rhs) const
+      {
+        if (size != rhs.size) return size > rhs.size;
+        if (avg_distance != rhs.avg_distance) return avg_distance < rhs.avg_distance;
+        if (center_map_index != rhs.center_map_index) return center_map_index < rhs.center_map_index;
+        return std::less<const BaseFeature*>()(center, rhs.center);
+      }
+    };
+  }
+
   FeatureGroupingAlgorithmKD::FeatureGroupingAlgorithmKD() :
     ProgressLogger(),
     feature_distance_(FeatureDistance())
@@ -75,6 +99,8 @@ namespace OpenMS
     defaults_.setValidStrings("mz_unit", ListUtils::create<String>("ppm,Da"));
     defaults_.setValue("nr_partitions", 100, "Number of partitions in m/z space");
     defaults_.setMinInt("nr_partitions", 1);
+    defaults_.setValue("link:tile_size", 0, "If larger than 0, m/z partitions containing more features than this (e.g. for very many input maps or very dense data) are split into overlapping m/z tiles of about this many features, which are linked independently (in parallel) to bound the memory used for the kd-tree. Only the kd-tree memory is bounded: all input maps are still held in memory. Results near tile boundaries may differ slightly from untiled linking.", ListUtils::create<String>("advanced"));
+    defaults_.setMinInt("link:tile_size", 0);
 
     // FeatureDistance defaults
     defaults_.insert("", feature_distance_.getDefaults());
@@ -197,25 +223,13 @@ namespace OpenMS
         double partition_start = partition_boundaries[j];
         double partition_end = partition_boundaries[j+1];
 
-        std::vector<MapType> tmp_input_maps(input_maps.size());
-        for (size_t k = 0; k < input_maps.size(); k++)
-        {
-          // iterate over all features in the current input map and append
-          // matching features (within the current partition) to the temporary
-          // map
-          for (size_t m = 0; m < input_maps[k].size(); m++)
+        // set up kd-tree on all features within the current partition
+        KDTreeFeatureMaps kd_data;
+        kd_data.setParameters(param_);
+        kd_data.addMaps(input_maps, [=](const BaseFeature& f)
           {
-            if (input_maps[k][m].getMZ() >= partition_start &&
-                input_maps[k][m].getMZ() < partition_end)
-            {
-              tmp_input_maps[k].push_back(input_maps[k][m]);
-            }
-          }
-          tmp_input_maps[k].updateRanges();
-        }
-
-        // set up kd-tree
-        KDTreeFeatureMaps kd_data(tmp_input_maps, param_);
+            return f.getMZ() >= partition_start && f.getMZ() < partition_end;
+          });
         aligner.addRTFitData(kd_data);
         setProgress(progress++);
       }
@@ -235,6 +249,7 @@ namespace OpenMS
     }
 
     // ------------ run alignment + feature linking on individual partitions ------------
+    const SignedSize tile_size = (Int)(param_.getValue("link:tile_size"));
     Size progress = 0;
     startProgress(0, partition_boundaries.size(), "linking features");
     for (size_t j = 0; j < partition_boundaries.size()-1; j++)
@@ -242,25 +257,36 @@ namespace OpenMS
       double partition_start = partition_boundaries[j];
       double partition_end = partition_boundaries[j+1];
 
-      std::vector<MapType> tmp_input_maps(input_maps.size());
-      for (size_t k = 0; k < input_maps.size(); k++)
+      // split large partitions into tiles of 'tile_size' features (in m/z):
+      vector<double> tile_boundaries(1, partition_start);
+      if (tile_size > 0)
       {
-        // iterate over all features in the current input map and append
-        // matching features (within the current partition) to the temporary
-        // map
-        for (size_t m = 0; m < input_maps[k].size(); m++)
+        vector<double>::const_iterator first = lower_bound(massrange.begin(), massrange.end(), partition_start);
+        vector<double>::const_iterator last = lower_bound(massrange.begin(), massrange.end(), partition_end);
+        for (SignedSize k = tile_size; k < last - first; k += tile_size)
         {
-          if (input_maps[k][m].getMZ() >= partition_start &&
-              input_maps[k][m].getMZ() < partition_end)
+          if (*(first + k) > tile_boundaries.back())
           {
-            tmp_input_maps[k].push_back(input_maps[k][m]);
+            tile_boundaries.push_back(*(first + k));
           }
         }
-        tmp_input_maps[k].updateRanges();
+      }
+      tile_boundaries.push_back(partition_end);
+
+      if (tile_boundaries.size() > 2)
+      {
+        linkTiles_(input_maps, tile_boundaries, align ? &aligner : nullptr, out);
+        setProgress(progress++);
+        continue;
       }
 
-      // set up kd-tree
-      KDTreeFeatureMaps kd_data(tmp_input_maps, param_);
+      // set up kd-tree on all features within the current partition
+      KDTreeFeatureMaps kd_data;
+      kd_data.setParameters(param_);
+      kd_data.addMaps(input_maps, [=](const BaseFeature& f)
+        {
+          return f.getMZ() >= partition_start && f.getMZ() < partition_end;
+        });
 
       // alignment
       if (align)
@@ -269,7 +295,13 @@ namespace OpenMS
       }
 
       // link features
-      runClustering_(kd_data, out);
+      vector<vector<Size> > clusters;
+      vector<ClusterProxyKD> proxies;
+      runClustering_(kd_data, clusters, proxies);
+      for (Size c = 0; c < clusters.size(); ++c)
+      {
+        addConsensusFeature_(clusters[c], kd_data, out);
+      }
       setProgress(progress++);
     }
     endProgress();
@@ -303,6 +335,127 @@ namespace OpenMS
     return;
   }
 
+  template <typename MapType>
+  void FeatureGroupingAlgorithmKD::linkTiles_(const vector<MapType>& input_maps,
+                                              const vector<double>& tile_boundaries,
+                                              const MapAlignmentAlgorithmKD* aligner,
+                                              ConsensusMap& out)
+  {
+    const double partition_start = tile_boundaries.front();
+    const double partition_end = tile_boundaries.back();
+
+    // ------------ link every tile independently ------------
+    const SignedSize n_tiles = tile_boundaries.size() - 1;
+    vector<vector<TileCluster> > tile_clusters(n_tiles);
+#pragma omp parallel for schedule(dynamic)
+    for (SignedSize t = 0; t < n_tiles; ++t)
+    {
+      const double core_start = tile_boundaries[t];
+      const double core_end = tile_boundaries[t + 1];
+      // extend the core by twice the m/z tolerance on both sides: the
+      // neighborhoods of all cluster centers in the core are then complete,
+      // as are those of competing clusters centered right next to the core
+      const double ext_start = max(partition_start, core_start - 2 * (mz_ppm_ ? mz_tol_ * 1e-6 * core_start : mz_tol_));
+      const double ext_end = min(partition_end, core_end + 2 * (mz_ppm_ ? mz_tol_ * 1e-6 * core_end : mz_tol_));
+
+      KDTreeFeatureMaps kd_data;
+      kd_data.setParameters(param_);
+      kd_data.addMaps(input_maps, [=](const BaseFeature& f)
+        {
+          return f.getMZ() >= ext_start && f.getMZ() < ext_end;
+        });
+      if (aligner)
+      {
+        aligner->transform(kd_data);
+      }
+
+      vector<vector<Size> > clusters;
+      vector<ClusterProxyKD> proxies;
+      runClustering_(kd_data, clusters, proxies);
+
+      // keep only the clusters whose center lies in the core of this tile
+      for (Size c = 0; c < clusters.size(); ++c)
+      {
+        Size center_index = proxies[c].getCenterIndex();
+        double center_mz = kd_data.mz(center_index);
+        if (center_mz < core_start || center_mz >= core_end)
+        {
+          continue;
+        }
+        TileCluster cluster;
+        cluster.size = proxies[c].getSize();
+        cluster.avg_distance = proxies[c].getAvgDistance();
+        cluster.center_map_index = kd_data.mapIndex(center_index);
+        cluster.center = kd_data.feature(center_index);
+        for (vector<Size>::const_iterator it = clusters[c].begin(); it != clusters[c].end(); ++it)
+        {
+          cluster.elements.push_back(make_pair(kd_data.mapIndex(*it), kd_data.feature(*it)));
+        }
+        tile_clusters[t].push_back(cluster);
+      }
+    }
+
+    // ------------ merge the tiles ------------
+    // clusters of neighboring tiles may share features from the overlap
+    // regions: accept clusters in order of preference and skip those that
+    // conflict with an already accepted one
+    vector<TileCluster> all_clusters;
+    for (SignedSize t = 0; t < n_tiles; ++t)
+    {
+      all_clusters.insert(all_clusters.end(), tile_clusters[t].begin(), tile_clusters[t].end());
+      vector<TileCluster>().swap(tile_clusters[t]);
+    }
+    sort(all_clusters.begin(), all_clusters.end());
+
+    boost::unordered_set<const BaseFeature*> used;
+    for (vector<TileCluster>::const_iterator c_it = all_clusters.begin(); c_it != all_clusters.end(); ++c_it)
+    {
+      bool conflict = false;
+      for (vector<pair<Size, const BaseFeature*> >::const_iterator e_it = c_it->elements.begin(); e_it != c_it->elements.end(); ++e_it)
+      {
+        if (used.count(e_it->second))
+        {
+          conflict = true;
+          break;
+        }
+      }
+      if (conflict)
+      {
+        continue;
+      }
+      for (vector<pair<Size, const BaseFeature*> >::const_iterator e_it = c_it->elements.begin(); e_it != c_it->elements.end(); ++e_it)
+      {
+        used.insert(e_it->second);
+      }
+      addConsensusFeature_(c_it->elements, out);
+    }
+    vector<TileCluster>().swap(all_clusters);
+
+    // link the remaining features (from rejected clusters or from clusters
+    // whose center was outside of every core) in one final round
+    KDTreeFeatureMaps kd_rest;
+    kd_rest.setParameters(param_);
+    kd_rest.addMaps(input_maps, [&](const BaseFeature& f)
+      {
+        return f.getMZ() >= partition_start && f.getMZ() < partition_end && !used.count(&f);
+      });
+    if (kd_rest.size() == 0)
+    {
+      return;
+    }
+    if (aligner)
+    {
+      aligner->transform(kd_rest);
+    }
+    vector<vector<Size> > clusters;
+    vector<ClusterProxyKD> proxies;
+    runClustering_(kd_rest, clusters, proxies);
+    for (Size c = 0; c < clusters.size(); ++c)
+    {
+      addConsensusFeature_(clusters[c], kd_rest, out);
+    }
+  }
+
   void FeatureGroupingAlgorithmKD::group(const std::vector<FeatureMap>& maps,
                                          ConsensusMap& out)
   {
@@ -315,7 +468,7 @@ namespace OpenMS
     group_(maps, out);
   }
 
-  void FeatureGroupingAlgorithmKD::runClustering_(const KDTreeFeatureMaps& kd_data, ConsensusMap& out)
+  void FeatureGroupingAlgorithmKD::runClustering_(const KDTreeFeatureMaps& kd_data, vector<vector<Size> >& clusters, vector<ClusterProxyKD>& proxies)
   {
     Size n = kd_data.size();
 
@@ -338,10 +491,10 @@ namespace OpenMS
 
       // compile the actual list of sub feature indices for cluster with center i
       vector<Size> cf_indices;
-      computeBestClusterForCenter_(i, cf_indices, assigned, kd_data);
+      proxies.push_back(computeBestClusterForCenter_(i, cf_indices, assigned, kd_data));
 
-      // add consensus feature
-      addConsensusFeature_(cf_indices, kd_data, out);
+      // store cluster (the consensus feature is created by the caller)
+      clusters.push_back(cf_indices);
 
       // mark selected sub features assigned and delete them from potential_clusters
       for (vector<Size>::const_iterator f_it = cf_indices.begin(); f_it != cf_indices.end(); ++f_it)
@@ -515,16 +668,25 @@ namespace OpenMS
   }
 
   void FeatureGroupingAlgorithmKD::addConsensusFeature_(const vector<Size>& indices, const KDTreeFeatureMaps& kd_data, ConsensusMap& out) const
+  {
+    vector<pair<Size, const BaseFeature*> > elements;
+    for (vector<Size>::const_iterator it = indices.begin(); it != indices.end(); ++it)
+    {
+      elements.push_back(make_pair(kd_data.mapIndex(*it), kd_data.feature(*it)));
+    }
+    addConsensusFeature_(elements, out);
+  }
+
+  void FeatureGroupingAlgorithmKD::addConsensusFeature_(const vector<pair<Size, const BaseFeature*> >& elements, ConsensusMap& out) const
   {
     ConsensusFeature cf;
     float avg_quality = 0;
-    for (vector<Size>::const_iterator it = indices.begin(); it != indices.end(); ++it)
+    for (vector<pair<Size, const BaseFeature*> >::const_iterator it = elements.begin(); it != elements.end(); ++it)
     {
-      Size i = *it;
-      cf.insert(kd_data.mapIndex(i), *(kd_data.feature(i)));
-      avg_quality += kd_data.feature(i)->getQuality();
+      cf.insert(it->first, *(it->second));
+      avg_quality += it->second->getQuality();
     }
-    avg_quality /= indices.size();
+    avg_quality /= elements.size();
     cf.setQuality(avg_quality);
     cf.computeConsensus();
     out.push_back(cf);
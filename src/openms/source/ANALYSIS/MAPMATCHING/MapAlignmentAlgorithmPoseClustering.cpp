@@ -62,6 +62,36 @@ namespace OpenMS
     pairfinder_.setLogType(getLogType());
 
     max_num_peaks_considered_ = param_.getValue("max_num_peaks_considered");
+
+    // superimposer parameters may have changed:
+    if (!reference_.empty())
+    {
+      prepareReference_();
+    }
+  }
+
+  void MapAlignmentAlgorithmPoseClustering::prepareReference_()
+  {
+    std::vector<Peak2D> points;
+    points.reserve(reference_.size());
+    for (ConsensusMap::const_iterator it = reference_.begin(); it != reference_.end(); ++it)
+    {
+      Peak2D c;
+      c.setIntensity(it->getIntensity());
+      c.setRT(it->getRT());
+      c.setMZ(it->getMZ());
+      points.push_back(c);
+    }
+    reference_model_ = PoseClusteringAffineSuperimposer::PreparedModel();
+    if (!points.empty())
+    {
+      superimposer_.prepareModel(points, reference_model_);
+    }
+  }
+
+  const ConsensusMap& MapAlignmentAlgorithmPoseClustering::getReference() const
+  {
+    return reference_;
   }
 
   MapAlignmentAlgorithmPoseClustering::~MapAlignmentAlgorithmPoseClustering()
@@ -72,27 +102,45 @@ namespace OpenMS
   {
     ConsensusMap map_scene;
     MapConversion::convert(1, map, map_scene, max_num_peaks_considered_);
-    align(map_scene, trafo);
+    alignScene_(map_scene, trafo);
   }
 
   void MapAlignmentAlgorithmPoseClustering::align(const PeakMap& map, TransformationDescription& trafo)
   {
     ConsensusMap map_scene;
-    PeakMap map2(map);
-    MapConversion::convert(1, map2, map_scene, max_num_peaks_considered_); // copy MSExperiment here, since it is sorted internally by intensity
-    align(map_scene, trafo);
+    MapConversion::convert(1, map, map_scene, max_num_peaks_considered_);
+    alignScene_(map_scene, trafo);
   }
 
   void MapAlignmentAlgorithmPoseClustering::align(const ConsensusMap& map, TransformationDescription& trafo)
   {
-    // TODO: move this to updateMembers_? (if ConsensusMap prevails)
-    // TODO: why does superimposer work on consensus map???
-    const ConsensusMap & map_model = reference_;
     ConsensusMap map_scene = map;
+    alignScene_(map_scene, trafo);
+  }
+
+  void MapAlignmentAlgorithmPoseClustering::alignScene_(ConsensusMap& map_scene, TransformationDescription& trafo)
+  {
+    const ConsensusMap & map_model = reference_;
+
+    std::vector<Peak2D> scene_points;
+    scene_points.reserve(map_scene.size());
+    for (ConsensusMap::const_iterator it = map_scene.begin(); it != map_scene.end(); ++it)
+    {
+      Peak2D c;
+      c.setIntensity(it->getIntensity());
+      c.setRT(it->getRT());
+      c.setMZ(it->getMZ());
+      scene_points.push_back(c);
+    }
 
-    // run superimposer to find the global transformation
+    // run superimposer to find the global transformation (using a local
+    // superimposer, since it keeps progress state; the prepared reference
+    // data is shared)
     TransformationDescription si_trafo;
-    superimposer_.run(map_model, map_scene, si_trafo);
+    PoseClusteringAffineSuperimposer superimposer;
+    superimposer.setParameters(superimposer_.getParameters());
+    superimposer.setLogType(superimposer_.getLogType());
+    superimposer.run(reference_model_, scene_points, si_trafo);
 
     // apply transformation to consensus features and contained feature
     // handles
@@ -109,11 +157,7 @@ namespace OpenMS
 
     // run pairfinder to find pairs
     ConsensusMap result;
-    // TODO: add another 2-map interface to pairfinder?
-    std::vector<ConsensusMap> input(2);
-    input[0] = map_model;
-    input[1] = map_scene;
-    pairfinder_.run(input, result);
+    pairfinder_.run(map_model, map_scene, result);
 
     // calculate the local transformation
     si_trafo.invert(); // to undo the transformation applied above
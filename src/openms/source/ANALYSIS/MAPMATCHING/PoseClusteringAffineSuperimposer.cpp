@@ -732,6 +732,31 @@ namespace OpenMS
     return total_int_model_map / total_int_scene_map;
   }
 
+  void PoseClusteringAffineSuperimposer::prepareModel(const std::vector<Peak2D> & map_model,
+                                                      PreparedModel & model) const
+  {
+    if (map_model.empty())
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                       "One of the input maps is empty! This is not allowed!");
+    }
+
+    // select the most abundant data points only (see 'run' below)
+    model.points = map_model;
+    const Size num_used_points = (Int) param_.getValue("num_used_points");
+    if (model.points.size() > num_used_points)
+    {
+      std::nth_element(model.points.rbegin(), model.points.rbegin() + (model.points.size() - num_used_points),
+          model.points.rend(), Peak2D::IntensityLess());
+      model.points.resize(num_used_points);
+    }
+    std::sort(model.points.begin(), model.points.end(), Peak2D::MZLess());
+
+    // the RT range is taken from the complete map
+    model.min_rt = std::min_element(map_model.begin(), map_model.end(), Peak2D::RTLess())->getRT();
+    model.max_rt = std::max_element(map_model.begin(), map_model.end(), Peak2D::RTLess())->getRT();
+  }
+
   void PoseClusteringAffineSuperimposer::run(const std::vector<Peak2D> & map_model,
                                              const std::vector<Peak2D> & map_scene, 
                                              TransformationDescription & transformation)
@@ -742,6 +767,20 @@ namespace OpenMS
       throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
                                        "One of the input maps is empty! This is not allowed!");
     }
+    PreparedModel model;
+    prepareModel(map_model, model);
+    run(model, map_scene, transformation);
+  }
+
+  void PoseClusteringAffineSuperimposer::run(const PreparedModel & model,
+                                             const std::vector<Peak2D> & map_scene,
+                                             TransformationDescription & transformation)
+  {
+    if (model.points.empty() || map_scene.empty())
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                       "One of the input maps is empty! This is not allowed!");
+    }
 
     //**************************************************************************
     // Parameters
@@ -803,8 +842,9 @@ namespace OpenMS
     //**************************************************************************
     // Step 1: Select the most abundant data points only.
     //**************************************************************************
+    // (for the model map, this was done in 'prepareModel')
+    const std::vector<Peak2D> & model_map = model.points;
     // use copy to truncate
-    std::vector<Peak2D> model_map(map_model);
     std::vector<Peak2D> scene_map(map_scene);
     {
       // truncate the data as necessary
@@ -812,12 +852,6 @@ namespace OpenMS
 
       // sort the last data points by ascending intensity (from the right, using reverse iterators)
       //  -> linear in complexity, should be faster than sorting and then taking cutoff
-      if (model_map.size() > num_used_points)
-      {
-        std::nth_element(model_map.rbegin(), model_map.rbegin() + (model_map.size() - num_used_points),
-            model_map.rend(), Peak2D::IntensityLess());
-        model_map.resize(num_used_points);
-      }
       setProgress(++actual_progress);
       if (scene_map.size() > num_used_points)
       {
@@ -828,7 +862,6 @@ namespace OpenMS
       setProgress(++actual_progress);
     }
     // sort by ascending m/z
-    std::sort(model_map.begin(), model_map.end(), Peak2D::MZLess());
     std::sort(scene_map.begin(), scene_map.end(), Peak2D::MZLess());
     setProgress((actual_progress = 10));
 
@@ -839,9 +872,9 @@ namespace OpenMS
     // possible improvement: use the truncated map from above which should be
     // more reliable (one outlier of low intensity could derail the estimate
     // below)
-    const double model_minrt = std::min_element(map_model.begin(), map_model.end(), Peak2D::RTLess())->getRT();
+    const double model_minrt = model.min_rt;
     const double scene_minrt = std::min_element(map_scene.begin(), map_scene.end(), Peak2D::RTLess())->getRT();
-    const double model_maxrt = std::max_element(map_model.begin(), map_model.end(), Peak2D::RTLess())->getRT();
+    const double model_maxrt = model.max_rt;
     const double scene_maxrt = std::max_element(map_scene.begin(), map_scene.end(), Peak2D::RTLess())->getRT();
     const double rt_low =  (model_minrt + scene_minrt) / 2.;
     const double rt_high = (model_maxrt + scene_maxrt) / 2.;
@@ -901,8 +934,10 @@ namespace OpenMS
 
     // The serial number is incremented for each invocation of this, to avoid
     // overwriting of hash table dumps.
-    static Int dump_buckets_serial = 0;
-    ++dump_buckets_serial;
+    static Int dump_buckets_serial_counter = 0;
+    Int dump_buckets_serial;
+#pragma omp critical (PoseClusteringAffineSuperimposer_dump_serial)
+    dump_buckets_serial = ++dump_buckets_serial_counter;
 
     //**************************************************************************
     // Step 4: Hashing
@@ -37,6 +37,8 @@
 #include <OpenMS/METADATA/PeptideIdentification.h>
 #include <OpenMS/KERNEL/FeatureHandle.h>
 
+#include <algorithm>
+
 // #define DEBUG_QTCLUSTERFINDER
 
 using std::list;
@@ -239,7 +241,7 @@ namespace OpenMS
 
     // compute QT clustering:
     // std::cout << "Clustering..." << std::endl;
-    list<QTCluster> clustering;
+    vector<QTCluster> clustering;
     computeClustering_(grid, clustering);
     // number of clusters == number of data points:
     Size size = clustering.size();
@@ -247,7 +249,7 @@ namespace OpenMS
     // create a temp. map storing which grid features are next to which clusters
     typedef OpenMSBoost::unordered_map<Size, std::vector<GridFeature*> > NeighborList;
     ElementMapping element_mapping;
-    for (list<QTCluster>::iterator it = clustering.begin();
+    for (vector<QTCluster>::iterator it = clustering.begin();
          it != clustering.end(); ++it)
     {
       NeighborList neigh = it->getAllNeighbors();
@@ -264,13 +266,21 @@ namespace OpenMS
     }
 
     // ensure that all cluster centers are in the list
-    for (list<QTCluster>::iterator it = clustering.begin();
+    for (vector<QTCluster>::iterator it = clustering.begin();
          it != clustering.end(); ++it)
     {
       OpenMS::GridFeature* center_feature = it->getCenterPoint();
       element_mapping[center_feature].push_back(&(*it));
     }
 
+    // order the clusters by quality:
+    ClusterQueue cluster_queue;
+    for (Size i = 0; i < clustering.size(); ++i)
+    {
+      cluster_queue.push(ClusterQueueEntry_(clustering[i].getQuality(), i,
+                                            &clustering[i]));
+    }
+
     ProgressLogger logger;
     Size progress = 0;
     if (do_progress)
@@ -283,7 +293,8 @@ namespace OpenMS
     {
       // std::cout << "Clusters: " << clustering.size() << std::endl;
       ConsensusFeature consensus_feature;
-      makeConsensusFeature_(clustering, consensus_feature, element_mapping, grid);
+      makeConsensusFeature_(clustering, cluster_queue, consensus_feature,
+                            element_mapping, grid);
       if (!clustering.empty())
       {
         result_map.push_back(consensus_feature);
@@ -294,32 +305,30 @@ namespace OpenMS
     if (do_progress) logger.endProgress();
   }
 
-  void QTClusterFinder::makeConsensusFeature_(list<QTCluster>& clustering,
+  void QTClusterFinder::makeConsensusFeature_(vector<QTCluster>& clustering,
+                                              ClusterQueue& cluster_queue,
                                               ConsensusFeature& feature,
                                               ElementMapping& element_mapping,
                                               Grid& grid)
   {
-    // find the best cluster (a valid cluster with the highest score)
-    // -> this is equivalent to std::max_element but we can skip invalid clusters
-    list<QTCluster>::iterator best = clustering.begin();
-    while (best != clustering.end() && best->isInvalid()) // find start element
+    // find the best cluster (a valid cluster with the highest score):
+    // entries of invalidated clusters and entries whose quality is out of date
+    // (the cluster was updated and re-inserted since) are skipped
+    QTCluster* best = nullptr;
+    while (!cluster_queue.empty())
     {
-      ++best;
-    }
-    for (list<QTCluster>::iterator it = best;
-         it != clustering.end(); ++it)
-    {
-      if (!it->isInvalid())
+      ClusterQueueEntry_ top = cluster_queue.top();
+      cluster_queue.pop();
+      if (!top.cluster->isInvalid() &&
+          top.cluster->getQuality() == top.quality)
       {
-        if (it->getQuality() > best->getQuality())
-        {
-          best = it;
-        }
+        best = top.cluster;
+        break;
       }
     }
 
     // no more clusters to process -> clear clustering and return
-    if (best == clustering.end())
+    if (best == nullptr)
     {
       clustering.clear();
       return;
@@ -357,7 +366,7 @@ namespace OpenMS
 #endif
 
     // Store the id of already used features (important: needs to be done
-    // before the large loop below)
+    // before the cluster updates below)
     for (OpenMSBoost::unordered_map<Size, OpenMS::GridFeature*>::const_iterator
          it = elements.begin(); it != elements.end(); ++it)
     {
@@ -369,71 +378,79 @@ namespace OpenMS
     // 2. update all clusters accordingly by removing already used elements
     // 3. Invalidate elements whose central has been used already
     best->setInvalid();
+
+    // Identify all clusters that could potentially have been touched by this
+    // (sorted by position in the clustering to get a deterministic order)
+    vector<QTCluster*> affected;
     for (OpenMSBoost::unordered_map<Size, OpenMS::GridFeature*>::const_iterator
         it = elements.begin(); it != elements.end(); ++it)
     {
-      // Identify all features that could potentially have been touched by this
-      //  Get all clusters that may potentially need updating
-
-      ElementMapping tmp_element_mapping; // modify copy, then update
-
-      for (std::vector<QTCluster*>::iterator
-           cluster  = element_mapping[&(*it->second)].begin();
-           cluster != element_mapping[&(*it->second)].end(); ++cluster)
+      ElementMapping::const_iterator pos = element_mapping.find(it->second);
+      if (pos == element_mapping.end()) continue;
+      for (std::vector<QTCluster*>::const_iterator cluster = pos->second.begin();
+           cluster != pos->second.end(); ++cluster)
       {
         // we do not want to update invalid features (saves time and does not
         // recompute the quality)
-        if (!(*cluster)->isInvalid())
-        {
-          // remove the elements of the new feature from the cluster
-          if ((*cluster)->update(elements))
-          {
-            // If update returns true, it means that at least one element was
-            // removed from the cluster and we need to update that cluster
-
-            // Get the coordinates of the current cluster
-            const Int x = (*cluster)->getXCoord(); 
-            const Int y = (*cluster)->getYCoord();
-
-            ////////////////////////////////////////
-            // Step 1: Iterate through all neighboring grid features and try to
-            // add elements to the current cluster to replace the ones we just
-            // removed
-            const OpenMS::GridFeature* center_feature = (*cluster)->getCenterPoint();
-            addClusterElements_(x, y, grid, (**cluster), center_feature);
-
-            ////////////////////////////////////////
-            // Step 2: update element_mapping as the best feature for each
-            // cluster may have changed
-            typedef OpenMSBoost::unordered_map<Size,
-                    std::vector<GridFeature*> > NeighborList;
-            NeighborList neigh = (*cluster)->getAllNeighbors();
-            for (NeighborList::iterator n_it = neigh.begin(); n_it != neigh.end(); ++n_it)
-            {
-              for (std::vector<GridFeature*>::iterator i_it =
-                  n_it->second.begin(); i_it != n_it->second.end(); ++i_it)
-              {
-                // remember for each feature (gridfeature) all the cluster
-                // elements it belongs to
-                tmp_element_mapping[*i_it].push_back(*cluster);
-              }
-            }
-          }
-        }
+        if (!(*cluster)->isInvalid()) affected.push_back(*cluster);
       }
+    }
+    std::sort(affected.begin(), affected.end());
+    affected.erase(std::unique(affected.begin(), affected.end()), affected.end());
+
+    // The updates of different clusters are independent of each other (they
+    // only read the grid and 'already_used_'), so they can run in parallel.
+    // Opening a parallel region only pays off for larger numbers of clusters.
+    typedef OpenMSBoost::unordered_map<Size, std::vector<GridFeature*> > NeighborList;
+    vector<NeighborList> new_neighbors(affected.size());
+    vector<char> updated(affected.size(), false);
+    const SignedSize n_affected = affected.size();
+#pragma omp parallel for schedule(dynamic) if (n_affected > 16)
+    for (SignedSize i = 0; i < n_affected; ++i)
+    {
+      QTCluster* cluster = affected[i];
+      // remove the elements of the new feature from the cluster
+      if (cluster->update(elements))
+      {
+        // If update returns true, it means that at least one element was
+        // removed from the cluster and we need to update that cluster
+
+        ////////////////////////////////////////
+        // Step 1: Iterate through all neighboring grid features and try to
+        // add elements to the current cluster to replace the ones we just
+        // removed
+        addClusterElements_(cluster->getXCoord(), cluster->getYCoord(), grid,
+                            *cluster, cluster->getCenterPoint());
+        new_neighbors[i] = cluster->getAllNeighbors();
+        updated[i] = true;
+      }
+    }
 
-      for (ElementMapping::iterator it = tmp_element_mapping.begin(); 
-          it != tmp_element_mapping.end(); ++it )
+    ////////////////////////////////////////
+    // Step 2: update element_mapping as the best feature for each cluster may
+    // have changed, and re-insert the updated clusters into the queue
+    for (Size i = 0; i < affected.size(); ++i)
+    {
+      if (!updated[i]) continue;
+      QTCluster* cluster = affected[i];
+      for (NeighborList::iterator n_it = new_neighbors[i].begin();
+           n_it != new_neighbors[i].end(); ++n_it)
       {
-        for (std::vector<QTCluster*>::iterator it2 = it->second.begin();
-            it2 != it->second.end(); ++it2)
+        for (std::vector<GridFeature*>::iterator i_it = n_it->second.begin();
+             i_it != n_it->second.end(); ++i_it)
         {
-          element_mapping[ it->first ].push_back(*it2);
+          // remember for each feature (gridfeature) all the cluster elements
+          // it belongs to
+          element_mapping[*i_it].push_back(cluster);
         }
       }
+      cluster_queue.push(ClusterQueueEntry_(cluster->getQuality(),
+                                            cluster - &clustering[0], cluster));
     }
   }
 
+
+
   void QTClusterFinder::addClusterElements_(int x, int y, const Grid& grid, QTCluster& cluster,
     const OpenMS::GridFeature* center_feature)
   {
@@ -531,7 +548,7 @@ namespace OpenMS
   }
 
   void QTClusterFinder::computeClustering_(Grid& grid,
-                                           list<QTCluster>& clustering)
+                                           vector<QTCluster>& clustering)
   {
     clustering.clear();
     already_used_.clear();
@@ -539,18 +556,28 @@ namespace OpenMS
     // FeatureDistance produces normalized distances (between 0 and 1):
     const double max_distance = 1.0;
 
-    // iterate over all grid cells:
+    // create one cluster per grid feature (the position in the clustering
+    // defines the order among clusters of equal quality):
+    clustering.reserve(grid.size());
     for (Grid::iterator it = grid.begin(); it != grid.end(); ++it)
     {
       const Grid::CellIndex& act_coords = it.index();
       const Int x = act_coords[0], y = act_coords[1];
 
       OpenMS::GridFeature* center_feature = it->second;
-      QTCluster cluster(center_feature, num_maps_, max_distance, use_IDs_, x, y);
-
-      addClusterElements_(x, y, grid, cluster, center_feature);
+      clustering.push_back(QTCluster(center_feature, num_maps_, max_distance,
+                                     use_IDs_, x, y));
+    }
 
-      clustering.push_back(cluster);
+    // fill the clusters (independent of each other, so this can run in
+    // parallel):
+    const SignedSize n_clusters = clustering.size();
+#pragma omp parallel for schedule(dynamic, 64)
+    for (SignedSize i = 0; i < n_clusters; ++i)
+    {
+      QTCluster& cluster = clustering[i];
+      addClusterElements_(cluster.getXCoord(), cluster.getYCoord(), grid,
+                          cluster, cluster.getCenterPoint());
     }
   }
 
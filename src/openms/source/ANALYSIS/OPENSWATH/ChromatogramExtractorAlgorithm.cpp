@@ -37,6 +37,8 @@
 #include <OpenMS/DATASTRUCTURES/String.h>
 
 #include <OpenMS/CONCEPT/Exception.h>
+
+#include <cmath>
 #include <iostream>
 
 namespace OpenMS
@@ -78,61 +80,26 @@ namespace OpenMS
       int_it++;
     }
 
-    // walk right and left and add to our intensity
-    mz_walker  = mz_it;
-    int_walker = int_it;
-
-    // if we moved past the end of the spectrum, we need to try the last peak
-    // of the spectrum (it could still be within the window)
-    if (mz_it == mz_end)
-    {
-      --mz_walker;
-      --int_walker;
-    }
-
-    // add the current peak if it is between right and left
-    if ((*mz_walker) > left && (*mz_walker) < right)
-    {
-      integrated_intensity += (*int_walker);
-    }
-
-    // (i) Walk to the left one step and then keep walking left until we go
-    // outside the window. Note for the first step to the left we have to
-    // check for the walker becoming equal to the first data point.
+    // (i) Walk to the left (all peaks below the target m/z, down to and
+    // including the first data point) until we go outside the window. If we
+    // moved past the end of the spectrum, this also covers the last peak.
     mz_walker  = mz_it;
     int_walker = int_it;
-    if (mz_it != mz_start)
+    while (mz_walker != mz_start)
     {
       --mz_walker;
       --int_walker;
-
-      // Special case: target m/z is larger than first data point but the first
-      // data point is inside the window.
-      // Then, mz_it is the second data point, mz_walker now points to the very
-      // first data point. If mz_it was the first data point, we already added
-      // it above. We still need to add this point if it is inside the window
-      // (while loop below will not catch it)
-      if (mz_walker == mz_start && (*mz_walker) > left && (*mz_walker) < right)
+      if (!((*mz_walker) > left && (*mz_walker) < right))
       {
-        integrated_intensity += (*int_walker);
+        break;
       }
-    }
-    while (mz_walker != mz_start && (*mz_walker) > left && (*mz_walker) < right)
-    {
       integrated_intensity += (*int_walker);
-      --mz_walker;
-      --int_walker;
     }
 
-    // (ii) Walk to the right one step and then keep walking right until we are
+    // (ii) Walk to the right (starting with the current peak) until we are
     // outside the window
     mz_walker  = mz_it;
     int_walker = int_it;
-    if (mz_it != mz_end)
-    {
-      ++mz_walker;
-      ++int_walker;
-    }
     while (mz_walker != mz_end && (*mz_walker) > left && (*mz_walker) < right)
     {
       integrated_intensity += (*int_walker);
@@ -192,68 +159,29 @@ namespace OpenMS
       int_it++;
     }
 
-    // walk right and left and add to our intensity
+    // (i) Walk to the left (all peaks below the target m/z, down to and
+    // including the first data point) until we go outside the window. If we
+    // moved past the end of the spectrum, this also covers the last peak.
     mz_walker  = mz_it;
     im_walker  = im_it;
     int_walker = int_it;
-
-    // if we moved past the end of the spectrum, we need to try the last peak
-    // of the spectrum (it could still be within the window)
-    if (mz_it == mz_end)
-    {
-      --mz_walker;
-      --im_walker;
-      --int_walker;
-    }
-
-    // add the current peak if it is between right and left
-    if ((*mz_walker) > left && (*mz_walker) < right && (*im_walker) > left_im && (*im_walker) < right_im)
-    {
-      integrated_intensity += (*int_walker);
-    }
-
-    // (i) Walk to the left one step and then keep walking left until we go
-    // outside the window. Note for the first step to the left we have to
-    // check for the walker becoming equal to the first data point.
-    mz_walker  = mz_it;
-    int_walker = int_it;
-    im_walker = im_it;
-    if (mz_it != mz_start)
+    while (mz_walker != mz_start)
     {
       --mz_walker;
       --im_walker;
       --int_walker;
-
-      // Special case: target m/z is larger than first data point but the first
-      // data point is inside the window.
-      // Then, mz_it is the second data point, mz_walker now points to the very
-      // first data point. If mz_it was the first data point, we already added
-      // it above. We still need to add this point if it is inside the window
-      // (while loop below will not catch it)
-      if (mz_walker == mz_start && (*mz_walker) > left && (*mz_walker) < right && (*im_walker) > left_im && (*im_walker) < right_im)
+      if (!((*mz_walker) > left && (*mz_walker) < right))
       {
-        integrated_intensity += (*int_walker);
+        break;
       }
-    }
-    while (mz_walker != mz_start && (*mz_walker) > left && (*mz_walker) < right)
-    {
       if (*im_walker > left_im && *im_walker < right_im) integrated_intensity += (*int_walker);
-      --mz_walker;
-      --im_walker;
-      --int_walker;
     }
 
-    // (ii) Walk to the right one step and then keep walking right until we are
+    // (ii) Walk to the right (starting with the current peak) until we are
     // outside the window
     mz_walker  = mz_it;
     im_walker  = im_it;
     int_walker = int_it;
-    if (mz_it != mz_end)
-    {
-      ++im_walker;
-      ++mz_walker;
-      ++int_walker;
-    }
     while (mz_walker != mz_end && (*mz_walker) > left && (*mz_walker) < right)
     {
       if (*im_walker > left_im && *im_walker < right_im) integrated_intensity += (*int_walker);
@@ -263,6 +191,53 @@ namespace OpenMS
     }
   }
 
+  namespace
+  {
+    /// Extraction window of a single coordinate (computed once for all spectra)
+    struct ExtractionWindow
+    {
+      double mz;
+      double left;
+      double right;
+      double half_width;
+      double im_left;
+      double im_right;
+      bool use_im;
+    };
+
+    /**
+      Tophat sum over the window [first, last) in the same order as
+      extract_value_tophat, so that the results are bit-identical: walking
+      left from the target position (center) and then walking right.
+    */
+    inline double sumTophat(const double* x, const double* im, Size first, Size center, Size last, const ExtractionWindow& w)
+    {
+      double s = 0.0;
+      for (Size i = center; i > first; --i)
+      {
+        if (!w.use_im || (im[i - 1] > w.im_left && im[i - 1] < w.im_right)) s += x[i - 1];
+      }
+      for (Size i = center; i < last; ++i)
+      {
+        if (!w.use_im || (im[i] > w.im_left && im[i] < w.im_right)) s += x[i];
+      }
+      return s;
+    }
+
+    /// Triangular (Bartlett) weighted sum of x[first, last) around the window center
+    inline double sumRangeBartlett(const double* x, const double* mz, const double* im, Size first, Size last, const ExtractionWindow& w)
+    {
+      double s = 0.0;
+      for (Size i = first; i < last; ++i)
+      {
+        double weight = 1.0 - std::fabs(mz[i] - w.mz) / w.half_width;
+        if (w.use_im && !(im[i] > w.im_left && im[i] < w.im_right)) weight = 0.0;
+        s += x[i] * weight;
+      }
+      return s;
+    }
+  }
+
   void ChromatogramExtractorAlgorithm::extractChromatograms(const OpenSwath::SpectrumAccessPtr input,
       std::vector< OpenSwath::ChromatogramPtr >& output,
       const std::vector<ExtractionCoordinates>& extraction_coordinates,
@@ -292,6 +267,24 @@ namespace OpenMS
         "Input to extractChromatogram needs to be sorted by m/z");
     }
 
+    // Compute the extraction windows once. Since the coordinates are sorted
+    // by m/z and all windows have the same (absolute or relative) width, the
+    // window borders are sorted as well.
+    const bool has_im = (im_extraction_window > 0.0);
+    std::vector<ExtractionWindow> windows(extraction_coordinates.size());
+    for (Size k = 0; k < extraction_coordinates.size(); ++k)
+    {
+      const ExtractionCoordinates& coord = extraction_coordinates[k];
+      ExtractionWindow& w = windows[k];
+      w.mz = coord.mz;
+      w.half_width = ppm ? coord.mz * mz_extraction_window / 2.0 * 1.0e-6 : mz_extraction_window / 2.0;
+      w.left = coord.mz - w.half_width;
+      w.right = coord.mz + w.half_width;
+      w.use_im = (coord.ion_mobility >= 0.0 && has_im);
+      w.im_left = coord.ion_mobility - im_extraction_window / 2.0;
+      w.im_right = coord.ion_mobility + im_extraction_window / 2.0;
+    }
+
     //go through all spectra
     startProgress(0, input_size, "Extracting chromatograms");
     for (Size scan_idx = 0; scan_idx < input_size; ++scan_idx)
@@ -301,27 +294,24 @@ namespace OpenMS
       OpenSwath::SpectrumPtr sptr = input->getSpectrumById(scan_idx);
       OpenSwath::SpectrumMeta s_meta = input->getSpectrumMetaById(scan_idx);
 
-      OpenSwath::BinaryDataArrayPtr mz_arr = sptr->getMZArray();
-      OpenSwath::BinaryDataArrayPtr int_arr = sptr->getIntensityArray();
-      std::vector<double>::const_iterator mz_start = mz_arr->data.begin();
-      std::vector<double>::const_iterator mz_end = mz_arr->data.end();
-      std::vector<double>::const_iterator mz_it = mz_arr->data.begin();
-      std::vector<double>::const_iterator int_it = int_arr->data.begin();
-      std::vector<double>::const_iterator im_it;
-
-      if (sptr->getMZArray()->data.size() == 0)
+      const std::vector<double>& mz_data = sptr->getMZArray()->data;
+      const std::vector<double>& int_data = sptr->getIntensityArray()->data;
+      const Size n = mz_data.size();
+      if (n == 0)
       {
         continue;
       }
+      const double* mz = mz_data.data();
+      const double* intensity = int_data.data();
+      const double* im = nullptr;
 
       // Look for ion mobility array
-      bool has_im = (im_extraction_window > 0.0);
       if (has_im)
       {
         OpenSwath::BinaryDataArrayPtr im_arr = sptr->getDriftTimeArray();
         if (im_arr != nullptr)
         {
-          im_it = im_arr->data.begin();
+          im = im_arr->data.data();
         }
         else
         {
@@ -330,14 +320,15 @@ namespace OpenMS
         }
       }
 
-      // go through all transitions / chromatograms which are sorted by
-      // ProductMZ. We can use this to step through the spectrum and at the
-      // same time step through the transitions. We increase the peak counter
-      // until we hit the next transition and then extract the signal.
+      // Go through all transitions / chromatograms which are sorted by
+      // ProductMZ and merge them with the (sorted) spectrum: the first peak
+      // inside the window (first), the first peak behind it (last) and the
+      // first peak at or above the target m/z (center) only ever move to the
+      // right, so the whole spectrum is traversed only once.
+      const double current_rt = s_meta.RT;
+      Size first = 0, last = 0, center = 0;
       for (Size k = 0; k < extraction_coordinates.size(); ++k)
       {
-        double integrated_intensity = 0;
-        double current_rt = s_meta.RT;
         if (extraction_coordinates[k].rt_end - extraction_coordinates[k].rt_start > 0 &&
              (current_rt < extraction_coordinates[k].rt_start ||
               current_rt > extraction_coordinates[k].rt_end) )
@@ -345,25 +336,19 @@ namespace OpenMS
           continue;
         }
 
-        const bool use_im = (extraction_coordinates[k].ion_mobility >= 0.0 && has_im);
-        if (!use_im && used_filter == 1)
-        {
-          extract_value_tophat(mz_start, mz_it, mz_end, int_it,
-                               extraction_coordinates[k].mz, integrated_intensity, mz_extraction_window, ppm);
-        }
-        else if (use_im && used_filter == 1)
+        const ExtractionWindow& w = windows[k];
+        while (first < n && mz[first] <= w.left) ++first;
+        while (last < n && mz[last] < w.right) ++last;
+        while (center < n && mz[center] < w.mz) ++center;
+
+        double integrated_intensity = 0;
+        if (used_filter == 1)
         {
-          if (extraction_coordinates[k].ion_mobility < 0)
-          {
-            std::cerr << "WARNING : Drift time of ion is negative!" << std::endl;
-          }
-          extract_value_tophat(mz_start, mz_it, mz_end, int_it, im_it,
-                               extraction_coordinates[k].mz, extraction_coordinates[k].ion_mobility,
-                               integrated_intensity, mz_extraction_window, im_extraction_window, ppm);
+          integrated_intensity = sumTophat(intensity, im, first, center, last, w);
         }
         else if (used_filter == 2)
         {
-          throw Exception::NotImplemented(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
+          integrated_intensity = sumRangeBartlett(intensity, mz, im, first, last, w);
         }
 
         output[k]->getTimeArray()->data.push_back(current_rt);
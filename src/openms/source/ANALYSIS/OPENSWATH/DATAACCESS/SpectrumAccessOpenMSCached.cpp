@@ -45,6 +45,11 @@ namespace OpenMS
   {
   }
 
+  SpectrumAccessOpenMSCached::SpectrumAccessOpenMSCached(const String& filename, bool memory_map) :
+    CachedmzML(filename, memory_map)
+  {
+  }
+
   SpectrumAccessOpenMSCached::~SpectrumAccessOpenMSCached()
   {
   }
@@ -68,6 +73,14 @@ namespace OpenMS
     int ms_level = -1;
     double rt = -1.0;
 
+    if (isMemoryMapped())
+    {
+      OpenSwath::SpectrumPtr sptr(new OpenSwath::Spectrum);
+      sptr->getDataArrays() = Internal::CachedMzMLHandler::readSpectrumFast(mappedData_(), mappedSize_(),
+        static_cast<std::streamoff>(spectra_index_[id]), ms_level, rt);
+      return sptr;
+    }
+
     if ( !ifs_.seekg(spectra_index_[id]) )
     {
       std::cerr << "Error while reading spectrum " << id << " - seekg created an error when trying to change position to " << spectra_index_[id] << "." << std::endl;
@@ -98,6 +111,14 @@ namespace OpenMS
     OPENMS_PRECONDITION(id >= 0, "Id needs to be larger than zero");
     OPENMS_PRECONDITION(id < (int)getNrChromatograms(), "Id cannot be larger than number of chromatograms");
 
+    if (isMemoryMapped())
+    {
+      OpenSwath::ChromatogramPtr cptr(new OpenSwath::Chromatogram);
+      cptr->getDataArrays() = Internal::CachedMzMLHandler::readChromatogramFast(mappedData_(), mappedSize_(),
+        static_cast<std::streamoff>(chrom_index_[id]));
+      return cptr;
+    }
+
     if ( !ifs_.seekg(chrom_index_[id]) )
     {
       std::cerr << "Error while reading chromatogram " << id << " - seekg created an error when trying to change position to " << chrom_index_[id] << "." << std::endl;
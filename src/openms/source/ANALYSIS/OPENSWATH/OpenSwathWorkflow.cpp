@@ -34,6 +34,15 @@
 
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathWorkflow.h>
 
+#include <OpenMS/SYSTEM/StopWatch.h>
+
+#include <condition_variable>
+#include <mutex>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 // OpenSwathCalibrationWorkflow
 namespace OpenMS
 {
@@ -435,6 +444,33 @@ namespace OpenMS
 namespace OpenMS
 {
 
+  namespace
+  {
+    /// A batch of compounds from one SWATH window, the unit of work in OpenSwathWorkflow::performExtraction
+    struct ExtractionTask
+    {
+      ExtractionTask(Size window_, Size batch_, Size nr_batches_) :
+        window(window_),
+        batch(batch_),
+        nr_batches(nr_batches_)
+      {}
+
+      Size window;
+      Size batch;
+      Size nr_batches;
+    };
+
+    /// Shared state of all tasks of one SWATH window
+    struct ExtractionWindowState
+    {
+      int batch_size = 0;
+      Size remaining_tasks = 0;
+      bool is_open = false;
+      std::once_flag load_flag;
+      OpenSwath::SpectrumAccessPtr swath_map;
+    };
+  }
+
   void OpenSwathWorkflow::performExtraction(
     const std::vector< OpenSwath::SwathMap > & swath_maps,
     const TransformationDescription trafo,
@@ -535,202 +571,237 @@ namespace OpenMS
     }
 
     // (iii) Perform extraction and scoring of fragment ion chromatograms (MS2)
-    // We set dynamic scheduling such that the maps are worked on in the order
-    // in which they were given to the program / acquired. This gives much
-    // better load balancing than static allocation.
-#ifdef _OPENMP
-#ifdef MT_ENABLE_NESTED_OPENMP
-    int total_nr_threads = omp_get_max_threads(); // store total number of threads we are allowed to use
-    if (threads_outer_loop_ > -1)
-    {
-      omp_set_nested(1);
-      omp_set_dynamic(0);
-      omp_set_num_threads(std::min(threads_outer_loop_, omp_get_max_threads()) ); // use at most threads_outer_loop_ threads here
-    }
-#endif
+    //
+    // The work is split into one task per (SWATH window, compound batch).
+    // All threads take tasks from a single queue which is ordered by window
+    // in the order in which the maps were given to the program / acquired.
+    // Large windows are thus worked on by several threads at the same time
+    // and no thread runs idle at the end as long as batches remain. If
+    // threads_outer_loop_ is set, at most that many windows are open (and
+    // held in memory) at any time.
+
+    // Step 1: select which transitions to extract for each window
+    std::vector< OpenSwath::LightTargetedExperiment > window_transitions(swath_maps.size());
 #pragma omp parallel for schedule(dynamic,1)
-#endif
     for (SignedSize i = 0; i < boost::numeric_cast<SignedSize>(swath_maps.size()); ++i)
     {
-      if (!swath_maps[i].ms1) // skip MS1
-      {
+      if (swath_maps[i].ms1) continue; // skip MS1
 
-        // Step 1: select which transitions to extract (proceed in batches)
-        OpenSwath::LightTargetedExperiment transition_exp_used_all;
-        if (!prm_)
-        {
-          // Step 1.1: select transitions matching the window
-          OpenSwathHelper::selectSwathTransitions(transition_exp, transition_exp_used_all,
-              cp.min_upper_edge_dist, swath_maps[i].lower, swath_maps[i].upper);
-        }
-        else
+      OpenSwath::LightTargetedExperiment& transition_exp_used_all = window_transitions[i];
+      if (!prm_)
+      {
+        // Step 1.1: select transitions matching the window
+        OpenSwathHelper::selectSwathTransitions(transition_exp, transition_exp_used_all,
+            cp.min_upper_edge_dist, swath_maps[i].lower, swath_maps[i].upper);
+      }
+      else
+      {
+        // Step 1.2: select transitions based on matching PRM window (best window)
+        std::set<std::string> matching_compounds;
+        for (Size k = 0; k < prm_map.size(); k++)
         {
-          // Step 1.2: select transitions based on matching PRM window (best window)
-          std::set<std::string> matching_compounds;
-          for (Size k = 0; k < prm_map.size(); k++)
+          if (prm_map[k] == i)
           {
-            if (prm_map[k] == i)
-            {
-               const OpenSwath::LightTransition& tr = transition_exp.transitions[k];
-               transition_exp_used_all.transitions.push_back(tr);
-               matching_compounds.insert(tr.getPeptideRef());
-            }
+             const OpenSwath::LightTransition& tr = transition_exp.transitions[k];
+             transition_exp_used_all.transitions.push_back(tr);
+             matching_compounds.insert(tr.getPeptideRef());
           }
+        }
 
-          std::set<std::string> matching_proteins;
-          for (Size i = 0; i < transition_exp.compounds.size(); i++)
+        std::set<std::string> matching_proteins;
+        for (Size k = 0; k < transition_exp.compounds.size(); k++)
+        {
+          if (matching_compounds.find(transition_exp.compounds[k].id) != matching_compounds.end())
           {
-            if (matching_compounds.find(transition_exp.compounds[i].id) != matching_compounds.end())
+            transition_exp_used_all.compounds.push_back( transition_exp.compounds[k] );
+            for (Size j = 0; j < transition_exp.compounds[k].protein_refs.size(); j++)
             {
-              transition_exp_used_all.compounds.push_back( transition_exp.compounds[i] );
-              for (Size j = 0; j < transition_exp.compounds[i].protein_refs.size(); j++)
-              {
-                matching_proteins.insert(transition_exp.compounds[i].protein_refs[j]);
-              }
+              matching_proteins.insert(transition_exp.compounds[k].protein_refs[j]);
             }
           }
-          for (Size i = 0; i < transition_exp.proteins.size(); i++)
+        }
+        for (Size k = 0; k < transition_exp.proteins.size(); k++)
+        {
+          if (matching_proteins.find(transition_exp.proteins[k].id) != matching_proteins.end())
           {
-            if (matching_proteins.find(transition_exp.proteins[i].id) != matching_proteins.end())
-            {
-              transition_exp_used_all.proteins.push_back( transition_exp.proteins[i] );
-            }
+            transition_exp_used_all.proteins.push_back( transition_exp.proteins[k] );
           }
         }
+      }
+    }
 
-        if (transition_exp_used_all.getTransitions().size() > 0) // skip if no transitions found
-        {
+    // Step 2: split each window into batches of compounds, one task each
+    std::vector< ExtractionWindowState > windows(swath_maps.size());
+    std::vector< ExtractionTask > tasks;
+    for (Size i = 0; i < swath_maps.size(); ++i)
+    {
+      const OpenSwath::LightTargetedExperiment& transition_exp_used_all = window_transitions[i];
+      Size nr_compounds = transition_exp_used_all.getCompounds().size();
+      if (transition_exp_used_all.getTransitions().empty() || nr_compounds == 0)
+      {
+        this->setProgress(++progress); // nothing to do for this window
+        continue;
+      }
 
-          OpenSwath::SpectrumAccessPtr current_swath_map = swath_maps[i].sptr;
-          if (load_into_memory)
-          {
-            // This creates an InMemory object that keeps all data in memory
-            current_swath_map = boost::shared_ptr<SpectrumAccessOpenMSInMemory>( new SpectrumAccessOpenMSInMemory(*current_swath_map) );
-          }
+      int batch_size = (batchSize <= 0 || batchSize >= (int)nr_compounds) ? (int)nr_compounds : batchSize;
+      Size nr_batches = (nr_compounds + batch_size - 1) / batch_size;
+      windows[i].batch_size = batch_size;
+      windows[i].remaining_tasks = nr_batches;
+      for (Size pep_idx = 0; pep_idx < nr_batches; ++pep_idx)
+      {
+        tasks.push_back(ExtractionTask(i, pep_idx, nr_batches));
+      }
+    }
 
-          int batch_size;
-          if (batchSize <= 0 || batchSize >= (int)transition_exp_used_all.getCompounds().size())
+    Size max_open_windows = threads_outer_loop_ > 0 ? threads_outer_loop_ : std::numeric_limits<Size>::max();
+    Size next_task = 0;
+    Size open_windows = 0;
+    // guards next_task, open_windows and the window states; threads that may
+    // not open another window wait on window_closed
+    std::mutex task_queue_mutex;
+    std::condition_variable window_closed;
+
+    // Step 3: process the tasks
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      while (true)
+      {
+        // Step 3.1: take the next task off the queue, unless this would open
+        // more windows than allowed (in which case we wait for one to finish)
+        Size task_idx;
+        {
+          std::unique_lock<std::mutex> lock(task_queue_mutex);
+          window_closed.wait(lock, [&]()
           {
-            batch_size = transition_exp_used_all.getCompounds().size();
-          }
-          else
+            return next_task >= tasks.size() ||
+                   windows[tasks[next_task].window].is_open ||
+                   open_windows < max_open_windows;
+          });
+          if (next_task >= tasks.size()) break;
+
+          ExtractionWindowState& window = windows[tasks[next_task].window];
+          if (!window.is_open)
           {
-            batch_size = batchSize;
+            window.is_open = true;
+            ++open_windows;
           }
+          task_idx = next_task++;
+        }
 
-          SignedSize nr_batches = (transition_exp_used_all.getCompounds().size() / batch_size);
+        const ExtractionTask& task = tasks[task_idx];
+        const Size i = task.window;
+        ExtractionWindowState& window = windows[i];
+        const OpenSwath::LightTargetedExperiment& transition_exp_used_all = window_transitions[i];
 
-#ifdef _OPENMP
-#ifdef MT_ENABLE_NESTED_OPENMP
-          // If we have a multiple of threads_outer_loop_ here, then use nested
-          // parallelization here. E.g. if we use 8 threads for the outer loop,
-          // but we have a total of 24 cores available, each of the 8 threads
-          // will then create a team of 3 threads to work on the batches
-          // individually.
-          //
-          // We should avoid oversubscribing the CPUs, therefore we use integer division.
-          // -- see https://docs.oracle.com/cd/E19059-01/stud.10/819-0501/2_nested.html
-          int outer_thread_nr = omp_get_thread_num();
-          omp_set_num_threads(std::max(1, total_nr_threads / threads_outer_loop_) );
-#pragma omp parallel for schedule(dynamic, 1)
-#endif
-#endif
-          for (SignedSize pep_idx = 0; pep_idx <= nr_batches; pep_idx++)
+        StopWatch task_timer;
+        task_timer.start();
+
+        // The first task of a window loads it into memory (if requested);
+        // all tasks of the window then share that copy
+        std::call_once(window.load_flag, [&]()
+        {
+          window.swath_map = swath_maps[i].sptr;
+          if (load_into_memory)
           {
-            OpenSwath::SpectrumAccessPtr current_swath_map_inner = current_swath_map;
+            // This creates an InMemory object that keeps all data in memory
+            window.swath_map = boost::shared_ptr<SpectrumAccessOpenMSInMemory>( new SpectrumAccessOpenMSInMemory(*swath_maps[i].sptr) );
+          }
+        });
+
+        // To ensure multi-threading safe access to the individual spectra, we
+        // need to use a light clone of the spectrum access (if multiple threads
+        // share a single filestream and call seek on it, chaos will ensue).
+        OpenSwath::SpectrumAccessPtr current_swath_map_inner = window.swath_map->lightClone();
 
 #ifdef _OPENMP
-#ifdef MT_ENABLE_NESTED_OPENMP
-            // To ensure multi-threading safe access to the individual spectra, we
-            // need to use a light clone of the spectrum access (if multiple threads
-            // share a single filestream and call seek on it, chaos will ensue).
-            if (total_nr_threads / threads_outer_loop_ > 1)
-            {
-              current_swath_map_inner = current_swath_map->lightClone();
-            }
-#endif
 #pragma omp critical (osw_write_stdout)
 #endif
-            {
-              std::cout << "Thread " <<
+        {
+          std::cout << "Thread " <<
 #ifdef _OPENMP
-#ifdef MT_ENABLE_NESTED_OPENMP
-              outer_thread_nr << "_" << omp_get_thread_num() << " " <<
-#else
-              omp_get_thread_num() << "_0 " <<
-#endif
+          omp_get_thread_num() << " " <<
 #else
-              "0" << 
+          "0 " <<
 #endif
-              "will analyze " << transition_exp_used_all.getCompounds().size() <<  " compounds and "
-              << transition_exp_used_all.getTransitions().size() <<  " transitions "
-              "from SWATH " << i << " (batch " << pep_idx << " out of " << nr_batches << ")" << std::endl;
-            }
-
-
-            // Create the new, batch-size transition experiment
-            OpenSwath::LightTargetedExperiment transition_exp_used;
-            selectCompoundsForBatch_(transition_exp_used_all, transition_exp_used, batch_size, pep_idx);
+          "will analyze " << transition_exp_used_all.getCompounds().size() <<  " compounds and "
+          << transition_exp_used_all.getTransitions().size() <<  " transitions "
+          "from SWATH " << i << " (batch " << task.batch << " out of " << task.nr_batches << ")" << std::endl;
+        }
 
-            // Extract MS1 chromatograms for this batch
-            std::vector< MSChromatogram > ms1_chromatograms;
-            if (ms1_map_ != nullptr) 
-            {
-              OpenSwath::SpectrumAccessPtr threadsafe_ms1 = ms1_map_->lightClone();
-              MS1Extraction_(threadsafe_ms1, swath_maps, ms1_chromatograms, chromConsumer, ms1_cp,
-                  transition_exp_used, trafo_inverse, ms1_only, ms1_isotopes);
-            }
+        // Create the new, batch-size transition experiment
+        OpenSwath::LightTargetedExperiment transition_exp_used;
+        selectCompoundsForBatch_(transition_exp_used_all, transition_exp_used, window.batch_size, task.batch);
 
-            // Step 2.1: extract these transitions
-            ChromatogramExtractor extractor;
-            std::vector< OpenSwath::ChromatogramPtr > chrom_list;
-            std::vector< ChromatogramExtractor::ExtractionCoordinates > coordinates;
+        // Extract MS1 chromatograms for this batch
+        std::vector< MSChromatogram > ms1_chromatograms;
+        if (ms1_map_ != nullptr) 
+        {
+          OpenSwath::SpectrumAccessPtr threadsafe_ms1 = ms1_map_->lightClone();
+          MS1Extraction_(threadsafe_ms1, swath_maps, ms1_chromatograms, chromConsumer, ms1_cp,
+              transition_exp_used, trafo_inverse, ms1_only, ms1_isotopes);
+        }
 
-            // Step 2.2: prepare the extraction coordinates and extract chromatograms
-            // chrom_list contains one entry for each fragment ion (transition) in transition_exp_used
-            prepareExtractionCoordinates_(chrom_list, coordinates, transition_exp_used, trafo_inverse, cp);
-            extractor.extractChromatograms(current_swath_map_inner, chrom_list, coordinates, cp.mz_extraction_window,
-                cp.ppm, cp.im_extraction_window, cp.extraction_function);
+        // Step 3.2: extract these transitions
+        ChromatogramExtractor extractor;
+        std::vector< OpenSwath::ChromatogramPtr > chrom_list;
+        std::vector< ChromatogramExtractor::ExtractionCoordinates > coordinates;
 
-            // Step 2.3: convert chromatograms back to OpenMS::MSChromatogram and write to output
-            PeakMap chrom_exp;
-            extractor.return_chromatogram(chrom_list, coordinates, transition_exp_used,  SpectrumSettings(), 
-                                          chrom_exp.getChromatograms(), false, cp.im_extraction_window);
+        // Step 3.3: prepare the extraction coordinates and extract chromatograms
+        // chrom_list contains one entry for each fragment ion (transition) in transition_exp_used
+        prepareExtractionCoordinates_(chrom_list, coordinates, transition_exp_used, trafo_inverse, cp);
+        extractor.extractChromatograms(current_swath_map_inner, chrom_list, coordinates, cp.mz_extraction_window,
+            cp.ppm, cp.im_extraction_window, cp.extraction_function);
 
+        // Step 3.4: convert chromatograms back to OpenMS::MSChromatogram and write to output
+        PeakMap chrom_exp;
+        extractor.return_chromatogram(chrom_list, coordinates, transition_exp_used,  SpectrumSettings(), 
+                                      chrom_exp.getChromatograms(), false, cp.im_extraction_window);
+
+        // Step 4: score these extracted transitions
+        FeatureMap featureFile;
+        std::vector< OpenSwath::SwathMap > tmp = {swath_maps[i]};
+        tmp.back().sptr = current_swath_map_inner;
+        scoreAllChromatograms_(chrom_exp.getChromatograms(), ms1_chromatograms, tmp, transition_exp_used,
+            feature_finder_param, trafo, cp.rt_extraction_window, featureFile, tsv_writer, osw_writer, ms1_isotopes);
+
+        // Step 5: write all chromatograms and features out into an output object / file
+        // (this needs to be done in a critical section since we only have one
+        // output file and one output map).
+        #pragma omp critical (osw_write_out)
+        {
+          writeOutFeaturesAndChroms_(chrom_exp.getChromatograms(), featureFile, out_featureFile, store_features, chromConsumer);
+        }
 
-            // Step 3: score these extracted transitions
-            FeatureMap featureFile;
-            std::vector< OpenSwath::SwathMap > tmp = {swath_maps[i]};
-            tmp.back().sptr = current_swath_map_inner;
-            scoreAllChromatograms_(chrom_exp.getChromatograms(), ms1_chromatograms, tmp, transition_exp_used,
-                feature_finder_param, trafo, cp.rt_extraction_window, featureFile, tsv_writer, osw_writer, ms1_isotopes);
+        task_timer.stop();
+#ifdef _OPENMP
+#pragma omp critical (osw_write_stdout)
+#endif
+        {
+          std::cout << "Finished SWATH " << i << " (batch " << task.batch << " out of " << task.nr_batches << ") in "
+            << task_timer.getClockTime() << " s" << std::endl;
+        }
 
-            // Step 4: write all chromatograms and features out into an output object / file
-            // (this needs to be done in a critical section since we only have one
-            // output file and one output map).
-            #pragma omp critical (osw_write_out)
-            {
-              writeOutFeaturesAndChroms_(chrom_exp.getChromatograms(), featureFile, out_featureFile, store_features, chromConsumer);
-            }
+        // Step 6: close the window once all of its batches are done (this
+        // releases the in-memory copy and lets the next window be opened)
+        current_swath_map_inner.reset();
+        bool closed = false;
+        {
+          std::lock_guard<std::mutex> lock(task_queue_mutex);
+          if (--window.remaining_tasks == 0)
+          {
+            window.swath_map.reset();
+            window.is_open = false;
+            --open_windows;
+            this->setProgress(++progress);
+            closed = true;
           }
-
-        } // continue 2 (no continue due to OpenMP)
-      } // continue 1 (no continue due to OpenMP)
-
-      #pragma omp critical (progress)
-      this->setProgress(++progress);
-
+        }
+        if (closed) window_closed.notify_all();
+      }
     }
     this->endProgress();
-    
-#ifdef _OPENMP
-#ifdef MT_ENABLE_NESTED_OPENMP
-    if (threads_outer_loop_ > -1)
-    {
-      omp_set_num_threads(total_nr_threads); // set number of available threads back to initial value
-    }
-#endif    
-#endif    
   }
 
   void OpenSwathWorkflow::writeOutFeaturesAndChroms_(
@@ -1281,8 +1281,9 @@ namespace OpenMS
           new_mod->setDiffMonoMass(mass - Residue::getInternalToNTerm().getMonoWeight());
         }
 
-        mod_db->addModification(new_mod);
-        aas.n_term_mod_ = new_mod;
+        // another thread may have added the same modification in the meantime
+        aas.n_term_mod_ = mod_db->addModification(new_mod);
+        if (aas.n_term_mod_ != new_mod) delete new_mod;
       }
       else
       {
@@ -1319,8 +1320,9 @@ namespace OpenMS
           new_mod->setDiffMonoMass(mass - Residue::getInternalToCTerm().getMonoWeight());
         }
 
-        mod_db->addModification(new_mod);
-        aas.c_term_mod_ = new_mod;
+        // another thread may have added the same modification in the meantime
+        aas.c_term_mod_ = mod_db->addModification(new_mod);
+        if (aas.c_term_mod_ != new_mod) delete new_mod;
       }
       else
       {
@@ -1334,6 +1336,7 @@ namespace OpenMS
       String residue_name = aas.peptide_.back()->getOneLetterCode() + "[" + mod + "]"; // e.g. N[12345.6]
       String modification_name = "[" + mod + "]";
 
+      const ResidueModification* res_mod(nullptr);
       if (!mod_db->has(residue_name)) 
       {
         // create new modification
@@ -1359,13 +1362,17 @@ namespace OpenMS
           new_mod->setDiffMonoMass(mass - residue->getMonoWeight());
         }
 
-        mod_db->addModification(new_mod);
+        // another thread may have added the same modification in the meantime
+        res_mod = mod_db->addModification(new_mod);
+        if (res_mod != new_mod) delete new_mod;
+      }
+      else
+      {
+        Size mod_idx = mod_db->findModificationIndex(residue_name);
+        res_mod = mod_db->getModification(mod_idx);
       }
 
       // now use the new modification
-      Size mod_idx = mod_db->findModificationIndex(residue_name);
-      const ResidueModification* res_mod = mod_db->getModification(mod_idx);
-
       // Note: this calls setModification_ on a new Residue which changes its
       // weight to the weight of the modification (set above)
       aas.peptide_.back() = ResidueDB::getInstance()->
@@ -0,0 +1,266 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CHEMISTRY/AASequencePool.h>
+
+#include <OpenMS/CHEMISTRY/ResidueDB.h>
+#include <OpenMS/CHEMISTRY/ResidueModification.h>
+#include <OpenMS/CONCEPT/Constants.h>
+
+#include <functional>
+
+using namespace std;
+
+namespace OpenMS
+{
+
+  namespace
+  {
+    // monoisotopic weight that turns internal residues into an ion of the given type
+    // (precomputed, the EmpiricalFormula objects would be evaluated on every call)
+    struct InternalToIonWeights
+    {
+      double weight[Residue::SizeOfResidueType];
+      bool valid[Residue::SizeOfResidueType];
+
+      InternalToIonWeights()
+      {
+        for (Size i = 0; i < Residue::SizeOfResidueType; ++i)
+        {
+          weight[i] = 0.0;
+          valid[i] = false;
+        }
+        set_(Residue::Full, Residue::getInternalToFull());
+        set_(Residue::Internal, EmpiricalFormula());
+        set_(Residue::NTerminal, Residue::getInternalToNTerm());
+        set_(Residue::CTerminal, Residue::getInternalToCTerm());
+        set_(Residue::AIon, Residue::getInternalToAIon());
+        set_(Residue::BIon, Residue::getInternalToBIon());
+        set_(Residue::CIon, Residue::getInternalToCIon());
+        set_(Residue::XIon, Residue::getInternalToXIon());
+        set_(Residue::YIon, Residue::getInternalToYIon());
+        set_(Residue::ZIon, Residue::getInternalToZIon());
+      }
+
+      void set_(Residue::ResidueType type, const EmpiricalFormula& ef)
+      {
+        weight[type] = ef.getMonoWeight();
+        valid[type] = true;
+      }
+    };
+
+    const InternalToIonWeights& internalToIonWeights()
+    {
+      static const InternalToIonWeights weights;
+      return weights;
+    }
+
+    bool hasNTerminus(Residue::ResidueType type)
+    {
+      return type == Residue::Full || type == Residue::AIon ||
+        type == Residue::BIon || type == Residue::CIon ||
+        type == Residue::NTerminal;
+    }
+
+    bool hasCTerminus(Residue::ResidueType type)
+    {
+      return type == Residue::Full || type == Residue::XIon ||
+        type == Residue::YIon || type == Residue::ZIon ||
+        type == Residue::CTerminal;
+    }
+  }
+
+  InternedAASequence::InternedAASequence() :
+    entry_(emptyEntry_())
+  {
+  }
+
+  InternedAASequence::InternedAASequence(const Entry_* entry) :
+    entry_(entry)
+  {
+  }
+
+  const InternedAASequence::Entry_* InternedAASequence::emptyEntry_()
+  {
+    static const Entry_ empty = []()
+    {
+      Entry_ entry;
+      entry.hash = std::hash<std::string>()(entry.string);
+      entry.prefix_masses.assign(1, 0.0);
+      entry.n_term_mass = 0.0;
+      entry.c_term_mass = 0.0;
+      entry.has_mass = false; // AASequence reports the error for empty sequences
+      return entry;
+    }();
+    return &empty;
+  }
+
+  double InternedAASequence::getMonoWeight(Residue::ResidueType type, Int charge) const
+  {
+    if (!entry_->has_mass || !internalToIonWeights().valid[type])
+    {
+      return entry_->sequence.getMonoWeight(type, charge);
+    }
+    return getMonoWeight_(0, size(), true, true, type, charge);
+  }
+
+  double InternedAASequence::getPrefixMonoWeight(Size length, Residue::ResidueType type, Int charge) const
+  {
+    if (length > size())
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, length, size());
+    }
+    if (length == 0 || !entry_->has_mass || !internalToIonWeights().valid[type])
+    {
+      return entry_->sequence.getPrefix(length).getMonoWeight(type, charge);
+    }
+    return getMonoWeight_(0, length, true, length == size(), type, charge);
+  }
+
+  double InternedAASequence::getSuffixMonoWeight(Size length, Residue::ResidueType type, Int charge) const
+  {
+    if (length > size())
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, length, size());
+    }
+    if (length == 0 || !entry_->has_mass || !internalToIonWeights().valid[type])
+    {
+      return entry_->sequence.getSuffix(length).getMonoWeight(type, charge);
+    }
+    return getMonoWeight_(size() - length, size(), length == size(), true, type, charge);
+  }
+
+  const EmpiricalFormula& InternedAASequence::getFormula() const
+  {
+    if (!entry_->has_mass)
+    {
+      // let AASequence report the problem
+      entry_->sequence.getFormula();
+    }
+    return entry_->formula;
+  }
+
+  double InternedAASequence::getMonoWeight_(Size begin, Size end, bool n_term, bool c_term, Residue::ResidueType type, Int charge) const
+  {
+    double weight = Constants::PROTON_MASS_U * charge + internalToIonWeights().weight[type] +
+      entry_->prefix_masses[end] - entry_->prefix_masses[begin];
+    if (n_term && hasNTerminus(type))
+    {
+      weight += entry_->n_term_mass;
+    }
+    if (c_term && hasCTerminus(type))
+    {
+      weight += entry_->c_term_mass;
+    }
+    return weight;
+  }
+
+  AASequencePool::AASequencePool()
+  {
+  }
+
+  AASequencePool::~AASequencePool()
+  {
+  }
+
+  InternedAASequence AASequencePool::fromString(const String& s, bool permissive)
+  {
+    unordered_map<string, const InternedAASequence::Entry_*>::const_iterator it = aliases_.find(s);
+    if (it != aliases_.end())
+    {
+      return InternedAASequence(it->second);
+    }
+    const InternedAASequence::Entry_* entry = intern_(AASequence::fromString(s, permissive));
+    aliases_.emplace(s, entry);
+    return InternedAASequence(entry);
+  }
+
+  InternedAASequence AASequencePool::intern(const AASequence& seq)
+  {
+    return InternedAASequence(intern_(seq));
+  }
+
+  Size AASequencePool::size() const
+  {
+    return entries_.size();
+  }
+
+  void AASequencePool::clear()
+  {
+    aliases_.clear();
+    entries_.clear();
+  }
+
+  const InternedAASequence::Entry_* AASequencePool::intern_(const AASequence& seq)
+  {
+    if (seq.empty()) return InternedAASequence::emptyEntry_();
+
+    String key = seq.toString();
+    unordered_map<string, unique_ptr<InternedAASequence::Entry_> >::const_iterator it = entries_.find(key);
+    if (it != entries_.end()) return it->second.get();
+
+    unique_ptr<InternedAASequence::Entry_> entry(new InternedAASequence::Entry_());
+    entry->sequence = seq;
+    entry->string = key;
+    entry->hash = std::hash<std::string>()(key);
+
+    static const Residue* const unknown = ResidueDB::getInstance()->getResidue("X");
+    entry->has_mass = true;
+    entry->prefix_masses.reserve(seq.size() + 1);
+    entry->prefix_masses.push_back(0.0);
+    for (Size i = 0; i < seq.size(); ++i)
+    {
+      const Residue* residue = &seq[i];
+      if (residue == unknown)
+      {
+        entry->has_mass = false;
+        entry->prefix_masses.clear();
+        break;
+      }
+      entry->prefix_masses.push_back(entry->prefix_masses.back() + residue->getMonoWeight(Residue::Internal));
+    }
+
+    entry->n_term_mass = seq.hasNTerminalModification() ? seq.getNTerminalModification()->getDiffMonoMass() : 0.0;
+    entry->c_term_mass = seq.hasCTerminalModification() ? seq.getCTerminalModification()->getDiffMonoMass() : 0.0;
+    if (entry->has_mass)
+    {
+      entry->formula = seq.getFormula();
+    }
+
+    const InternedAASequence::Entry_* result = entry.get();
+    entries_.emplace(key, std::move(entry));
+    return result;
+  }
+
+} // namespace OpenMS
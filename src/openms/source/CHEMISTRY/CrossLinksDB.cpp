@@ -45,19 +45,13 @@ namespace OpenMS
 {
   CrossLinksDB::CrossLinksDB()
   {
-    mods_.clear();
-    modification_names_.clear();
+    clear_();
     readFromOBOFile("CHEMISTRY/XLMOD.obo");
   }
 
 
   CrossLinksDB::~CrossLinksDB()
   {
-    modification_names_.clear();
-    for (vector<ResidueModification*>::iterator it = mods_.begin(); it != mods_.end(); ++it)
-    {
-      delete *it;
-    }
   }
 
   void CrossLinksDB::readFromOBOFile(const String& filename)
@@ -320,11 +314,12 @@ namespace OpenMS
       if (it->second.getUniModRecordId() > 0)
       {
         //cerr << "Found UniMod PSI-MOD mapping: " << it->second.getPSIMODAccession() << " " << it->second.getUniModAccession() << endl;
-        set<const ResidueModification*> mods = modification_names_[it->second.getUniModAccession()];
+        set<const ResidueModification*> mods;
+        findModificationsByName_(it->second.getUniModAccession(), mods);
         for (set<const ResidueModification*>::const_iterator mit = mods.begin(); mit != mods.end(); ++mit)
         {
           //cerr << "Adding PSIMOD accession: " << it->second.getPSIMODAccession() << " " << it->second.getUniModAccession() << endl;
-          modification_names_[it->second.getPSIMODAccession()].insert(*mit);
+          addName_(it->second.getPSIMODAccession(), *mit);
         }
       }
       else
@@ -335,7 +330,7 @@ namespace OpenMS
             ((it->second.getTermSpecificity() != ResidueModification::ANYWHERE) &&
              (it->second.getDiffMonoMass() != 0)))
         {
-          mods_.push_back(new ResidueModification(it->second));
+          ResidueModification* new_mod = new ResidueModification(it->second);
 
           set<String> synonyms = it->second.getSynonyms();
           synonyms.insert(it->first);
@@ -343,15 +338,16 @@ namespace OpenMS
           //synonyms.insert(it->second.getUniModAccession());
           synonyms.insert(it->second.getPSIMODAccession());
           // full ID is auto-generated based on (short) ID, but we want the name instead:
-          mods_.back()->setId(it->second.getFullName());
-          mods_.back()->setFullId();
-          mods_.back()->setId(it->second.getId());
-          synonyms.insert(mods_.back()->getFullId());
+          new_mod->setId(it->second.getFullName());
+          new_mod->setFullId();
+          new_mod->setId(it->second.getId());
+          synonyms.insert(new_mod->getFullId());
+          addMod_(new_mod);
 
           // now check each of the names and link it to the residue modification
           for (set<String>::const_iterator nit = synonyms.begin(); nit != synonyms.end(); ++nit)
           {
-            modification_names_[*nit].insert(mods_.back());
+            addName_(*nit, new_mod);
           }
         }
       }
@@ -362,11 +358,12 @@ namespace OpenMS
   {
     modifications.clear();
 
-    for (vector<ResidueModification*>::const_iterator it = mods_.begin(); it != mods_.end(); ++it)
+    const Size n = size_();
+    for (Size i = 0; i != n; ++i)
     {
-      if ((*it)->getPSIMODAccession() != "")
+      if (at_(i)->getPSIMODAccession() != "")
       {
-        modifications.push_back((*it)->getFullId());
+        modifications.push_back(at_(i)->getFullId());
       }
     }
     sort(modifications.begin(), modifications.end());
@@ -46,12 +46,159 @@
 
 #include <boost/math/special_functions/binomial.hpp>
 
+#include <functional>
 #include <iostream>
+#include <stdexcept>
 
 using namespace std;
 
 namespace OpenMS
 {
+  EmpiricalFormula::MapType_::MapType_() :
+    data_(inline_),
+    size_(0),
+    capacity_(INLINE_CAPACITY)
+  {
+  }
+
+  EmpiricalFormula::MapType_::MapType_(const MapType_& rhs) :
+    data_(inline_),
+    size_(0),
+    capacity_(INLINE_CAPACITY)
+  {
+    *this = rhs;
+  }
+
+  EmpiricalFormula::MapType_::MapType_(MapType_&& rhs) noexcept :
+    data_(inline_),
+    size_(0),
+    capacity_(INLINE_CAPACITY)
+  {
+    *this = std::move(rhs);
+  }
+
+  EmpiricalFormula::MapType_::~MapType_()
+  {
+    reset_();
+  }
+
+  EmpiricalFormula::MapType_& EmpiricalFormula::MapType_::operator=(const MapType_& rhs)
+  {
+    if (&rhs == this) return *this;
+    size_ = 0;
+    reserve_(rhs.size_);
+    std::copy(rhs.begin(), rhs.end(), data_);
+    size_ = rhs.size_;
+    return *this;
+  }
+
+  EmpiricalFormula::MapType_& EmpiricalFormula::MapType_::operator=(MapType_&& rhs) noexcept
+  {
+    if (&rhs == this) return *this;
+    if (rhs.data_ == rhs.inline_)
+    {
+      // inline storage cannot be stolen, copying is cheap anyway
+      size_ = 0;
+      std::copy(rhs.begin(), rhs.end(), data_);
+    }
+    else
+    {
+      reset_();
+      data_ = rhs.data_;
+      capacity_ = rhs.capacity_;
+      rhs.data_ = rhs.inline_;
+      rhs.capacity_ = INLINE_CAPACITY;
+    }
+    size_ = rhs.size_;
+    rhs.size_ = 0;
+    return *this;
+  }
+
+  EmpiricalFormula::MapType_::iterator EmpiricalFormula::MapType_::lowerBound_(const Element* element) const
+  {
+    // formulae are short: a linear scan beats binary search here
+    std::less<const Element*> less;
+    value_type* it = data_;
+    value_type* last = data_ + size_;
+    while (it != last && less(it->first, element)) ++it;
+    return it;
+  }
+
+  EmpiricalFormula::MapType_::iterator EmpiricalFormula::MapType_::find(const Element* element)
+  {
+    iterator it = lowerBound_(element);
+    return (it != end() && it->first == element) ? it : end();
+  }
+
+  EmpiricalFormula::MapType_::const_iterator EmpiricalFormula::MapType_::find(const Element* element) const
+  {
+    const_iterator it = lowerBound_(element);
+    return (it != end() && it->first == element) ? it : end();
+  }
+
+  std::pair<EmpiricalFormula::MapType_::iterator, bool> EmpiricalFormula::MapType_::insert(const value_type& value)
+  {
+    Size pos = lowerBound_(value.first) - data_;
+    if (pos != size_ && data_[pos].first == value.first)
+    {
+      return std::make_pair(data_ + pos, false);
+    }
+    if (size_ == capacity_) reserve_(2 * capacity_);
+    std::copy_backward(data_ + pos, data_ + size_, data_ + size_ + 1);
+    data_[pos] = value;
+    ++size_;
+    return std::make_pair(data_ + pos, true);
+  }
+
+  SignedSize& EmpiricalFormula::MapType_::operator[](const Element* element)
+  {
+    return insert(value_type(element, 0)).first->second;
+  }
+
+  SignedSize& EmpiricalFormula::MapType_::at(const Element* element)
+  {
+    iterator it = find(element);
+    if (it == end())
+    {
+      throw std::out_of_range("EmpiricalFormula: element not contained in formula");
+    }
+    return it->second;
+  }
+
+  EmpiricalFormula::MapType_::iterator EmpiricalFormula::MapType_::erase(iterator pos)
+  {
+    std::copy(pos + 1, end(), pos);
+    --size_;
+    return pos;
+  }
+
+  bool EmpiricalFormula::MapType_::operator==(const MapType_& rhs) const
+  {
+    return size_ == rhs.size_ && std::equal(begin(), end(), rhs.begin());
+  }
+
+  bool EmpiricalFormula::MapType_::operator!=(const MapType_& rhs) const
+  {
+    return !(*this == rhs);
+  }
+
+  void EmpiricalFormula::MapType_::reserve_(Size capacity)
+  {
+    if (capacity <= capacity_) return;
+    value_type* data = new value_type[capacity];
+    std::copy(begin(), end(), data);
+    if (data_ != inline_) delete[] data_;
+    data_ = data;
+    capacity_ = capacity;
+  }
+
+  void EmpiricalFormula::MapType_::reset_()
+  {
+    if (data_ != inline_) delete[] data_;
+    data_ = inline_;
+    capacity_ = INLINE_CAPACITY;
+  }
+
   EmpiricalFormula::EmpiricalFormula() :
     charge_(0)
   {}
@@ -422,7 +569,7 @@ namespace OpenMS
     return os;
   }
 
-  Int EmpiricalFormula::parseFormula_(std::map<const Element*, SignedSize>& ef, const String& input_formula) const
+  Int EmpiricalFormula::parseFormula_(MapType_& ef, const String& input_formula) const
   {
     Int charge = 0;
     String formula(input_formula);
@@ -586,7 +733,7 @@ namespace OpenMS
         if (num != 0)
         {
           const Element* e = db->getElement(symbol);
-          std::map<const Element*, SignedSize>::iterator it = ef.find(e);
+          MapType_::iterator it = ef.find(e);
           if (it != ef.end())
           {
             it->second += num;
@@ -604,12 +751,12 @@ namespace OpenMS
     }
 
     // remove elements with 0 counts
-    std::map<const Element*, SignedSize>::iterator it = ef.begin();
+    MapType_::iterator it = ef.begin();
     while (it != ef.end())
     {
       if (it->second == 0)
       {
-        ef.erase(it++);   // Note: post increment needed! Otherwise iterator is invalidated
+        it = ef.erase(it);
       }
       else
       {
@@ -627,7 +774,7 @@ namespace OpenMS
     {
       if (it->second == 0)
       {
-        formula_.erase(it++);   // Note: post increment needed! Otherwise iterator is invalidated
+        it = formula_.erase(it);
       }
       else
       {
@@ -244,7 +244,7 @@ namespace OpenMS
     {
       if (sequence.size() >= min_length && sequence.size() <= max_length)
       {
-        output.emplace_back(0, sequence.size() - 1);
+        output.emplace_back(0, sequence.size());
       }
       return wrong_size;
     }
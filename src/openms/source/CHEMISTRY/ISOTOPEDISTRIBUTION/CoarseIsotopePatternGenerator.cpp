@@ -37,6 +37,7 @@
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsotopeDistribution.h>
 #include <OpenMS/CHEMISTRY/EmpiricalFormula.h>
 #include <OpenMS/CHEMISTRY/Element.h>
+#include <OpenMS/CHEMISTRY/ElementDB.h>
 #include <include/OpenMS/CONCEPT/Constants.h>
 
 #include <cmath>
@@ -45,12 +46,32 @@
 #include <algorithm>
 #include <limits>
 #include <functional>
+#include <map>
 #include <numeric>
+#include <tuple>
+#include <vector>
 
 using namespace std;
 
 namespace OpenMS
 {
+  namespace
+  {
+    /// key of the pattern cache: maximal isotope, mass rounding and element composition of the formula
+    typedef std::vector<std::pair<const Element*, SignedSize> > ElementCounts;
+    typedef std::tuple<Size, bool, ElementCounts> PatternKey;
+
+    /// number of cached patterns after which the cache of a thread is flushed (bounds memory use)
+    const Size MAX_CACHED_PATTERNS = 10000;
+
+    /// per-thread cache of averagine isotope distributions (lookups need no locking)
+    std::map<PatternKey, IsotopeDistribution>& patternCache()
+    {
+      static thread_local std::map<PatternKey, IsotopeDistribution> cache;
+      return cache;
+    }
+  }
+
   CoarseIsotopePatternGenerator::CoarseIsotopePatternGenerator() : 
     IsotopePatternGenerator(),
     max_isotope_(0),
@@ -116,6 +137,36 @@ namespace OpenMS
     return result;
   }
 
+  IsotopeDistribution CoarseIsotopePatternGenerator::runCached_(const EmpiricalFormula& formula) const
+  {
+    // only elements owned by ElementDB are guaranteed to outlive the cache
+    // (isotopes like (13)C are owned as well, but not under their atomic number)
+    const ElementDB* db = ElementDB::getInstance();
+    for (auto it = formula.begin(); it != formula.end(); ++it)
+    {
+      if (db->getElement(it->first->getSymbol()) != it->first)
+      {
+        return run(formula);
+      }
+    }
+
+    std::map<PatternKey, IsotopeDistribution>& cache = patternCache();
+    PatternKey key(max_isotope_, round_masses_, ElementCounts(formula.begin(), formula.end()));
+    auto cache_it = cache.find(key);
+    if (cache_it != cache.end())
+    {
+      return cache_it->second;
+    }
+
+    if (cache.size() >= MAX_CACHED_PATTERNS)
+    {
+      cache.clear();
+    }
+    IsotopeDistribution result = run(formula);
+    cache.emplace(std::move(key), result);
+    return result;
+  }
+
   IsotopeDistribution CoarseIsotopePatternGenerator::estimateFromPeptideWeight(double average_weight)
   {
     // Element counts are from Senko's Averagine model
@@ -142,14 +193,14 @@ namespace OpenMS
   {
     EmpiricalFormula ef;
     ef.estimateFromWeightAndComp(average_weight, C, H, N, O, S, P);
-    return ef.getIsotopeDistribution(*this);
+    return runCached_(ef);
   }
 
   IsotopeDistribution CoarseIsotopePatternGenerator::estimateFromWeightAndCompAndS(double average_weight, UInt S, double C, double H, double N, double O, double P)
   {
     EmpiricalFormula ef;
     ef.estimateFromWeightAndCompAndS(average_weight, S, C, H, N, O, P);
-    return ef.getIsotopeDistribution(*this);
+    return runCached_(ef);
   }
 
   IsotopeDistribution CoarseIsotopePatternGenerator::estimateForFragmentFromPeptideWeight(double average_weight_precursor, double average_weight_fragment, const std::set<UInt>& precursor_isotopes)
@@ -171,7 +222,7 @@ namespace OpenMS
     EmpiricalFormula ef_fragment;
     ef_fragment.estimateFromWeightAndCompAndS(average_weight_fragment, S_fragment, 4.9384, 7.7583, 1.3577, 1.4773, 0);
 
-    IsotopeDistribution id_fragment(ef_fragment.getIsotopeDistribution(solver));
+    IsotopeDistribution id_fragment(solver.runCached_(ef_fragment));
     IsotopeDistribution id_comp_fragment(solver.estimateFromPeptideWeightAndS(average_weight_comp_fragment, S_comp_fragment));
 
     IsotopeDistribution result = calcFragmentIsotopeDist(id_fragment, id_comp_fragment, precursor_isotopes, ef_fragment.getMonoWeight());
@@ -198,11 +249,11 @@ namespace OpenMS
 
     EmpiricalFormula ef_fragment;
     ef_fragment.estimateFromWeightAndComp(average_weight_fragment, C, H, N, O, S, P);
-    IsotopeDistribution id_fragment = ef_fragment.getIsotopeDistribution(solver);
+    IsotopeDistribution id_fragment = solver.runCached_(ef_fragment);
 
     EmpiricalFormula ef_comp_frag;
     ef_comp_frag.estimateFromWeightAndComp(average_weight_precursor-average_weight_fragment, C, H, N, O, S, P);
-    IsotopeDistribution id_comp_fragment = ef_comp_frag.getIsotopeDistribution(solver);
+    IsotopeDistribution id_comp_fragment = solver.runCached_(ef_comp_frag);
 
     IsotopeDistribution result = calcFragmentIsotopeDist(id_fragment, id_comp_fragment, precursor_isotopes, ef_fragment.getMonoWeight());
 
@@ -251,15 +302,26 @@ namespace OpenMS
 
     // fill result with probabilities
     // (we loop backwards because then the small products tend to come first, for better numerics)
-    for (SignedSize i = left_l.size() - 1; i >= 0; --i)
+    // The products are accumulated in plain arrays so the compiler can vectorize the inner
+    // loop; every entry still receives its summands in the same order.
+    std::vector<Peak1D::IntensityType> left_int = intensities_(left_l);
+    std::vector<Peak1D::IntensityType> right_int = intensities_(right_l);
+    std::vector<Peak1D::IntensityType> result_int(r_max, 0);
+    for (SignedSize i = left_int.size() - 1; i >= 0; --i)
     {
-      for (SignedSize j = min<SignedSize>(r_max - i, right_l.size()) - 1; j >= 0; --j)
+      const Peak1D::IntensityType left_i = left_int[i];
+      const SignedSize j_end = min<SignedSize>(r_max - i, right_int.size());
+      if (j_end <= 0) continue; // only contributes beyond max_isotope
+      Peak1D::IntensityType* target = &result_int[i];
+      for (SignedSize j = 0; j < j_end; ++j)
       {
-        Peak1D& peak = result[i + j];
-        Peak1D::IntensityType p_intensity = peak.getIntensity();
-        peak.setIntensity( p_intensity + left_l[i].getIntensity() * right_l[j].getIntensity());
+        target[j] += left_i * right_int[j];
       }
     }
+    for (IsotopeDistribution::ContainerType::size_type i = 0; i != r_max; ++i)
+    {
+      result[i].setIntensity(result_int[i]);
+    }
     return result;
   }
 
@@ -338,14 +400,24 @@ namespace OpenMS
     }
 
     // we loop backwards because then the small products tend to come first
-    // (for better numerics)
-    for (SignedSize i = input.size() - 1; i >= 0; --i)
+    // (for better numerics); see convolve_() for the vectorization-friendly layout
+    std::vector<Peak1D::IntensityType> input_int = intensities_(input);
+    std::vector<Peak1D::IntensityType> result_int(r_max, 0);
+    for (SignedSize i = input_int.size() - 1; i >= 0; --i)
     {
-      for (SignedSize j = min<SignedSize>(r_max - i, input.size()) - 1; j >= 0; --j)
+      const Peak1D::IntensityType input_i = input_int[i];
+      const SignedSize j_end = min<SignedSize>(r_max - i, input_int.size());
+      if (j_end <= 0) continue; // only contributes beyond max_isotope
+      Peak1D::IntensityType* target = &result_int[i];
+      for (SignedSize j = 0; j < j_end; ++j)
       {
-        result[i + j].setIntensity( result[i + j].getIntensity() + input[i].getIntensity() * input[j].getIntensity());
+        target[j] += input_i * input_int[j];
       }
     }
+    for (IsotopeDistribution::ContainerType::size_type i = 0; i != r_max; ++i)
+    {
+      result[i].setIntensity(result_int[i]);
+    }
 
     return result;
   }
@@ -425,6 +497,16 @@ namespace OpenMS
 
   }
 
+  std::vector<Peak1D::IntensityType> CoarseIsotopePatternGenerator::intensities_(const IsotopeDistribution::ContainerType& id) const
+  {
+    std::vector<Peak1D::IntensityType> result(id.size());
+    for (Size i = 0; i < id.size(); ++i)
+    {
+      result[i] = id[i].getIntensity();
+    }
+    return result;
+  }
+
   IsotopeDistribution::ContainerType CoarseIsotopePatternGenerator::fillGaps_(const IsotopeDistribution::ContainerType& id) const
   {
     IsotopeDistribution::ContainerType id_gapless;
@@ -50,8 +50,18 @@ namespace OpenMS
 {
   bool ModificationsDB::is_instantiated_ = false;
 
-  ModificationsDB::ModificationsDB(OpenMS::String unimod_file, OpenMS::String psimod_file, OpenMS::String xlmod_file)
+  ModificationsDB::ModificationsDB(OpenMS::String unimod_file, OpenMS::String psimod_file, OpenMS::String xlmod_file) :
+    mods_size_(0)
   {
+    for (Size i = 0; i < MAX_MODS_BLOCKS; ++i)
+    {
+      mods_blocks_[i] = nullptr;
+    }
+    for (Size i = 0; i < NR_NAME_BUCKETS; ++i)
+    {
+      name_buckets_[i].store(nullptr, std::memory_order_relaxed);
+    }
+
     if (!unimod_file.empty())
     {
       readFromUnimodXMLFile(unimod_file);
@@ -72,11 +82,7 @@ namespace OpenMS
 
   ModificationsDB::~ModificationsDB()
   {
-    modification_names_.clear();
-    for (auto it = mods_.begin(); it != mods_.end(); ++it)
-    {
-      delete *it;
-    }
+    clear_();
   }
 
   bool ModificationsDB::isInstantiated()
@@ -84,21 +90,113 @@ namespace OpenMS
     return is_instantiated_;
   }
 
-  Size ModificationsDB::getNumberOfModifications() const
+  void ModificationsDB::findModificationsByName_(const String& name, set<const ResidueModification*>& mods) const
+  {
+    const Size bucket = std::hash<std::string>()(name) % NR_NAME_BUCKETS;
+    // entries are fully constructed before they are published (release),
+    // so the chain can be traversed without a lock
+    for (const NameEntry_* e = name_buckets_[bucket].load(std::memory_order_acquire); e != nullptr; e = e->next)
+    {
+      if (e->name == name) mods.insert(e->mod);
+    }
+  }
+
+  bool ModificationsDB::hasName_(const String& name) const
   {
-    Size s;
-    #pragma omp critical (OpenMS_ModificationsDB)
+    return findName_(name) != nullptr;
+  }
+
+  const ResidueModification* ModificationsDB::findName_(const String& name) const
+  {
+    const Size bucket = std::hash<std::string>()(name) % NR_NAME_BUCKETS;
+    for (const NameEntry_* e = name_buckets_[bucket].load(std::memory_order_acquire); e != nullptr; e = e->next)
     {
-      s = mods_.size();
+      if (e->name == name) return e->mod;
     }
-    return s;
+    return nullptr;
+  }
+
+  Size ModificationsDB::size_() const
+  {
+    return mods_size_.load(std::memory_order_acquire);
+  }
+
+  const ResidueModification* ModificationsDB::at_(Size index) const
+  {
+    // blocks and entries below size_() were written before the size was published
+    return mods_blocks_[index / MODS_BLOCK_SIZE][index % MODS_BLOCK_SIZE];
+  }
+
+  void ModificationsDB::addMod_(ResidueModification* mod)
+  {
+    const Size index = mods_size_.load(std::memory_order_relaxed);
+    const Size block = index / MODS_BLOCK_SIZE;
+    if (block >= MAX_MODS_BLOCKS)
+    {
+      throw Exception::OutOfRange(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
+    }
+    if (mods_blocks_[block] == nullptr)
+    {
+      mods_blocks_[block] = new ResidueModification*[MODS_BLOCK_SIZE];
+    }
+    mods_blocks_[block][index % MODS_BLOCK_SIZE] = mod;
+    // publish
+    mods_size_.store(index + 1, std::memory_order_release);
+  }
+
+  void ModificationsDB::addName_(const String& name, const ResidueModification* mod)
+  {
+    std::atomic<NameEntry_*>& head = name_buckets_[std::hash<std::string>()(name) % NR_NAME_BUCKETS];
+    for (const NameEntry_* e = head.load(std::memory_order_relaxed); e != nullptr; e = e->next)
+    {
+      if (e->mod == mod && e->name == name) return; // already linked
+    }
+
+    NameEntry_* e = new NameEntry_();
+    e->name = name;
+    e->mod = mod;
+    e->next = head.load(std::memory_order_relaxed);
+    // publish
+    head.store(e, std::memory_order_release);
+  }
+
+  void ModificationsDB::clear_()
+  {
+    for (Size i = 0; i < NR_NAME_BUCKETS; ++i)
+    {
+      NameEntry_* e = name_buckets_[i].load(std::memory_order_relaxed);
+      while (e != nullptr)
+      {
+        NameEntry_* next = e->next;
+        delete e;
+        e = next;
+      }
+      name_buckets_[i].store(nullptr, std::memory_order_relaxed);
+    }
+
+    const Size n = mods_size_.load(std::memory_order_relaxed);
+    for (Size i = 0; i < n; ++i)
+    {
+      delete mods_blocks_[i / MODS_BLOCK_SIZE][i % MODS_BLOCK_SIZE];
+    }
+    for (Size i = 0; i < MAX_MODS_BLOCKS; ++i)
+    {
+      delete[] mods_blocks_[i];
+      mods_blocks_[i] = nullptr;
+    }
+    mods_size_.store(0, std::memory_order_relaxed);
+  }
+
+  Size ModificationsDB::getNumberOfModifications() const
+  {
+    return size_();
   }
 
 
   const ResidueModification* ModificationsDB::getModification(Size index) const
   {
-    OPENMS_PRECONDITION(index < mods_.size(), "Index out of bounds in ModificationsDB::getModification(Size index)." );
-    return mods_[index];
+    OPENMS_PRECONDITION(index < size_(), "Index out of bounds in ModificationsDB::getModification(Size index)." );
+    return at_(index);
   }
 
 
@@ -111,38 +209,33 @@ namespace OpenMS
 
     String mod_name = mod_name_;
 
-    #pragma omp critical(OpenMS_ModificationsDB)
+    set<const ResidueModification*> temp;
+    findModificationsByName_(mod_name, temp);
+    if (temp.empty())
     {
-      bool found = true;
-      if (!modification_names_.has(mod_name))
+      // Try to fix things, Skyline for example uses unimod:10 and not UniMod:10 syntax
+      if (mod_name.size() > 6 && mod_name.prefix(6).toLower() == "unimod")
       {
-        // Try to fix things, Skyline for example uses unimod:10 and not UniMod:10 syntax
-        if (mod_name.size() > 6 && mod_name.prefix(6).toLower() == "unimod")
-        {
-          mod_name = "UniMod" + mod_name.substr(6, mod_name.size() - 6);
-        }
+        mod_name = "UniMod" + mod_name.substr(6, mod_name.size() - 6);
+        findModificationsByName_(mod_name, temp);
+      }
 
-        if (!modification_names_.has(mod_name))
-        {
-          OPENMS_LOG_WARN << OPENMS_PRETTY_FUNCTION << "Modification not found: " << mod_name << endl;
-          found = false; 
-        }
+      if (temp.empty())
+      {
+        OPENMS_LOG_WARN << OPENMS_PRETTY_FUNCTION << "Modification not found: " << mod_name << endl;
+        return;
       }
+    }
 
-      if (found)
+    for (const auto& it : temp)
+    {
+      if (residuesMatch_(residue, it) &&
+           (term_spec == ResidueModification::NUMBER_OF_TERM_SPECIFICITY ||
+           (term_spec == it->getTermSpecificity())))
       {
-        const set<const ResidueModification*>& temp = modification_names_[mod_name];
-        for (const auto& it : temp)
-        {
-          if (residuesMatch_(residue, it) &&
-               (term_spec == ResidueModification::NUMBER_OF_TERM_SPECIFICITY ||
-               (term_spec == it->getTermSpecificity())))
-          {
-            mods.insert(it);
-          }
-        }
+        mods.insert(it);
       }
-    } 
+    }
   }
 
   const ResidueModification* ModificationsDB::getModification(const String& mod_name, const String& residue, ResidueModification::TermSpecificity term_spec) const
@@ -179,70 +272,48 @@ namespace OpenMS
 
   bool ModificationsDB::has(String modification) const
   {
-    bool has_mod;
-    #pragma omp critical(OpenMS_ModificationsDB)
-    {
-      has_mod = modification_names_.has(modification);
-    }
-    return has_mod;
+    return hasName_(modification);
   }
 
   Size ModificationsDB::findModificationIndex(const String & mod_name) const
   {
-    if (!has(mod_name))
+    set<const ResidueModification*> mods;
+    findModificationsByName_(mod_name, mods);
+    if (mods.empty())
     {
       throw Exception::ElementNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Modification not found: " + mod_name);
     }
-
-    bool one_mod(true);
-    #pragma omp critical(OpenMS_ModificationsDB)
-    {
-      if (modification_names_[mod_name].size() > 1)
-      {
-        one_mod = false;
-      }
-    }
-    if (!one_mod) 
+    if (mods.size() > 1)
     {
       throw Exception::ElementNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "More than one modification with name: " + mod_name);
     }
 
-    Size index(numeric_limits<Size>::max());
-    #pragma omp critical(OpenMS_ModificationsDB)
+    const ResidueModification* mod = *mods.begin();
+    const Size n = size_();
+    for (Size i = 0; i != n; ++i)
     {
-      const ResidueModification* mod = *modification_names_[mod_name].begin();
-      for (Size i = 0; i != mods_.size(); ++i)
+      if (at_(i) == mod)
       {
-        if (mods_[i] == mod)
-        {
-          index = i;
-          break;
-        }
+        return i;
       }
     }
-
-    if (index == numeric_limits<Size>::max())
-    {
-      throw Exception::ElementNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Modification name found but modification not found: " + mod_name);
-    }
-    return index;
+    throw Exception::ElementNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Modification name found but modification not found: " + mod_name);
   }
 
 
   void ModificationsDB::searchModificationsByDiffMonoMass(vector<String>& mods, double mass, double max_error, const String& residue, ResidueModification::TermSpecificity term_spec)
   {
     mods.clear();
-    #pragma omp critical(OpenMS_ModificationsDB)
+    const Size n = size_();
+    for (Size i = 0; i != n; ++i)
     {
-      for (auto const & m : mods_)
+      const ResidueModification* m = at_(i);
+      if ((fabs(m->getDiffMonoMass() - mass) <= max_error) &&
+          residuesMatch_(residue, m) &&
+          ((term_spec == ResidueModification::NUMBER_OF_TERM_SPECIFICITY) ||
+           (term_spec == m->getTermSpecificity())))
       {
-        if ((fabs(m->getDiffMonoMass() - mass) <= max_error) &&
-            residuesMatch_(residue, m) &&
-            ((term_spec == ResidueModification::NUMBER_OF_TERM_SPECIFICITY) ||
-             (term_spec == m->getTermSpecificity())))
-        {
-          mods.push_back(m->getFullId());
-        }
+        mods.push_back(m->getFullId());
       }
     }
   }
@@ -252,22 +323,21 @@ namespace OpenMS
   {
     double min_error = max_error;
     const ResidueModification* mod = nullptr;
-    #pragma omp critical(OpenMS_ModificationsDB)
+    const Size n = size_();
+    for (Size i = 0; i != n; ++i)
     {
-      for (auto const & m : mods_)
+      const ResidueModification* m = at_(i);
+      // using less instead of less-or-equal will pick the first matching
+      // modification of equally heavy modifications (in our case this is the
+      // first matching UniMod entry)
+      double mass_error = fabs(m->getDiffMonoMass() - mass);
+      if ((mass_error < min_error) &&
+          residuesMatch_(residue, m) &&
+          ((term_spec == ResidueModification::NUMBER_OF_TERM_SPECIFICITY) ||
+           (term_spec == m->getTermSpecificity())))
       {
-        // using less instead of less-or-equal will pick the first matching
-        // modification of equally heavy modifications (in our case this is the
-        // first matching UniMod entry)
-        double mass_error = fabs(m->getDiffMonoMass() - mass);
-        if ((mass_error < min_error) &&
-            residuesMatch_(residue, m) &&
-            ((term_spec == ResidueModification::NUMBER_OF_TERM_SPECIFICITY) ||
-             (term_spec == m->getTermSpecificity())))
-        {
-          min_error = mass_error;
-          mod = m;
-        }
+        min_error = mass_error;
+        mod = m;
       }
     }
     return mod;
@@ -278,42 +348,48 @@ namespace OpenMS
     vector<ResidueModification*> new_mods;
     UnimodXMLFile().load(filename, new_mods);
 
-    for (auto & m : new_mods)
+    #pragma omp critical(OpenMS_ModificationsDB)
     {
-      // create full ID based on other information:
-      m->setFullId();
-
-      #pragma omp critical(OpenMS_ModificationsDB)
+      for (auto & m : new_mods)
       {
+        // create full ID based on other information:
+        m->setFullId();
+
+        addMod_(m);
         // e.g. Oxidation (M)
-        modification_names_[m->getFullId()].insert(m);
+        addName_(m->getFullId(), m);
         // e.g. Oxidation
-        modification_names_[m->getId()].insert(m);
+        addName_(m->getId(), m);
         // e.g. Oxidized
-        modification_names_[m->getFullName()].insert(m);
+        addName_(m->getFullName(), m);
         // e.g. UniMod:312
-        modification_names_[m->getUniModAccession()].insert(m);
-        mods_.push_back(m);
+        addName_(m->getUniModAccession(), m);
       }
     }
   }
 
-  void ModificationsDB::addModification(ResidueModification* new_mod)
+  const ResidueModification* ModificationsDB::addModification(ResidueModification* new_mod)
   {
-    if (has(new_mod->getFullId()))
+    const ResidueModification* registered(nullptr);
+    #pragma omp critical(OpenMS_ModificationsDB)
     {
-      OPENMS_LOG_WARN << "Modification already exists in ModificationsDB. Skipping." << new_mod->getFullId() << endl;
-      return;
+      // checked while holding the lock, so concurrent additions of the same modification are detected
+      registered = findName_(new_mod->getFullId());
+      if (registered == nullptr)
+      {
+        registered = new_mod;
+        addMod_(new_mod);
+        addName_(new_mod->getFullId(), new_mod);
+        addName_(new_mod->getId(), new_mod);
+        addName_(new_mod->getFullName(), new_mod);
+        addName_(new_mod->getUniModAccession(), new_mod);
+      }
     }
-
-    #pragma omp critical(OpenMS_ModificationsDB)
+    if (registered != new_mod)
     {
-      modification_names_[new_mod->getFullId()].insert(new_mod);
-      modification_names_[new_mod->getId()].insert(new_mod);
-      modification_names_[new_mod->getFullName()].insert(new_mod);
-      modification_names_[new_mod->getUniModAccession()].insert(new_mod);
-      mods_.push_back(new_mod); // we probably want that
+      OPENMS_LOG_WARN << "Modification already exists in ModificationsDB. Skipping." << new_mod->getFullId() << endl;
     }
+    return registered;
   }
 
   void ModificationsDB::readFromOBOFile(const String& filename)
@@ -579,11 +655,12 @@ namespace OpenMS
         if (it->second.getUniModRecordId() > 0)
         {
           //cerr << "Found UniMod PSI-MOD mapping: " << it->second.getPSIMODAccession() << " " << it->second.getUniModAccession() << endl;
-          set<const ResidueModification*> mods = modification_names_[it->second.getUniModAccession()];
+          set<const ResidueModification*> mods;
+          findModificationsByName_(it->second.getUniModAccession(), mods);
           for (set<const ResidueModification*>::const_iterator mit = mods.begin(); mit != mods.end(); ++mit)
           {
             //cerr << "Adding PSIMOD accession: " << it->second.getPSIMODAccession() << " " << it->second.getUniModAccession() << endl;
-            modification_names_[it->second.getPSIMODAccession()].insert(*mit);
+            addName_(it->second.getPSIMODAccession(), *mit);
           }
         }
         else
@@ -594,7 +671,7 @@ namespace OpenMS
              ((it->second.getTermSpecificity() != ResidueModification::ANYWHERE) &&
              (it->second.getDiffMonoMass() != 0)))
           {
-            mods_.push_back(new ResidueModification(it->second));
+            ResidueModification* new_mod = new ResidueModification(it->second);
 
             set<String> synonyms = it->second.getSynonyms();
             synonyms.insert(it->first);
@@ -602,15 +679,16 @@ namespace OpenMS
             //synonyms.insert(it->second.getUniModAccession());
             synonyms.insert(it->second.getPSIMODAccession());
             // full ID is auto-generated based on (short) ID, but we want the name instead:
-            mods_.back()->setId(it->second.getFullName());
-            mods_.back()->setFullId();
-            mods_.back()->setId(it->second.getId());
-            synonyms.insert(mods_.back()->getFullId());
+            new_mod->setId(it->second.getFullName());
+            new_mod->setFullId();
+            new_mod->setId(it->second.getId());
+            synonyms.insert(new_mod->getFullId());
+            addMod_(new_mod);
 
             // now check each of the names and link it to the residue modification
             for (set<String>::const_iterator nit = synonyms.begin(); nit != synonyms.end(); ++nit)
             {
-              modification_names_[*nit].insert(mods_.back());
+              addName_(*nit, new_mod);
             }
           }
         }
@@ -622,14 +700,12 @@ namespace OpenMS
   {
     modifications.clear();
 
-    #pragma omp critical(OpenMS_ModificationsDB)
+    const Size n = size_();
+    for (Size i = 0; i != n; ++i)
     {
-      for (auto const & m : mods_)
+      if (at_(i)->getUniModRecordId() > 0)
       {
-        if (m->getUniModRecordId() > 0)
-        {
-          modifications.push_back(m->getFullId());
-        }
+        modifications.push_back(at_(i)->getFullId());
       }
     }
 
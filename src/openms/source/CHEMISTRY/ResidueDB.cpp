@@ -51,8 +51,13 @@ using namespace std;
 
 namespace OpenMS
 {
-  ResidueDB::ResidueDB()
+  ResidueDB::ResidueDB() :
+    number_of_modified_residues_(0)
   {
+    for (Size i = 0; i < NR_MODIFIED_BUCKETS; ++i)
+    {
+      modified_buckets_[i].store(nullptr, std::memory_order_relaxed);
+    }
     readResiduesFromFile_("CHEMISTRY/Residues.xml");
     buildResidueNames_();
   }
@@ -75,17 +80,13 @@ namespace OpenMS
       throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "No residue specified.", "");
     }
 
-    Residue* r(nullptr);
-    #pragma omp critical (ResidueDB)
-    {   
-      auto it = residue_names_.find(name);
-      if (it != residue_names_.end()) r = it->second;
-    }
-    if (r == nullptr)
+    // no lock required: unmodified residues are not changed after construction
+    auto it = residue_names_.find(name);
+    if (it == residue_names_.end())
     {
       throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Residue not found: ", name);
     }
-    return r;
+    return it->second;
   }
 
   const Residue* ResidueDB::getResidue(const unsigned char& one_letter_code) const
@@ -96,34 +97,22 @@ namespace OpenMS
 
   Size ResidueDB::getNumberOfResidues() const
   {
-    Size s;
-    #pragma omp critical (ResidueDB)
-    {
-      s = residues_.size();
-    } 
-    return s;
+    return residues_.size();
   }
 
   Size ResidueDB::getNumberOfModifiedResidues() const
   {
-    Size s;
-    #pragma omp critical (ResidueDB)
-    {
-      s = modified_residues_.size();
-    } 
-    return s;
+    return number_of_modified_residues_.load(std::memory_order_acquire);
   }
 
   const set<const Residue*> ResidueDB::getResidues(const String& residue_set) const
   {
     set<const Residue*> s;
-    #pragma omp critical (ResidueDB)
+    auto it = residues_by_set_.find(residue_set);
+    if (it != residues_by_set_.end())
     {
-      if (residues_by_set_.has(residue_set))
-      {
-        s = residues_by_set_[residue_set];
-      }
-    } 
+      s = it->second;
+    }
 
     if (s.empty()) 
     {
@@ -141,83 +130,48 @@ namespace OpenMS
     }     
   }
 
-  void ResidueDB::addResidue_(Residue* r)
+  const String& ResidueDB::getModificationId_(const ResidueModification* mod)
   {
-    vector<String> names;
-    if (r->getName() != "")
-    {
-      names.push_back(r->getName());
-    }
-    if (r->getShortName() != "")
-    {
-      names.push_back(r->getShortName());
-    }
-    set<String> synonyms = r->getSynonyms();
-    for (const String & s : synonyms)
-    {
-      names.push_back(s);
-    }
+    return mod->getId().empty() ? mod->getFullId() : mod->getId();
+  }
 
-    if (!r->isModified())
+  const Residue* ResidueDB::findModifiedResidue_(const String& residue_name, const String& modification_id) const
+  {
+    const Size bucket = (std::hash<std::string>()(residue_name) ^ std::hash<std::string>()(modification_id)) % NR_MODIFIED_BUCKETS;
+    // entries are fully constructed before they are published (release),
+    // so the chain can be traversed without a lock
+    for (const ModifiedResidueEntry_* e = modified_buckets_[bucket].load(std::memory_order_acquire); e != nullptr; e = e->next)
     {
-      for (vector<String>::const_iterator it = names.begin(); it != names.end(); ++it)
-      {
-        residue_names_[*it] = r;
-      }
-      residues_.insert(r);
-      const_residues_.insert(r);
+      if (e->modification_id == modification_id && e->residue_name == residue_name) return e->residue;
     }
-    else
-    {
-      modified_residues_.insert(r);
-      const_modified_residues_.insert(r);
-
-      // get all modification names
-      vector<String> mod_names;
-      const ResidueModification* mod = r->getModification();
-
-      mod_names.push_back(mod->getId());
-      mod_names.push_back(mod->getFullName());
-      mod_names.push_back(mod->getFullId());
-      const set<String>& mod_synonyms = mod->getSynonyms();
-      for (set<String>::const_iterator it = mod_synonyms.begin(); it != mod_synonyms.end(); ++it)
-      {
-        mod_names.push_back(*it);
-      }
+    return nullptr;
+  }
 
-      for (const String& n : names)
-      {
-        if (n.empty()) continue;
-        for (const String& m : mod_names)
-        {
-          if (m.empty()) continue;
-          residue_mod_names_[n][m] = r;
-        }
-      }
-    }
-    buildResidueNames_();
-    return;
+  void ResidueDB::addModifiedResidue_(Residue* r, const String& modification_id)
+  {
+    std::atomic<ModifiedResidueEntry_*>& head = modified_buckets_[(std::hash<std::string>()(r->getName()) ^ std::hash<std::string>()(modification_id)) % NR_MODIFIED_BUCKETS];
+
+    ModifiedResidueEntry_* e = new ModifiedResidueEntry_();
+    e->residue_name = r->getName();
+    e->modification_id = modification_id;
+    e->residue = r;
+    e->next = head.load(std::memory_order_relaxed);
+
+    // publish
+    head.store(e, std::memory_order_release);
+    number_of_modified_residues_.fetch_add(1, std::memory_order_release);
   }
 
   bool ResidueDB::hasResidue(const String& res_name) const
   {
-    bool found = false;
-    #pragma omp critical (ResidueDB)
-    {
-      found = residue_names_.find(res_name) != residue_names_.end();
-    }  
-    return found;
+    return residue_names_.find(res_name) != residue_names_.end();
   }
 
   bool ResidueDB::hasResidue(const Residue* residue) const
   {
-    bool found = false;
-    #pragma omp critical (ResidueDB)
-    {
-      found = (const_residues_.find(residue) != const_residues_.end() ||
-          const_modified_residues_.find(residue) != const_modified_residues_.end());
-    } 
-    return found;
+    if (const_residues_.find(residue) != const_residues_.end()) return true;
+    if (!residue->isModified()) return false;
+    return findModifiedResidue_(residue->getName(), getModificationId_(residue->getModification())) == residue;
   }
 
   void ResidueDB::readResiduesFromFile_(const String& file_name)
@@ -301,10 +255,19 @@ namespace OpenMS
 
   void ResidueDB::clearResidueModifications_()
   {
-    for (auto& r : modified_residues_) { delete r; }
-    modified_residues_.clear();
-    residue_mod_names_.clear();
-    const_modified_residues_.clear();
+    for (Size i = 0; i < NR_MODIFIED_BUCKETS; ++i)
+    {
+      ModifiedResidueEntry_* e = modified_buckets_[i].load(std::memory_order_relaxed);
+      while (e != nullptr)
+      {
+        ModifiedResidueEntry_* next = e->next;
+        delete e->residue;
+        delete e;
+        e = next;
+      }
+      modified_buckets_[i].store(nullptr, std::memory_order_relaxed);
+    }
+    number_of_modified_residues_.store(0, std::memory_order_relaxed);
   }
 
   Residue* ResidueDB::parseResidue_(Map<String, String>& values)
@@ -459,12 +422,7 @@ namespace OpenMS
 
   const set<String> ResidueDB::getResidueSets() const
   {
-    set<String> rs;
-    #pragma omp critical (ResidueDB)
-    {
-      rs = residue_sets_; 
-    }
-    return rs;
+    return residue_sets_;
   }
 
   void ResidueDB::buildResidueNames_()
@@ -508,60 +466,42 @@ namespace OpenMS
   const Residue* ResidueDB::getModifiedResidue(const Residue* residue, const String& modification)
   {
     OPENMS_PRECONDITION(!modification.empty(), "Modification cannot be empty")
-    // search if the mod already exists
-    const String & res_name = residue->getName();
-    Residue* res(nullptr);
-    bool residue_found(true), mod_found(true);
-    #pragma omp critical (ResidueDB)
+    const String& res_name = residue->getName();
+    auto base = residue_names_.find(res_name);
+    if (base == residue_names_.end())
     {
-      if (residue_names_.find(res_name) == residue_names_.end())
-      {
-        residue_found = false;
-      }
-      else
-      {
-        const ResidueModification* mod;
-        try
-        {
-          // terminal modifications don't apply to residues (side chain), so only consider internal ones
-          mod = ModificationsDB::getInstance()->getModification(modification, residue->getOneLetterCode(), ResidueModification::ANYWHERE);
-        }
-        catch (...)
-        {
-          mod_found = false;
-        }
-
-        // check if modification in ResidueDB
-        if (mod_found)
-        {
-          const String& id = mod->getId().empty() ? mod->getFullId() : mod->getId();
-
-          // check if modified residue is already present in ResidueDB
-          if (residue_mod_names_.has(res_name) && residue_mod_names_[res_name].has(id))
-          {
-            res = residue_mod_names_[res_name][id];
-          }
-          else
-          {
-            // create and register this modified residue
-            res = new Residue(*residue_names_[res_name]);
-            res->setModification_(*mod);
-            addResidue_(res);
-          }
-        }
-      }
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Residue not found: ", res_name);
     }
 
-    // throwing (uncaught) exceptions needs to happen outside of critical section (see OpenMP reference manual)
-    if (!residue_found)
+    const ResidueModification* mod;
+    try
     {
-      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Residue not found: ", res_name);
+      // terminal modifications don't apply to residues (side chain), so only consider internal ones
+      mod = ModificationsDB::getInstance()->getModification(modification, residue->getOneLetterCode(), ResidueModification::ANYWHERE);
     }
-    else if (!mod_found)
+    catch (...)
     {
       throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Modification not found: ", modification);
     }
-    
+    const String& id = getModificationId_(mod);
+
+    // fast path: modified residue is already present
+    const Residue* res = findModifiedResidue_(res_name, id);
+    if (res != nullptr) return res;
+
+    #pragma omp critical (ResidueDB)
+    {
+      // another thread may have added it in the meantime
+      res = findModifiedResidue_(res_name, id);
+      if (res == nullptr)
+      {
+        // create and register this modified residue
+        Residue* new_res = new Residue(*base->second);
+        new_res->setModification_(*mod);
+        addModifiedResidue_(new_res, id);
+        res = new_res;
+      }
+    }
     return res;
   }
 
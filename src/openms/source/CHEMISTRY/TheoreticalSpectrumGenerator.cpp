@@ -38,6 +38,7 @@
 #include <OpenMS/CONCEPT/Constants.h>
 #include <OpenMS/CONCEPT/LogStream.h>
 #include <OpenMS/CHEMISTRY/AASequence.h>
+#include <OpenMS/CHEMISTRY/AASequencePool.h>
 #include <OpenMS/CHEMISTRY/ResidueDB.h>
 #include <OpenMS/KERNEL/MSSpectrum.h>
 
@@ -128,6 +129,18 @@ namespace OpenMS
 
 
   void TheoreticalSpectrumGenerator::getSpectrum(PeakSpectrum& spectrum, const AASequence& peptide, Int min_charge, Int max_charge) const
+  {
+    getSpectrum_(spectrum, peptide, nullptr, min_charge, max_charge);
+  }
+
+  void TheoreticalSpectrumGenerator::getSpectrum(PeakSpectrum& spectrum, const InternedAASequence& peptide, Int min_charge, Int max_charge) const
+  {
+    // no cached masses for sequences with residues of unknown mass
+    const double* prefix_masses = peptide.getPrefixMasses().empty() ? nullptr : peptide.getPrefixMasses().data();
+    getSpectrum_(spectrum, peptide.getSequence(), prefix_masses, min_charge, max_charge);
+  }
+
+  void TheoreticalSpectrumGenerator::getSpectrum_(PeakSpectrum& spectrum, const AASequence& peptide, const double* prefix_masses, Int min_charge, Int max_charge) const
   {
     if (peptide.empty())
     {
@@ -153,12 +166,12 @@ namespace OpenMS
 
     for (Int z = min_charge; z <= max_charge; ++z)
     {
-      if (add_b_ions_) addPeaks_(spectrum, peptide, ion_names, charges, Residue::BIon, z);
-      if (add_y_ions_) addPeaks_(spectrum, peptide, ion_names, charges, Residue::YIon, z);
-      if (add_a_ions_) addPeaks_(spectrum, peptide, ion_names, charges, Residue::AIon, z);
-      if (add_c_ions_) addPeaks_(spectrum, peptide, ion_names, charges, Residue::CIon, z);
-      if (add_x_ions_) addPeaks_(spectrum, peptide, ion_names, charges, Residue::XIon, z);
-      if (add_z_ions_) addPeaks_(spectrum, peptide, ion_names, charges, Residue::ZIon, z);
+      if (add_b_ions_) addPeaks_(spectrum, peptide, ion_names, charges, Residue::BIon, z, prefix_masses);
+      if (add_y_ions_) addPeaks_(spectrum, peptide, ion_names, charges, Residue::YIon, z, prefix_masses);
+      if (add_a_ions_) addPeaks_(spectrum, peptide, ion_names, charges, Residue::AIon, z, prefix_masses);
+      if (add_c_ions_) addPeaks_(spectrum, peptide, ion_names, charges, Residue::CIon, z, prefix_masses);
+      if (add_x_ions_) addPeaks_(spectrum, peptide, ion_names, charges, Residue::XIon, z, prefix_masses);
+      if (add_z_ions_) addPeaks_(spectrum, peptide, ion_names, charges, Residue::ZIon, z, prefix_masses);
     }
 
     if (add_precursor_peaks_)
@@ -430,7 +443,7 @@ namespace OpenMS
   }
 
 
-  void TheoreticalSpectrumGenerator::addPeaks_(PeakSpectrum& spectrum, const AASequence& peptide, DataArrays::StringDataArray& ion_names, DataArrays::IntegerDataArray& charges, Residue::ResidueType res_type, Int charge) const
+  void TheoreticalSpectrumGenerator::addPeaks_(PeakSpectrum& spectrum, const AASequence& peptide, DataArrays::StringDataArray& ion_names, DataArrays::IntegerDataArray& charges, Residue::ResidueType res_type, Int charge, const double* prefix_masses) const
   {
     int f = 1 + int(add_isotopes_) + int(add_losses_);
     spectrum.reserve(spectrum.size() + f * peptide.size());
@@ -465,11 +478,19 @@ namespace OpenMS
       if (!add_isotopes_) // add single peak
       {
         Size i = add_first_prefix_ion_ ? 0 : 1;
-        if (i == 1) mono_weight += peptide[0].getMonoWeight(Residue::Internal);
+        if (i == 1 && prefix_masses == nullptr) mono_weight += peptide[0].getMonoWeight(Residue::Internal);
         for (; i < peptide.size() - 1; ++i)
         {
-          mono_weight += peptide[i].getMonoWeight(Residue::Internal); // standard internal residue including named modifications: c
-          double pos(mono_weight);
+          double pos;
+          if (prefix_masses != nullptr) // residues [0, i]
+          {
+            pos = mono_weight + prefix_masses[i + 1];
+          }
+          else
+          {
+            mono_weight += peptide[i].getMonoWeight(Residue::Internal); // standard internal residue including named modifications: c
+            pos = mono_weight;
+          }
           switch (res_type)
           {
           case Residue::AIon: pos = (pos + Residue::getInternalToAIon().getMonoWeight()) / charge; break;
@@ -522,8 +543,16 @@ namespace OpenMS
 
         for (; i > 0; --i)
         {
-          mono_weight += peptide[i].getMonoWeight(Residue::Internal); // standard internal residue including named modifications: c
-          double pos(mono_weight);
+          double pos;
+          if (prefix_masses != nullptr) // residues [i, size)
+          {
+            pos = mono_weight + (prefix_masses[peptide.size()] - prefix_masses[i]);
+          }
+          else
+          {
+            mono_weight += peptide[i].getMonoWeight(Residue::Internal); // standard internal residue including named modifications: c
+            pos = mono_weight;
+          }
           switch (res_type)
           {
           case Residue::XIon: pos = (pos + Residue::getInternalToXIon().getMonoWeight()) / charge; break;
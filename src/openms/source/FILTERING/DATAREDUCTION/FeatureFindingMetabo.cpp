@@ -42,6 +42,7 @@
 #include <boost/dynamic_bitset.hpp>
 
 #ifdef _OPENMP
+#include <omp.h>
 #endif
 
 // #define FFM_DEBUG
@@ -285,6 +286,62 @@ namespace OpenMS
     return feat_score_;
   }
 
+  /// Feature hypotheses that reference the mass traces by their index
+  struct FeatureFindingMetabo::HypothesisBuffer_
+  {
+    struct Hypothesis
+    {
+      double score;
+      SignedSize charge;
+      /// position of the monoisotopic trace in trace_indices
+      Size begin;
+      /// number of traces
+      Size size;
+      /// position in the buffer at creation time (breaks ties between hypotheses of the same monoisotopic trace)
+      Size rank;
+    };
+
+    /// trace indices of all hypotheses; hypotheses of the same charge share their traces
+    std::vector<Size> trace_indices;
+
+    std::vector<Hypothesis> hypotheses;
+
+    void add(double score, SignedSize charge, Size begin, Size size)
+    {
+      Hypothesis h = {score, charge, begin, size, hypotheses.size()};
+      hypotheses.push_back(h);
+    }
+
+    /// Index of the monoisotopic trace of hypothesis @p h
+    Size getMonoisotopicTrace(const Hypothesis& h) const
+    {
+      return trace_indices[h.begin];
+    }
+
+    /// Does hypothesis @p h contain a trace marked in @p used_traces?
+    bool collides(const Hypothesis& h, const boost::dynamic_bitset<>& used_traces) const
+    {
+      for (Size i = h.begin; i < h.begin + h.size; ++i)
+      {
+        if (used_traces[trace_indices[i]]) return true;
+      }
+      return false;
+    }
+
+    /// Build the FeatureHypothesis for hypothesis @p h
+    FeatureHypothesis getFeatureHypothesis(const Hypothesis& h, const std::vector<MassTrace>& traces) const
+    {
+      FeatureHypothesis fh;
+      for (Size i = h.begin; i < h.begin + h.size; ++i)
+      {
+        fh.addMassTrace(traces[trace_indices[i]]);
+      }
+      fh.setScore(h.score);
+      fh.setCharge(h.charge);
+      return fh;
+    }
+  };
+
   FeatureFindingMetabo::FeatureFindingMetabo() :
     DefaultParamHandler("FeatureFindingMetabo"), ProgressLogger()
   {
@@ -651,30 +708,23 @@ namespace OpenMS
   }
 
 
-  void FeatureFindingMetabo::findLocalFeatures_(const std::vector<const MassTrace*>& candidates, const double total_intensity, std::vector<FeatureHypothesis>& output_hypotheses) const
+  void FeatureFindingMetabo::findLocalFeatures_(const std::vector<MassTrace>& traces, const std::vector<Size>& candidates, const double total_intensity, HypothesisBuffer_& output_hypotheses) const
   {
-    // single Mass trace hypothesis
-    FeatureHypothesis tmp_hypo;
-    tmp_hypo.addMassTrace(*candidates[0]);
-    tmp_hypo.setScore((candidates[0]->getIntensity(use_smoothed_intensities_)) / total_intensity);
+    const MassTrace& mono_trace = traces[candidates[0]];
+    const double mono_score((mono_trace.getIntensity(use_smoothed_intensities_)) / total_intensity);
 
-#ifdef _OPENMP
-#pragma omp critical (OPENMS_FFMetabo_output_hypos)
-#endif
-    {
-      // pushing back to shared vector needs to be synchronized
-      output_hypotheses.push_back(tmp_hypo);
-    }
+    // single Mass trace hypothesis
+    output_hypotheses.trace_indices.push_back(candidates[0]);
+    output_hypotheses.add(mono_score, 0, output_hypotheses.trace_indices.size() - 1, 1);
 
     for (Size charge = charge_lower_bound_; charge <= charge_upper_bound_; ++charge)
     {
-      FeatureHypothesis fh_tmp;
-      fh_tmp.addMassTrace(*candidates[0]);
-      fh_tmp.setScore((candidates[0]->getIntensity(use_smoothed_intensities_)) / total_intensity);
-
-      // double mono_iso_rt(candidates[0]->getCentroidRT());
-      // double mono_iso_mz(candidates[0]->getCentroidMZ());
-      // double mono_iso_int(candidates[0]->computePeakArea());
+      // each accepted isotopic trace extends the previous hypothesis of this
+      // charge, so all of them share the same stretch of trace indices
+      const Size hypo_begin(output_hypotheses.trace_indices.size());
+      output_hypotheses.trace_indices.push_back(candidates[0]);
+      double hypo_score(mono_score);
+      std::vector<double> hypo_ints(1, mono_trace.getIntensity(false));
 
       Size last_iso_idx(0);
       Size iso_pos_max(static_cast<Size>(std::floor(charge * local_mz_range_)));
@@ -687,18 +737,16 @@ namespace OpenMS
         Size best_idx(0);
         for (Size mt_idx = last_iso_idx + 1; mt_idx < candidates.size(); ++mt_idx)
         {
-          // double tmp_iso_rt(candidates[mt_idx]->getCentroidRT());
-          // double tmp_iso_mz(candidates[mt_idx]->getCentroidMZ());
-          // double tmp_iso_int(candidates[mt_idx]->computePeakArea());
+          const MassTrace& candidate = traces[candidates[mt_idx]];
 
 #ifdef FFM_DEBUG
-          std::cout << "scoring " << candidates[0]->getLabel() << " " << candidates[0]->getCentroidMZ() << 
-            " with " << candidates[mt_idx]->getLabel() << " " << candidates[mt_idx]->getCentroidMZ() << std::endl;
+          std::cout << "scoring " << mono_trace.getLabel() << " " << mono_trace.getCentroidMZ() << 
+            " with " << candidate.getLabel() << " " << candidate.getCentroidMZ() << std::endl;
 #endif
 
           // Score current mass trace candidates against hypothesis
-          double rt_score(scoreRT_(*candidates[0], *candidates[mt_idx]));
-          double mz_score(scoreMZ_(*candidates[0], *candidates[mt_idx], iso_pos, charge));
+          double rt_score(scoreRT_(mono_trace, candidate));
+          double mz_score(scoreMZ_(mono_trace, candidate, iso_pos, charge));
 
           // disable intensity scoring for now...
           double int_score(1.0);
@@ -706,13 +754,13 @@ namespace OpenMS
 
           if (isotope_filtering_model_ == "peptides")
           {
-            std::vector<double> tmp_ints(fh_tmp.getAllIntensities());
-            tmp_ints.push_back(candidates[mt_idx]->getIntensity(use_smoothed_intensities_));
-            int_score = computeAveragineSimScore_(tmp_ints, candidates[mt_idx]->getCentroidMZ() * charge);
+            std::vector<double> tmp_ints(hypo_ints);
+            tmp_ints.push_back(candidate.getIntensity(use_smoothed_intensities_));
+            int_score = computeAveragineSimScore_(tmp_ints, candidate.getCentroidMZ() * charge);
           }
 
 #ifdef FFM_DEBUG
-          std::cout << fh_tmp.getLabel() << "_" << candidates[mt_idx]->getLabel() << 
+          std::cout << mono_trace.getLabel() << "_" << candidate.getLabel() << 
             "\t" << "ch: " << charge << " isopos: " << iso_pos << " rt: " << 
             rt_score << "mz: " << mz_score << "int: " << int_score << std::endl;
 #endif
@@ -733,20 +781,15 @@ namespace OpenMS
         // and isotopic position
         if (best_so_far > 0.0)
         {
-          fh_tmp.addMassTrace(*candidates[best_idx]);
-          double weighted_score(((candidates[best_idx]->getIntensity(use_smoothed_intensities_)) * best_so_far) / total_intensity);
+          const MassTrace& best_trace = traces[candidates[best_idx]];
+          output_hypotheses.trace_indices.push_back(candidates[best_idx]);
+          hypo_ints.push_back(best_trace.getIntensity(false));
+          double weighted_score(((best_trace.getIntensity(use_smoothed_intensities_)) * best_so_far) / total_intensity);
 
-          fh_tmp.setScore(fh_tmp.getScore() + weighted_score);
-          fh_tmp.setCharge(charge);
+          hypo_score += weighted_score;
           last_iso_idx = best_idx;
 
-#ifdef _OPENMP
-#pragma omp critical (OPENMS_FFMetabo_output_hypos)
-#endif
-          {
-            // pushing back to shared vector needs to be synchronized
-            output_hypotheses.push_back(fh_tmp);
-          }
+          output_hypotheses.add(hypo_score, charge, hypo_begin, output_hypotheses.trace_indices.size() - hypo_begin);
         }
         else
         {
@@ -755,7 +798,7 @@ namespace OpenMS
       } // end for iso_pos
 
 #ifdef FFM_DEBUG
-      std::cout << "best found for ch " << charge << ":" << fh_tmp.getLabel() << " score: " << fh_tmp.getScore() << std::endl;
+      std::cout << "best found for ch " << charge << ":" << mono_trace.getLabel() << " size: " << hypo_ints.size() << " score: " << hypo_score << std::endl;
 #endif
     } // end for charge
   } // end of findLocalFeatures_(...)
@@ -797,13 +840,18 @@ namespace OpenMS
 
     // *********************************************************** //
     // Step 2 Iterate through all mass traces to find likely matches 
-    // and generate isotopic / charge hypotheses
+    // and generate isotopic / charge hypotheses. Every thread writes
+    // into its own buffer, so no synchronization is needed.
     // *********************************************************** //
 
-    std::vector<FeatureHypothesis> feat_hypos;
+#ifdef _OPENMP
+    std::vector<HypothesisBuffer_> thread_hypos(omp_get_max_threads());
+#else
+    std::vector<HypothesisBuffer_> thread_hypos(1);
+#endif
     Size progress(0);
 #ifdef _OPENMP
-#pragma omp parallel for
+#pragma omp parallel for schedule(dynamic, 64)
 #endif
     for (SignedSize i = 0; i < (SignedSize)input_mtraces.size(); ++i)
     {
@@ -813,11 +861,17 @@ namespace OpenMS
 #endif
       ++progress;
 
-      std::vector<const MassTrace*> local_traces;
+#ifdef _OPENMP
+      HypothesisBuffer_& local_hypos = thread_hypos[omp_get_thread_num()];
+#else
+      HypothesisBuffer_& local_hypos = thread_hypos[0];
+#endif
+
+      std::vector<Size> local_traces;
       double ref_trace_mz(input_mtraces[i].getCentroidMZ());
       double ref_trace_rt(input_mtraces[i].getCentroidRT());
 
-      local_traces.push_back(&input_mtraces[i]);
+      local_traces.push_back(i);
 
       for (Size ext_idx = i + 1; ext_idx < input_mtraces.size(); ++ext_idx)
       {
@@ -829,24 +883,56 @@ namespace OpenMS
         if (diff_rt <= local_rt_range_)
         {
           // std::cout << " accepted!" << std::endl;
-          local_traces.push_back(&input_mtraces[ext_idx]);
+          local_traces.push_back(ext_idx);
         }
       }
-      findLocalFeatures_(local_traces, total_intensity, feat_hypos);
+      findLocalFeatures_(input_mtraces, local_traces, total_intensity, local_hypos);
     }
     this->endProgress();
 
-    // sort feature candidates by their score
-    std::sort(feat_hypos.begin(), feat_hypos.end(), CmpHypothesesByScore());
+    // merge the thread-local hypotheses
+    HypothesisBuffer_ feat_hypos;
+    Size nr_hypos(0), nr_trace_indices(0);
+    for (Size t = 0; t < thread_hypos.size(); ++t)
+    {
+      nr_hypos += thread_hypos[t].hypotheses.size();
+      nr_trace_indices += thread_hypos[t].trace_indices.size();
+    }
+    feat_hypos.hypotheses.reserve(nr_hypos);
+    feat_hypos.trace_indices.reserve(nr_trace_indices);
+    for (Size t = 0; t < thread_hypos.size(); ++t)
+    {
+      const Size offset(feat_hypos.trace_indices.size());
+      feat_hypos.trace_indices.insert(feat_hypos.trace_indices.end(), thread_hypos[t].trace_indices.begin(), thread_hypos[t].trace_indices.end());
+      for (Size h = 0; h < thread_hypos[t].hypotheses.size(); ++h)
+      {
+        feat_hypos.hypotheses.push_back(thread_hypos[t].hypotheses[h]);
+        feat_hypos.hypotheses.back().begin += offset;
+      }
+      thread_hypos[t] = HypothesisBuffer_(); // release memory early
+    }
+
+    // sort feature candidates by their score; ties are broken by the
+    // monoisotopic trace and the order of creation, which makes the order
+    // independent of how the traces were distributed over the threads
+    std::sort(feat_hypos.hypotheses.begin(), feat_hypos.hypotheses.end(),
+      [&feat_hypos](const HypothesisBuffer_::Hypothesis& a, const HypothesisBuffer_::Hypothesis& b)
+      {
+        if (a.score != b.score) return a.score > b.score;
+        Size mono_a(feat_hypos.getMonoisotopicTrace(a)), mono_b(feat_hypos.getMonoisotopicTrace(b));
+        if (mono_a != mono_b) return mono_a < mono_b;
+        return a.rank < b.rank;
+      });
 
 #ifdef FFM_DEBUG
-    std::cout << "size of hypotheses: " << feat_hypos.size() << std::endl;
+    std::cout << "size of hypotheses: " << feat_hypos.hypotheses.size() << std::endl;
     // output all hypotheses:
-    for (Size hypo_idx = 0; hypo_idx < feat_hypos.size(); ++ hypo_idx)
+    for (Size hypo_idx = 0; hypo_idx < feat_hypos.hypotheses.size(); ++ hypo_idx)
     {
-      bool legal = isLegalIsotopePattern_(feat_hypos[hypo_idx]) > 0;
-      std::cout << feat_hypos[hypo_idx].getLabel() << " ch: " << feat_hypos[hypo_idx].getCharge() << 
-        " score: " << feat_hypos[hypo_idx].getScore() << " legal: " << legal << std::endl;
+      FeatureHypothesis fh(feat_hypos.getFeatureHypothesis(feat_hypos.hypotheses[hypo_idx], input_mtraces));
+      bool legal = isLegalIsotopePattern_(fh) > 0;
+      std::cout << fh.getLabel() << " ch: " << fh.getCharge() << 
+        " score: " << fh.getScore() << " legal: " << legal << std::endl;
     }
 #endif
 
@@ -854,101 +940,126 @@ namespace OpenMS
     // Step 3 Iterate through all hypotheses, starting with the highest 
     // scoring one. Accept them if they do not contain traces that have 
     // already been used by a higher scoring hypothesis.
+    // The hypotheses are processed in blocks: the isotope filter is
+    // evaluated in parallel for all hypotheses of a block that do not
+    // collide with the traces used so far, afterwards the block is
+    // accepted greedily in score order.
     // *********************************************************** //
-    std::map<String, bool> trace_excl_map;
-    for (Size hypo_idx = 0; hypo_idx < feat_hypos.size(); ++hypo_idx)
+    const bool use_isotope_filter(isotope_filtering_model_ != "none" && isotope_filtering_model_ != "peptides");
+    const Size block_size(1024);
+    boost::dynamic_bitset<> trace_used(input_mtraces.size());
+    std::vector<std::pair<Size, int> > accepted_hypos; // index, isotope filter result
+    std::vector<int> pass_isotope_filter; // -1 == 'did not test'; 0 = no pass; 1 = pass
+    for (Size block_begin = 0; block_begin < feat_hypos.hypotheses.size(); block_begin += block_size)
     {
-      // std::cout << "score now: " <<  feat_hypos[hypo_idx].getScore() << std::endl;
-      std::vector<String> labels(feat_hypos[hypo_idx].getLabels());
-      bool trace_coll = false;   // trace collision?
-      for (Size lab_idx = 0; lab_idx < labels.size(); ++lab_idx)
+      const Size block_end(std::min(block_begin + block_size, feat_hypos.hypotheses.size()));
+      pass_isotope_filter.assign(block_end - block_begin, -1);
+
+      // Check whether the trace  passes the intensity filter (metabolites
+      // only). This is based on a pre-trained SVM model of isotopic
+      // intensities.
+      if (use_isotope_filter)
       {
-        if (trace_excl_map.find(labels[lab_idx]) != trace_excl_map.end())
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+        for (SignedSize hypo_idx = block_begin; hypo_idx < (SignedSize)block_end; ++hypo_idx)
         {
-          trace_coll = true;
-          break;
+          const HypothesisBuffer_::Hypothesis& hypo = feat_hypos.hypotheses[hypo_idx];
+          // single traces are not tested, colliding hypotheses are skipped anyway
+          if (hypo.size == 1 || feat_hypos.collides(hypo, trace_used)) continue;
+
+          pass_isotope_filter[hypo_idx - block_begin] = isLegalIsotopePattern_(feat_hypos.getFeatureHypothesis(hypo, input_mtraces));
         }
       }
 
-#ifdef FFM_DEBUG
-      if (feat_hypos[hypo_idx].getSize() > 1)
+      for (Size hypo_idx = block_begin; hypo_idx < block_end; ++hypo_idx)
       {
-        std::cout << "check for collision: " << trace_coll << " " << 
-          feat_hypos[hypo_idx].getLabel() << " " << isLegalIsotopePattern_(feat_hypos[hypo_idx]) << 
-          " " << feat_hypos[hypo_idx].getScore() << std::endl;
-      }
-#endif
+        const HypothesisBuffer_::Hypothesis& hypo = feat_hypos.hypotheses[hypo_idx];
 
-      // Skip hypotheses that contain a mass trace that has already been used
-      if (trace_coll) 
-      {
-        continue;
-      }
+        // Skip hypotheses that contain a mass trace that has already been used
+        if (feat_hypos.collides(hypo, trace_used))
+        {
+          continue;
+        }
 
-      // Check whether the trace  passes the intensity filter (metabolites
-      // only). This is based on a pre-trained SVM model of isotopic
-      // intensities.
-      int pass_isotope_filter = -1; // -1 == 'did not test'; 0 = no pass; 1 = pass
-      if (isotope_filtering_model_ != "none" && isotope_filtering_model_ != "peptides")
-      {
-        pass_isotope_filter = isLegalIsotopePattern_(feat_hypos[hypo_idx]);
-      }
-    
-      // std::cout << "\nlegal iso? " << feat_hypos[hypo_idx].getLabel() << " score: " << feat_hypos[hypo_idx].getScore() << " " << result << std::endl;
+        if (pass_isotope_filter[hypo_idx - block_begin] == 0) // not passing filter
+        {
+          continue;
+        }
 
-      if (pass_isotope_filter == 0) // not passing filter
-      {
-        continue;
-      }
+        // filter out single traces if option is set
+        if (remove_single_traces_ && hypo.charge == 0)
+        {
+          continue;
+        }
 
-      // filter out single traces if option is set
-      if (remove_single_traces_ && feat_hypos[hypo_idx].getCharge() == 0)
-      {
-        continue;
+        // Now accept hypothesis and mark its traces as used
+        accepted_hypos.push_back(std::make_pair(hypo_idx, pass_isotope_filter[hypo_idx - block_begin]));
+        for (Size i = hypo.begin; i < hypo.begin + hypo.size; ++i)
+        {
+          trace_used[feat_hypos.trace_indices[i]] = true;
+        }
       }
+    }
 
-      //
-      // Now accept hypothesis
-      //
+    // *********************************************************** //
+    // Step 4 Assemble the accepted hypotheses to features
+    // *********************************************************** //
+    std::vector<Feature> features(accepted_hypos.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (SignedSize feat_idx = 0; feat_idx < (SignedSize)accepted_hypos.size(); ++feat_idx)
+    {
+      const FeatureHypothesis hypo(feat_hypos.getFeatureHypothesis(feat_hypos.hypotheses[accepted_hypos[feat_idx].first], input_mtraces));
 
-      Feature f;
-      f.setRT(feat_hypos[hypo_idx].getCentroidRT());
-      f.setMZ(feat_hypos[hypo_idx].getCentroidMZ());
+      Feature& f = features[feat_idx];
+      f.setRT(hypo.getCentroidRT());
+      f.setMZ(hypo.getCentroidMZ());
 
       if (report_summed_ints_)
       {
-        f.setIntensity(feat_hypos[hypo_idx].getSummedFeatureIntensity(use_smoothed_intensities_));
+        f.setIntensity(hypo.getSummedFeatureIntensity(use_smoothed_intensities_));
       }
       else
       {
-        f.setIntensity(feat_hypos[hypo_idx].getMonoisotopicFeatureIntensity(use_smoothed_intensities_));
+        f.setIntensity(hypo.getMonoisotopicFeatureIntensity(use_smoothed_intensities_));
       }
       
-      f.setWidth(feat_hypos[hypo_idx].getFWHM());
-      f.setCharge(feat_hypos[hypo_idx].getCharge());
-      f.setMetaValue(3, feat_hypos[hypo_idx].getLabel());
+      f.setWidth(hypo.getFWHM());
+      f.setCharge(hypo.getCharge());
+      f.setMetaValue(3, hypo.getLabel());
 
       // store isotope intensities
-      std::vector<double> all_ints(feat_hypos[hypo_idx].getAllIntensities(use_smoothed_intensities_));
+      std::vector<double> all_ints(hypo.getAllIntensities(use_smoothed_intensities_));
       f.setMetaValue("num_of_masstraces", all_ints.size());
-      if (report_convex_hulls_) f.setConvexHulls(feat_hypos[hypo_idx].getConvexHulls());
-      f.setOverallQuality(feat_hypos[hypo_idx].getScore());
+      if (report_convex_hulls_) f.setConvexHulls(hypo.getConvexHulls());
+      f.setOverallQuality(hypo.getScore());
       f.setMetaValue("masstrace_intensity", all_ints);
-      f.setMetaValue("masstrace_centroid_rt", feat_hypos[hypo_idx].getAllCentroidRT());
-      f.setMetaValue("masstrace_centroid_mz", feat_hypos[hypo_idx].getAllCentroidMZ());;
-      f.setMetaValue("isotope_distances", feat_hypos[hypo_idx].getIsotopeDistances());
-      f.setMetaValue("legal_isotope_pattern", pass_isotope_filter);
-      f.applyMemberFunction(&UniqueIdInterface::setUniqueId);
-      output_featmap.push_back(f);
-
-      if (report_chromatograms_)
-      {
-        output_chromatograms.push_back(feat_hypos[hypo_idx].getChromatograms(f.getUniqueId()));
-      }
-      // add used traces to exclusion map
-      for (Size lab_idx = 0; lab_idx < labels.size(); ++lab_idx)
+      f.setMetaValue("masstrace_centroid_rt", hypo.getAllCentroidRT());
+      f.setMetaValue("masstrace_centroid_mz", hypo.getAllCentroidMZ());;
+      f.setMetaValue("isotope_distances", hypo.getIsotopeDistances());
+      f.setMetaValue("legal_isotope_pattern", accepted_hypos[feat_idx].second);
+    }
+
+    // unique ids are assigned in the order of acceptance
+    for (Size feat_idx = 0; feat_idx < features.size(); ++feat_idx)
+    {
+      features[feat_idx].applyMemberFunction(&UniqueIdInterface::setUniqueId);
+      output_featmap.push_back(features[feat_idx]);
+    }
+
+    if (report_chromatograms_)
+    {
+      output_chromatograms.resize(features.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+      for (SignedSize feat_idx = 0; feat_idx < (SignedSize)features.size(); ++feat_idx)
       {
-        trace_excl_map[labels[lab_idx]] = true;
+        const FeatureHypothesis hypo(feat_hypos.getFeatureHypothesis(feat_hypos.hypotheses[accepted_hypos[feat_idx].first], input_mtraces));
+        output_chromatograms[feat_idx] = hypo.getChromatograms(features[feat_idx].getUniqueId());
       }
     }
     output_featmap.setUniqueId(UniqueIdGenerator::getUniqueId());
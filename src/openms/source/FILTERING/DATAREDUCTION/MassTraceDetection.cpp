@@ -38,8 +38,186 @@
 
 #include <boost/dynamic_bitset.hpp>
 
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
+    struct MassTraceDetection::Partition_
+    {
+      /// Peaks of all spectra with m/z in [mz_low, mz_high)
+      Partition_(const PeakMap& work_exp, double mz_low, double mz_high) :
+        mz_low(mz_low),
+        mz_high(mz_high),
+        begin(work_exp.size()),
+        end(work_exp.size()),
+        offsets(work_exp.size())
+      {
+        Size peak_count(0);
+        for (Size i = 0; i < work_exp.size(); ++i)
+        {
+          const MSSpectrum& spec = work_exp[i];
+          begin[i] = spec.MZBegin(mz_low) - spec.begin();
+          end[i] = spec.MZBegin(mz_high) - spec.begin();
+          offsets[i] = peak_count;
+          peak_count += end[i] - begin[i];
+        }
+        visited.resize(peak_count);
+      }
+
+      bool isVisited(Size scan_idx, Size peak_idx) const
+      {
+        return visited[offsets[scan_idx] + peak_idx - begin[scan_idx]];
+      }
+
+      void setVisited(Size scan_idx, Size peak_idx)
+      {
+        visited[offsets[scan_idx] + peak_idx - begin[scan_idx]] = true;
+      }
+
+      /// Whether no peak outside of the partition can be as close to @p mz as the peak at @p nearest_mz
+      bool containsNearest(double nearest_mz, double mz) const
+      {
+        return std::fabs(nearest_mz - mz) < std::min(mz - mz_low, mz_high - mz);
+      }
+
+      double mz_low;
+      double mz_high;
+      /// First peak of each spectrum in the partition
+      std::vector<Size> begin;
+      /// One past the last peak of each spectrum in the partition
+      std::vector<Size> end;
+      /// Start of each spectrum in the visited flags
+      std::vector<Size> offsets;
+      boost::dynamic_bitset<> visited;
+    };
+
+    struct MassTraceDetection::PartitionTrace_
+    {
+      /// Position of the apex in the processing order
+      Size rank;
+      /// Whether the extension resulted in a valid trace
+      bool found;
+      /// Whether the extension saw the same peaks as an extension on all peaks (see extendTrace_())
+      bool confined;
+      MassTrace trace;
+      std::vector<std::pair<Size, Size> > gathered_idx;
+      std::vector<std::pair<Size, Size> > visited_idx;
+    };
+
+    /// Same as MSSpectrum::findNearest() but restricted to the peaks [begin, end)
+    static Size findNearestInRange(const MSSpectrum& spec, Size begin, Size end, double mz)
+    {
+      MSSpectrum::ConstIterator first = spec.begin() + begin;
+      MSSpectrum::ConstIterator last = spec.begin() + end;
+      MSSpectrum::ConstIterator it = std::lower_bound(first, last, mz, [](const Peak1D& p, double value) { return p.getMZ() < value; });
+      if (it == first) return begin;
+      if (it == last) return end - 1;
+
+      // the peak before or the current peak are closest
+      MSSpectrum::ConstIterator it2 = it;
+      --it2;
+      if (std::fabs(it->getMZ() - mz) < std::fabs(it2->getMZ() - mz))
+      {
+        return Size(it - spec.begin());
+      }
+      return Size(it2 - spec.begin());
+    }
+
+    MassTraceDetection::PeakCollector::PeakCollector(const MassTraceDetection& mtd) :
+      noise_threshold_int_(mtd.noise_threshold_int_),
+      chrom_peak_snr_(mtd.chrom_peak_snr_),
+      total_peak_count_(0)
+    {
+    }
+
+    void MassTraceDetection::PeakCollector::setExperimentalSettings(const ExperimentalSettings& /* settings */)
+    {
+    }
+
+    void MassTraceDetection::PeakCollector::setExpectedSize(Size expected_spectra, Size /* expected_chromatograms */)
+    {
+      work_exp_.reserveSpaceSpectra(expected_spectra);
+      spec_offsets_.reserve(expected_spectra);
+    }
+
+    void MassTraceDetection::PeakCollector::consumeSpectrum(SpectrumType& s)
+    {
+      if (s.getMSLevel() != 1) return;
+      s.sortByPosition();
+      addSpectrum_(s);
+    }
+
+    void MassTraceDetection::PeakCollector::consumeChromatogram(ChromatogramType& /* c */)
+    {
+    }
+
+    Size MassTraceDetection::PeakCollector::getNrSpectra() const
+    {
+      return work_exp_.size();
+    }
+
+    Size MassTraceDetection::PeakCollector::getNrPeaks() const
+    {
+      return total_peak_count_;
+    }
+
+    void MassTraceDetection::PeakCollector::addSpectrum_(const MSSpectrum& spectrum)
+    {
+      // check if this is a MS1 survey scan
+      if (spectrum.getMSLevel() != 1) return;
+
+      // FWHM meta data (as annotated by PeakPickerHiRes) is the only data array needed
+      const MSSpectrum::FloatDataArray* fwhms = nullptr;
+      if (!spectrum.getFloatDataArrays().empty() && spectrum.getFloatDataArrays()[0].getName() == "FWHM_ppm")
+      {
+        fwhms = &spectrum.getFloatDataArrays()[0];
+        if (fwhms->size() != spectrum.size())
+        { // float data should always have the same size as the corresponding array
+          throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, spectrum.size());
+        }
+      }
+
+      MSSpectrum work_spec;
+      work_spec.setRT(spectrum.getRT());
+      work_spec.setMSLevel(1);
+      if (fwhms != nullptr)
+      {
+        work_spec.getFloatDataArrays().resize(1);
+        work_spec.getFloatDataArrays()[0].setName("FWHM_ppm");
+      }
+
+      const Size scan_idx = work_exp_.size();
+      for (Size peak_idx = 0; peak_idx < spectrum.size(); ++peak_idx)
+      {
+        double tmp_peak_int(spectrum[peak_idx].getIntensity());
+        if (tmp_peak_int > noise_threshold_int_)
+        {
+          // Assume that noise_threshold_int_ contains the noise level of the
+          // data and we want to be chrom_peak_snr times above the noise level
+          // --> add this peak as possible chromatographic apex
+          if (tmp_peak_int > chrom_peak_snr_ * noise_threshold_int_)
+          {
+            Apex apex;
+            apex.intensity = tmp_peak_int;
+            apex.scan = scan_idx;
+            apex.peak = work_spec.size();
+            apices_.push_back(apex);
+          }
+          work_spec.push_back(spectrum[peak_idx]);
+          if (fwhms != nullptr) work_spec.getFloatDataArrays()[0].push_back((*fwhms)[peak_idx]);
+        }
+      }
+
+      spec_offsets_.push_back(total_peak_count_);
+      total_peak_count_ += work_spec.size();
+      work_exp_.addSpectrum(std::move(work_spec));
+    }
     MassTraceDetection::MassTraceDetection() :
             DefaultParamHandler("MassTraceDetection"), ProgressLogger()
     {
@@ -62,6 +240,11 @@ namespace OpenMS
       defaults_.setValue("min_trace_length", 5.0, "Minimum expected length of a mass trace (in seconds).", ListUtils::create<String>("advanced"));
       defaults_.setValue("max_trace_length", -1.0, "Maximum expected length of a mass trace (in seconds). Set to a negative value to disable maximal length check during mass trace detection.", ListUtils::create<String>("advanced"));
 
+      defaults_.setValue("mz_partitions", 1, "Number of m/z partitions (with about the same number of apex peaks) that are processed in parallel. 1 = sequential detection. Traces at partition borders are extended again in order of apex intensity, so the result is the same as for sequential detection.", ListUtils::create<String>("advanced"));
+      defaults_.setMinInt("mz_partitions", 1);
+      defaults_.setValue("mz_partition_overlap", 1.0, "Overlap (in Th) of neighbouring m/z partitions. Should be larger than the m/z spread of a mass trace, so that few traces need to be extended again when merging the partitions.", ListUtils::create<String>("advanced"));
+      defaults_.setMinFloat("mz_partition_overlap", 0.0);
+
       defaultsToParam_();
 
       this->setLogType(CMD);
@@ -189,80 +372,43 @@ namespace OpenMS
 
     void MassTraceDetection::run(const PeakMap& input_exp, std::vector<MassTrace>& found_masstraces, const Size max_traces)
     {
-      // make sure the output vector is empty
-      found_masstraces.clear();
-
-      // gather all peaks that are potential chromatographic peak apices
-      //   - use work_exp for actual work (remove peaks below noise threshold)
-      //   - store potential apices in chrom_apices
-      PeakMap work_exp;
-      MapIdxSortedByInt chrom_apices;
-
-      Size total_peak_count(0);
-      std::vector<Size> spec_offsets;
-      spec_offsets.push_back(0);
-
-      Size spectra_count(0);
-
       // *********************************************************** //
       //  Step 1: Detecting potential chromatographic apices
+      //    (remove peaks below noise threshold, collect the apices)
       // *********************************************************** //
+      PeakCollector peaks(*this);
+      peaks.setExpectedSize(input_exp.size(), 0);
       for (PeakMap::ConstIterator it = input_exp.begin(); it != input_exp.end(); ++it)
       {
-        // check if this is a MS1 survey scan
-        if (it->getMSLevel() != 1) continue;
-
-        std::vector<Size> indices_passing;
-        for (Size peak_idx = 0; peak_idx < it->size(); ++peak_idx)
-        {
-          double tmp_peak_int((*it)[peak_idx].getIntensity());
-          if (tmp_peak_int > noise_threshold_int_)
-          {
-            // Assume that noise_threshold_int_ contains the noise level of the
-            // data and we want to be chrom_peak_snr times above the noise level
-            // --> add this peak as possible chromatographic apex
-            if (tmp_peak_int > chrom_peak_snr_ * noise_threshold_int_)
-            {
-              chrom_apices.insert(std::make_pair(tmp_peak_int, std::make_pair(spectra_count, indices_passing.size())));
-            }
-            indices_passing.push_back(peak_idx);
-            ++total_peak_count;
-          }
-        }
-        PeakMap::SpectrumType tmp_spec(*it);
-        tmp_spec.select(indices_passing);
-        work_exp.addSpectrum(tmp_spec);
-        spec_offsets.push_back(spec_offsets.back() + tmp_spec.size());
-        ++spectra_count;
+        peaks.addSpectrum_(*it);
       }
 
-      if (spectra_count < 3)
+      run(peaks, found_masstraces, max_traces);
+    } // end of MassTraceDetection::run
+
+    void MassTraceDetection::run(const PeakCollector& peaks, std::vector<MassTrace>& found_masstraces, const Size max_traces)
+    {
+      // make sure the output vector is empty
+      found_masstraces.clear();
+
+      if (peaks.getNrSpectra() < 3)
       {
         throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-                                      "Input map consists of too few MS1 spectra (less than 3!). Aborting...", String(spectra_count));
+                                      "Input map consists of too few MS1 spectra (less than 3!). Aborting...", String(peaks.getNrSpectra()));
       }
 
-      // discard last spectrum's offset
-      spec_offsets.pop_back();
-
       // *********************************************************************
       // Step 2: start extending mass traces beginning with the apex peak (go
       // through all peaks in order of decreasing intensity)
       // *********************************************************************
-      run_(chrom_apices, total_peak_count, work_exp, spec_offsets, found_masstraces, max_traces);
-
-      return;
-    } // end of MassTraceDetection::run
+      run_(peaks, found_masstraces, max_traces);
+    }
 
-    void MassTraceDetection::run_(const MapIdxSortedByInt& chrom_apices,
-                                  const Size total_peak_count,
-                                  const PeakMap& work_exp,
-                                  const std::vector<Size>& spec_offsets,
+    void MassTraceDetection::run_(const PeakCollector& peaks,
                                   std::vector<MassTrace>& found_masstraces,
                                   const Size max_traces)
     {
-      boost::dynamic_bitset<> peak_visited(total_peak_count);
-      Size trace_number(1);
+      const PeakMap& work_exp = peaks.work_exp_;
 
       // check presence of FWHM meta data
       int fwhm_meta_idx(-1);
@@ -272,10 +418,6 @@ namespace OpenMS
         if (work_exp[i].getFloatDataArrays().size() > 0 &&
             work_exp[i].getFloatDataArrays()[0].getName() == "FWHM_ppm")
         {
-          if (work_exp[i].getFloatDataArrays()[0].size() != work_exp[i].size())
-          { // float data should always have the same size as the corresponding array
-            throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, work_exp[i].size());
-          }
           fwhm_meta_idx = 0;
           ++fwhm_meta_count;
         }
@@ -286,269 +428,462 @@ namespace OpenMS
                                       String("FWHM meta arrays are expected to be missing or present for all MS spectra [") + fwhm_meta_count + "/" + work_exp.size() + "].");
       }
 
+      // apices in order of decreasing intensity (ties: later peaks first)
+      const std::vector<PeakCollector::Apex>& apices = peaks.apices_;
+      std::vector<Size> apex_order(apices.size());
+      std::iota(apex_order.begin(), apex_order.end(), 0);
+      std::sort(apex_order.begin(), apex_order.end(), [&apices](Size a, Size b)
+      {
+        if (apices[a].intensity != apices[b].intensity) return apices[a].intensity > apices[b].intensity;
+        if (apices[a].scan != apices[b].scan) return apices[a].scan > apices[b].scan;
+        return apices[a].peak > apices[b].peak;
+      });
+
+      if (mz_partitions_ > 1)
+      {
+        runPartitioned_(peaks, apex_order, fwhm_meta_idx, found_masstraces, max_traces);
+        return;
+      }
+
+      Partition_ partition(work_exp, -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity());
+      Size trace_number(1);
 
-      this->startProgress(0, total_peak_count, "mass trace detection");
+      this->startProgress(0, peaks.total_peak_count_, "mass trace detection");
       Size peaks_detected(0);
 
-      for (MapIdxSortedByInt::const_reverse_iterator m_it = chrom_apices.rbegin(); m_it != chrom_apices.rend(); ++m_it)
+      for (Size a : apex_order)
       {
-        Size apex_scan_idx(m_it->second.first);
-        Size apex_peak_idx(m_it->second.second);
+        const PeakCollector::Apex& apex = apices[a];
+        if (partition.isVisited(apex.scan, apex.peak))
+        {
+          continue;
+        }
 
-        if (peak_visited[spec_offsets[apex_scan_idx] + apex_peak_idx])
+        MassTrace new_trace;
+        std::vector<std::pair<Size, Size> > gathered_idx, visited_idx;
+        bool confined;
+        if (!extendTrace_(work_exp, partition, fwhm_meta_idx, apex.scan, apex.peak, new_trace, gathered_idx, visited_idx, confined))
         {
           continue;
         }
 
-        Peak2D apex_peak;
-        apex_peak.setRT(work_exp[apex_scan_idx].getRT());
-        apex_peak.setMZ(work_exp[apex_scan_idx][apex_peak_idx].getMZ());
-        apex_peak.setIntensity(work_exp[apex_scan_idx][apex_peak_idx].getIntensity());
+        // mark all peaks as visited
+        for (Size i = 0; i < gathered_idx.size(); ++i)
+        {
+          partition.setVisited(gathered_idx[i].first, gathered_idx[i].second);
+        }
+
+        new_trace.setLabel("T" + String(trace_number));
+        ++trace_number;
+
+        found_masstraces.push_back(new_trace);
+
+        peaks_detected += new_trace.getSize();
+        this->setProgress(peaks_detected);
+
+        // check if we already reached the (optional) maximum number of traces
+        if (max_traces > 0 && found_masstraces.size() == max_traces) break;
+      }
+
+      this->endProgress();
+    }
+
+    void MassTraceDetection::runPartitioned_(const PeakCollector& peaks,
+                                             const std::vector<Size>& apex_order,
+                                             const int fwhm_meta_idx,
+                                             std::vector<MassTrace>& found_masstraces,
+                                             const Size max_traces)
+    {
+      const PeakMap& work_exp = peaks.work_exp_;
+      const std::vector<PeakCollector::Apex>& apices = peaks.apices_;
+      const double inf = std::numeric_limits<double>::infinity();
+      if (apices.empty()) return;
+
+      // partition borders at m/z quantiles of the apices, so the partitions get similar work
+      std::vector<double> apex_mzs;
+      apex_mzs.reserve(apices.size());
+      for (const PeakCollector::Apex& apex : apices)
+      {
+        apex_mzs.push_back(work_exp[apex.scan][apex.peak].getMZ());
+      }
+      std::sort(apex_mzs.begin(), apex_mzs.end());
+      std::vector<double> borders(1, -inf);
+      for (Size p = 1; p < mz_partitions_; ++p)
+      {
+        double border = apex_mzs[apex_mzs.size() * p / mz_partitions_];
+        if (border > borders.back()) borders.push_back(border);
+      }
+      borders.push_back(inf);
+      const Size nr_partitions = borders.size() - 1;
+
+      // apices (their rank in the processing order) of each partition
+      std::vector<std::vector<Size> > partition_apices(nr_partitions);
+      for (Size rank = 0; rank < apex_order.size(); ++rank)
+      {
+        const PeakCollector::Apex& apex = apices[apex_order[rank]];
+        double mz = work_exp[apex.scan][apex.peak].getMZ();
+        Size p = std::upper_bound(borders.begin(), borders.end(), mz) - borders.begin() - 1;
+        partition_apices[p].push_back(rank);
+      }
+
+      // *********************************************************************
+      // Step 2a: detect traces in each partition independently
+      // *********************************************************************
+      std::vector<std::vector<PartitionTrace_> > partition_traces(nr_partitions);
+      this->startProgress(0, nr_partitions, "mass trace detection");
+      Size partitions_done(0);
+
+#pragma omp parallel for schedule(dynamic, 1)
+      for (SignedSize p = 0; p < (SignedSize)nr_partitions; ++p)
+      {
+        Partition_ partition(work_exp, borders[p] - mz_partition_overlap_, borders[p + 1] + mz_partition_overlap_);
+        for (Size rank : partition_apices[p])
+        {
+          const PeakCollector::Apex& apex = apices[apex_order[rank]];
+          if (partition.isVisited(apex.scan, apex.peak)) continue;
+
+          // failed extensions are kept as well, as they need to be validated in the merge
+          PartitionTrace_ t;
+          t.rank = rank;
+          t.found = extendTrace_(work_exp, partition, fwhm_meta_idx, apex.scan, apex.peak, t.trace, t.gathered_idx, t.visited_idx, t.confined);
+          if (t.found)
+          {
+            for (Size i = 0; i < t.gathered_idx.size(); ++i)
+            {
+              partition.setVisited(t.gathered_idx[i].first, t.gathered_idx[i].second);
+            }
+          }
+          partition_traces[p].push_back(std::move(t));
+        }
+
+#pragma omp atomic
+        ++partitions_done;
 
-        Size trace_up_idx(apex_scan_idx);
-        Size trace_down_idx(apex_scan_idx);
+        IF_MASTERTHREAD
+        {
+          this->setProgress(partitions_done);
+        }
+      }
+      this->endProgress();
 
-        std::list<PeakType> current_trace;
-        current_trace.push_back(apex_peak);
-        std::vector<double> fwhms_mz; // peak-FWHM meta values of collected peaks
+      // *********************************************************************
+      // Step 2b: replay the sequential algorithm in apex order. An extension
+      // from a partition is taken over if it saw the same peaks and visited
+      // flags as the sequential extension would; otherwise (or if the apex
+      // was skipped in its partition) the trace is extended again.
+      // *********************************************************************
+      std::vector<PartitionTrace_*> attempts(apex_order.size(), nullptr);
+      for (std::vector<PartitionTrace_>& pt : partition_traces)
+      {
+        for (PartitionTrace_& t : pt) attempts[t.rank] = &t;
+      }
 
-        // Initialization for the iterative version of weighted m/z mean calculation
-        double centroid_mz(apex_peak.getMZ());
-        double prev_counter(apex_peak.getIntensity() * apex_peak.getMZ());
-        double prev_denom(apex_peak.getIntensity());
+      Partition_ all_peaks(work_exp, -inf, inf);
+      Size trace_number(1), re_extended(0);
+      PartitionTrace_ extended_again;
+      for (Size rank = 0; rank < apex_order.size(); ++rank)
+      {
+        const PeakCollector::Apex& apex = apices[apex_order[rank]];
+        if (all_peaks.isVisited(apex.scan, apex.peak)) continue;
 
-        updateIterativeWeightedMeanMZ(apex_peak.getMZ(), apex_peak.getIntensity(), centroid_mz, prev_counter, prev_denom);
+        PartitionTrace_* t = attempts[rank];
+        bool valid = (t != nullptr) && t->confined;
+        for (Size i = 0; valid && i < t->gathered_idx.size(); ++i)
+        {
+          valid = !all_peaks.isVisited(t->gathered_idx[i].first, t->gathered_idx[i].second);
+        }
+        for (Size i = 0; valid && i < t->visited_idx.size(); ++i)
+        {
+          valid = all_peaks.isVisited(t->visited_idx[i].first, t->visited_idx[i].second);
+        }
+        if (!valid)
+        {
+          ++re_extended;
+          t = &extended_again;
+          t->trace = MassTrace();
+          t->found = extendTrace_(work_exp, all_peaks, fwhm_meta_idx, apex.scan, apex.peak, t->trace, t->gathered_idx, t->visited_idx, t->confined);
+        }
+        if (!t->found) continue;
 
-        std::vector<std::pair<Size, Size> > gathered_idx;
-        gathered_idx.push_back(std::make_pair(apex_scan_idx, apex_peak_idx));
-        if (fwhm_meta_idx != -1)
+        // mark all peaks as visited
+        for (Size i = 0; i < t->gathered_idx.size(); ++i)
         {
-          fwhms_mz.push_back(work_exp[apex_scan_idx].getFloatDataArrays()[fwhm_meta_idx][apex_peak_idx]);
+          all_peaks.setVisited(t->gathered_idx[i].first, t->gathered_idx[i].second);
         }
 
-        Size up_hitting_peak(0), down_hitting_peak(0);
-        Size up_scan_counter(0), down_scan_counter(0);
+        t->trace.setLabel("T" + String(trace_number));
+        ++trace_number;
+        found_masstraces.push_back(std::move(t->trace));
+
+        // check if we already reached the (optional) maximum number of traces
+        if (max_traces > 0 && found_masstraces.size() == max_traces) break;
+      }
+
+      OPENMS_LOG_DEBUG << "Mass trace detection in " << nr_partitions << " m/z partitions, "
+                       << re_extended << " extensions at partition borders repeated." << std::endl;
+    }
 
-        bool toggle_up = true, toggle_down = true;
+    bool MassTraceDetection::extendTrace_(const PeakMap& work_exp,
+                                          const Partition_& partition,
+                                          const int fwhm_meta_idx,
+                                          const Size apex_scan_idx,
+                                          const Size apex_peak_idx,
+                                          MassTrace& trace,
+                                          std::vector<std::pair<Size, Size> >& gathered_idx,
+                                          std::vector<std::pair<Size, Size> >& visited_idx,
+                                          bool& confined)
+    {
+      Peak2D apex_peak;
+      apex_peak.setRT(work_exp[apex_scan_idx].getRT());
+      apex_peak.setMZ(work_exp[apex_scan_idx][apex_peak_idx].getMZ());
+      apex_peak.setIntensity(work_exp[apex_scan_idx][apex_peak_idx].getIntensity());
+
+      Size trace_up_idx(apex_scan_idx);
+      Size trace_down_idx(apex_scan_idx);
+
+      std::list<PeakType> current_trace;
+      current_trace.push_back(apex_peak);
+      std::vector<double> fwhms_mz; // peak-FWHM meta values of collected peaks
+
+      // Initialization for the iterative version of weighted m/z mean calculation
+      double centroid_mz(apex_peak.getMZ());
+      double prev_counter(apex_peak.getIntensity() * apex_peak.getMZ());
+      double prev_denom(apex_peak.getIntensity());
+
+      updateIterativeWeightedMeanMZ(apex_peak.getMZ(), apex_peak.getIntensity(), centroid_mz, prev_counter, prev_denom);
+
+      gathered_idx.clear();
+      gathered_idx.push_back(std::make_pair(apex_scan_idx, apex_peak_idx));
+      visited_idx.clear();
+      confined = true;
+      if (fwhm_meta_idx != -1)
+      {
+        fwhms_mz.push_back(work_exp[apex_scan_idx].getFloatDataArrays()[fwhm_meta_idx][apex_peak_idx]);
+      }
 
-        Size conseq_missed_peak_up(0), conseq_missed_peak_down(0);
-        Size max_consecutive_missing(trace_termination_outliers_);
+      Size up_hitting_peak(0), down_hitting_peak(0);
+      Size up_scan_counter(0), down_scan_counter(0);
 
-        double current_sample_rate(1.0);
-        // Size min_scans_to_consider(std::floor((min_sample_rate_ /2)*10));
-        Size min_scans_to_consider(5);
+      bool toggle_up = true, toggle_down = true;
 
-        // double outlier_ratio(0.3);
+      Size conseq_missed_peak_up(0), conseq_missed_peak_down(0);
+      Size max_consecutive_missing(trace_termination_outliers_);
 
-        // double ftl_mean(centroid_mz);
-        double ftl_sd((centroid_mz / 1e6) * mass_error_ppm_);
-        double intensity_so_far(apex_peak.getIntensity());
+      double current_sample_rate(1.0);
+      // Size min_scans_to_consider(std::floor((min_sample_rate_ /2)*10));
+      Size min_scans_to_consider(5);
 
-        while (((trace_down_idx > 0) && toggle_down) ||
-               ((trace_up_idx < work_exp.size() - 1) && toggle_up)
-                )
+      // double outlier_ratio(0.3);
+
+      // double ftl_mean(centroid_mz);
+      double ftl_sd((centroid_mz / 1e6) * mass_error_ppm_);
+      double intensity_so_far(apex_peak.getIntensity());
+
+      while (((trace_down_idx > 0) && toggle_down) ||
+             ((trace_up_idx < work_exp.size() - 1) && toggle_up)
+              )
+      {
+        // *********************************************************** //
+        // Step 2.1 MOVE DOWN in RT dim
+        // *********************************************************** //
+        if ((trace_down_idx > 0) && toggle_down)
         {
-          // *********************************************************** //
-          // Step 2.1 MOVE DOWN in RT dim
-          // *********************************************************** //
-          if ((trace_down_idx > 0) && toggle_down)
+          const MSSpectrum& spec_trace_down = work_exp[trace_down_idx - 1];
+          if (partition.begin[trace_down_idx - 1] == partition.end[trace_down_idx - 1])
+          {
+            confined = confined && spec_trace_down.empty();
+          }
+          else
           {
-            const MSSpectrum& spec_trace_down = work_exp[trace_down_idx - 1];
-            if (!spec_trace_down.empty())
+            Size next_down_peak_idx = findNearestInRange(spec_trace_down, partition.begin[trace_down_idx - 1], partition.end[trace_down_idx - 1], centroid_mz);
+            double next_down_peak_mz = spec_trace_down[next_down_peak_idx].getMZ();
+            double next_down_peak_int = spec_trace_down[next_down_peak_idx].getIntensity();
+            confined = confined && partition.containsNearest(next_down_peak_mz, centroid_mz);
+
+            double right_bound = centroid_mz + 3 * ftl_sd;
+            double left_bound = centroid_mz - 3 * ftl_sd;
+
+            if ((next_down_peak_mz <= right_bound) &&
+                (next_down_peak_mz >= left_bound) &&
+                !partition.isVisited(trace_down_idx - 1, next_down_peak_idx)
+                    )
             {
-              Size next_down_peak_idx = spec_trace_down.findNearest(centroid_mz);
-              double next_down_peak_mz = spec_trace_down[next_down_peak_idx].getMZ();
-              double next_down_peak_int = spec_trace_down[next_down_peak_idx].getIntensity();
-
-              double right_bound = centroid_mz + 3 * ftl_sd;
-              double left_bound = centroid_mz - 3 * ftl_sd;
-
-              if ((next_down_peak_mz <= right_bound) &&
-                  (next_down_peak_mz >= left_bound) &&
-                  !peak_visited[spec_offsets[trace_down_idx - 1] + next_down_peak_idx]
-                      )
+              Peak2D next_peak;
+              next_peak.setRT(spec_trace_down.getRT());
+              next_peak.setMZ(next_down_peak_mz);
+              next_peak.setIntensity(next_down_peak_int);
+
+              current_trace.push_front(next_peak);
+              // FWHM average
+              if (fwhm_meta_idx != -1)
               {
-                Peak2D next_peak;
-                next_peak.setRT(spec_trace_down.getRT());
-                next_peak.setMZ(next_down_peak_mz);
-                next_peak.setIntensity(next_down_peak_int);
-
-                current_trace.push_front(next_peak);
-                // FWHM average
-                if (fwhm_meta_idx != -1)
-                {
-                  fwhms_mz.push_back(spec_trace_down.getFloatDataArrays()[fwhm_meta_idx][next_down_peak_idx]);
-                }
-                // Update the m/z mean of the current trace as we added a new peak
-                updateIterativeWeightedMeanMZ(next_down_peak_mz, next_down_peak_int, centroid_mz, prev_counter, prev_denom);
-                gathered_idx.push_back(std::make_pair(trace_down_idx - 1, next_down_peak_idx));
+                fwhms_mz.push_back(spec_trace_down.getFloatDataArrays()[fwhm_meta_idx][next_down_peak_idx]);
+              }
+              // Update the m/z mean of the current trace as we added a new peak
+              updateIterativeWeightedMeanMZ(next_down_peak_mz, next_down_peak_int, centroid_mz, prev_counter, prev_denom);
+              gathered_idx.push_back(std::make_pair(trace_down_idx - 1, next_down_peak_idx));
 
-                // Update the m/z variance dynamically
-                if (reestimate_mt_sd_)           //  && (down_hitting_peak+1 > min_flank_scans))
+              // Update the m/z variance dynamically
+              if (reestimate_mt_sd_)           //  && (down_hitting_peak+1 > min_flank_scans))
+              {
+                // if (ftl_t > min_fwhm_scans)
                 {
-                  // if (ftl_t > min_fwhm_scans)
-                  {
-                    updateWeightedSDEstimateRobust(next_peak, centroid_mz, ftl_sd, intensity_so_far);
-                  }
+                  updateWeightedSDEstimateRobust(next_peak, centroid_mz, ftl_sd, intensity_so_far);
                 }
-
-                ++down_hitting_peak;
-                conseq_missed_peak_down = 0;
-              }
-              else
-              {
-                ++conseq_missed_peak_down;
               }
 
+              ++down_hitting_peak;
+              conseq_missed_peak_down = 0;
             }
-            --trace_down_idx;
-            ++down_scan_counter;
-
-            // trace termination criterion: max allowed number of
-            // consecutive outliers reached OR cancel extension if
-            // sampling_rate falls below min_sample_rate_
-            if (trace_termination_criterion_ == "outlier")
+            else
             {
-              if (conseq_missed_peak_down > max_consecutive_missing)
+              // peaks within the bounds are only missed because they are visited
+              if ((next_down_peak_mz <= right_bound) && (next_down_peak_mz >= left_bound))
               {
-                toggle_down = false;
+                visited_idx.push_back(std::make_pair(trace_down_idx - 1, next_down_peak_idx));
               }
+              ++conseq_missed_peak_down;
             }
-            else if (trace_termination_criterion_ == "sample_rate")
+
+          }
+          --trace_down_idx;
+          ++down_scan_counter;
+
+          // trace termination criterion: max allowed number of
+          // consecutive outliers reached OR cancel extension if
+          // sampling_rate falls below min_sample_rate_
+          if (trace_termination_criterion_ == "outlier")
+          {
+            if (conseq_missed_peak_down > max_consecutive_missing)
             {
-              current_sample_rate = (double)(down_hitting_peak + up_hitting_peak + 1) /
-                                    (double)(down_scan_counter + up_scan_counter + 1);
-              if (down_scan_counter > min_scans_to_consider && current_sample_rate < min_sample_rate_)
-              {
-                // std::cout << "stopping down..." << std::endl;
-                toggle_down = false;
-              }
+              toggle_down = false;
             }
           }
-
-          // *********************************************************** //
-          // Step 2.2 MOVE UP in RT dim
-          // *********************************************************** //
-          if ((trace_up_idx < work_exp.size() - 1) && toggle_up)
+          else if (trace_termination_criterion_ == "sample_rate")
           {
-            const MSSpectrum& spec_trace_up = work_exp[trace_up_idx + 1];
-            if (!spec_trace_up.empty())
+            current_sample_rate = (double)(down_hitting_peak + up_hitting_peak + 1) /
+                                  (double)(down_scan_counter + up_scan_counter + 1);
+            if (down_scan_counter > min_scans_to_consider && current_sample_rate < min_sample_rate_)
             {
-              Size next_up_peak_idx = spec_trace_up.findNearest(centroid_mz);
-              double next_up_peak_mz = spec_trace_up[next_up_peak_idx].getMZ();
-              double next_up_peak_int = spec_trace_up[next_up_peak_idx].getIntensity();
-
-              double right_bound = centroid_mz + 3 * ftl_sd;
-              double left_bound = centroid_mz - 3 * ftl_sd;
-
-              if ((next_up_peak_mz <= right_bound) &&
-                  (next_up_peak_mz >= left_bound) &&
-                  !peak_visited[spec_offsets[trace_up_idx + 1] + next_up_peak_idx])
-              {
-                Peak2D next_peak;
-                next_peak.setRT(spec_trace_up.getRT());
-                next_peak.setMZ(next_up_peak_mz);
-                next_peak.setIntensity(next_up_peak_int);
+              // std::cout << "stopping down..." << std::endl;
+              toggle_down = false;
+            }
+          }
+        }
 
-                current_trace.push_back(next_peak);
-                if (fwhm_meta_idx != -1)
-                {
-                  fwhms_mz.push_back(spec_trace_up.getFloatDataArrays()[fwhm_meta_idx][next_up_peak_idx]);
-                }
-                // Update the m/z mean of the current trace as we added a new peak
-                updateIterativeWeightedMeanMZ(next_up_peak_mz, next_up_peak_int, centroid_mz, prev_counter, prev_denom);
-                gathered_idx.push_back(std::make_pair(trace_up_idx + 1, next_up_peak_idx));
+        // *********************************************************** //
+        // Step 2.2 MOVE UP in RT dim
+        // *********************************************************** //
+        if ((trace_up_idx < work_exp.size() - 1) && toggle_up)
+        {
+          const MSSpectrum& spec_trace_up = work_exp[trace_up_idx + 1];
+          if (partition.begin[trace_up_idx + 1] == partition.end[trace_up_idx + 1])
+          {
+            confined = confined && spec_trace_up.empty();
+          }
+          else
+          {
+            Size next_up_peak_idx = findNearestInRange(spec_trace_up, partition.begin[trace_up_idx + 1], partition.end[trace_up_idx + 1], centroid_mz);
+            double next_up_peak_mz = spec_trace_up[next_up_peak_idx].getMZ();
+            double next_up_peak_int = spec_trace_up[next_up_peak_idx].getIntensity();
+            confined = confined && partition.containsNearest(next_up_peak_mz, centroid_mz);
 
-                // Update the m/z variance dynamically
-                if (reestimate_mt_sd_)           //  && (up_hitting_peak+1 > min_flank_scans))
-                {
-                  // if (ftl_t > min_fwhm_scans)
-                  {
-                    updateWeightedSDEstimateRobust(next_peak, centroid_mz, ftl_sd, intensity_so_far);
-                  }
-                }
+            double right_bound = centroid_mz + 3 * ftl_sd;
+            double left_bound = centroid_mz - 3 * ftl_sd;
 
-                ++up_hitting_peak;
-                conseq_missed_peak_up = 0;
+            if ((next_up_peak_mz <= right_bound) &&
+                (next_up_peak_mz >= left_bound) &&
+                !partition.isVisited(trace_up_idx + 1, next_up_peak_idx))
+            {
+              Peak2D next_peak;
+              next_peak.setRT(spec_trace_up.getRT());
+              next_peak.setMZ(next_up_peak_mz);
+              next_peak.setIntensity(next_up_peak_int);
 
-              }
-              else
+              current_trace.push_back(next_peak);
+              if (fwhm_meta_idx != -1)
               {
-                ++conseq_missed_peak_up;
+                fwhms_mz.push_back(spec_trace_up.getFloatDataArrays()[fwhm_meta_idx][next_up_peak_idx]);
               }
+              // Update the m/z mean of the current trace as we added a new peak
+              updateIterativeWeightedMeanMZ(next_up_peak_mz, next_up_peak_int, centroid_mz, prev_counter, prev_denom);
+              gathered_idx.push_back(std::make_pair(trace_up_idx + 1, next_up_peak_idx));
 
-            }
-
-            ++trace_up_idx;
-            ++up_scan_counter;
-
-            if (trace_termination_criterion_ == "outlier")
-            {
-              if (conseq_missed_peak_up > max_consecutive_missing)
+              // Update the m/z variance dynamically
+              if (reestimate_mt_sd_)           //  && (up_hitting_peak+1 > min_flank_scans))
               {
-                toggle_up = false;
+                // if (ftl_t > min_fwhm_scans)
+                {
+                  updateWeightedSDEstimateRobust(next_peak, centroid_mz, ftl_sd, intensity_so_far);
+                }
               }
+
+              ++up_hitting_peak;
+              conseq_missed_peak_up = 0;
+
             }
-            else if (trace_termination_criterion_ == "sample_rate")
+            else
             {
-              current_sample_rate = (double)(down_hitting_peak + up_hitting_peak + 1) / (double)(down_scan_counter + up_scan_counter + 1);
-
-              if (up_scan_counter > min_scans_to_consider && current_sample_rate < min_sample_rate_)
+              // peaks within the bounds are only missed because they are visited
+              if ((next_up_peak_mz <= right_bound) && (next_up_peak_mz >= left_bound))
               {
-                // std::cout << "stopping up" << std::endl;
-                toggle_up = false;
+                visited_idx.push_back(std::make_pair(trace_up_idx + 1, next_up_peak_idx));
               }
+              ++conseq_missed_peak_up;
             }
 
-
           }
 
-        }
-
-        // std::cout << "current sr: " << current_sample_rate << std::endl;
-        double num_scans(down_scan_counter + up_scan_counter + 1 - conseq_missed_peak_down - conseq_missed_peak_up);
-
-        double mt_quality((double)current_trace.size() / (double)num_scans);
-        // std::cout << "mt quality: " << mt_quality << std::endl;
-        double rt_range(std::fabs(current_trace.rbegin()->getRT() - current_trace.begin()->getRT()));
-
-        // *********************************************************** //
-        // Step 2.3 check if minimum length and quality of mass trace criteria are met
-        // *********************************************************** //
-        bool max_trace_criteria = (max_trace_length_ < 0.0 || rt_range < max_trace_length_);
-        if (rt_range >= min_trace_length_ && max_trace_criteria && mt_quality >= min_sample_rate_)
-        {
-          // std::cout << "T" << trace_number << "\t" << mt_quality << std::endl;
+          ++trace_up_idx;
+          ++up_scan_counter;
 
-          // mark all peaks as visited
-          for (Size i = 0; i < gathered_idx.size(); ++i)
+          if (trace_termination_criterion_ == "outlier")
           {
-            peak_visited[spec_offsets[gathered_idx[i].first] +  gathered_idx[i].second] = true;
+            if (conseq_missed_peak_up > max_consecutive_missing)
+            {
+              toggle_up = false;
+            }
           }
+          else if (trace_termination_criterion_ == "sample_rate")
+          {
+            current_sample_rate = (double)(down_hitting_peak + up_hitting_peak + 1) / (double)(down_scan_counter + up_scan_counter + 1);
 
-          // create new MassTrace object and store collected peaks from list current_trace
-          MassTrace new_trace(current_trace);
-          new_trace.updateWeightedMeanRT();
-          new_trace.updateWeightedMeanMZ();
-          if (!fwhms_mz.empty()) new_trace.fwhm_mz_avg = Math::median(fwhms_mz.begin(), fwhms_mz.end());
-          new_trace.setQuantMethod(quant_method_);
-          //new_trace.setCentroidSD(ftl_sd);
-          new_trace.updateWeightedMZsd();
-          new_trace.setLabel("T" + String(trace_number));
-          ++trace_number;
-
-          found_masstraces.push_back(new_trace);
+            if (up_scan_counter > min_scans_to_consider && current_sample_rate < min_sample_rate_)
+            {
+              // std::cout << "stopping up" << std::endl;
+              toggle_up = false;
+            }
+          }
 
-          peaks_detected += new_trace.getSize();
-          this->setProgress(peaks_detected);
 
-          // check if we already reached the (optional) maximum number of traces
-          if (max_traces > 0 && found_masstraces.size() == max_traces) break;
         }
+
       }
 
-      this->endProgress();
+      // std::cout << "current sr: " << current_sample_rate << std::endl;
+      double num_scans(down_scan_counter + up_scan_counter + 1 - conseq_missed_peak_down - conseq_missed_peak_up);
 
+      double mt_quality((double)current_trace.size() / (double)num_scans);
+      // std::cout << "mt quality: " << mt_quality << std::endl;
+      double rt_range(std::fabs(current_trace.rbegin()->getRT() - current_trace.begin()->getRT()));
+
+      // *********************************************************** //
+      // Step 2.3 check if minimum length and quality of mass trace criteria are met
+      // *********************************************************** //
+      bool max_trace_criteria = (max_trace_length_ < 0.0 || rt_range < max_trace_length_);
+      if (rt_range >= min_trace_length_ && max_trace_criteria && mt_quality >= min_sample_rate_)
+      {
+        // create new MassTrace object and store collected peaks from list current_trace
+        trace = MassTrace(current_trace);
+        trace.updateWeightedMeanRT();
+        trace.updateWeightedMeanMZ();
+        if (!fwhms_mz.empty()) trace.fwhm_mz_avg = Math::median(fwhms_mz.begin(), fwhms_mz.end());
+        trace.setQuantMethod(quant_method_);
+        //trace.setCentroidSD(ftl_sd);
+        trace.updateWeightedMZsd();
+        return true;
+      }
+      return false;
     }
 
     void MassTraceDetection::updateMembers_()
@@ -564,6 +899,8 @@ namespace OpenMS
       min_trace_length_ = (double)param_.getValue("min_trace_length");
       max_trace_length_ = (double)param_.getValue("max_trace_length");
       reestimate_mt_sd_ = param_.getValue("reestimate_mt_sd").toBool();
+      mz_partitions_ = (Size)param_.getValue("mz_partitions");
+      mz_partition_overlap_ = (double)param_.getValue("mz_partition_overlap");
     }
 
 }
@@ -734,4 +734,62 @@ namespace OpenMS
     if (id_data.getParentMolecules().size() < n_parents) id_data.cleanup();
   }
 
+
+  void IDFilter::removeEmptyIdentifications(PSMTable& psms)
+  {
+    psms.removeEmptyIdentifications();
+  }
+
+
+  void IDFilter::filterHitsByScore(PSMTable& psms, double threshold_score)
+  {
+    vector<bool> keep(psms.getNrHits(), true);
+    for (Size i = 0; i < psms.getNrIdentifications(); ++i)
+    {
+      bool higher_better = psms.isHigherScoreBetter(i);
+      for (Size h = psms.getHitsBegin(i); h < psms.getHitsEnd(i); ++h)
+      {
+        double score = psms.getScore(h);
+        keep[h] = higher_better ? (score >= threshold_score) :
+          (score <= threshold_score);
+      }
+    }
+    psms.filterHits(keep);
+  }
+
+
+  void IDFilter::keepNBestHits(PSMTable& psms, Size n)
+  {
+    psms.sortHits();
+    vector<bool> keep(psms.getNrHits(), true);
+    for (Size i = 0; i < psms.getNrIdentifications(); ++i)
+    {
+      for (Size h = psms.getHitsBegin(i) + n; h < psms.getHitsEnd(i); ++h)
+      {
+        keep[h] = false;
+      }
+    }
+    psms.filterHits(keep);
+  }
+
+
+  void IDFilter::removeDecoyHits(PSMTable& psms)
+  {
+    static const MetaValueKey target_decoy("target_decoy");
+    static const MetaValueKey is_decoy("isDecoy");
+
+    vector<bool> keep(psms.getNrHits(), true);
+    for (Size h = 0; h < psms.getNrHits(); ++h)
+    {
+      if ((psms.hitMetaValueExists(h, target_decoy) &&
+           psms.getHitMetaValue(h, target_decoy).toString() == "decoy") ||
+          (psms.hitMetaValueExists(h, is_decoy) &&
+           psms.getHitMetaValue(h, is_decoy).toString() == "true"))
+      {
+        keep[h] = false;
+      }
+    }
+    psms.filterHits(keep);
+  }
+
 } // namespace OpenMS
@@ -44,6 +44,8 @@
 
 #include <OpenMS/FORMAT/HANDLERS/CachedMzMLHandler.h>
 
+#include <boost/iostreams/device/mapped_file.hpp>
+
 namespace OpenMS
 {
 
@@ -56,6 +58,11 @@ namespace OpenMS
     load_(filename);
   }
 
+  CachedmzML::CachedmzML(const String& filename, bool memory_map)
+  {
+    load_(filename, memory_map);
+  }
+
   CachedmzML::~CachedmzML()
   {
     ifs_.close();
@@ -64,13 +71,15 @@ namespace OpenMS
   CachedmzML::CachedmzML(const CachedmzML & rhs) :
     meta_ms_experiment_(rhs.meta_ms_experiment_),
     ifs_(rhs.filename_cached_.c_str(), std::ios::binary),
+    mapped_file_(rhs.mapped_file_),
     filename_(rhs.filename_),
+    filename_cached_(rhs.filename_cached_),
     spectra_index_(rhs.spectra_index_),
     chrom_index_(rhs.chrom_index_)
   {
   }
 
-  void CachedmzML::load_(const String& filename)
+  void CachedmzML::load_(const String& filename, bool memory_map)
   {
     filename_cached_ = filename + ".cached";
     filename_ = filename;
@@ -84,6 +93,22 @@ namespace OpenMS
     // open the filestream
     ifs_.open(filename_cached_.c_str(), std::ios::binary);
 
+    // map the cached data into memory (read-only)
+    mapped_file_.reset();
+    if (memory_map)
+    {
+      try
+      {
+        mapped_file_ = boost::shared_ptr<boost::iostreams::mapped_file_source>(
+          new boost::iostreams::mapped_file_source(filename_cached_));
+      }
+      catch (std::exception& e)
+      {
+        throw Exception::FileNotReadable(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          filename_cached_ + " (memory mapping failed: " + e.what() + ")");
+      }
+    }
+
     // load the meta data from disk
     MzMLFile().load(filename, meta_ms_experiment_);
   }
@@ -92,6 +117,13 @@ namespace OpenMS
   {
     OPENMS_PRECONDITION(id < getNrSpectra(), "Id cannot be larger than number of spectra");
 
+    if (isMemoryMapped())
+    {
+      MSSpectrum s = meta_ms_experiment_.getSpectrum(id);
+      Internal::CachedMzMLHandler::readSpectrum(s, mappedData_(), mappedSize_(), static_cast<std::streamoff>(spectra_index_[id]));
+      return s;
+    }
+
     if ( !ifs_.seekg(spectra_index_[id]) )
     {
       std::cerr << "Error while reading spectrum " << id << " - seekg created an error when trying to change position to " << spectra_index_[id] << "." << std::endl;
@@ -109,6 +141,13 @@ namespace OpenMS
   {
     OPENMS_PRECONDITION(id < getNrChromatograms(), "Id cannot be larger than number of chromatograms");
 
+    if (isMemoryMapped())
+    {
+      MSChromatogram c = meta_ms_experiment_.getChromatogram(id);
+      Internal::CachedMzMLHandler::readChromatogram(c, mappedData_(), mappedSize_(), static_cast<std::streamoff>(chrom_index_[id]));
+      return c;
+    }
+
     if ( !ifs_.seekg(chrom_index_[id]) )
     {
       std::cerr << "Error while reading chromatogram " << id << " - seekg created an error when trying to change position to " << chrom_index_[id] << "." << std::endl;
@@ -122,6 +161,45 @@ namespace OpenMS
     return c;
   }
 
+  Internal::CachedMzMLHandler::SpectrumView CachedmzML::getSpectrumView(Size id) const
+  {
+    OPENMS_PRECONDITION(id < getNrSpectra(), "Id cannot be larger than number of spectra");
+
+    if (!isMemoryMapped())
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Spectrum views are only available for memory-mapped cached files.");
+    }
+    return Internal::CachedMzMLHandler::readSpectrumView(mappedData_(), mappedSize_(), static_cast<std::streamoff>(spectra_index_[id]));
+  }
+
+  Internal::CachedMzMLHandler::ChromatogramView CachedmzML::getChromatogramView(Size id) const
+  {
+    OPENMS_PRECONDITION(id < getNrChromatograms(), "Id cannot be larger than number of chromatograms");
+
+    if (!isMemoryMapped())
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Chromatogram views are only available for memory-mapped cached files.");
+    }
+    return Internal::CachedMzMLHandler::readChromatogramView(mappedData_(), mappedSize_(), static_cast<std::streamoff>(chrom_index_[id]));
+  }
+
+  bool CachedmzML::isMemoryMapped() const
+  {
+    return mapped_file_ && mapped_file_->is_open();
+  }
+
+  const char* CachedmzML::mappedData_() const
+  {
+    return isMemoryMapped() ? mapped_file_->data() : nullptr;
+  }
+
+  Size CachedmzML::mappedSize_() const
+  {
+    return isMemoryMapped() ? mapped_file_->size() : 0;
+  }
+
   size_t CachedmzML::getNrSpectra() const
   {
     return meta_ms_experiment_.size();
@@ -138,9 +216,9 @@ namespace OpenMS
     Internal::CachedMzMLHandler().writeMetadata_x(map, filename, true);
   }
 
-  void CachedmzML::load(const String& filename, CachedmzML& map)
+  void CachedmzML::load(const String& filename, CachedmzML& map, bool memory_map)
   {
-    map.load_(filename);
+    map.load_(filename, memory_map);
   }
 
 }
@@ -49,6 +49,7 @@ namespace OpenMS
     XMLFile("/SCHEMAS/ConsensusXML_1_7.xsd", "1.7"),
     ProgressLogger(),
     consensus_map_(nullptr),
+    consumer_(nullptr),
     act_cons_element_(),
     last_meta_(nullptr)
   {
@@ -81,7 +82,14 @@ namespace OpenMS
       if ((!options_.hasRTRange() || options_.getRTRange().encloses(act_cons_element_.getRT())) && (!options_.hasMZRange() || options_.getMZRange().encloses(
                                                                                                       act_cons_element_.getMZ())) && (!options_.hasIntensityRange() || options_.getIntensityRange().encloses(act_cons_element_.getIntensity())))
       {
-        consensus_map_->push_back(act_cons_element_);
+        if (consumer_ != nullptr)
+        {
+          consumer_->consumeFeature(act_cons_element_);
+        }
+        else
+        {
+          consensus_map_->push_back(act_cons_element_);
+        }
         act_cons_element_.getPeptideIdentifications().clear();
       }
       last_meta_ = nullptr;
@@ -151,7 +159,15 @@ namespace OpenMS
     open_tags_.push_back(tag);
 
     String tmp_str;
-    if (tag == "map")
+    if (tag == "consensusElementList")
+    {
+      // transform(): the meta data is complete now
+      if (consumer_ != nullptr)
+      {
+        consumer_->setMapMetaData(*consensus_map_);
+      }
+    }
+    else if (tag == "map")
     {
       setProgress(++progress_);
       Size last_map = attributeAsInt_(attributes, "id");
@@ -679,6 +695,20 @@ namespace OpenMS
       throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
     }
 
+    writeHeader_(filename, os, consensus_map);
+    for (Size i = 0; i < consensus_map.size(); ++i)
+    {
+      setProgress(++progress_);
+      writeConsensusElement_(filename, os, consensus_map[i]);
+    }
+    writeFooter_(os);
+
+    endProgress();
+  }
+
+  void
+  ConsensusXMLFile::writeHeader_(const String& filename, std::ostream& os, const ConsensusMap& consensus_map)
+  {
     os.precision(writtenDigits<double>(0.0));
 
     setProgress(++progress_);
@@ -842,49 +872,53 @@ namespace OpenMS
     }
     os << "\t</mapList>\n";
 
-    // write all consensus elements
+    // consensus elements follow
     os << "\t<consensusElementList>\n";
-    for (Size i = 0; i < consensus_map.size(); ++i)
-    {
-      setProgress(++progress_);
-      // write a consensusElement
-      const ConsensusFeature& elem = consensus_map[i];
-      os << "\t\t<consensusElement id=\"e_" << elem.getUniqueId() << "\" quality=\"" << precisionWrapper(elem.getQuality()) << "\"";
-      if (elem.getCharge() != 0)
-      {
-        os << " charge=\"" << elem.getCharge() << "\"";
-      }
-      os << ">\n";
-      // write centroid
-      os << "\t\t\t<centroid rt=\"" << precisionWrapper(elem.getRT()) << "\" mz=\"" << precisionWrapper(elem.getMZ()) << "\" it=\"" << precisionWrapper(
-        elem.getIntensity()) << "\"/>\n";
-      // write groupedElementList
-      os << "\t\t\t<groupedElementList>\n";
-      for (ConsensusFeature::HandleSetType::const_iterator it = elem.begin(); it != elem.end(); ++it)
-      {
-        os << "\t\t\t\t<element"
-              " map=\"" << it->getMapIndex() << "\""
-                                                " id=\"" << it->getUniqueId() << "\""
-                                                                                 " rt=\"" << precisionWrapper(it->getRT()) << "\""
-                                                                                                                              " mz=\"" << precisionWrapper(it->getMZ()) << "\""
-                                                                                                                                                                           " it=\"" << precisionWrapper(it->getIntensity()) << "\"";
-        if (it->getCharge() != 0)
-        {
-          os << " charge=\"" << it->getCharge() << "\"";
-        }
-        os << "/>\n";
-      }
-      os << "\t\t\t</groupedElementList>\n";
+  }
 
-      // write PeptideIdentification
-      for (UInt j = 0; j < elem.getPeptideIdentifications().size(); ++j)
+  void
+  ConsensusXMLFile::writeConsensusElement_(const String& filename, std::ostream& os, const ConsensusFeature& elem)
+  {
+    os << "\t\t<consensusElement id=\"e_" << elem.getUniqueId() << "\" quality=\"" << precisionWrapper(elem.getQuality()) << "\"";
+    if (elem.getCharge() != 0)
+    {
+      os << " charge=\"" << elem.getCharge() << "\"";
+    }
+    os << ">\n";
+    // write centroid
+    os << "\t\t\t<centroid rt=\"" << precisionWrapper(elem.getRT()) << "\" mz=\"" << precisionWrapper(elem.getMZ()) << "\" it=\"" << precisionWrapper(
+      elem.getIntensity()) << "\"/>\n";
+    // write groupedElementList
+    os << "\t\t\t<groupedElementList>\n";
+    for (ConsensusFeature::HandleSetType::const_iterator it = elem.begin(); it != elem.end(); ++it)
+    {
+      os << "\t\t\t\t<element"
+            " map=\"" << it->getMapIndex() << "\""
+                                              " id=\"" << it->getUniqueId() << "\""
+                                                                               " rt=\"" << precisionWrapper(it->getRT()) << "\""
+                                                                                                                            " mz=\"" << precisionWrapper(it->getMZ()) << "\""
+                                                                                                                                                                         " it=\"" << precisionWrapper(it->getIntensity()) << "\"";
+      if (it->getCharge() != 0)
       {
-        writePeptideIdentification_(filename, os, elem.getPeptideIdentifications()[j], "PeptideIdentification", 3);
+        os << " charge=\"" << it->getCharge() << "\"";
       }
+      os << "/>\n";
+    }
+    os << "\t\t\t</groupedElementList>\n";
 
-      writeUserParam_("UserParam", os, elem, 3);
-      os << "\t\t</consensusElement>\n";
+    // write PeptideIdentification
+    for (UInt j = 0; j < elem.getPeptideIdentifications().size(); ++j)
+    {
+      writePeptideIdentification_(filename, os, elem.getPeptideIdentifications()[j], "PeptideIdentification", 3);
     }
+
+    writeUserParam_("UserParam", os, elem, 3);
+    os << "\t\t</consensusElement>\n";
+  }
+
+  void
+  ConsensusXMLFile::writeFooter_(std::ostream& os)
+  {
     os << "\t</consensusElementList>\n";
 
     os << "</consensusXML>\n";
@@ -892,7 +926,6 @@ namespace OpenMS
     //Clear members
     identifier_id_.clear();
     accession_to_id_.clear();
-    endProgress();
   }
 
   void
@@ -903,6 +936,7 @@ namespace OpenMS
 
     map.clear(true); // clear map
     consensus_map_ = &map;
+    consumer_ = nullptr;
 
     //set DocumentIdentifier
     consensus_map_->setLoadedFileType(file_);
@@ -917,8 +951,35 @@ namespace OpenMS
 
     }
 
-    //reset members
+    resetMembers_();
+    map.updateRanges();
+  }
+
+  void
+  ConsensusXMLFile::transform(const String& filename, Interfaces::IConsensusDataConsumer* consumer)
+  {
+    //Filename for error messages in XMLHandler
+    file_ = filename;
+
+    // holds the meta data only, consensus features are passed on to the consumer as soon as they are complete
+    ConsensusMap meta_data;
+    consensus_map_ = &meta_data;
+    consumer_ = consumer;
+
+    //set DocumentIdentifier
+    consensus_map_->setLoadedFileType(file_);
+    consensus_map_->setLoadedFilePath(file_);
+
+    parse_(filename, this);
+
+    resetMembers_();
+  }
+
+  void
+  ConsensusXMLFile::resetMembers_()
+  {
     consensus_map_ = nullptr;
+    consumer_ = nullptr;
     act_cons_element_ = ConsensusFeature();
     pos_.clear();
     it_ = 0;
@@ -933,7 +994,6 @@ namespace OpenMS
     id_identifier_.clear();
     search_param_ = ProteinIdentification::SearchParameters();
     progress_ = 0;
-    map.updateRanges();
   }
 
   void
@@ -0,0 +1,110 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/DATAACCESS/ConsensusXMLWritingConsumer.h>
+
+#include <OpenMS/CONCEPT/LogStream.h>
+#include <OpenMS/FORMAT/FileHandler.h>
+
+namespace OpenMS
+{
+
+  ConsensusXMLWritingConsumer::ConsensusXMLWritingConsumer(const String& filename) :
+    ConsensusXMLFile(),
+    filename_(filename),
+    features_written_(0),
+    started_writing_(false)
+  {
+    if (!FileHandler::hasValidExtension(filename, FileTypes::CONSENSUSXML))
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "invalid file extension, expected '" + FileTypes::typeToName(FileTypes::CONSENSUSXML) + "'");
+    }
+    ofs_.open(filename.c_str());
+    if (!ofs_)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+  }
+
+  ConsensusXMLWritingConsumer::~ConsensusXMLWritingConsumer()
+  {
+    try
+    {
+      close();
+    }
+    catch (Exception::BaseException& e)
+    {
+      OPENMS_LOG_ERROR << "Error while writing consensusXML file: " << e.what() << std::endl;
+    }
+  }
+
+  void ConsensusXMLWritingConsumer::setExpectedSize(Size /* expected_features */)
+  {
+  }
+
+  void ConsensusXMLWritingConsumer::setMapMetaData(const ConsensusMap& map)
+  {
+    meta_data_ = map;
+    meta_data_.clear(false);
+  }
+
+  void ConsensusXMLWritingConsumer::consumeFeature(ConsensusFeature& feature)
+  {
+    startWriting_();
+    writeConsensusElement_(filename_, ofs_, feature);
+    ++features_written_;
+  }
+
+  Size ConsensusXMLWritingConsumer::getNrFeaturesWritten() const
+  {
+    return features_written_;
+  }
+
+  void ConsensusXMLWritingConsumer::startWriting_()
+  {
+    if (started_writing_) return;
+    writeHeader_(filename_, ofs_, meta_data_);
+    started_writing_ = true;
+  }
+
+  void ConsensusXMLWritingConsumer::close()
+  {
+    if (!ofs_.is_open()) return;
+
+    startWriting_();
+    writeFooter_(ofs_);
+    ofs_.close();
+  }
+
+} // namespace OpenMS
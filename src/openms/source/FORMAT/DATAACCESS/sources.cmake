@@ -3,7 +3,9 @@ set(directory source/FORMAT/DATAACCESS)
 
 ### list all filenames of the directory here
 set(sources_list
+  ConsensusXMLWritingConsumer.cpp
   CsiFingerIdMzTabWriter.cpp
+  FeatureXMLWritingConsumer.cpp
   MSDataWritingConsumer.cpp
   MSDataTransformingConsumer.cpp
   MSDataAggregatingConsumer.cpp
@@ -62,6 +62,7 @@ namespace OpenMS
     disable_parsing_ = 0;
     current_feature_ = nullptr;
     map_ = nullptr;
+    consumer_ = nullptr;
     //options_ = FeatureFileOptions(); do NOT reset this, since we need to preserve options!
     size_only_ = false;
     expected_size_ = 0;
@@ -107,6 +108,7 @@ namespace OpenMS
 
     feature_map.clear(true);
     map_ = &feature_map;
+    consumer_ = nullptr;
 
     //set DocumentIdentifier
     map_->setLoadedFileType(file_);
@@ -133,6 +135,26 @@ namespace OpenMS
     return;
   }
 
+  void FeatureXMLFile::transform(const String& filename, Interfaces::IFeatureDataConsumer* consumer)
+  {
+    //Filename for error messages in XMLHandler
+    file_ = filename;
+
+    // holds the meta data only, features are passed on to the consumer as soon as they are complete
+    FeatureMap meta_data;
+    map_ = &meta_data;
+    consumer_ = consumer;
+
+    //set DocumentIdentifier
+    map_->setLoadedFileType(file_);
+    map_->setLoadedFilePath(file_);
+
+    parse_(filename, this);
+
+    // reset members
+    resetMembers_();
+  }
+
   void FeatureXMLFile::store(const String& filename, const FeatureMap& feature_map)
   {
     if (!FileHandler::hasValidExtension(filename, FileTypes::FEATUREXML))
@@ -169,6 +191,23 @@ namespace OpenMS
       throw;
     }
 
+    writeHeader_(filename, os, feature_map);
+    os << "\t<featureList count=\"" << feature_map.size() << "\">\n";
+
+    startProgress(0, feature_map.size(), "Storing featureXML file");
+    for (Size s = 0; s < feature_map.size(); s++)
+    {
+      writeFeature_(filename, os, feature_map[s], "f_", feature_map[s].getUniqueId(), 0);
+      setProgress(s);
+      // writeFeature_(filename, os, feature_map[s], "f_", s, 0);
+    }
+    endProgress();
+
+    writeFooter_(os);
+  }
+
+  void FeatureXMLFile::writeHeader_(const String& filename, std::ostream& os, const FeatureMap& feature_map)
+  {
     os.precision(writtenDigits<double>(0.0));
 
     os << "<?xml version=\"1.0\" encoding=\"ISO-8859-1\"?>\n"
@@ -303,18 +342,10 @@ namespace OpenMS
     {
       writePeptideIdentification_(filename, os, feature_map.getUnassignedPeptideIdentifications()[i], "UnassignedPeptideIdentification", 1);
     }
+  }
 
-    // write features with their corresponding attributes
-    os << "\t<featureList count=\"" << feature_map.size() << "\">\n";
-    startProgress(0, feature_map.size(), "Storing featureXML file");
-    for (Size s = 0; s < feature_map.size(); s++)
-    {
-      writeFeature_(filename, os, feature_map[s], "f_", feature_map[s].getUniqueId(), 0);
-      setProgress(s);
-      // writeFeature_(filename, os, feature_map[s], "f_", s, 0);
-    }
-    endProgress();
-
+  void FeatureXMLFile::writeFooter_(std::ostream& os)
+  {
     os << "\t</featureList>\n";
     os << "</featureMap>\n";
 
@@ -400,7 +431,15 @@ namespace OpenMS
         expected_size_ = count;
         throw EndParsingSoftly(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
       }
-      map_->reserve(std::min(Size(1e5), count)); // reserve vector for faster push_back, but with upper boundary of 1e5 (as >1e5 is most likely an invalid feature count)
+      if (consumer_ != nullptr) // transform(): the meta data is complete now
+      {
+        consumer_->setExpectedSize(count);
+        consumer_->setMapMetaData(*map_);
+      }
+      else
+      {
+        map_->reserve(std::min(Size(1e5), count)); // reserve vector for faster push_back, but with upper boundary of 1e5 (as >1e5 is most likely an invalid feature count)
+      }
       startProgress(0, count, "Loading featureXML file");
     }
     else if (tag == "quality" || tag == "hposition" || tag == "position")
@@ -852,6 +891,19 @@ namespace OpenMS
           f1->getSubordinates().pop_back();
         }
       }
+
+      // transform(): pass on complete top-level features
+      if (consumer_ != nullptr && subordinate_feature_level_ == 0 && !map_->empty())
+      {
+        Feature& feature = map_->back();
+        // same hack as in load()
+        if (feature.metaValueExists("FWHM"))
+        {
+          feature.setWidth((double)feature.getMetaValue("FWHM"));
+        }
+        consumer_->consumeFeature(feature);
+        map_->pop_back();
+      }
       updateCurrentFeature_(false);
     }
     else if (tag == "model")
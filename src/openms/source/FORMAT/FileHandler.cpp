@@ -47,6 +47,7 @@
 #include <OpenMS/FORMAT/MsInspectFile.h>
 #include <OpenMS/FORMAT/SpecArrayFile.h>
 #include <OpenMS/FORMAT/KroenikFile.h>
+#include <OpenMS/FORMAT/IdBinaryFile.h>
 
 #include <OpenMS/KERNEL/ChromatogramTools.h>
 
@@ -127,6 +128,12 @@ namespace OpenMS
 
   FileTypes::Type FileHandler::getTypeByContent(const String& filename)
   {
+    // binary formats are recognized by their magic number
+    if (IdBinaryFile::isIdBinaryFile(filename))
+    {
+      return FileTypes::IDBIN;
+    }
+
     String first_line;
     String two_five;
     String all_simple;
@@ -42,6 +42,105 @@ namespace OpenMS
 namespace Internal
 {
 
+  namespace
+  {
+    /**
+      @brief Sequential reader on a memory buffer (e.g. a memory-mapped cached file)
+
+      Mirrors the std::ifstream interface used for reading cached files but
+      keeps its position locally, allowing concurrent readers on the same
+      buffer.
+    */
+    struct MemoryReader
+    {
+      MemoryReader(const char* buffer, Size buffer_size, Size offset) :
+        begin_(buffer),
+        end_(buffer + buffer_size),
+        pos_(buffer + offset)
+      {
+        if (offset > buffer_size)
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+            "Tried to read beyond the end of the buffer, something is wrong here. Aborting.", "memory buffer");
+        }
+      }
+
+      /// copy @p n bytes from the current position into @p dest
+      void read(void* dest, Size n)
+      {
+        std::memcpy(dest, skip(n), n);
+      }
+
+      /// throws a ParseError unless @p count items of @p item_size bytes are left to read
+      void require(Size count, Size item_size) const
+      {
+        if (count > static_cast<Size>(end_ - pos_) / item_size)
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+            "Tried to read beyond the end of the buffer, something is wrong here. Aborting.", "memory buffer");
+        }
+      }
+
+      /// advance the current position by @p n bytes, returns the previous position
+      const char* skip(Size n)
+      {
+        if (static_cast<Size>(end_ - pos_) < n)
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+            "Tried to read beyond the end of the buffer, something is wrong here. Aborting.", "memory buffer");
+        }
+        const char* current = pos_;
+        pos_ += n;
+        return current;
+      }
+
+      const char* begin_;
+      const char* end_;
+      const char* pos_;
+    };
+
+    /// skip a data array of @p data_size elements and return a view of it
+    CachedMzMLHandler::DataArrayView readView(MemoryReader& reader, Size data_size)
+    {
+      CachedMzMLHandler::DataArrayView view;
+      reader.require(data_size, sizeof(CachedMzMLHandler::DatumSingleton));
+      view.data = reader.skip(data_size * sizeof(CachedMzMLHandler::DatumSingleton));
+      view.size = data_size;
+      return view;
+    }
+
+    /// read the data arrays starting at the current position of @p reader
+    void readDataMemory(MemoryReader& reader, std::vector<OpenSwath::BinaryDataArrayPtr>& data,
+                        Size data_size, Size nr_float_arrays)
+    {
+      // check sizes read from the buffer before allocating memory for them
+      reader.require(data_size, 2 * sizeof(CachedMzMLHandler::DatumSingleton));
+      data[0]->data.resize(data_size);
+      data[1]->data.resize(data_size);
+      if (data_size > 0)
+      {
+        reader.read(&(data[0]->data)[0], data_size * sizeof(CachedMzMLHandler::DatumSingleton));
+        reader.read(&(data[1]->data)[0], data_size * sizeof(CachedMzMLHandler::DatumSingleton));
+      }
+
+      for (Size k = 0; k < nr_float_arrays; k++)
+      {
+        data.push_back(OpenSwath::BinaryDataArrayPtr(new OpenSwath::BinaryDataArray));
+        Size len, len_name;
+        reader.read(&len, sizeof(len));
+        reader.read(&len_name, sizeof(len_name));
+        const char* name = reader.skip(len_name * sizeof(char));
+        data.back()->description = std::string(name, len_name);
+        reader.require(len, sizeof(CachedMzMLHandler::DatumSingleton));
+        data.back()->data.resize(len);
+        if (len > 0)
+        {
+          reader.read(&(data.back()->data)[0], len * sizeof(CachedMzMLHandler::DatumSingleton));
+        }
+      }
+    }
+  }
+
   CachedMzMLHandler::CachedMzMLHandler()
   {
   }
@@ -404,10 +503,95 @@ namespace Internal
     int ms_level;
     double rt;
     std::vector<OpenSwath::BinaryDataArrayPtr> data = readSpectrumFast(ifs, ms_level, rt);
-    spectrum.reserve(data[0]->data.size());
     spectrum.setMSLevel(ms_level);
     spectrum.setRT(rt);
+    fillSpectrum_(spectrum, data);
+  }
 
+  void CachedMzMLHandler::readChromatogram(ChromatogramType& chromatogram, std::ifstream& ifs)
+  {
+    std::vector<OpenSwath::BinaryDataArrayPtr> data = readChromatogramFast(ifs);
+    fillChromatogram_(chromatogram, data);
+  }
+
+  std::vector<OpenSwath::BinaryDataArrayPtr> CachedMzMLHandler::readSpectrumFast(const char* buffer, Size buffer_size, Size offset,
+                                                                                 int& ms_level, double& rt)
+  {
+    std::vector<OpenSwath::BinaryDataArrayPtr> data;
+    data.push_back(OpenSwath::BinaryDataArrayPtr(new OpenSwath::BinaryDataArray));
+    data.push_back(OpenSwath::BinaryDataArrayPtr(new OpenSwath::BinaryDataArray));
+
+    MemoryReader reader(buffer, buffer_size, offset);
+    Size spec_size, nr_float_arrays;
+    reader.read(&spec_size, sizeof(spec_size));
+    reader.read(&nr_float_arrays, sizeof(nr_float_arrays));
+    reader.read(&ms_level, sizeof(ms_level));
+    reader.read(&rt, sizeof(rt));
+
+    readDataMemory(reader, data, spec_size, nr_float_arrays);
+    return data;
+  }
+
+  std::vector<OpenSwath::BinaryDataArrayPtr> CachedMzMLHandler::readChromatogramFast(const char* buffer, Size buffer_size, Size offset)
+  {
+    std::vector<OpenSwath::BinaryDataArrayPtr> data;
+    data.push_back(OpenSwath::BinaryDataArrayPtr(new OpenSwath::BinaryDataArray));
+    data.push_back(OpenSwath::BinaryDataArrayPtr(new OpenSwath::BinaryDataArray));
+
+    MemoryReader reader(buffer, buffer_size, offset);
+    Size chrom_size, nr_float_arrays;
+    reader.read(&chrom_size, sizeof(chrom_size));
+    reader.read(&nr_float_arrays, sizeof(nr_float_arrays));
+
+    readDataMemory(reader, data, chrom_size, nr_float_arrays);
+    return data;
+  }
+
+  CachedMzMLHandler::SpectrumView CachedMzMLHandler::readSpectrumView(const char* buffer, Size buffer_size, Size offset)
+  {
+    MemoryReader reader(buffer, buffer_size, offset);
+    SpectrumView view;
+    Size spec_size, nr_float_arrays;
+    reader.read(&spec_size, sizeof(spec_size));
+    reader.read(&nr_float_arrays, sizeof(nr_float_arrays));
+    reader.read(&view.ms_level, sizeof(view.ms_level));
+    reader.read(&view.rt, sizeof(view.rt));
+    view.mz = readView(reader, spec_size);
+    view.intensity = readView(reader, spec_size);
+    return view;
+  }
+
+  CachedMzMLHandler::ChromatogramView CachedMzMLHandler::readChromatogramView(const char* buffer, Size buffer_size, Size offset)
+  {
+    MemoryReader reader(buffer, buffer_size, offset);
+    ChromatogramView view;
+    Size chrom_size, nr_float_arrays;
+    reader.read(&chrom_size, sizeof(chrom_size));
+    reader.read(&nr_float_arrays, sizeof(nr_float_arrays));
+    view.rt = readView(reader, chrom_size);
+    view.intensity = readView(reader, chrom_size);
+    return view;
+  }
+
+  void CachedMzMLHandler::readSpectrum(SpectrumType& spectrum, const char* buffer, Size buffer_size, Size offset)
+  {
+    int ms_level;
+    double rt;
+    std::vector<OpenSwath::BinaryDataArrayPtr> data = readSpectrumFast(buffer, buffer_size, offset, ms_level, rt);
+    spectrum.setMSLevel(ms_level);
+    spectrum.setRT(rt);
+    fillSpectrum_(spectrum, data);
+  }
+
+  void CachedMzMLHandler::readChromatogram(ChromatogramType& chromatogram, const char* buffer, Size buffer_size, Size offset)
+  {
+    std::vector<OpenSwath::BinaryDataArrayPtr> data = readChromatogramFast(buffer, buffer_size, offset);
+    fillChromatogram_(chromatogram, data);
+  }
+
+  void CachedMzMLHandler::fillSpectrum_(SpectrumType& spectrum, const std::vector<OpenSwath::BinaryDataArrayPtr>& data)
+  {
+    spectrum.reserve(data[0]->data.size());
     for (Size j = 0; j < data[0]->data.size(); j++)
     {
       Peak1D p;
@@ -425,11 +609,9 @@ namespace Internal
     }
   }
 
-  void CachedMzMLHandler::readChromatogram(ChromatogramType& chromatogram, std::ifstream& ifs)
+  void CachedMzMLHandler::fillChromatogram_(ChromatogramType& chromatogram, const std::vector<OpenSwath::BinaryDataArrayPtr>& data)
   {
-    std::vector<OpenSwath::BinaryDataArrayPtr> data = readChromatogramFast(ifs);
     chromatogram.reserve(data[0]->data.size());
-
     for (Size j = 0; j < data[0]->data.size(); j++)
     {
       ChromatogramPeak p;
@@ -443,7 +625,7 @@ namespace Internal
     {
       MSChromatogram::FloatDataArray fda;
       fda.reserve(data[j]->data.size());
-      for (const auto& k : fda) fda.push_back(k);
+      for (const auto& k : data[j]->data) fda.push_back(k);
       fda.setName(data[j]->description);
       fdas.push_back(fda);
     }
@@ -37,6 +37,8 @@
 #include <OpenMS/FORMAT/HANDLERS/IndexedMzMLDecoder.h>
 #include <OpenMS/FORMAT/HANDLERS/MzMLSpectrumDecoder.h>
 
+#include <boost/iostreams/device/mapped_file.hpp>
+
 // #define DEBUG_READER
 
 namespace OpenMS
@@ -44,6 +46,16 @@ namespace OpenMS
 namespace Internal
 {
 
+  namespace
+  {
+    /// Per-thread buffer holding the XML of the spectrum / chromatogram that is currently decoded
+    std::string& threadLocalBuffer()
+    {
+      static thread_local std::string buffer;
+      return buffer;
+    }
+  }
+
   void IndexedMzMLHandler::parseFooter_(String filename)
   {
     //-------------------------------------------------------------
@@ -87,12 +99,17 @@ namespace Internal
     chromatograms_offsets_(source.chromatograms_offsets_),
     index_offset_(source.index_offset_),
     spectra_before_chroms_(source.spectra_before_chroms_),
-    // do not copy the filestream itself but open a new filestream using the same file
-    // this is critical for parallel access to the same file!
-    filestream_(source.filename_.c_str()),
+    mapped_file_(source.mapped_file_),
     parsing_success_(source.parsing_success_),
     skip_xml_checks_(source.skip_xml_checks_)
   {
+    // do not copy the filestream itself but open a new filestream using the same file
+    // this is critical for parallel access to the same file! (not needed if
+    // the file is memory-mapped as the mapping is read-only and shared)
+    if (!isMemoryMapped())
+    {
+      filestream_.open(filename_.c_str());
+    }
   }
 
   IndexedMzMLHandler::~IndexedMzMLHandler()
@@ -106,8 +123,57 @@ namespace Internal
       filestream_.close();
     }
     filename_ = filename;
-    filestream_.open(filename.c_str());
     parseFooter_(filename);
+
+    // try to map the file into memory, fall back to a file stream otherwise
+    mapped_file_.reset();
+    if (parsing_success_)
+    {
+      try
+      {
+        mapped_file_ = boost::shared_ptr<boost::iostreams::mapped_file_source>(
+          new boost::iostreams::mapped_file_source(filename));
+      }
+      catch (std::exception& /* e */)
+      {
+        mapped_file_.reset();
+      }
+    }
+    if (!isMemoryMapped())
+    {
+      filestream_.open(filename.c_str());
+    }
+  }
+
+  bool IndexedMzMLHandler::isMemoryMapped() const
+  {
+    return mapped_file_ && mapped_file_->is_open();
+  }
+
+  void IndexedMzMLHandler::readRange_(std::streampos startidx, std::streampos endidx, std::string& text)
+  {
+    std::streamoff readl = endidx - startidx;
+    if (isMemoryMapped())
+    {
+      std::streamoff start = startidx;
+      if (start < 0 || readl < 0 || static_cast<Size>(start + readl) > mapped_file_->size())
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+            "Offset points outside of the file, the index might be corrupt", filename_);
+      }
+      text.assign(mapped_file_->data() + start, readl);
+    }
+    else
+    {
+      text.resize(readl);
+      filestream_.seekg(startidx, filestream_.beg);
+      filestream_.read(&text[0], readl);
+    }
+
+#ifdef DEBUG_READER
+    // print the full text we just read
+    std::cout << text << std::endl;
+#endif
   }
 
   bool IndexedMzMLHandler::getParsingSuccess() const
@@ -125,7 +191,7 @@ namespace Internal
     return chromatograms_offsets_.size();
   }
 
-  std::string IndexedMzMLHandler::getChromatogramById_helper_(int id)
+  void IndexedMzMLHandler::getChromatogramById_helper_(int id, std::string& text)
   {
     int chromToGet = id;
 
@@ -169,23 +235,10 @@ namespace Internal
       endidx = chromatograms_offsets_[chromToGet + 1].second;
     }
 
-    std::streampos readl = endidx - startidx;
-    char* buffer = new char[readl + std::streampos(1)];
-    filestream_.seekg(startidx, filestream_.beg);
-    filestream_.read(buffer, readl);
-    buffer[readl] = '\0';
-    std::string text(buffer);
-    delete[] buffer;
-
-#ifdef DEBUG_READER
-    // print the full text we just read
-    std::cout << text << std::endl;
-#endif
-
-    return text;
+    readRange_(startidx, endidx, text);
   }
 
-  std::string IndexedMzMLHandler::getSpectrumById_helper_(int id)
+  void IndexedMzMLHandler::getSpectrumById_helper_(int id, std::string& text)
   {
     int spectrumToGet = id;
 
@@ -229,26 +282,14 @@ namespace Internal
       endidx = spectra_offsets_[spectrumToGet + 1].second;
     }
 
-    std::streampos readl = endidx - startidx;
-    char* buffer = new char[readl + std::streampos(1)];
-    filestream_.seekg(startidx, filestream_.beg);
-    filestream_.read(buffer, readl);
-    buffer[readl] = '\0';
-    std::string text(buffer);
-    delete[] buffer;
-
-#ifdef DEBUG_READER
-    // print the full text we just read
-    std::cout << text << std::endl;
-#endif
-
-    return text;
+    readRange_(startidx, endidx, text);
   }
 
   OpenMS::Interfaces::SpectrumPtr IndexedMzMLHandler::getSpectrumById(int id)
   {
     OpenMS::Interfaces::SpectrumPtr sptr(new OpenMS::Interfaces::Spectrum);
-    std::string text = IndexedMzMLHandler::getSpectrumById_helper_(id);
+    std::string& text = threadLocalBuffer();
+    getSpectrumById_helper_(id, text);
     MzMLSpectrumDecoder(skip_xml_checks_).domParseSpectrum(text, sptr);
     return sptr;
   }
@@ -262,14 +303,16 @@ namespace Internal
 
   void IndexedMzMLHandler::getMSSpectrumById(int id, MSSpectrum& s)
   {
-    std::string text = IndexedMzMLHandler::getSpectrumById_helper_(id);
+    std::string& text = threadLocalBuffer();
+    getSpectrumById_helper_(id, text);
     MzMLSpectrumDecoder(skip_xml_checks_).domParseSpectrum(text, s);
   }
 
   OpenMS::Interfaces::ChromatogramPtr IndexedMzMLHandler::getChromatogramById(int id)
   {
     OpenMS::Interfaces::ChromatogramPtr cptr(new OpenMS::Interfaces::Chromatogram);
-    std::string text = IndexedMzMLHandler::getChromatogramById_helper_(id);
+    std::string& text = threadLocalBuffer();
+    getChromatogramById_helper_(id, text);
     MzMLSpectrumDecoder(skip_xml_checks_).domParseChromatogram(text, cptr);
     return cptr;
   }
@@ -283,7 +326,8 @@ namespace Internal
 
   void IndexedMzMLHandler::getMSChromatogramById(int id, MSChromatogram& c)
   {
-    std::string text = IndexedMzMLHandler::getChromatogramById_helper_(id);
+    std::string& text = threadLocalBuffer();
+    getChromatogramById_helper_(id, text);
     MzMLSpectrumDecoder(skip_xml_checks_).domParseChromatogram(text, c);
   }
 
@@ -2571,7 +2571,7 @@ namespace OpenMS
                         new_mod->setDiffMonoMass(mass_delta);
                         new_mod->setMonoMass(mass_delta + Residue::getInternalToNTerm().getMonoWeight());
                         new_mod->setTermSpecificity(ResidueModification::N_TERM);
-                        mod_db->addModification(new_mod);
+                        if (mod_db->addModification(new_mod) != new_mod) delete new_mod;
                       }
 
                       aas.setNTerminalModification(residue_id);
@@ -2594,7 +2594,7 @@ namespace OpenMS
                         new_mod->setDiffMonoMass(mass_delta);
                         new_mod->setMonoMass(mass_delta + Residue::getInternalToCTerm().getMonoWeight());
                         new_mod->setTermSpecificity(ResidueModification::C_TERM);
-                        mod_db->addModification(new_mod);
+                        if (mod_db->addModification(new_mod) != new_mod) delete new_mod;
                       }
                       aas.setCTerminalModification(residue_id);
                       cvp = cvp->getNextElementSibling();
@@ -2627,7 +2627,7 @@ namespace OpenMS
                         new_mod->setAverageMass(mass_delta + residue.getAverageWeight());
                         new_mod->setDiffMonoMass(mass_delta);
 
-                        mod_db->addModification(new_mod);
+                        if (mod_db->addModification(new_mod) != new_mod) delete new_mod;
                       }
 
                       // now use the new modification
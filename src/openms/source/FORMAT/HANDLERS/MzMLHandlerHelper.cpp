@@ -162,7 +162,7 @@ namespace OpenMS
     }
   }
 
-  void MzMLHandlerHelper::decodeBase64Arrays(std::vector<BinaryData>& data, const bool skipXMLCheck)
+  void MzMLHandlerHelper::decodeBase64Arrays(std::vector<BinaryData>& data, const bool skipXMLCheck, const bool convert_to_64bit)
   {
     // decode all base64 arrays
     for (auto& bindata : data)
@@ -221,6 +221,18 @@ namespace OpenMS
             bindata.size = bindata.floats_64.size();
           }
         }
+        else if (bindata.precision == BinaryData::PRE_32 && convert_to_64bit)
+        {
+          // widen to double while decoding, no intermediate float array
+          Base64::decodeAndConvert<float>(bindata.base64, Base64::BYTEORDER_LITTLEENDIAN, bindata.floats_64, bindata.compression);
+          bindata.precision = BinaryData::PRE_64;
+          if (bindata.size != bindata.floats_64.size())
+          {
+            MzMLHandlerHelper::warning(0, String("Float binary data array '") + bindata.meta.getName() + 
+                "' has length " + bindata.floats_64.size() + ", but should have length " + bindata.size + ".");
+            bindata.size = bindata.floats_64.size();
+          }
+        }
         else if (bindata.precision == BinaryData::PRE_32)
         {
           Base64::decode(bindata.base64, Base64::BYTEORDER_LITTLEENDIAN, bindata.floats_32, bindata.compression);
@@ -72,13 +72,13 @@ namespace OpenMS
     }
   }
 
-  inline void fillDataArray(const std::vector<Internal::MzMLHandlerHelper::BinaryData>& data,
+  inline void fillDataArray(std::vector<Internal::MzMLHandlerHelper::BinaryData>& data,
                             OpenMS::Interfaces::BinaryDataArrayPtr array, bool precision_64, SignedSize index)
   {
-    // This seems to be the fastest method to move the data (faster than copy or assign)
     if (precision_64)
     {
-      array->data.insert(array->data.begin(), data[index].floats_64.begin(), data[index].floats_64.end());
+      // the decoded doubles are not needed anymore, hand them over without a copy
+      array->data.swap(data[index].floats_64);
     }
     else
     {
@@ -348,7 +348,7 @@ namespace OpenMS
 
   OpenMS::Interfaces::SpectrumPtr MzMLSpectrumDecoder::decodeBinaryDataSpectrum_(std::vector<BinaryData>& data)
   {
-    Internal::MzMLHandlerHelper::decodeBase64Arrays(data, skip_xml_checks_);
+    Internal::MzMLHandlerHelper::decodeBase64Arrays(data, skip_xml_checks_, true);
     OpenMS::Interfaces::SpectrumPtr sptr(new OpenMS::Interfaces::Spectrum);
 
     //look up the precision and the index of the intensity and m/z array
@@ -398,7 +398,7 @@ namespace OpenMS
 
   OpenMS::Interfaces::ChromatogramPtr MzMLSpectrumDecoder::decodeBinaryDataChrom_(std::vector<BinaryData>& data)
   {
-    Internal::MzMLHandlerHelper::decodeBase64Arrays(data, skip_xml_checks_);
+    Internal::MzMLHandlerHelper::decodeBase64Arrays(data, skip_xml_checks_, true);
     OpenMS::Interfaces::ChromatogramPtr sptr(new OpenMS::Interfaces::Chromatogram);
 
     //look up the precision and the index of the intensity and m/z array
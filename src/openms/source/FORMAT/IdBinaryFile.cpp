@@ -0,0 +1,955 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/IdBinaryFile.h>
+
+#include <OpenMS/CHEMISTRY/ModificationsDB.h>
+#include <OpenMS/CHEMISTRY/ProteaseDB.h>
+#include <OpenMS/CONCEPT/LogStream.h>
+#include <OpenMS/METADATA/MetaInfoInterface.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <cstring>
+
+using namespace std;
+
+namespace OpenMS
+{
+
+  namespace
+  {
+    const char IDBIN_MAGIC[8] = {'O', 'M', 'S', 'I', 'D', 'B', 'I', 'N'};
+    const UInt64 IDBIN_VERSION = 1;
+
+    /// maximal number of distinct sequences kept by a Reader between blocks
+    const Size MAX_POOLED_SEQUENCES = 100000;
+
+    /// Sections as stored in a block (meta values of identifications and hits are stored separately)
+    enum StoredSection
+    {
+      STORED_POSITIONS,
+      STORED_IDENTIFICATIONS,
+      STORED_HITS,
+      STORED_EVIDENCES,
+      STORED_IDENTIFICATION_META,
+      STORED_HIT_META,
+      NR_STORED_SECTIONS
+    };
+
+    /// File header, followed by the protein identifications (size + data), the blocks and the meta value names
+    struct IdBinHeader
+    {
+      char magic[8];
+      UInt64 version;
+      UInt64 nr_peptide_ids;
+      UInt64 nr_blocks;
+      UInt64 keys_offset;
+    };
+
+    /// Header of a block of peptide identifications, followed by the sections
+    struct IdBinBlockHeader
+    {
+      UInt64 nr_ids;
+      UInt64 nr_hits;
+      UInt64 section_sizes[NR_STORED_SECTIONS];
+    };
+
+    /// Appends binary values to a buffer
+    class ByteWriter
+    {
+public:
+      explicit ByteWriter(vector<char>& data) :
+        data_(data)
+      {
+      }
+
+      template <typename T>
+      void put(const T value)
+      {
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        data_.insert(data_.end(), bytes, bytes + sizeof(T));
+      }
+
+      void putString(const String& s)
+      {
+        put<UInt32>(s.size());
+        data_.insert(data_.end(), s.begin(), s.end());
+      }
+
+      void putStringList(const vector<String>& strings)
+      {
+        put<UInt64>(strings.size());
+        for (const String& s : strings) putString(s);
+      }
+
+      void putDataValue(const DataValue& value)
+      {
+        put<Byte>(value.valueType());
+        switch (value.valueType())
+        {
+          case DataValue::STRING_VALUE:
+            putString(value.toString());
+            break;
+          case DataValue::INT_VALUE:
+            put<Int64>(static_cast<SignedSize>(value));
+            break;
+          case DataValue::DOUBLE_VALUE:
+            put<double>(static_cast<double>(value));
+            break;
+          case DataValue::STRING_LIST:
+            putStringList(value.toStringList());
+            break;
+          case DataValue::INT_LIST:
+          {
+            IntList list = value.toIntList();
+            put<UInt64>(list.size());
+            for (Int i : list) put<Int32>(i);
+            break;
+          }
+          case DataValue::DOUBLE_LIST:
+          {
+            DoubleList list = value.toDoubleList();
+            put<UInt64>(list.size());
+            for (double d : list) put<double>(d);
+            break;
+          }
+          default:
+            break;
+        }
+        put<Byte>(value.getUnitType());
+        put<Int32>(value.getUnit());
+      }
+
+      /// writes the meta values of @p meta, meta value keys are stored as indices in @p key_indices (extended as necessary)
+      void putMetaValues(const MetaInfoInterface& meta, map<UInt, UInt>& key_indices)
+      {
+        vector<UInt> keys;
+        meta.getKeys(keys);
+        put<UInt32>(keys.size());
+        for (UInt key : keys)
+        {
+          UInt index = key_indices.insert(make_pair(key, key_indices.size())).first->second;
+          put<UInt32>(index);
+          putDataValue(meta.getMetaValue(key));
+        }
+      }
+
+protected:
+      vector<char>& data_;
+    };
+
+    /// Reads binary values from a buffer (with range checks)
+    class ByteReader
+    {
+public:
+      ByteReader(const char* begin, const char* end, const String& filename) :
+        pos_(begin),
+        end_(end),
+        filename_(filename)
+      {
+      }
+
+      template <typename T>
+      T get()
+      {
+        check_(sizeof(T));
+        T value;
+        memcpy(&value, pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return value;
+      }
+
+      /// reads an element count of type @p T and checks that @p min_item_size bytes per element are left
+      template <typename T>
+      Size getCount(Size min_item_size)
+      {
+        T count = get<T>();
+        if (UInt64(count) > UInt64(end_ - pos_) / min_item_size)
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Truncated or corrupt idBin file: " + filename_);
+        }
+        return count;
+      }
+
+      String getString()
+      {
+        UInt32 size = get<UInt32>();
+        check_(size);
+        String s(pos_, pos_ + size);
+        pos_ += size;
+        return s;
+      }
+
+      vector<String> getStringList()
+      {
+        vector<String> strings(getCount<UInt64>(sizeof(UInt32)));
+        for (String& s : strings) s = getString();
+        return strings;
+      }
+
+      DataValue getDataValue()
+      {
+        DataValue value;
+        switch (get<Byte>())
+        {
+          case DataValue::STRING_VALUE:
+            value = DataValue(getString());
+            break;
+          case DataValue::INT_VALUE:
+            value = DataValue(static_cast<SignedSize>(get<Int64>()));
+            break;
+          case DataValue::DOUBLE_VALUE:
+            value = DataValue(get<double>());
+            break;
+          case DataValue::STRING_LIST:
+            value = DataValue(getStringList());
+            break;
+          case DataValue::INT_LIST:
+          {
+            IntList list(getCount<UInt64>(sizeof(Int32)));
+            for (Int& i : list) i = get<Int32>();
+            value = DataValue(list);
+            break;
+          }
+          case DataValue::DOUBLE_LIST:
+          {
+            DoubleList list(getCount<UInt64>(sizeof(double)));
+            for (double& d : list) d = get<double>();
+            value = DataValue(list);
+            break;
+          }
+          case DataValue::EMPTY_VALUE:
+            break;
+          default:
+            throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Invalid meta value type in idBin file: " + filename_);
+        }
+        value.setUnitType(static_cast<DataValue::UnitType>(get<Byte>()));
+        value.setUnit(get<Int32>());
+        return value;
+      }
+
+      /// reads meta values into @p meta, @p keys maps the stored key indices to MetaInfoRegistry keys
+      void getMetaValues(MetaInfoInterface& meta, const vector<UInt>& keys)
+      {
+        UInt32 size = get<UInt32>();
+        for (UInt32 i = 0; i < size; ++i)
+        {
+          UInt32 index = get<UInt32>();
+          if (index >= keys.size())
+          {
+            throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Invalid meta value key in idBin file: " + filename_);
+          }
+          meta.setMetaValue(keys[index], getDataValue());
+        }
+      }
+
+protected:
+      void check_(Size size) const
+      {
+        if (Size(end_ - pos_) < size)
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Truncated or corrupt idBin file: " + filename_);
+        }
+      }
+
+      const char* pos_;
+      const char* end_;
+      const String& filename_;
+    };
+
+    void writeDescription(ByteWriter& writer, const MetaInfoDescription& description, map<UInt, UInt>& key_indices)
+    {
+      writer.putString(description.getName());
+      writer.putMetaValues(description, key_indices);
+    }
+
+    void readDescription(ByteReader& reader, MetaInfoDescription& description, const vector<UInt>& keys)
+    {
+      description.setName(reader.getString());
+      reader.getMetaValues(description, keys);
+    }
+
+    void writeProteinGroups(ByteWriter& writer, const vector<ProteinIdentification::ProteinGroup>& groups, map<UInt, UInt>& key_indices)
+    {
+      writer.put<UInt64>(groups.size());
+      for (const ProteinIdentification::ProteinGroup& group : groups)
+      {
+        writer.put<double>(group.probability);
+        writer.putStringList(group.accessions);
+
+        writer.put<UInt64>(group.getFloatDataArrays().size());
+        for (const ProteinIdentification::ProteinGroup::FloatDataArray& array : group.getFloatDataArrays())
+        {
+          writeDescription(writer, array, key_indices);
+          writer.put<UInt64>(array.size());
+          for (float f : array) writer.put<float>(f);
+        }
+        writer.put<UInt64>(group.getStringDataArrays().size());
+        for (const ProteinIdentification::ProteinGroup::StringDataArray& array : group.getStringDataArrays())
+        {
+          writeDescription(writer, array, key_indices);
+          writer.putStringList(array);
+        }
+        writer.put<UInt64>(group.getIntegerDataArrays().size());
+        for (const ProteinIdentification::ProteinGroup::IntegerDataArray& array : group.getIntegerDataArrays())
+        {
+          writeDescription(writer, array, key_indices);
+          writer.put<UInt64>(array.size());
+          for (Int i : array) writer.put<Int32>(i);
+        }
+      }
+    }
+
+    void readProteinGroups(ByteReader& reader, vector<ProteinIdentification::ProteinGroup>& groups, const vector<UInt>& keys)
+    {
+      groups.resize(reader.getCount<UInt64>(sizeof(double)));
+      for (ProteinIdentification::ProteinGroup& group : groups)
+      {
+        group.probability = reader.get<double>();
+        group.accessions = reader.getStringList();
+
+        ProteinIdentification::ProteinGroup::FloatDataArrays float_arrays(reader.getCount<UInt64>(sizeof(UInt32)));
+        for (ProteinIdentification::ProteinGroup::FloatDataArray& array : float_arrays)
+        {
+          readDescription(reader, array, keys);
+          array.resize(reader.getCount<UInt64>(sizeof(float)));
+          for (float& f : array) f = reader.get<float>();
+        }
+        group.setFloatDataArrays(float_arrays);
+
+        ProteinIdentification::ProteinGroup::StringDataArrays string_arrays(reader.getCount<UInt64>(sizeof(UInt32)));
+        for (ProteinIdentification::ProteinGroup::StringDataArray& array : string_arrays)
+        {
+          readDescription(reader, array, keys);
+          vector<String> strings = reader.getStringList();
+          array.assign(strings.begin(), strings.end());
+        }
+        group.setStringDataArrays(string_arrays);
+
+        ProteinIdentification::ProteinGroup::IntegerDataArrays integer_arrays(reader.getCount<UInt64>(sizeof(UInt32)));
+        for (ProteinIdentification::ProteinGroup::IntegerDataArray& array : integer_arrays)
+        {
+          readDescription(reader, array, keys);
+          array.resize(reader.getCount<UInt64>(sizeof(Int32)));
+          for (Int& i : array) i = reader.get<Int32>();
+        }
+        group.setIntegerDataArrays(integer_arrays);
+      }
+    }
+
+    void writeProteinIdentifications(ByteWriter& writer, const vector<ProteinIdentification>& protein_ids, map<UInt, UInt>& key_indices)
+    {
+      writer.put<UInt64>(protein_ids.size());
+      for (const ProteinIdentification& protein_id : protein_ids)
+      {
+        writer.putString(protein_id.getIdentifier());
+        writer.putString(protein_id.getSearchEngine());
+        writer.putString(protein_id.getSearchEngineVersion());
+        writer.putString(protein_id.getDateTime().get());
+        writer.putString(protein_id.getScoreType());
+        writer.put<Byte>(protein_id.isHigherScoreBetter());
+        writer.put<double>(protein_id.getSignificanceThreshold());
+        writer.putMetaValues(protein_id, key_indices);
+
+        const ProteinIdentification::SearchParameters& params = protein_id.getSearchParameters();
+        writer.putString(params.db);
+        writer.putString(params.db_version);
+        writer.putString(params.taxonomy);
+        writer.putString(params.charges);
+        writer.put<Byte>(params.mass_type);
+        writer.putStringList(params.fixed_modifications);
+        writer.putStringList(params.variable_modifications);
+        writer.put<UInt32>(params.missed_cleavages);
+        writer.put<double>(params.fragment_mass_tolerance);
+        writer.put<Byte>(params.fragment_mass_tolerance_ppm);
+        writer.put<double>(params.precursor_mass_tolerance);
+        writer.put<Byte>(params.precursor_mass_tolerance_ppm);
+        writer.putString(params.digestion_enzyme.getName());
+        writer.putMetaValues(params, key_indices);
+
+        writer.put<UInt64>(protein_id.getHits().size());
+        for (const ProteinHit& hit : protein_id.getHits())
+        {
+          writer.put<float>(hit.getScore());
+          writer.put<UInt32>(hit.getRank());
+          writer.putString(hit.getAccession());
+          writer.putString(hit.getSequence());
+          writer.put<double>(hit.getCoverage());
+          writer.putMetaValues(hit, key_indices);
+          writer.put<UInt64>(hit.getModifications().size());
+          for (const pair<Size, ResidueModification>& mod : hit.getModifications())
+          {
+            writer.put<UInt64>(mod.first);
+            writer.putString(mod.second.getFullId());
+          }
+        }
+
+        writeProteinGroups(writer, protein_id.getProteinGroups(), key_indices);
+        writeProteinGroups(writer, protein_id.getIndistinguishableProteins(), key_indices);
+      }
+    }
+
+    void readProteinIdentifications(ByteReader& reader, vector<ProteinIdentification>& protein_ids, const vector<UInt>& keys)
+    {
+      protein_ids.resize(reader.getCount<UInt64>(sizeof(UInt32)));
+      for (ProteinIdentification& protein_id : protein_ids)
+      {
+        protein_id.setIdentifier(reader.getString());
+        protein_id.setSearchEngine(reader.getString());
+        protein_id.setSearchEngineVersion(reader.getString());
+        String date = reader.getString();
+        if (date != DateTime().get()) // not set
+        {
+          DateTime date_time;
+          date_time.set(date);
+          protein_id.setDateTime(date_time);
+        }
+        protein_id.setScoreType(reader.getString());
+        protein_id.setHigherScoreBetter(reader.get<Byte>());
+        protein_id.setSignificanceThreshold(reader.get<double>());
+        reader.getMetaValues(protein_id, keys);
+
+        ProteinIdentification::SearchParameters& params = protein_id.getSearchParameters();
+        params.db = reader.getString();
+        params.db_version = reader.getString();
+        params.taxonomy = reader.getString();
+        params.charges = reader.getString();
+        params.mass_type = static_cast<ProteinIdentification::PeakMassType>(reader.get<Byte>());
+        params.fixed_modifications = reader.getStringList();
+        params.variable_modifications = reader.getStringList();
+        params.missed_cleavages = reader.get<UInt32>();
+        params.fragment_mass_tolerance = reader.get<double>();
+        params.fragment_mass_tolerance_ppm = reader.get<Byte>();
+        params.precursor_mass_tolerance = reader.get<double>();
+        params.precursor_mass_tolerance_ppm = reader.get<Byte>();
+        String enzyme = reader.getString();
+        if (ProteaseDB::getInstance()->hasEnzyme(enzyme))
+        {
+          params.digestion_enzyme = *(ProteaseDB::getInstance()->getEnzyme(enzyme));
+        }
+        reader.getMetaValues(params, keys);
+
+        vector<ProteinHit>& hits = protein_id.getHits();
+        hits.resize(reader.getCount<UInt64>(sizeof(float)));
+        for (ProteinHit& hit : hits)
+        {
+          hit.setScore(reader.get<float>());
+          hit.setRank(reader.get<UInt32>());
+          hit.setAccession(reader.getString());
+          hit.setSequence(reader.getString());
+          hit.setCoverage(reader.get<double>());
+          reader.getMetaValues(hit, keys);
+          UInt64 nr_mods = reader.get<UInt64>();
+          if (nr_mods > 0)
+          {
+            set<pair<Size, ResidueModification> > mods;
+            for (UInt64 i = 0; i < nr_mods; ++i)
+            {
+              Size position = reader.get<UInt64>();
+              const ResidueModification* mod = ModificationsDB::getInstance()->getModification(reader.getString());
+              mods.insert(make_pair(position, *mod));
+            }
+            hit.setModifications(mods);
+          }
+        }
+
+        readProteinGroups(reader, protein_id.getProteinGroups(), keys);
+        readProteinGroups(reader, protein_id.getIndistinguishableProteins(), keys);
+      }
+    }
+  }
+
+  const Size IdBinaryFile::DEFAULT_BLOCK_SIZE;
+
+  IdBinaryFile::IdBinaryFile() :
+    ProgressLogger(),
+    sections_(ALL_SECTIONS)
+  {
+  }
+
+  void IdBinaryFile::setSections(UInt sections)
+  {
+    sections_ = sections;
+  }
+
+  UInt IdBinaryFile::getSections() const
+  {
+    return sections_;
+  }
+
+  bool IdBinaryFile::isIdBinaryFile(const String& filename)
+  {
+    ifstream ifs(filename.c_str(), ios::in | ios::binary);
+    char magic[sizeof(IDBIN_MAGIC)];
+    return ifs.read(magic, sizeof(magic)) && (memcmp(magic, IDBIN_MAGIC, sizeof(magic)) == 0);
+  }
+
+  void IdBinaryFile::load(const String& filename, vector<ProteinIdentification>& protein_ids, vector<PeptideIdentification>& peptide_ids)
+  {
+    Reader reader(filename, sections_);
+    protein_ids = reader.getProteinIdentifications();
+    peptide_ids.clear();
+    peptide_ids.reserve(reader.getNrPeptideIdentifications());
+
+    startProgress(0, reader.getNrPeptideIdentifications(), "loading idBin file");
+    vector<PeptideIdentification> block;
+    while (reader.readBlock(block))
+    {
+      peptide_ids.insert(peptide_ids.end(), make_move_iterator(block.begin()), make_move_iterator(block.end()));
+      setProgress(peptide_ids.size());
+    }
+    endProgress();
+  }
+
+  void IdBinaryFile::store(const String& filename, const vector<ProteinIdentification>& protein_ids, const vector<PeptideIdentification>& peptide_ids)
+  {
+    Writer writer(filename, protein_ids);
+    startProgress(0, peptide_ids.size(), "storing idBin file");
+    for (Size i = 0; i < peptide_ids.size(); ++i)
+    {
+      writer.add(peptide_ids[i]);
+      setProgress(i);
+    }
+    writer.close();
+    endProgress();
+  }
+
+  IdBinaryFile::Reader::Reader(const String& filename, UInt sections) :
+    filename_(filename),
+    sections_(sections),
+    nr_peptide_ids_(0),
+    nr_blocks_(0),
+    blocks_read_(0),
+    blocks_end_(0)
+  {
+    if (!File::exists(filename))
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+    ifs_.open(filename.c_str(), ios::in | ios::binary);
+    if (!ifs_)
+    {
+      throw Exception::FileNotReadable(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+
+    IdBinHeader header;
+    if (!ifs_.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        memcmp(header.magic, IDBIN_MAGIC, sizeof(header.magic)) != 0)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Not an idBin file: " + filename);
+    }
+    // also rejects files written with a different byte order
+    if (header.version != IDBIN_VERSION)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Unsupported version or byte order of idBin file: " + filename);
+    }
+    nr_peptide_ids_ = header.nr_peptide_ids;
+    nr_blocks_ = header.nr_blocks;
+    blocks_end_ = header.keys_offset;
+
+    // meta value names (at the end of the file)
+    ifs_.seekg(0, ios::end);
+    UInt64 file_size = ifs_.tellg();
+    if (header.keys_offset < sizeof(header) || header.keys_offset > file_size)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Truncated or corrupt idBin file: " + filename);
+    }
+    // every peptide identification takes at least its position (RT, m/z) in a block
+    if (header.nr_peptide_ids > header.keys_offset / (2 * sizeof(double)))
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Truncated or corrupt idBin file: " + filename);
+    }
+    buffer_.resize(file_size - header.keys_offset);
+    ifs_.seekg(header.keys_offset);
+    ifs_.read(buffer_.data(), buffer_.size());
+    ByteReader keys_reader(buffer_.data(), buffer_.data() + buffer_.size(), filename_);
+    vector<String> names = keys_reader.getStringList();
+    keys_.reserve(names.size());
+    for (const String& name : names)
+    {
+      keys_.push_back(MetaInfoInterface::metaRegistry().registerName(name));
+    }
+
+    // protein identifications
+    ifs_.seekg(sizeof(header));
+    UInt64 size(0);
+    ifs_.read(reinterpret_cast<char*>(&size), sizeof(size));
+    if (!ifs_ || size > file_size)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Truncated or corrupt idBin file: " + filename);
+    }
+    buffer_.resize(size);
+    ifs_.read(buffer_.data(), size);
+    ByteReader reader(buffer_.data(), buffer_.data() + buffer_.size(), filename_);
+    readProteinIdentifications(reader, protein_ids_, keys_);
+  }
+
+  const vector<ProteinIdentification>& IdBinaryFile::Reader::getProteinIdentifications() const
+  {
+    return protein_ids_;
+  }
+
+  Size IdBinaryFile::Reader::getNrPeptideIdentifications() const
+  {
+    return nr_peptide_ids_;
+  }
+
+  bool IdBinaryFile::Reader::readBlock(vector<PeptideIdentification>& peptide_ids)
+  {
+    peptide_ids.clear();
+    if (blocks_read_ == nr_blocks_) return false;
+
+    IdBinBlockHeader header;
+    if (!ifs_.read(reinterpret_cast<char*>(&header), sizeof(header)))
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Truncated or corrupt idBin file: " + filename_);
+    }
+    ++blocks_read_;
+
+    // the parsed sequences are copied into the hits, so the pool can be emptied between blocks
+    if (sequences_.size() > MAX_POOLED_SEQUENCES) sequences_.clear();
+
+    // sections must fit into the file, and every identification has a position
+    UInt64 position = ifs_.tellg();
+    UInt64 remaining = position <= blocks_end_ ? blocks_end_ - position : 0;
+    for (Size section = 0; section < NR_STORED_SECTIONS; ++section)
+    {
+      if (header.section_sizes[section] > remaining)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Truncated or corrupt idBin file: " + filename_);
+      }
+      remaining -= header.section_sizes[section];
+    }
+    if (header.nr_ids > header.section_sizes[STORED_POSITIONS] / (2 * sizeof(double)))
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Truncated or corrupt idBin file: " + filename_);
+    }
+
+    bool read_hits = sections_ & HITS;
+    bool read_section[NR_STORED_SECTIONS];
+    read_section[STORED_POSITIONS] = true;
+    read_section[STORED_IDENTIFICATIONS] = sections_ & IDENTIFICATIONS;
+    read_section[STORED_HITS] = read_hits;
+    read_section[STORED_EVIDENCES] = read_hits && (sections_ & EVIDENCES);
+    read_section[STORED_IDENTIFICATION_META] = sections_ & META_VALUES;
+    read_section[STORED_HIT_META] = read_hits && (sections_ & META_VALUES);
+
+    peptide_ids.resize(header.nr_ids);
+    for (Size section = 0; section < NR_STORED_SECTIONS; ++section)
+    {
+      if (!read_section[section])
+      {
+        ifs_.seekg(header.section_sizes[section], ios::cur);
+        continue;
+      }
+
+      buffer_.resize(header.section_sizes[section]);
+      if (!ifs_.read(buffer_.data(), buffer_.size()))
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Truncated or corrupt idBin file: " + filename_);
+      }
+      ByteReader reader(buffer_.data(), buffer_.data() + buffer_.size(), filename_);
+
+      switch (section)
+      {
+        case STORED_POSITIONS:
+          for (PeptideIdentification& id : peptide_ids)
+          {
+            id.setRT(reader.get<double>());
+            id.setMZ(reader.get<double>());
+          }
+          break;
+
+        case STORED_IDENTIFICATIONS:
+          for (PeptideIdentification& id : peptide_ids)
+          {
+            id.setIdentifier(reader.getString());
+            id.setScoreType(reader.getString());
+            id.setHigherScoreBetter(reader.get<Byte>());
+            id.setSignificanceThreshold(reader.get<double>());
+            id.setBaseName(reader.getString());
+          }
+          break;
+
+        case STORED_HITS:
+          for (PeptideIdentification& id : peptide_ids)
+          {
+            vector<PeptideHit>& hits = id.getHits();
+            hits.resize(reader.getCount<UInt32>(sizeof(double)));
+            for (PeptideHit& hit : hits)
+            {
+              hit.setScore(reader.get<double>());
+              hit.setRank(reader.get<UInt32>());
+              hit.setCharge(reader.get<Int32>());
+              hit.setSequence(sequences_.fromString(reader.getString()).getSequence());
+            }
+          }
+          break;
+
+        case STORED_EVIDENCES:
+          for (PeptideIdentification& id : peptide_ids)
+          {
+            for (PeptideHit& hit : id.getHits())
+            {
+              vector<PeptideEvidence> evidences(reader.getCount<UInt32>(sizeof(UInt32)));
+              for (PeptideEvidence& evidence : evidences)
+              {
+                evidence.setProteinAccession(reader.getString());
+                evidence.setStart(reader.get<Int32>());
+                evidence.setEnd(reader.get<Int32>());
+                evidence.setAABefore(reader.get<char>());
+                evidence.setAAAfter(reader.get<char>());
+              }
+              hit.setPeptideEvidences(evidences);
+            }
+          }
+          break;
+
+        case STORED_IDENTIFICATION_META:
+          for (PeptideIdentification& id : peptide_ids)
+          {
+            reader.getMetaValues(id, keys_);
+          }
+          break;
+
+        case STORED_HIT_META:
+          for (PeptideIdentification& id : peptide_ids)
+          {
+            for (PeptideHit& hit : id.getHits())
+            {
+              reader.getMetaValues(hit, keys_);
+
+              UInt32 nr_annotations = reader.getCount<UInt32>(sizeof(UInt32));
+              if (nr_annotations > 0)
+              {
+                vector<PeptideHit::PeakAnnotation> annotations(nr_annotations);
+                for (PeptideHit::PeakAnnotation& annotation : annotations)
+                {
+                  annotation.annotation = reader.getString();
+                  annotation.charge = reader.get<Int32>();
+                  annotation.mz = reader.get<double>();
+                  annotation.intensity = reader.get<double>();
+                }
+                hit.setPeakAnnotations(annotations);
+              }
+
+              UInt32 nr_results = reader.getCount<UInt32>(sizeof(UInt32));
+              if (nr_results > 0)
+              {
+                vector<PeptideHit::PepXMLAnalysisResult> results(nr_results);
+                for (PeptideHit::PepXMLAnalysisResult& result : results)
+                {
+                  result.score_type = reader.getString();
+                  result.higher_is_better = reader.get<Byte>();
+                  result.main_score = reader.get<double>();
+                  UInt32 nr_sub_scores = reader.get<UInt32>();
+                  for (UInt32 i = 0; i < nr_sub_scores; ++i)
+                  {
+                    String name = reader.getString();
+                    result.sub_scores[name] = reader.get<double>();
+                  }
+                }
+                hit.setAnalysisResults(results);
+              }
+            }
+          }
+          break;
+      }
+    }
+    return true;
+  }
+
+  IdBinaryFile::Writer::Writer(const String& filename, const vector<ProteinIdentification>& protein_ids, Size block_size) :
+    filename_(filename),
+    block_size_(std::max(block_size, Size(1))),
+    nr_peptide_ids_(0),
+    nr_blocks_(0),
+    block_ids_(0),
+    block_hits_(0),
+    sections_(NR_STORED_SECTIONS)
+  {
+    ofs_.open(filename.c_str(), ios::out | ios::binary);
+    if (!ofs_)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+
+    // placeholder, written by close()
+    IdBinHeader header;
+    memset(&header, 0, sizeof(header));
+    ofs_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    vector<char> data;
+    ByteWriter writer(data);
+    writeProteinIdentifications(writer, protein_ids, key_indices_);
+    UInt64 size = data.size();
+    ofs_.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    ofs_.write(data.data(), data.size());
+  }
+
+  IdBinaryFile::Writer::~Writer()
+  {
+    try
+    {
+      close();
+    }
+    catch (Exception::BaseException& e)
+    {
+      OPENMS_LOG_ERROR << "Error while writing idBin file: " << e.what() << endl;
+    }
+  }
+
+  void IdBinaryFile::Writer::add(const PeptideIdentification& id)
+  {
+    ByteWriter positions(sections_[STORED_POSITIONS]);
+    positions.put<double>(id.getRT());
+    positions.put<double>(id.getMZ());
+
+    ByteWriter identifications(sections_[STORED_IDENTIFICATIONS]);
+    identifications.putString(id.getIdentifier());
+    identifications.putString(id.getScoreType());
+    identifications.put<Byte>(id.isHigherScoreBetter());
+    identifications.put<double>(id.getSignificanceThreshold());
+    identifications.putString(id.getBaseName());
+
+    ByteWriter(sections_[STORED_IDENTIFICATION_META]).putMetaValues(id, key_indices_);
+
+    ByteWriter hits(sections_[STORED_HITS]);
+    ByteWriter evidences(sections_[STORED_EVIDENCES]);
+    ByteWriter hit_meta(sections_[STORED_HIT_META]);
+    hits.put<UInt32>(id.getHits().size());
+    for (const PeptideHit& hit : id.getHits())
+    {
+      hits.put<double>(hit.getScore());
+      hits.put<UInt32>(hit.getRank());
+      hits.put<Int32>(hit.getCharge());
+      hits.putString(hit.getSequence().toString());
+
+      evidences.put<UInt32>(hit.getPeptideEvidences().size());
+      for (const PeptideEvidence& evidence : hit.getPeptideEvidences())
+      {
+        evidences.putString(evidence.getProteinAccession());
+        evidences.put<Int32>(evidence.getStart());
+        evidences.put<Int32>(evidence.getEnd());
+        evidences.put<char>(evidence.getAABefore());
+        evidences.put<char>(evidence.getAAAfter());
+      }
+
+      hit_meta.putMetaValues(hit, key_indices_);
+
+      const vector<PeptideHit::PeakAnnotation> annotations = hit.getPeakAnnotations();
+      hit_meta.put<UInt32>(annotations.size());
+      for (const PeptideHit::PeakAnnotation& annotation : annotations)
+      {
+        hit_meta.putString(annotation.annotation);
+        hit_meta.put<Int32>(annotation.charge);
+        hit_meta.put<double>(annotation.mz);
+        hit_meta.put<double>(annotation.intensity);
+      }
+
+      const vector<PeptideHit::PepXMLAnalysisResult>& results = hit.getAnalysisResults();
+      hit_meta.put<UInt32>(results.size());
+      for (const PeptideHit::PepXMLAnalysisResult& result : results)
+      {
+        hit_meta.putString(result.score_type);
+        hit_meta.put<Byte>(result.higher_is_better);
+        hit_meta.put<double>(result.main_score);
+        hit_meta.put<UInt32>(result.sub_scores.size());
+        for (const pair<const String, double>& sub_score : result.sub_scores)
+        {
+          hit_meta.putString(sub_score.first);
+          hit_meta.put<double>(sub_score.second);
+        }
+      }
+    }
+
+    ++nr_peptide_ids_;
+    ++block_ids_;
+    block_hits_ += id.getHits().size();
+    if (block_ids_ == block_size_) writeBlock_();
+  }
+
+  void IdBinaryFile::Writer::writeBlock_()
+  {
+    IdBinBlockHeader header;
+    header.nr_ids = block_ids_;
+    header.nr_hits = block_hits_;
+    for (Size section = 0; section < NR_STORED_SECTIONS; ++section)
+    {
+      header.section_sizes[section] = sections_[section].size();
+    }
+    ofs_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (vector<char>& section : sections_)
+    {
+      ofs_.write(section.data(), section.size());
+      section.clear();
+    }
+    ++nr_blocks_;
+    block_ids_ = 0;
+    block_hits_ = 0;
+  }
+
+  void IdBinaryFile::Writer::close()
+  {
+    if (!ofs_.is_open()) return;
+
+    if (block_ids_ > 0) writeBlock_();
+
+    IdBinHeader header;
+    memcpy(header.magic, IDBIN_MAGIC, sizeof(header.magic));
+    header.version = IDBIN_VERSION;
+    header.nr_peptide_ids = nr_peptide_ids_;
+    header.nr_blocks = nr_blocks_;
+    header.keys_offset = ofs_.tellp();
+
+    // meta value names, by key index
+    vector<String> names(key_indices_.size());
+    for (const pair<const UInt, UInt>& key : key_indices_)
+    {
+      names[key.second] = MetaInfoInterface::metaRegistry().getName(key.first);
+    }
+    vector<char> data;
+    ByteWriter(data).putStringList(names);
+    ofs_.write(data.data(), data.size());
+
+    ofs_.seekp(0);
+    ofs_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    ofs_.close();
+    if (!ofs_)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename_);
+    }
+  }
+
+} // namespace OpenMS
@@ -35,12 +35,24 @@
 #include <OpenMS/FORMAT/MzMLFile.h>
 
 #include <OpenMS/FORMAT/HANDLERS/MzMLHandler.h>
+#include <OpenMS/FORMAT/HANDLERS/IndexedMzMLDecoder.h>
 #include <OpenMS/FORMAT/CVMappingFile.h>
 #include <OpenMS/FORMAT/VALIDATORS/XMLValidator.h>
 #include <OpenMS/FORMAT/VALIDATORS/MzMLValidator.h>
 #include <OpenMS/FORMAT/TextFile.h>
 #include <OpenMS/SYSTEM/File.h>
 
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
 
@@ -173,11 +185,213 @@ namespace OpenMS
     map.setLoadedFileType(filename);
     map.setLoadedFilePath(filename);
 
+    // indexed mzML can be split into independent blocks of spectra
+    if (loadParallel_(filename, map))
+    {
+      return;
+    }
+
     Internal::MzMLHandler handler(map, filename, getVersion(), *this);
     handler.setOptions(options_);
     safeParse_(filename, &handler);
   }
 
+  bool MzMLFile::loadParallel_(const String& filename, PeakMap& map)
+  {
+    int nr_threads = 1;
+#ifdef _OPENMP
+    nr_threads = omp_get_max_threads();
+#endif
+    if (nr_threads < 2 || options_.getParallelChunkSize() == 0 || options_.getMetadataOnly() || !File::exists(filename))
+    {
+      return false;
+    }
+
+    // compressed files (gzip, bzip2) cannot be split at byte offsets
+    {
+      std::ifstream ifs(filename.c_str(), std::ios::in | std::ios::binary);
+      unsigned char magic[3] = {0, 0, 0};
+      ifs.read(reinterpret_cast<char*>(magic), sizeof(magic));
+      if ((magic[0] == 0x1f && magic[1] == 0x8b) || (magic[0] == 'B' && magic[1] == 'Z' && magic[2] == 'h'))
+      {
+        return false;
+      }
+    }
+
+    // read the index, any problem here means we use the sequential parser
+    IndexedMzMLDecoder::OffsetVector spectra_offsets, chromatograms_offsets;
+    try
+    {
+      IndexedMzMLDecoder decoder;
+      std::streampos index_offset = decoder.findIndexListOffset(filename);
+      if (index_offset == (std::streampos)-1 ||
+          decoder.parseOffsets(filename, index_offset, spectra_offsets, chromatograms_offsets) != 0)
+      {
+        return false;
+      }
+    }
+    catch (Exception::BaseException& /* e */)
+    {
+      return false;
+    }
+    if (spectra_offsets.size() < 2)
+    {
+      return false;
+    }
+
+    boost::iostreams::mapped_file_source file;
+    try
+    {
+      file.open(filename);
+    }
+    catch (std::exception& /* e */)
+    {
+      return false;
+    }
+    if (!file.is_open())
+    {
+      return false;
+    }
+    const char* data = file.data();
+    const Size file_size = file.size();
+
+    // the offsets have to point to consecutive <spectrum> tags, otherwise the
+    // index is outdated and cannot be trusted
+    std::vector<Size> offsets;
+    offsets.reserve(spectra_offsets.size());
+    for (const auto& entry : spectra_offsets)
+    {
+      if (entry.second < 0) return false;
+      Size offset = static_cast<Size>(entry.second);
+      if (offset + 10 > file_size || (!offsets.empty() && offset <= offsets.back()) ||
+          std::strncmp(data + offset, "<spectrum", 9) != 0 || !std::isspace(static_cast<unsigned char>(data[offset + 9])))
+      {
+        return false;
+      }
+      offsets.push_back(offset);
+    }
+
+    // all spectra are located between the first offset and </spectrumList>
+    const std::string list_end_tag = "</spectrumList>";
+    const char* list_end = std::search(data + offsets.back(), data + file_size, list_end_tag.begin(), list_end_tag.end());
+    const std::string prefix(data, offsets.front());
+    if (list_end == data + file_size || prefix.rfind("<spectrumList") == std::string::npos)
+    {
+      return false;
+    }
+    const Size spectra_end = list_end - data;
+
+    // Each block is parsed with the original header, whose <spectrumList
+    // count="..."> is used to reserve space for the spectra. Split the header
+    // around the count value so that each block announces its own size.
+    const Size list_start = prefix.rfind("<spectrumList");
+    const Size list_tag_end = prefix.find('>', list_start);
+    std::string prefix_head = prefix, prefix_tail;
+    const std::string count_attribute = "count=";
+    Size count_pos = prefix.find(count_attribute, list_start);
+    if (count_pos != std::string::npos && count_pos < list_tag_end && std::isspace(static_cast<unsigned char>(prefix[count_pos - 1])))
+    {
+      const char quote = prefix[count_pos + count_attribute.size()];
+      const Size value_start = count_pos + count_attribute.size() + 1;
+      const Size value_end = prefix.find(quote, value_start);
+      if ((quote == '"' || quote == '\'') && value_end < list_tag_end)
+      {
+        prefix_head = prefix.substr(0, value_start);
+        prefix_tail = prefix.substr(value_end);
+      }
+    }
+    const Size spectra_bytes = spectra_end - offsets.front();
+
+    Size nr_chunks = std::min(std::min((Size)nr_threads, spectra_bytes / options_.getParallelChunkSize()), offsets.size());
+    if (nr_chunks < 2)
+    {
+      return false;
+    }
+
+    // split into blocks of roughly equal size, each starting at a <spectrum> tag
+    std::vector<Size> chunk_starts;
+    for (Size c = 0; c < nr_chunks; ++c)
+    {
+      Size target = offsets.front() + spectra_bytes / nr_chunks * c;
+      Size start = *std::lower_bound(offsets.begin(), offsets.end(), target);
+      if (chunk_starts.empty() || start > chunk_starts.back()) chunk_starts.push_back(start);
+    }
+    chunk_starts.push_back(spectra_end);
+    nr_chunks = chunk_starts.size() - 1;
+
+    // close all tags that are open at the first <spectrum>
+    String suffix = "\n</spectrumList>\n</run>\n</mzML>\n";
+    if (prefix.find("<indexedmzML") != std::string::npos)
+    {
+      suffix += "</indexedmzML>\n";
+    }
+
+    // Parse everything except for the spectra (meta data, chromatograms)
+    // first. This also initializes the XML parser before it is used from
+    // several threads.
+    {
+      std::string skeleton;
+      skeleton.reserve(prefix.size() + file_size - spectra_end);
+      skeleton.append(prefix).append(data + spectra_end, file_size - spectra_end);
+      Internal::MzMLHandler handler(map, filename, getVersion(), *this);
+      handler.setOptions(options_);
+      parseBuffer_(skeleton, &handler);
+    }
+
+    // Parse blocks of spectra in parallel. Each block is wrapped into the
+    // original header so that references to instruments, data processing
+    // and referenceable parameter groups are resolved as usual.
+    std::vector<PeakMap> parts(nr_chunks);
+    String error;
+#pragma omp parallel for schedule(dynamic, 1)
+    for (SignedSize c = 0; c < (SignedSize)nr_chunks; ++c)
+    {
+      try
+      {
+        std::string buffer;
+        buffer.reserve(prefix.size() + chunk_starts[c + 1] - chunk_starts[c] + suffix.size());
+        buffer.append(prefix_head);
+        if (!prefix_tail.empty())
+        {
+          Size nr_chunk_spectra = std::lower_bound(offsets.begin(), offsets.end(), chunk_starts[c + 1]) -
+                                  std::lower_bound(offsets.begin(), offsets.end(), chunk_starts[c]);
+          buffer.append(String(nr_chunk_spectra)).append(prefix_tail);
+        }
+        buffer.append(data + chunk_starts[c], chunk_starts[c + 1] - chunk_starts[c]).append(suffix);
+
+        ProgressLogger no_log;
+        Internal::MzMLHandler handler(parts[c], filename, getVersion(), no_log);
+        handler.setOptions(options_);
+        parseBuffer_(buffer, &handler);
+      }
+      catch (std::exception& e)
+      {
+#pragma omp critical (MzMLFile_loadParallel)
+        {
+          if (error.empty()) error = e.what();
+        }
+      }
+    }
+    if (!error.empty())
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, error);
+    }
+
+    // reassemble the spectra in file order
+    Size nr_spectra = 0;
+    for (const auto& part : parts) nr_spectra += part.size();
+    map.reserveSpaceSpectra(nr_spectra);
+    for (auto& part : parts)
+    {
+      for (auto& spectrum : part.getSpectra())
+      {
+        map.addSpectrum(std::move(spectrum));
+      }
+      part.clear(true);
+    }
+    return true;
+  }
+
   void MzMLFile::store(const String& filename, const PeakMap& map) const
   {
     Internal::MzMLHandler handler(map, filename, getVersion(), *this);
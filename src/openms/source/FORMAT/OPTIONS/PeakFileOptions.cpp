@@ -63,6 +63,7 @@ namespace OpenMS
     np_config_int_(),
     np_config_fda_(),
     maximal_data_pool_size_(100),
+    parallel_chunk_size_(64 * 1024 * 1024),
     precursor_mz_selected_ion_(true)
   {
   }
@@ -92,6 +93,7 @@ namespace OpenMS
     np_config_int_(options.np_config_int_),
     np_config_fda_(options.np_config_fda_),
     maximal_data_pool_size_(options.maximal_data_pool_size_),
+    parallel_chunk_size_(options.parallel_chunk_size_),
     precursor_mz_selected_ion_(options.precursor_mz_selected_ion_)
   {
   }
@@ -352,6 +354,16 @@ namespace OpenMS
     maximal_data_pool_size_ = size;
   }
 
+  Size PeakFileOptions::getParallelChunkSize() const
+  {
+    return parallel_chunk_size_;
+  }
+
+  void PeakFileOptions::setParallelChunkSize(Size size)
+  {
+    parallel_chunk_size_ = size;
+  }
+
   bool PeakFileOptions::getPrecursorMZSelectedIon() const
   {
     return precursor_mz_selected_ion_;
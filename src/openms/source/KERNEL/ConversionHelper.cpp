@@ -37,7 +37,7 @@
 namespace OpenMS
 {
   void MapConversion::convert(UInt64 const input_map_index,
-                              PeakMap& input_map,
+                              const PeakMap& input_map,
                               ConsensusMap& output_map,
                               Size n)
   {
@@ -46,17 +46,15 @@ namespace OpenMS
     // see @todo above
     output_map.setUniqueId();
 
-    input_map.updateRanges(1);
-    if (n > input_map.getSize())
+    // only the RT/m/z/intensity of MS1 peaks are needed here, which is much
+    // less than a copy of the whole experiment
+    std::vector<Peak2D> tmp;
+    input_map.get2DData(tmp);
+    if (n > tmp.size())
     {
-      n = input_map.getSize();
+      n = tmp.size();
     }
     output_map.reserve(n);
-    std::vector<Peak2D> tmp;
-    tmp.reserve(input_map.getSize());
-
-    // TODO Avoid tripling the memory consumption by this call
-    input_map.get2DData(tmp);
 
     std::partial_sort(tmp.begin(),
                       tmp.begin() + n,
@@ -189,6 +189,11 @@ namespace OpenMS
     return MetaInfo::registry();
   }
 
+  MetaValueKey::MetaValueKey(const String& name, const String& description, const String& unit) :
+    index_(MetaInfoInterface::metaRegistry().registerName(name, description, unit))
+  {
+  }
+
   void MetaInfoInterface::createIfNotExists_()
   {
     if (meta_ == nullptr)
@@ -42,85 +42,43 @@ namespace OpenMS
 {
 
   MetaInfoRegistry::MetaInfoRegistry() :
-    next_index_(1024), 
-    name_to_index_(), 
-    index_to_name_(), 
-    index_to_description_(), 
-    index_to_unit_()
+    next_index_(1024)
   {
-    name_to_index_["isotopic_range"] = 1;
-    index_to_name_[1] = "isotopic_range";
-    index_to_description_[1] = "consecutive numbering of the peaks in an isotope pattern. 0 is the monoisotopic peak";
-    index_to_unit_[1] = "";
-
-    name_to_index_["cluster_id"] = 2;
-    index_to_name_[2] = "cluster_id";
-    index_to_description_[2] = "consecutive numbering of isotope clusters in a spectrum";
-    index_to_unit_[2] = "";
-
-    name_to_index_["label"] = 3;
-    index_to_name_[3] = "label";
-    index_to_description_[3] = "label e.g. shown in visualization";
-    index_to_unit_[3] = "";
-
-    name_to_index_["icon"] = 4;
-    index_to_name_[4] = "icon";
-    index_to_description_[4] = "icon shown in visualization";
-    index_to_unit_[4] = "";
-
-    name_to_index_["color"] = 5;
-    index_to_name_[5] = "color";
-    index_to_description_[5] = "color used for visualization e.g. #FF00FF for purple";
-    index_to_unit_[5] = "";
-
-    name_to_index_["RT"] = 6;
-    index_to_name_[6] = "RT";
-    index_to_description_[6] = "the retention time of an identification";
-    index_to_unit_[6] = "";
-
-    name_to_index_["MZ"] = 7;
-    index_to_name_[7] = "MZ";
-    index_to_description_[7] = "the MZ of an identification";
-    index_to_unit_[7] = "";
-
-    name_to_index_["predicted_RT"] = 8;
-    index_to_name_[8] = "predicted_RT";
-    index_to_description_[8] = "the predicted retention time of a peptide hit";
-    index_to_unit_[8] = "";
-
-    name_to_index_["predicted_RT_p_value"] = 9;
-    index_to_name_[9] = "predicted_RT_p_value";
-    index_to_description_[9] = "the predicted RT p-value of a peptide hit";
-    index_to_unit_[9] = "";
-
-    name_to_index_["spectrum_reference"] = 10;
-    index_to_name_[10] = "spectrum_reference";
-    index_to_description_[10] = "Reference to a spectrum or feature number";
-    index_to_unit_[10] = "";
-
-    name_to_index_["ID"] = 11;
-    index_to_name_[11] = "ID";
-    index_to_description_[11] = "Some type of identifier";
-    index_to_unit_[11] = "";
-
-    name_to_index_["low_quality"] = 12;
-    index_to_name_[12] = "low_quality";
-    index_to_description_[12] = "Flag which indicates that some entity has a low quality (e.g. a feature pair)";
-    index_to_unit_[12] = "";
+    for (Size i = 0; i < NR_BUCKETS; ++i)
+    {
+      name_buckets_[i].store(nullptr, std::memory_order_relaxed);
+      index_buckets_[i].store(nullptr, std::memory_order_relaxed);
+    }
 
-    name_to_index_["charge"] = 13;
-    index_to_name_[13] = "charge";
-    index_to_description_[13] = "Charge of a feature or peak";
-    index_to_unit_[13] = "";
+    insert_("isotopic_range", 1, "consecutive numbering of the peaks in an isotope pattern. 0 is the monoisotopic peak", "");
+    insert_("cluster_id", 2, "consecutive numbering of isotope clusters in a spectrum", "");
+    insert_("label", 3, "label e.g. shown in visualization", "");
+    insert_("icon", 4, "icon shown in visualization", "");
+    insert_("color", 5, "color used for visualization e.g. #FF00FF for purple", "");
+    insert_("RT", 6, "the retention time of an identification", "");
+    insert_("MZ", 7, "the MZ of an identification", "");
+    insert_("predicted_RT", 8, "the predicted retention time of a peptide hit", "");
+    insert_("predicted_RT_p_value", 9, "the predicted RT p-value of a peptide hit", "");
+    insert_("spectrum_reference", 10, "Reference to a spectrum or feature number", "");
+    insert_("ID", 11, "Some type of identifier", "");
+    insert_("low_quality", 12, "Flag which indicates that some entity has a low quality (e.g. a feature pair)", "");
+    insert_("charge", 13, "Charge of a feature or peak", "");
   }
 
-  MetaInfoRegistry::MetaInfoRegistry(const MetaInfoRegistry& rhs)
+  MetaInfoRegistry::MetaInfoRegistry(const MetaInfoRegistry& rhs) :
+    next_index_(1024)
   {
+    for (Size i = 0; i < NR_BUCKETS; ++i)
+    {
+      name_buckets_[i].store(nullptr, std::memory_order_relaxed);
+      index_buckets_[i].store(nullptr, std::memory_order_relaxed);
+    }
     *this = rhs;
   }
 
   MetaInfoRegistry::~MetaInfoRegistry()
   {
+    clear_();
   }
 
   MetaInfoRegistry& MetaInfoRegistry::operator=(const MetaInfoRegistry& rhs)
@@ -129,32 +87,93 @@ namespace OpenMS
 
 #pragma omp critical (MetaInfoRegistry)
     {
+      clear_();
       next_index_ = rhs.next_index_;
-      name_to_index_ = rhs.name_to_index_;
-      index_to_name_ = rhs.index_to_name_;
-      index_to_description_ = rhs.index_to_description_;
-      index_to_unit_ = rhs.index_to_unit_;
+      for (Size i = 0; i < NR_BUCKETS; ++i)
+      {
+        for (const Entry_* e = rhs.index_buckets_[i].load(std::memory_order_acquire); e != nullptr; e = e->next_by_index)
+        {
+          insert_(e->name, e->index, e->description, e->unit);
+        }
+      }
     }
     return *this;
   }
 
+  MetaInfoRegistry::Entry_* MetaInfoRegistry::findByName_(const std::string& name) const
+  {
+    const Size bucket = std::hash<std::string>()(name) % NR_BUCKETS;
+    // entries are fully constructed before they are published (release),
+    // so the chain can be traversed without a lock
+    for (Entry_* e = name_buckets_[bucket].load(std::memory_order_acquire); e != nullptr; e = e->next_by_name)
+    {
+      if (e->name == name) return e;
+    }
+    return nullptr;
+  }
+
+  MetaInfoRegistry::Entry_* MetaInfoRegistry::findByIndex_(UInt index) const
+  {
+    for (Entry_* e = index_buckets_[index % NR_BUCKETS].load(std::memory_order_acquire); e != nullptr; e = e->next_by_index)
+    {
+      if (e->index == index) return e;
+    }
+    return nullptr;
+  }
+
+  void MetaInfoRegistry::insert_(const std::string& name, UInt index, const std::string& description, const std::string& unit)
+  {
+    std::atomic<Entry_*>& name_head = name_buckets_[std::hash<std::string>()(name) % NR_BUCKETS];
+    std::atomic<Entry_*>& index_head = index_buckets_[index % NR_BUCKETS];
+
+    Entry_* e = new Entry_();
+    e->name = name;
+    e->index = index;
+    e->description = description;
+    e->unit = unit;
+    e->next_by_name = name_head.load(std::memory_order_relaxed);
+    e->next_by_index = index_head.load(std::memory_order_relaxed);
+
+    // publish: index first, so a name that can be found can also be resolved
+    index_head.store(e, std::memory_order_release);
+    name_head.store(e, std::memory_order_release);
+  }
+
+  void MetaInfoRegistry::clear_()
+  {
+    for (Size i = 0; i < NR_BUCKETS; ++i)
+    {
+      Entry_* e = index_buckets_[i].load(std::memory_order_relaxed);
+      while (e != nullptr)
+      {
+        Entry_* next = e->next_by_index;
+        delete e;
+        e = next;
+      }
+      index_buckets_[i].store(nullptr, std::memory_order_relaxed);
+      name_buckets_[i].store(nullptr, std::memory_order_relaxed);
+    }
+  }
+
   UInt MetaInfoRegistry::registerName(const String& name, const String& description, const String& unit)
   {
+    // fast path: already registered
+    const Entry_* existing = findByName_(name);
+    if (existing != nullptr) return existing->index;
+
     UInt rv;
 #pragma omp critical (MetaInfoRegistry)
     {
-      MapString2IndexType::iterator it = name_to_index_.find(name);
-      if (it == name_to_index_.end())
+      // another thread may have registered the name in the meantime
+      existing = findByName_(name);
+      if (existing == nullptr)
       {
-        name_to_index_[name] = next_index_;
-        index_to_name_[next_index_] = name;
-        index_to_description_[next_index_] = description;
-        index_to_unit_[next_index_] = unit;
         rv = next_index_++;
+        insert_(name, rv, description, unit);
       }
       else
       {
-        rv = it->second;
+        rv = existing->index;
       }
     }
     return rv;
@@ -162,169 +181,131 @@ namespace OpenMS
 
   void MetaInfoRegistry::setDescription(UInt index, const String& description)
   {
-    MapIndex2StringType::iterator pos;
+    Entry_* e = findByIndex_(index);
+    if (e == nullptr)
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered index!", String(index));
+    }
 #pragma omp critical (MetaInfoRegistry)
     {
-      pos = index_to_description_.find(index);
-      if (pos != index_to_description_.end())
-      {
-        pos->second = description;
-      }
-      else
-      {
-        throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered index!", String(index));
-      }
+      e->description = description;
     }
   }
 
   void MetaInfoRegistry::setDescription(const String& name, const String& description)
   {
-    MapString2IndexType::iterator pos;
+    Entry_* e = findByName_(name);
+    if (e == nullptr)
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered name!", name);
+    }
 #pragma omp critical (MetaInfoRegistry)
     {
-      pos = name_to_index_.find(name);
-      if (pos != name_to_index_.end())
-      {
-        index_to_description_[pos->second] = description;
-      }
-      else
-      {
-        throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered name!", name);
-      }
+      e->description = description;
     }
   }
 
   void MetaInfoRegistry::setUnit(UInt index, const String& unit)
   {
-    MapIndex2StringType::iterator pos;
+    Entry_* e = findByIndex_(index);
+    if (e == nullptr)
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered index!", String(index));
+    }
 #pragma omp critical (MetaInfoRegistry)
     {
-      pos = index_to_unit_.find(index);
-      if (pos != index_to_unit_.end())
-      {
-        pos->second = unit;
-      }
-      else
-      {
-        throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered index!", String(index));
-      }
+      e->unit = unit;
     }
   }
 
   void MetaInfoRegistry::setUnit(const String& name, const String& unit)
   {
-    MapString2IndexType::iterator pos;
+    Entry_* e = findByName_(name);
+    if (e == nullptr)
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered name!", name);
+    }
 #pragma omp critical (MetaInfoRegistry)
     {
-      pos = name_to_index_.find(name);
-      if (pos != name_to_index_.end())
-      {
-        index_to_unit_[pos->second] = unit;
-      }
-      else
-      {
-        throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered name!", name);
-      }
+      e->unit = unit;
     }
   }
 
   UInt MetaInfoRegistry::getIndex(const String& name) const
   {
-    UInt rv = UInt(-1);
-#pragma omp critical (MetaInfoRegistry)
-    {
-      MapString2IndexType::const_iterator it = name_to_index_.find(name);
-      if (it != name_to_index_.end())
-      {
-        rv = it->second;
-      }
-    }
-    return rv;
+    const Entry_* e = findByName_(name);
+    return (e != nullptr) ? e->index : UInt(-1);
   }
 
   String MetaInfoRegistry::getDescription(UInt index) const
   {
-    String result;
+    const Entry_* e = findByIndex_(index);
+    if (e == nullptr)
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered index!", String(index));
+    }
+    String rv;
 #pragma omp critical (MetaInfoRegistry)
     {
-      MapIndex2StringType::const_iterator it = index_to_description_.find(index);
-      if (it == index_to_description_.end())
-      {
-        throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered index!", String(index));
-      }
-      result = it->second;
+      rv = e->description;
     }
-    return result;
+    return rv;
   }
 
   String MetaInfoRegistry::getDescription(const String& name) const
   {
-    String rv;
-    UInt index = getIndex(name); // this has to be outside the OpenMP "critical" block!
-    if (index == UInt(-1)) // not found
+    const Entry_* e = findByName_(name);
+    if (e == nullptr)
     {
       throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered Name!", name);
     }
-    else
-    {
+    String rv;
 #pragma omp critical (MetaInfoRegistry)
-      {
-        rv = (index_to_description_.find(index))->second;
-      }
+    {
+      rv = e->description;
     }
     return rv;
   }
 
   String MetaInfoRegistry::getUnit(UInt index) const
   {
-    String result;
+    const Entry_* e = findByIndex_(index);
+    if (e == nullptr)
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered index!", String(index));
+    }
+    String rv;
 #pragma omp critical (MetaInfoRegistry)
     {
-      MapIndex2StringType::const_iterator it = index_to_unit_.find(index);
-      if (it == index_to_unit_.end())
-      {
-        throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered index!", String(index));
-      }
-      result = it->second;
+      rv = e->unit;
     }
-    return result;
+    return rv;
   }
 
   String MetaInfoRegistry::getUnit(const String& name) const
   {
-    String rv;
-    UInt index = getIndex(name); // this has to be outside the OpenMP "critical" block!
-    if (index == UInt(-1)) // not found
+    const Entry_* e = findByName_(name);
+    if (e == nullptr)
     {
       throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered Name!", name);
     }
-    else
-    {
+    String rv;
 #pragma omp critical (MetaInfoRegistry)
-      {
-        rv = (index_to_unit_.find(index))->second;
-      }
+    {
+      rv = e->unit;
     }
     return rv;
   }
 
   String MetaInfoRegistry::getName(UInt index) const
   {
-    String rv;
-#pragma omp critical (MetaInfoRegistry)
+    // names never change after registration, so no lock is needed
+    const Entry_* e = findByIndex_(index);
+    if (e == nullptr)
     {
-      MapIndex2StringType::const_iterator it = index_to_name_.find(index);
-      if (it != index_to_name_.end())
-      {
-        rv = it->second;
-      }
-      else
-      {
-        throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered index!", String(index));
-      }
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered index!", String(index));
     }
-    return rv;
+    return e->name;
   }
 
 } //namespace
-
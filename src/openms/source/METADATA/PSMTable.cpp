@@ -0,0 +1,736 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/METADATA/PSMTable.h>
+
+#include <algorithm>
+
+using namespace std;
+
+namespace OpenMS
+{
+
+  UInt32 PSMTable::StringPool_::intern(const String& s)
+  {
+    unordered_map<string, UInt32>::const_iterator it = ids.find(s);
+    if (it != ids.end()) return it->second;
+
+    UInt32 id = static_cast<UInt32>(strings.size());
+    strings.push_back(s);
+    ids.emplace(s, id);
+    return id;
+  }
+
+  PSMTable::MetaColumn_::Type PSMTable::MetaColumn_::typeOf(const DataValue& value)
+  {
+    if (value.hasUnit()) return GENERIC;
+    switch (value.valueType())
+    {
+      case DataValue::INT_VALUE: return INT;
+      case DataValue::DOUBLE_VALUE: return DOUBLE;
+      case DataValue::STRING_VALUE: return STRING;
+      default: return GENERIC;
+    }
+  }
+
+  void PSMTable::MetaColumn_::init(Type t, Size rows)
+  {
+    type = t;
+    present.assign(rows, false);
+    ints.clear();
+    doubles.clear();
+    strings.clear();
+    generic.clear();
+    switch (type)
+    {
+      case INT: ints.resize(rows); break;
+      case DOUBLE: doubles.resize(rows); break;
+      case STRING: strings.resize(rows); break;
+      case GENERIC: generic.resize(rows); break;
+    }
+  }
+
+  void PSMTable::MetaColumn_::appendAbsent()
+  {
+    present.push_back(false);
+    switch (type)
+    {
+      case INT: ints.push_back(0); break;
+      case DOUBLE: doubles.push_back(0.0); break;
+      case STRING: strings.push_back(0); break;
+      case GENERIC: generic.push_back(DataValue()); break;
+    }
+  }
+
+  DataValue PSMTable::MetaColumn_::get(Size row, const StringPool_& pool) const
+  {
+    if (!present[row]) return DataValue::EMPTY;
+    switch (type)
+    {
+      case INT: return DataValue(ints[row]);
+      case DOUBLE: return DataValue(doubles[row]);
+      case STRING: return DataValue(pool.strings[strings[row]]);
+      default: return generic[row];
+    }
+  }
+
+  void PSMTable::MetaColumn_::set(Size row, const DataValue& value, StringPool_& pool)
+  {
+    Type value_type = typeOf(value);
+    if (value_type != type)
+    {
+      if (std::find(present.begin(), present.end(), true) == present.end())
+      {
+        init(value_type, present.size()); // no values yet - just change the type
+      }
+      else if (type != GENERIC)
+      {
+        toGeneric(pool);
+      }
+    }
+
+    switch (type)
+    {
+      case INT: ints[row] = static_cast<SignedSize>(value); break;
+      case DOUBLE: doubles[row] = static_cast<double>(value); break;
+      case STRING: strings[row] = pool.intern(value.toString()); break;
+      case GENERIC: generic[row] = value; break;
+    }
+    present[row] = true;
+  }
+
+  void PSMTable::MetaColumn_::remove(Size row)
+  {
+    present[row] = false;
+    if (type == GENERIC) generic[row] = DataValue();
+  }
+
+  void PSMTable::MetaColumn_::toGeneric(const StringPool_& pool)
+  {
+    if (type == GENERIC) return;
+
+    vector<DataValue> values(present.size());
+    for (Size row = 0; row < present.size(); ++row)
+    {
+      if (present[row]) values[row] = get(row, pool);
+    }
+    vector<bool> keep_present;
+    keep_present.swap(present);
+    init(GENERIC, 0);
+    present.swap(keep_present);
+    generic.swap(values);
+  }
+
+  void PSMTable::MetaColumn_::select(const vector<Size>& rows)
+  {
+    vector<bool> new_present(rows.size());
+    for (Size i = 0; i < rows.size(); ++i)
+    {
+      new_present[i] = present[rows[i]];
+    }
+    present.swap(new_present);
+
+    switch (type)
+    {
+      case INT:
+      {
+        vector<SignedSize> values(rows.size());
+        for (Size i = 0; i < rows.size(); ++i) values[i] = ints[rows[i]];
+        ints.swap(values);
+        break;
+      }
+      case DOUBLE:
+      {
+        vector<double> values(rows.size());
+        for (Size i = 0; i < rows.size(); ++i) values[i] = doubles[rows[i]];
+        doubles.swap(values);
+        break;
+      }
+      case STRING:
+      {
+        vector<UInt32> values(rows.size());
+        for (Size i = 0; i < rows.size(); ++i) values[i] = strings[rows[i]];
+        strings.swap(values);
+        break;
+      }
+      case GENERIC:
+      {
+        vector<DataValue> values(rows.size());
+        for (Size i = 0; i < rows.size(); ++i) values[i] = generic[rows[i]];
+        generic.swap(values);
+        break;
+      }
+    }
+  }
+
+  void PSMTable::MetaTable_::appendRow(const MetaInfoInterface& meta, StringPool_& pool)
+  {
+    for (map<UInt, MetaColumn_>::iterator it = columns.begin(); it != columns.end(); ++it)
+    {
+      it->second.appendAbsent();
+    }
+    ++rows;
+
+    if (meta.isMetaEmpty()) return;
+
+    vector<UInt> keys;
+    meta.getKeys(keys);
+    for (Size i = 0; i < keys.size(); ++i)
+    {
+      set(rows - 1, keys[i], meta.getMetaValue(keys[i]), pool);
+    }
+  }
+
+  bool PSMTable::MetaTable_::exists(Size row, UInt key) const
+  {
+    map<UInt, MetaColumn_>::const_iterator it = columns.find(key);
+    return (it != columns.end()) && it->second.present[row];
+  }
+
+  DataValue PSMTable::MetaTable_::get(Size row, UInt key, const StringPool_& pool) const
+  {
+    map<UInt, MetaColumn_>::const_iterator it = columns.find(key);
+    if (it == columns.end()) return DataValue::EMPTY;
+    return it->second.get(row, pool);
+  }
+
+  void PSMTable::MetaTable_::set(Size row, UInt key, const DataValue& value, StringPool_& pool)
+  {
+    map<UInt, MetaColumn_>::iterator it = columns.find(key);
+    if (it == columns.end())
+    {
+      it = columns.insert(make_pair(key, MetaColumn_())).first;
+      it->second.init(MetaColumn_::typeOf(value), rows);
+    }
+    it->second.set(row, value, pool);
+  }
+
+  void PSMTable::MetaTable_::remove(Size row, UInt key)
+  {
+    map<UInt, MetaColumn_>::iterator it = columns.find(key);
+    if (it != columns.end()) it->second.remove(row);
+  }
+
+  void PSMTable::MetaTable_::copyTo(Size row, MetaInfoInterface& meta, const StringPool_& pool) const
+  {
+    for (map<UInt, MetaColumn_>::const_iterator it = columns.begin(); it != columns.end(); ++it)
+    {
+      if (it->second.present[row])
+      {
+        meta.setMetaValue(it->first, it->second.get(row, pool));
+      }
+    }
+  }
+
+  void PSMTable::MetaTable_::select(const vector<Size>& selected_rows)
+  {
+    for (map<UInt, MetaColumn_>::iterator it = columns.begin(); it != columns.end(); )
+    {
+      it->second.select(selected_rows);
+      // drop columns that no longer hold any value
+      if (std::find(it->second.present.begin(), it->second.present.end(), true) == it->second.present.end())
+      {
+        it = columns.erase(it);
+      }
+      else
+      {
+        ++it;
+      }
+    }
+    rows = selected_rows.size();
+  }
+
+  void PSMTable::MetaTable_::clear()
+  {
+    columns.clear();
+    rows = 0;
+  }
+
+  PSMTable::PSMTable() :
+    hits_begin_(1, 0),
+    evidences_begin_(1, 0)
+  {
+  }
+
+  PSMTable::PSMTable(const vector<PeptideIdentification>& ids) :
+    hits_begin_(1, 0),
+    evidences_begin_(1, 0)
+  {
+    add(ids);
+  }
+
+  void PSMTable::add(const vector<PeptideIdentification>& ids)
+  {
+    Size nr_hits(0);
+    for (vector<PeptideIdentification>::const_iterator it = ids.begin(); it != ids.end(); ++it)
+    {
+      nr_hits += it->getHits().size();
+    }
+    rt_.reserve(rt_.size() + ids.size());
+    mz_.reserve(mz_.size() + ids.size());
+    hits_begin_.reserve(hits_begin_.size() + ids.size());
+    score_.reserve(score_.size() + nr_hits);
+    sequence_.reserve(sequence_.size() + nr_hits);
+    evidences_begin_.reserve(evidences_begin_.size() + nr_hits);
+
+    for (vector<PeptideIdentification>::const_iterator it = ids.begin(); it != ids.end(); ++it)
+    {
+      add(*it);
+    }
+  }
+
+  void PSMTable::add(const PeptideIdentification& id)
+  {
+    rt_.push_back(id.getRT());
+    mz_.push_back(id.getMZ());
+    significance_threshold_.push_back(id.getSignificanceThreshold());
+    identifier_.push_back(strings_.intern(id.getIdentifier()));
+    base_name_.push_back(strings_.intern(id.getBaseName()));
+    score_type_.push_back(strings_.intern(id.getScoreType()));
+    higher_score_better_.push_back(id.isHigherScoreBetter());
+    identification_meta_.appendRow(id, strings_);
+
+    for (vector<PeptideHit>::const_iterator hit = id.getHits().begin(); hit != id.getHits().end(); ++hit)
+    {
+      const Size row = score_.size();
+      sequence_.push_back(strings_.intern(hit->getSequence().toString()));
+      score_.push_back(hit->getScore());
+      rank_.push_back(hit->getRank());
+      charge_.push_back(hit->getCharge());
+
+      const vector<PeptideEvidence>& evidences = hit->getPeptideEvidences();
+      for (vector<PeptideEvidence>::const_iterator ev = evidences.begin(); ev != evidences.end(); ++ev)
+      {
+        evidence_accession_.push_back(strings_.intern(ev->getProteinAccession()));
+        evidence_start_.push_back(ev->getStart());
+        evidence_end_.push_back(ev->getEnd());
+        evidence_aa_before_.push_back(ev->getAABefore());
+        evidence_aa_after_.push_back(ev->getAAAfter());
+      }
+      evidences_begin_.push_back(evidence_accession_.size());
+
+      hit_meta_.appendRow(*hit, strings_);
+
+      // rarely used, kept on the side
+      if (!hit->getPeakAnnotations().empty())
+      {
+        peak_annotations_[row] = hit->getPeakAnnotations();
+      }
+      if (!hit->getAnalysisResults().empty())
+      {
+        analysis_results_[row] = hit->getAnalysisResults();
+      }
+    }
+    hits_begin_.push_back(score_.size());
+  }
+
+  PeptideIdentification PSMTable::getIdentification(Size index) const
+  {
+    PeptideIdentification id;
+    getIdentification(index, id);
+    return id;
+  }
+
+  void PSMTable::getIdentification(Size index, PeptideIdentification& id) const
+  {
+    unordered_map<UInt32, AASequence> sequences;
+    getIdentification_(index, id, sequences);
+  }
+
+  void PSMTable::getIdentifications(vector<PeptideIdentification>& ids) const
+  {
+    ids.clear();
+    ids.resize(getNrIdentifications());
+    unordered_map<UInt32, AASequence> sequences;
+    for (Size i = 0; i < ids.size(); ++i)
+    {
+      getIdentification_(i, ids[i], sequences);
+    }
+  }
+
+  void PSMTable::getIdentification_(Size index, PeptideIdentification& id, unordered_map<UInt32, AASequence>& sequences) const
+  {
+    id = PeptideIdentification();
+    id.setRT(rt_[index]);
+    id.setMZ(mz_[index]);
+    id.setSignificanceThreshold(significance_threshold_[index]);
+    id.setIdentifier(strings_.strings[identifier_[index]]);
+    id.setBaseName(strings_.strings[base_name_[index]]);
+    id.setScoreType(strings_.strings[score_type_[index]]);
+    id.setHigherScoreBetter(higher_score_better_[index]);
+    identification_meta_.copyTo(index, id, strings_);
+
+    vector<PeptideHit>& hits = id.getHits();
+    hits.resize(getHitsEnd(index) - getHitsBegin(index));
+    for (Size h = getHitsBegin(index), i = 0; h < getHitsEnd(index); ++h, ++i)
+    {
+      PeptideHit& hit = hits[i];
+
+      unordered_map<UInt32, AASequence>::const_iterator seq_it = sequences.find(sequence_[h]);
+      if (seq_it == sequences.end())
+      {
+        seq_it = sequences.emplace(sequence_[h], AASequence::fromString(strings_.strings[sequence_[h]])).first;
+      }
+      hit.setSequence(seq_it->second);
+      hit.setScore(score_[h]);
+      hit.setRank(rank_[h]);
+      hit.setCharge(charge_[h]);
+      hit.setPeptideEvidences(getPeptideEvidences(h));
+      hit_meta_.copyTo(h, hit, strings_);
+
+      map<Size, vector<PeptideHit::PeakAnnotation> >::const_iterator pa_it = peak_annotations_.find(h);
+      if (pa_it != peak_annotations_.end())
+      {
+        hit.setPeakAnnotations(pa_it->second);
+      }
+      map<Size, vector<PeptideHit::PepXMLAnalysisResult> >::const_iterator ar_it = analysis_results_.find(h);
+      if (ar_it != analysis_results_.end())
+      {
+        hit.setAnalysisResults(ar_it->second);
+      }
+    }
+  }
+
+  Size PSMTable::getNrIdentifications() const
+  {
+    return rt_.size();
+  }
+
+  Size PSMTable::getNrHits() const
+  {
+    return score_.size();
+  }
+
+  bool PSMTable::empty() const
+  {
+    return rt_.empty();
+  }
+
+  void PSMTable::clear()
+  {
+    *this = PSMTable();
+  }
+
+  double PSMTable::getRT(Size index) const
+  {
+    return rt_[index];
+  }
+
+  double PSMTable::getMZ(Size index) const
+  {
+    return mz_[index];
+  }
+
+  double PSMTable::getSignificanceThreshold(Size index) const
+  {
+    return significance_threshold_[index];
+  }
+
+  const String& PSMTable::getIdentifier(Size index) const
+  {
+    return strings_.strings[identifier_[index]];
+  }
+
+  const String& PSMTable::getBaseName(Size index) const
+  {
+    return strings_.strings[base_name_[index]];
+  }
+
+  const String& PSMTable::getScoreType(Size index) const
+  {
+    return strings_.strings[score_type_[index]];
+  }
+
+  void PSMTable::setScoreType(Size index, const String& type)
+  {
+    score_type_[index] = strings_.intern(type);
+  }
+
+  bool PSMTable::isHigherScoreBetter(Size index) const
+  {
+    return higher_score_better_[index];
+  }
+
+  void PSMTable::setHigherScoreBetter(Size index, bool value)
+  {
+    higher_score_better_[index] = value;
+  }
+
+  Size PSMTable::getHitsBegin(Size index) const
+  {
+    return hits_begin_[index];
+  }
+
+  Size PSMTable::getHitsEnd(Size index) const
+  {
+    return hits_begin_[index + 1];
+  }
+
+  Size PSMTable::getIdentificationIndex(Size hit) const
+  {
+    // last identification that starts at or before the hit (skips empty ones)
+    return std::upper_bound(hits_begin_.begin(), hits_begin_.end(), hit) - hits_begin_.begin() - 1;
+  }
+
+  bool PSMTable::identificationMetaValueExists(Size index, UInt key) const
+  {
+    return identification_meta_.exists(index, key);
+  }
+
+  DataValue PSMTable::getIdentificationMetaValue(Size index, UInt key) const
+  {
+    return identification_meta_.get(index, key, strings_);
+  }
+
+  void PSMTable::setIdentificationMetaValue(Size index, UInt key, const DataValue& value)
+  {
+    identification_meta_.set(index, key, value, strings_);
+  }
+
+  double PSMTable::getScore(Size hit) const
+  {
+    return score_[hit];
+  }
+
+  void PSMTable::setScore(Size hit, double score)
+  {
+    score_[hit] = score;
+  }
+
+  UInt PSMTable::getRank(Size hit) const
+  {
+    return rank_[hit];
+  }
+
+  void PSMTable::setRank(Size hit, UInt rank)
+  {
+    rank_[hit] = rank;
+  }
+
+  Int PSMTable::getCharge(Size hit) const
+  {
+    return charge_[hit];
+  }
+
+  const String& PSMTable::getSequence(Size hit) const
+  {
+    return strings_.strings[sequence_[hit]];
+  }
+
+  UInt32 PSMTable::getSequenceId(Size hit) const
+  {
+    return sequence_[hit];
+  }
+
+  vector<PeptideEvidence> PSMTable::getPeptideEvidences(Size hit) const
+  {
+    vector<PeptideEvidence> evidences;
+    evidences.reserve(evidences_begin_[hit + 1] - evidences_begin_[hit]);
+    for (Size e = evidences_begin_[hit]; e < evidences_begin_[hit + 1]; ++e)
+    {
+      evidences.push_back(PeptideEvidence(strings_.strings[evidence_accession_[e]], evidence_start_[e], evidence_end_[e], evidence_aa_before_[e], evidence_aa_after_[e]));
+    }
+    return evidences;
+  }
+
+  bool PSMTable::hitMetaValueExists(Size hit, UInt key) const
+  {
+    return hit_meta_.exists(hit, key);
+  }
+
+  DataValue PSMTable::getHitMetaValue(Size hit, UInt key) const
+  {
+    return hit_meta_.get(hit, key, strings_);
+  }
+
+  void PSMTable::setHitMetaValue(Size hit, UInt key, const DataValue& value)
+  {
+    hit_meta_.set(hit, key, value, strings_);
+  }
+
+  void PSMTable::removeHitMetaValue(Size hit, UInt key)
+  {
+    hit_meta_.remove(hit, key);
+  }
+
+  void PSMTable::sortHits()
+  {
+    vector<Size> order(getNrHits()), hit_counts(getNrIdentifications());
+    for (Size i = 0; i < getNrIdentifications(); ++i)
+    {
+      vector<Size>::iterator begin = order.begin() + getHitsBegin(i), end = order.begin() + getHitsEnd(i);
+      for (Size h = getHitsBegin(i); h < getHitsEnd(i); ++h) order[h] = h;
+      if (higher_score_better_[i])
+      {
+        std::stable_sort(begin, end, [this](Size a, Size b) { return score_[a] > score_[b]; });
+      }
+      else
+      {
+        std::stable_sort(begin, end, [this](Size a, Size b) { return score_[a] < score_[b]; });
+      }
+      hit_counts[i] = getHitsEnd(i) - getHitsBegin(i);
+    }
+    selectHits_(order, hit_counts);
+  }
+
+  void PSMTable::assignRanks()
+  {
+    sortHits();
+    for (Size i = 0; i < getNrIdentifications(); ++i)
+    {
+      UInt rank = 1;
+      for (Size h = getHitsBegin(i); h < getHitsEnd(i); ++h)
+      {
+        if (h > getHitsBegin(i) && score_[h] != score_[h - 1]) ++rank;
+        rank_[h] = rank;
+      }
+    }
+  }
+
+  void PSMTable::filterHits(const vector<bool>& keep)
+  {
+    if (keep.size() != getNrHits())
+    {
+      throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, keep.size());
+    }
+
+    vector<Size> selected, hit_counts(getNrIdentifications(), 0);
+    for (Size i = 0; i < getNrIdentifications(); ++i)
+    {
+      for (Size h = getHitsBegin(i); h < getHitsEnd(i); ++h)
+      {
+        if (!keep[h]) continue;
+        selected.push_back(h);
+        ++hit_counts[i];
+      }
+    }
+    if (selected.size() == getNrHits()) return;
+
+    selectHits_(selected, hit_counts);
+  }
+
+  void PSMTable::removeEmptyIdentifications()
+  {
+    vector<Size> selected;
+    for (Size i = 0; i < getNrIdentifications(); ++i)
+    {
+      if (getHitsEnd(i) > getHitsBegin(i)) selected.push_back(i);
+    }
+    if (selected.size() == getNrIdentifications()) return;
+
+    vector<double> rt, mz, significance_threshold;
+    vector<UInt32> identifier, base_name, score_type;
+    vector<bool> higher_score_better;
+    vector<Size> hits_begin(1, 0);
+    for (Size k = 0; k < selected.size(); ++k)
+    {
+      const Size i = selected[k];
+      rt.push_back(rt_[i]);
+      mz.push_back(mz_[i]);
+      significance_threshold.push_back(significance_threshold_[i]);
+      identifier.push_back(identifier_[i]);
+      base_name.push_back(base_name_[i]);
+      score_type.push_back(score_type_[i]);
+      higher_score_better.push_back(higher_score_better_[i]);
+      hits_begin.push_back(hits_begin_[i + 1]);
+    }
+    rt_.swap(rt);
+    mz_.swap(mz);
+    significance_threshold_.swap(significance_threshold);
+    identifier_.swap(identifier);
+    base_name_.swap(base_name);
+    score_type_.swap(score_type);
+    higher_score_better_.swap(higher_score_better);
+    hits_begin_.swap(hits_begin);
+    identification_meta_.select(selected);
+  }
+
+  void PSMTable::selectHits_(const vector<Size>& hits, const vector<Size>& hit_counts)
+  {
+    vector<UInt32> sequence(hits.size());
+    vector<double> score(hits.size());
+    vector<UInt> rank(hits.size());
+    vector<Int> charge(hits.size());
+    vector<Size> evidences_begin(1, 0);
+    evidences_begin.reserve(hits.size() + 1);
+    vector<UInt32> evidence_accession;
+    vector<Int> evidence_start, evidence_end;
+    vector<char> evidence_aa_before, evidence_aa_after;
+    map<Size, vector<PeptideHit::PeakAnnotation> > peak_annotations;
+    map<Size, vector<PeptideHit::PepXMLAnalysisResult> > analysis_results;
+
+    for (Size i = 0; i < hits.size(); ++i)
+    {
+      const Size h = hits[i];
+      sequence[i] = sequence_[h];
+      score[i] = score_[h];
+      rank[i] = rank_[h];
+      charge[i] = charge_[h];
+      for (Size e = evidences_begin_[h]; e < evidences_begin_[h + 1]; ++e)
+      {
+        evidence_accession.push_back(evidence_accession_[e]);
+        evidence_start.push_back(evidence_start_[e]);
+        evidence_end.push_back(evidence_end_[e]);
+        evidence_aa_before.push_back(evidence_aa_before_[e]);
+        evidence_aa_after.push_back(evidence_aa_after_[e]);
+      }
+      evidences_begin.push_back(evidence_accession.size());
+
+      map<Size, vector<PeptideHit::PeakAnnotation> >::iterator pa_it = peak_annotations_.find(h);
+      if (pa_it != peak_annotations_.end()) peak_annotations[i].swap(pa_it->second);
+      map<Size, vector<PeptideHit::PepXMLAnalysisResult> >::iterator ar_it = analysis_results_.find(h);
+      if (ar_it != analysis_results_.end()) analysis_results[i].swap(ar_it->second);
+    }
+
+    sequence_.swap(sequence);
+    score_.swap(score);
+    rank_.swap(rank);
+    charge_.swap(charge);
+    evidences_begin_.swap(evidences_begin);
+    evidence_accession_.swap(evidence_accession);
+    evidence_start_.swap(evidence_start);
+    evidence_end_.swap(evidence_end);
+    evidence_aa_before_.swap(evidence_aa_before);
+    evidence_aa_after_.swap(evidence_aa_after);
+    peak_annotations_.swap(peak_annotations);
+    analysis_results_.swap(analysis_results);
+    hit_meta_.select(hits);
+
+    for (Size i = 0; i < hit_counts.size(); ++i)
+    {
+      hits_begin_[i + 1] = hits_begin_[i] + hit_counts[i];
+    }
+  }
+
+} // namespace OpenMS
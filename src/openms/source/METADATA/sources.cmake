@@ -40,6 +40,7 @@ Precursor.cpp
 Product.cpp
 ProteinHit.cpp
 ProteinIdentification.cpp
+PSMTable.cpp
 Sample.cpp
 SampleTreatment.cpp
 ScanWindow.cpp
@@ -319,7 +319,7 @@ namespace OpenMS
           new_mod->setTermSpecificity(ResidueModification::ANYWHERE);
           new_mod->setUniModRecordId(100000 + seeds_added); // required for TargetedExperimentHelper
           new_mod->setOrigin('X');
-          ModificationsDB::getInstance()->addModification(new_mod);
+          if (ModificationsDB::getInstance()->addModification(new_mod) != new_mod) delete new_mod;
         }
 
         AASequence some_seq = AASequence::fromString("XXX");
@@ -35,12 +35,16 @@
 
 #include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerHiRes.h>
 
-#include <OpenMS/FILTERING/NOISEESTIMATION/SignalToNoiseEstimatorMedian.h>
+#include <OpenMS/FILTERING/NOISEESTIMATION/SignalToNoiseEstimatorMedianIncremental.h>
 #include <OpenMS/KERNEL/OnDiscMSExperiment.h>
 #include <OpenMS/KERNEL/MSChromatogram.h>
 #include <OpenMS/MATH/MISC/SplineBisection.h>
 #include <OpenMS/MATH/MISC/CubicSpline2d.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 using namespace std;
 
@@ -120,8 +124,8 @@ namespace OpenMS
       check_spacings = false;
     }
 
-    // signal-to-noise estimation
-    SignalToNoiseEstimatorMedian<MSSpectrum > snt;
+    // signal-to-noise estimation (same results as SignalToNoiseEstimatorMedian, but faster)
+    SignalToNoiseEstimatorMedianIncremental<MSSpectrum > snt;
     snt.setParameters(param_.copy("SignalToNoise:", true));
 
     if (signal_to_noise_ > 0.0)
@@ -416,7 +420,7 @@ namespace OpenMS
 
   /**
   * @brief Applies the peak-picking algorithm to a map (MSExperiment). This
-  * method picks peaks for each scan in the map consecutively. The resulting
+  * method picks peaks for each scan in the map (in parallel). The resulting
   * picked peaks are written to the output map.
   *
   * @param input  input map in profile mode
@@ -432,7 +436,7 @@ namespace OpenMS
 
   /**
   * @brief Applies the peak-picking algorithm to a map (MSExperiment). This
-  * method picks peaks for each scan in the map consecutively. The resulting
+  * method picks peaks for each scan in the map (in parallel). The resulting
   * picked peaks are written to the output map.
   *
   * @param input  input map in profile mode
@@ -455,61 +459,73 @@ namespace OpenMS
     // resize output with respect to input
     output.resize(input.size());
 
-    Size progress = 0;
-    startProgress(0, input.size() + input.getChromatograms().size(), "picking peaks");
-
-    if (input.getNrSpectra() > 0)
+    // decide which spectra are picked (serially, as exceptions must not escape the parallel region below)
+    std::vector<char> do_pick(input.size(), 0);
+    for (Size scan_idx = 0; scan_idx != input.size(); ++scan_idx)
     {
-      for (Size scan_idx = 0; scan_idx != input.size(); ++scan_idx)
+      if (ms_levels_.empty()) // auto mode
       {
-        if (ms_levels_.empty()) // auto mode
-        {
-          SpectrumSettings::SpectrumType spectrum_type = input[scan_idx].getType();
-          if (spectrum_type == SpectrumSettings::CENTROID)
-          {
-            output[scan_idx] = input[scan_idx];
-          }
-          else
-          {
-            std::vector<PeakBoundary> boundaries_s; // peak boundaries of a single spectrum
-
-            pick(input[scan_idx], output[scan_idx], boundaries_s);
-            boundaries_spec.push_back(boundaries_s);
-          }
-        }
-        else if (!ListUtils::contains(ms_levels_, input[scan_idx].getMSLevel())) // manual mode
+        do_pick[scan_idx] = (input[scan_idx].getType() != SpectrumSettings::CENTROID);
+      }
+      else if (ListUtils::contains(ms_levels_, input[scan_idx].getMSLevel())) // manual mode
+      {
+        // determine type of spectral data (profile or centroided)
+        if (input[scan_idx].getType() == SpectrumSettings::CENTROID && check_spectrum_type)
         {
-          output[scan_idx] = input[scan_idx];
+          throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Centroided data provided but profile spectra expected.");
         }
-        else
-        {
-          std::vector<PeakBoundary> boundaries_s; // peak boundaries of a single spectrum
-
-                                                  // determine type of spectral data (profile or centroided)
-          SpectrumSettings::SpectrumType spectrum_type = input[scan_idx].getType();
+        do_pick[scan_idx] = 1;
+      }
+    }
 
-          if (spectrum_type == SpectrumSettings::CENTROID && check_spectrum_type)
-          {
-            throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Centroided data provided but profile spectra expected.");
-          }
+    Size progress = 0;
+    startProgress(0, input.size() + input.getChromatograms().size(), "picking peaks");
 
-          pick(input[scan_idx], output[scan_idx], boundaries_s);
-          boundaries_spec.push_back(boundaries_s);
-        }
+    // spectra are independent of each other, so pick them in parallel;
+    // boundaries are collected per spectrum to keep the output order
+    std::vector<std::vector<PeakBoundary> > boundaries_s(input.size()); // peak boundaries of each spectrum
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 10)
+#endif
+    for (SignedSize scan_idx = 0; scan_idx < (SignedSize)input.size(); ++scan_idx)
+    {
+      if (do_pick[scan_idx])
+      {
+        pick(input[scan_idx], output[scan_idx], boundaries_s[scan_idx]);
+      }
+      else
+      {
+        output[scan_idx] = input[scan_idx];
+      }
+#ifdef _OPENMP
+#pragma omp critical (PeakPickerHiRes_PickExperiment)
+#endif
+      {
         setProgress(++progress);
       }
     }
+    for (Size scan_idx = 0; scan_idx != input.size(); ++scan_idx)
+    {
+      if (do_pick[scan_idx]) boundaries_spec.push_back(std::move(boundaries_s[scan_idx]));
+    }
 
-
-    for (Size i = 0; i < input.getChromatograms().size(); ++i)
+    std::vector<MSChromatogram> chromatograms(input.getChromatograms().size());
+    std::vector<std::vector<PeakBoundary> > boundaries_c(chromatograms.size()); // peak boundaries of each chromatogram
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 10)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)chromatograms.size(); ++i)
     {
-      MSChromatogram chromatogram;
-      std::vector<PeakBoundary> boundaries_c; // peak boundaries of a single chromatogram
-      pick(input.getChromatograms()[i], chromatogram, boundaries_c);
-      output.addChromatogram(chromatogram);
-      boundaries_chrom.push_back(boundaries_c);
-      setProgress(++progress);
+      pick(input.getChromatograms()[i], chromatograms[i], boundaries_c[i]);
+#ifdef _OPENMP
+#pragma omp critical (PeakPickerHiRes_PickExperiment)
+#endif
+      {
+        setProgress(++progress);
+      }
     }
+    output.setChromatograms(chromatograms);
+    boundaries_chrom.insert(boundaries_chrom.end(), boundaries_c.begin(), boundaries_c.end());
     endProgress();
 
     return;
@@ -517,7 +533,7 @@ namespace OpenMS
 
   /**
   @brief Applies the peak-picking algorithm to a map (MSExperiment). This
-  method picks peaks for each scan in the map consecutively. The resulting
+  method picks peaks for each scan in the map (in parallel). The resulting
   picked peaks are written to the output map.
 
   Currently we have to give up const-correctness but we know that everything on disc is constant
@@ -536,47 +552,56 @@ namespace OpenMS
     // resize output with respect to input
     output.resize(input.size());
 
-    if (input.getNrSpectra() > 0)
+    // Reading from disc is serial, picking is done in parallel on blocks of
+    // spectra (memory use is bounded by the block size).
+    Size block_size = 100;
+#ifdef _OPENMP
+    block_size *= omp_get_max_threads();
+#endif
+    std::vector<MSSpectrum> block;
+    std::vector<char> do_pick;
+    for (Size block_start = 0; block_start < input.size(); block_start += block_size)
     {
-      for (Size scan_idx = 0; scan_idx != input.size(); ++scan_idx)
+      Size block_end = std::min(block_start + block_size, input.size());
+      block.resize(block_end - block_start);
+      do_pick.assign(block.size(), 0);
+      for (Size scan_idx = block_start; scan_idx != block_end; ++scan_idx)
       {
+        MSSpectrum& s = block[scan_idx - block_start];
+        s = input[scan_idx];
         if (ms_levels_.empty()) //auto mode
         {
-          MSSpectrum s = input[scan_idx];
-          s.sortByPosition();
-
           // determine type of spectral data (profile or centroided)
-          SpectrumSettings::SpectrumType spectrumType = s.getType();
-          if (spectrumType == SpectrumSettings::CENTROID)
-          {
-            output[scan_idx] = input[scan_idx];
-          }
-          else
-          {
-            pick(s, output[scan_idx]);
-          }
-        }
-        else if (!ListUtils::contains(ms_levels_, input[scan_idx].getMSLevel())) // manual mode
-        {
-          output[scan_idx] = input[scan_idx];
+          do_pick[scan_idx - block_start] = (s.getType() != SpectrumSettings::CENTROID);
         }
-        else
+        else if (ListUtils::contains(ms_levels_, s.getMSLevel())) // manual mode
         {
-          MSSpectrum s = input[scan_idx];
-          s.sortByPosition();
-
           // determine type of spectral data (profile or centroided)
-          SpectrumSettings::SpectrumType spectrum_type = s.getType();
-
-          if (spectrum_type == SpectrumSettings::CENTROID && check_spectrum_type)
+          if (s.getType() == SpectrumSettings::CENTROID && check_spectrum_type)
           {
             throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Centroided data provided but profile spectra expected.");
           }
+          do_pick[scan_idx - block_start] = 1;
+        }
+      }
 
-          pick(s, output[scan_idx]);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 10)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)block.size(); ++i)
+      {
+        if (do_pick[i])
+        {
+          block[i].sortByPosition();
+          pick(block[i], output[block_start + i]);
+        }
+        else
+        {
+          output[block_start + i] = std::move(block[i]);
         }
-        setProgress(++progress);
       }
+      progress += block.size();
+      setProgress(progress);
     }
 
     for (Size i = 0; i < input.getNrChromatograms(); ++i)
@@ -34,6 +34,7 @@
 
 #pragma once
 
+#include <map>
 #include <string>
 #include <boost/math/special_functions/fpclassify.hpp> // for isnan
 #include <boost/numeric/conversion/cast.hpp>
@@ -230,6 +231,20 @@ public:
 
 private:
 
+    /**
+      @brief Standardized intensities of a fragment (or precursor) chromatogram of @p mrmfeature
+
+      The standardized traces are cached so that each chromatogram is only
+      fetched and standardized once per cross-correlation matrix, however many
+      pairs it takes part in. Every initializeXCorr*() call starts with an
+      empty cache (see clearNormalizedIntensities_()), so no trace of a
+      previously scored feature is ever reused.
+    */
+    const std::vector<double>& getNormalizedIntensity_(OpenSwath::IMRMFeature* mrmfeature, const String& id, bool is_precursor);
+
+    /// Clear the cache of getNormalizedIntensity_()
+    void clearNormalizedIntensities_();
+
     /** @name Members */
     //@{
     /// the precomputed cross correlation matrix
@@ -267,6 +282,12 @@ private:
     std::vector< std::vector<double> > mi_precursor_combined_matrix_;
     //@}
 
+    /// standardized fragment ion traces, keyed by native id
+    std::map<String, std::vector<double> > normalized_fragment_traces_;
+
+    /// standardized precursor traces, keyed by precursor id
+    std::map<String, std::vector<double> > normalized_precursor_traces_;
+
   };
 }
 
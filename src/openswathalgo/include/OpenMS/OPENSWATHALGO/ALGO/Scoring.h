@@ -119,6 +119,15 @@ public:
     OPENSWATHALGO_DLLAPI XCorrArrayType normalizedCrossCorrelation(std::vector<double>& data1,
                                                                    std::vector<double>& data2, const int& maxdelay, const int& lag);
 
+    /** @brief Calculate crosscorrelation on std::vector data that is already standardized
+
+      Same as normalizedCrossCorrelation() but expects that standardize_data()
+      has been applied to both inputs, which allows callers to standardize
+      each chromatogram once and correlate it against many others.
+    */
+    OPENSWATHALGO_DLLAPI XCorrArrayType normalizedCrossCorrelationPost(const std::vector<double>& normalized_data1,
+                                                                       const std::vector<double>& normalized_data2, const int maxdelay, const int lag);
+
     /// Calculate crosscorrelation on std::vector data without normalization
     OPENSWATHALGO_DLLAPI XCorrArrayType calculateCrossCorrelation(const std::vector<double>& data1,
                                                                   const std::vector<double>& data2, const int& maxdelay, const int& lag);
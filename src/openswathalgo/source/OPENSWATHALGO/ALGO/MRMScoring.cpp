@@ -64,130 +64,141 @@ namespace OpenSwath
     return xcorr_precursor_combined_matrix_;
   }
 
+  namespace
+  {
+    /// Cross-correlation of (b, a) derived from the one of (a, b), i.e. the same values at negated delays
+    MRMScoring::XCorrArrayType mirrorXCorrArray(const MRMScoring::XCorrArrayType& array)
+    {
+      MRMScoring::XCorrArrayType result;
+      result.data.reserve(array.data.size());
+      for (std::vector<Scoring::XCorrEntry>::const_reverse_iterator it = array.data.rbegin(); it != array.data.rend(); ++it)
+      {
+        result.data.push_back(std::make_pair(-it->first, it->second));
+      }
+      return result;
+    }
+  }
+
+  void MRMScoring::clearNormalizedIntensities_()
+  {
+    normalized_fragment_traces_.clear();
+    normalized_precursor_traces_.clear();
+  }
+
+  const std::vector<double>& MRMScoring::getNormalizedIntensity_(OpenSwath::IMRMFeature* mrmfeature, const String& id, bool is_precursor)
+  {
+    std::map<String, std::vector<double> >& traces = is_precursor ? normalized_precursor_traces_ : normalized_fragment_traces_;
+    std::map<String, std::vector<double> >::iterator it = traces.find(id);
+    if (it != traces.end())
+    {
+      return it->second;
+    }
+
+    std::vector<double>& intensity = traces[id];
+    FeatureType f = is_precursor ? mrmfeature->getPrecursorFeature(id) : mrmfeature->getFeature(id);
+    f->getIntensity(intensity);
+    Scoring::standardize_data(intensity);
+    return intensity;
+  }
+
   void MRMScoring::initializeXCorrMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
+    clearNormalizedIntensities_();
     xcorr_matrix_.resize(native_ids.size());
     for (std::size_t i = 0; i < native_ids.size(); i++)
     {
-      String native_id = native_ids[i];
-      FeatureType fi = mrmfeature->getFeature(native_id);
+      const std::vector<double>& intensityi = getNormalizedIntensity_(mrmfeature, native_ids[i], false);
       xcorr_matrix_[i].resize(native_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
       for (std::size_t j = i; j < native_ids.size(); j++)
       {
-        String native_id2 = native_ids[j];
-        FeatureType fj = mrmfeature->getFeature(native_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
+        const std::vector<double>& intensityj = getNormalizedIntensity_(mrmfeature, native_ids[j], false);
         // compute normalized cross correlation
-        xcorr_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
+        xcorr_matrix_[i][j] = Scoring::normalizedCrossCorrelationPost(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
       }
     }
   }
 
   void MRMScoring::initializeXCorrContrastMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& native_ids_set1, const std::vector<String>& native_ids_set2)
   {
-    std::vector<double> intensityi, intensityj;
+    clearNormalizedIntensities_();
     xcorr_contrast_matrix_.resize(native_ids_set1.size());
     for (std::size_t i = 0; i < native_ids_set1.size(); i++)
     { 
-      String native_id = native_ids_set1[i];
-      FeatureType fi = mrmfeature->getFeature(native_id);
+      const std::vector<double>& intensityi = getNormalizedIntensity_(mrmfeature, native_ids_set1[i], false);
       xcorr_contrast_matrix_[i].resize(native_ids_set2.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
       for (std::size_t j = 0; j < native_ids_set2.size(); j++)
       {
-        String native_id2 = native_ids_set2[j];
-        FeatureType fj = mrmfeature->getFeature(native_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
+        const std::vector<double>& intensityj = getNormalizedIntensity_(mrmfeature, native_ids_set2[j], false);
         // compute normalized cross correlation
-        xcorr_contrast_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
+        xcorr_contrast_matrix_[i][j] = Scoring::normalizedCrossCorrelationPost(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
       }
     }
   }
 
   void MRMScoring::initializeXCorrPrecursorMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids)
   {
-    std::vector<double> intensityi, intensityj;
+    clearNormalizedIntensities_();
     xcorr_precursor_matrix_.resize(precursor_ids.size());
     for (std::size_t i = 0; i < precursor_ids.size(); i++)
     {
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
+      const std::vector<double>& intensityi = getNormalizedIntensity_(mrmfeature, precursor_ids[i], true);
       xcorr_precursor_matrix_[i].resize(precursor_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
       for (std::size_t j = i; j < precursor_ids.size(); j++)
       {
-        String precursor_id2 = precursor_ids[j];
-        FeatureType fj = mrmfeature->getPrecursorFeature(precursor_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
+        const std::vector<double>& intensityj = getNormalizedIntensity_(mrmfeature, precursor_ids[j], true);
         // compute normalized cross correlation
-        xcorr_precursor_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
+        xcorr_precursor_matrix_[i][j] = Scoring::normalizedCrossCorrelationPost(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
       }
     }
   }
 
   void MRMScoring::initializeXCorrPrecursorContrastMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
+    clearNormalizedIntensities_();
     xcorr_precursor_contrast_matrix_.resize(precursor_ids.size());
     for (std::size_t i = 0; i < precursor_ids.size(); i++)
     { 
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
+      const std::vector<double>& intensityi = getNormalizedIntensity_(mrmfeature, precursor_ids[i], true);
       xcorr_precursor_contrast_matrix_[i].resize(native_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
       for (std::size_t j = 0; j < native_ids.size(); j++)
       {
-        String native_id = native_ids[j];
-        FeatureType fj = mrmfeature->getFeature(native_id);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
+        const std::vector<double>& intensityj = getNormalizedIntensity_(mrmfeature, native_ids[j], false);
         // compute normalized cross correlation
-        xcorr_precursor_contrast_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
+        xcorr_precursor_contrast_matrix_[i][j] = Scoring::normalizedCrossCorrelationPost(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
       }
     }
   }
 
   void MRMScoring::initializeXCorrPrecursorCombinedMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    std::vector<FeatureType> features;
-
+    clearNormalizedIntensities_();
+    std::vector<const std::vector<double>*> intensities;
     for (std::size_t i = 0; i < precursor_ids.size(); i++)
     { 
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      features.push_back(fi);
+      intensities.push_back(&getNormalizedIntensity_(mrmfeature, precursor_ids[i], true));
     }
     for (std::size_t j = 0; j < native_ids.size(); j++)
     {
-      String native_id = native_ids[j];
-      FeatureType fj = mrmfeature->getFeature(native_id);
-      features.push_back(fj);
+      intensities.push_back(&getNormalizedIntensity_(mrmfeature, native_ids[j], false));
     }
 
-    xcorr_precursor_combined_matrix_.resize(features.size());
-    for (std::size_t i = 0; i < features.size(); i++)
+    xcorr_precursor_combined_matrix_.resize(intensities.size());
+    for (std::size_t i = 0; i < intensities.size(); i++)
+    {
+      xcorr_precursor_combined_matrix_[i].resize(intensities.size());
+    }
+    for (std::size_t i = 0; i < intensities.size(); i++)
     { 
-      FeatureType fi = features[i];
-      xcorr_precursor_combined_matrix_[i].resize(features.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < features.size(); j++)
-      {
-        FeatureType fj = features[j];
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute normalized cross correlation
-        xcorr_precursor_combined_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
+      const std::vector<double>& intensityi = *intensities[i];
+      for (std::size_t j = i; j < intensities.size(); j++)
+      {
+        // compute normalized cross correlation; the lower triangle holds the
+        // same sums at negated delays and is mirrored instead of recomputed
+        xcorr_precursor_combined_matrix_[i][j] = Scoring::normalizedCrossCorrelationPost(intensityi, *intensities[j], boost::numeric_cast<int>(intensityi.size()), 1);
+        if (j != i)
+        {
+          xcorr_precursor_combined_matrix_[j][i] = mirrorXCorrArray(xcorr_precursor_combined_matrix_[i][j]);
+        }
       }
     }
   }
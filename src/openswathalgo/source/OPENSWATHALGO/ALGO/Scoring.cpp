@@ -34,6 +34,7 @@
 
 #include <OpenMS/OPENSWATHALGO/ALGO/Scoring.h>
 #include <OpenMS/OPENSWATHALGO/Macros.h>
+#include <algorithm>
 #include <cmath>
 
 #include <boost/numeric/conversion/cast.hpp>
@@ -155,10 +156,18 @@ namespace OpenSwath
       // normalize the data
       standardize_data(data1);
       standardize_data(data2);
-      XCorrArrayType result = calculateCrossCorrelation(data1, data2, maxdelay, lag);
+      return normalizedCrossCorrelationPost(data1, data2, maxdelay, lag);
+    }
+
+    XCorrArrayType normalizedCrossCorrelationPost(const std::vector<double>& normalized_data1,
+                                                  const std::vector<double>& normalized_data2, const int maxdelay, const int lag)
+    {
+      OPENSWATH_PRECONDITION(normalized_data1.size() != 0 && normalized_data1.size() == normalized_data2.size(), "Both data vectors need to have the same length");
+
+      XCorrArrayType result = calculateCrossCorrelation(normalized_data1, normalized_data2, maxdelay, lag);
       for (XCorrArrayType::iterator it = result.begin(); it != result.end(); ++it)
       {
-        it->second = it->second / data1.size();
+        it->second = it->second / normalized_data1.size();
       }
       return result;
     }
@@ -171,19 +180,20 @@ namespace OpenSwath
       XCorrArrayType result;
       result.data.reserve( (size_t)std::ceil((2*maxdelay + 1) / lag));
       int datasize = boost::numeric_cast<int>(data1.size());
-      int i, j, delay;
+      const double* x = &data1[0];
+      const double* y = &data2[0];
 
-      for (delay = -maxdelay; delay <= maxdelay; delay = delay + lag)
+      for (int delay = -maxdelay; delay <= maxdelay; delay = delay + lag)
       {
+        // only indices i with 0 <= i + delay < datasize contribute; computing
+        // that range up front keeps the inner loop free of branches (the
+        // summation order, and thus the result, is the same as before)
+        int i_begin = std::max(0, -delay);
+        int i_end = std::min(datasize, datasize - delay);
         double sxy = 0;
-        for (i = 0; i < datasize; ++i)
+        for (int i = i_begin; i < i_end; ++i)
         {
-          j = i + delay;
-          if (j < 0 || j >= datasize)
-          {
-            continue;
-          }
-          sxy += (data1[i]) * (data2[j]);
+          sxy += x[i] * y[i + delay];
         }
         result.data.push_back(std::make_pair(delay, sxy));
       }
@@ -29,7 +29,7 @@ cdef extern from "<OpenMS/CHEMISTRY/ModificationsDB.h>" namespace "OpenMS":
 
         bool has(String modification) nogil except +
 
-        void addModification(ResidueModification * new_mod) nogil except +
+        const ResidueModification * addModification(ResidueModification * new_mod) nogil except +
 
         Size findModificationIndex(const String & mod_name) nogil except +
 
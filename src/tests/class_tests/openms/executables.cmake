@@ -110,6 +110,7 @@ set(metadata_executables_list
   Product_test
   ProteinHit_test
   ProteinIdentification_test
+  PSMTable_test
   SampleTreatment_test
   Sample_test
   ScanWindow_test
@@ -138,6 +139,7 @@ set(kernel_executables_list
   ComparatorUtils_test
   ConsensusFeature_test
   ConsensusMap_test
+  ColumnarSpectrum_test
   ConversionHelper_test
   ConstRefVector_test
   DPeak_test
@@ -183,6 +185,7 @@ set(format_executables_list
   GzipIfstream_test
   GzipInputStream_test
   IBSpectraFile_test
+  IdBinaryFile_test
   IdXMLFile_test
   IndexedMzMLDecoder_test
   IndexedMzMLFile_test
@@ -259,6 +262,8 @@ set(format_executables_list
   MSDataChainingConsumer_test
   MSDataStoringConsumer_test
   MSDataAggregatingConsumer_test
+  FeatureXMLWritingConsumer_test
+  ConsensusXMLWritingConsumer_test
   SpectrumAccessQuadMZTransforming_test
   SpectrumAccessSqMass_test
   SiriusFragmentAnnotation_test
@@ -344,6 +349,7 @@ set(filtering_executables_list
   Scaler_test
   SignalToNoiseEstimatorMeanIterative_test
   SignalToNoiseEstimatorMedian_test
+  SignalToNoiseEstimatorMedianIncremental_test
   SignalToNoiseEstimatorMedianRapid_test
   SignalToNoiseEstimator_test
   SqrtMower_test
@@ -381,6 +387,7 @@ set(comparison_executables_list
 set(chemistry_executables_list
   AAIndex_test
   AASequence_test
+  AASequencePool_test
   CoarseIsotopeDistribution_test
   CrossLinksDB_test
   DigestionEnzymeProtein_test
@@ -513,6 +520,8 @@ set(analysis_executables_list
   ModifiedPeptideGenerator_test
   OfflinePrecursorIonSelection_test
   PeptideIndexing_test
+  FragmentIndex_test
+  PeptideDatabase_test
   PeptideAndProteinQuant_test
   PeakIntensityPredictor_test
   PScore_test
@@ -0,0 +1,241 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/CHEMISTRY/AASequencePool.h>
+///////////////////////////
+
+#include <unordered_set>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(AASequencePool, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+AASequencePool* ptr = nullptr;
+AASequencePool* null_ptr = nullptr;
+START_SECTION((AASequencePool()))
+{
+  ptr = new AASequencePool();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->size(), 0)
+}
+END_SECTION
+
+START_SECTION((~AASequencePool()))
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((InternedAASequence fromString(const String& s, bool permissive = true)))
+{
+  AASequencePool pool;
+  InternedAASequence seq1 = pool.fromString("PEPTM(Oxidation)IDE");
+  InternedAASequence seq2 = pool.fromString("PEPTM(Oxidation)IDE");
+  InternedAASequence seq3 = pool.fromString("PEPTM(UniMod:35)IDE"); // different notation, same sequence
+  InternedAASequence seq4 = pool.fromString("PEPTMIDE");
+  TEST_EQUAL(pool.size(), 2)
+  TEST_EQUAL(seq1 == seq2, true)
+  TEST_EQUAL(seq1 == seq3, true)
+  TEST_EQUAL(seq1 != seq4, true)
+  TEST_EQUAL(&seq1.getSequence(), &seq3.getSequence())
+  TEST_EQUAL(seq1.getSequence() == AASequence::fromString("PEPTM(Oxidation)IDE"), true)
+  TEST_STRING_EQUAL(seq3.toString(), "PEPTM(Oxidation)IDE")
+
+  TEST_EQUAL(pool.fromString("").empty(), true)
+  TEST_EQUAL(pool.fromString("") == InternedAASequence(), true)
+
+  TEST_EXCEPTION(Exception::ParseError, pool.fromString("blDABCDEF"))
+  TEST_EQUAL(pool.size(), 2)
+}
+END_SECTION
+
+START_SECTION((InternedAASequence intern(const AASequence& seq)))
+{
+  AASequencePool pool;
+  AASequence aas = AASequence::fromString(".(Acetyl)PEPTIDEK.(Amidated)");
+  InternedAASequence seq1 = pool.intern(aas);
+  InternedAASequence seq2 = pool.fromString(aas.toString());
+  TEST_EQUAL(pool.size(), 1)
+  TEST_EQUAL(&seq1.getSequence(), &seq2.getSequence())
+  TEST_EQUAL(seq1.getSequence() == aas, true)
+  TEST_EQUAL(seq1.size(), 8)
+}
+END_SECTION
+
+START_SECTION((Size size() const))
+{
+  AASequencePool pool;
+  pool.fromString("PEPTIDE");
+  pool.fromString("PEPTIDER");
+  pool.fromString("PEPTIDE");
+  TEST_EQUAL(pool.size(), 2)
+}
+END_SECTION
+
+START_SECTION((void clear()))
+{
+  AASequencePool pool;
+  pool.fromString("PEPTIDE");
+  pool.intern(AASequence::fromString("PEPTIDER"));
+  pool.clear();
+  TEST_EQUAL(pool.size(), 0)
+  TEST_EQUAL(pool.fromString("PEPTIDE").toString(), "PEPTIDE")
+  TEST_EQUAL(pool.size(), 1)
+}
+END_SECTION
+
+START_SECTION(([InternedAASequence] InternedAASequence()))
+{
+  InternedAASequence seq;
+  TEST_EQUAL(seq.empty(), true)
+  TEST_EQUAL(seq.size(), 0)
+  TEST_STRING_EQUAL(seq.toString(), "")
+}
+END_SECTION
+
+START_SECTION(([InternedAASequence] std::size_t hash() const))
+{
+  AASequencePool pool;
+  InternedAASequence seq1 = pool.fromString("PEPTIDE");
+  TEST_EQUAL(seq1.hash(), std::hash<std::string>()("PEPTIDE"))
+
+  unordered_set<InternedAASequence> seqs;
+  seqs.insert(seq1);
+  seqs.insert(pool.fromString("PEPTIDE"));
+  seqs.insert(pool.fromString("PEPTIDER"));
+  TEST_EQUAL(seqs.size(), 2)
+}
+END_SECTION
+
+START_SECTION(([InternedAASequence] bool operator<(const InternedAASequence& rhs) const))
+{
+  AASequencePool pool;
+  InternedAASequence seq1 = pool.fromString("PEPTIDE"), seq2 = pool.fromString("PEPTIDER");
+  TEST_EQUAL(seq1 < seq2, true)
+  TEST_EQUAL(seq2 < seq1, false)
+  TEST_EQUAL(seq1 < seq1, false)
+}
+END_SECTION
+
+START_SECTION(([InternedAASequence] double getMonoWeight(Residue::ResidueType type = Residue::Full, Int charge = 0) const))
+{
+  AASequencePool pool;
+  const char* sequences[] = {"PEPTIDE", "PEPTM(Oxidation)IDE", ".(Acetyl)PEPTIDEK.(Amidated)", "DFPIANGER"};
+  Residue::ResidueType types[] = {Residue::Full, Residue::Internal, Residue::NTerminal, Residue::CTerminal, Residue::AIon, Residue::BIon, Residue::CIon, Residue::XIon, Residue::YIon, Residue::ZIon};
+  for (Size i = 0; i < 4; ++i)
+  {
+    AASequence aas = AASequence::fromString(sequences[i]);
+    InternedAASequence seq = pool.fromString(sequences[i]);
+    for (Size t = 0; t < 10; ++t)
+    {
+      for (Int charge = 0; charge <= 2; ++charge)
+      {
+        TEST_REAL_SIMILAR(seq.getMonoWeight(types[t], charge), aas.getMonoWeight(types[t], charge))
+      }
+    }
+  }
+
+  TEST_EXCEPTION(Exception::InvalidValue, pool.fromString("PEPTXDE").getMonoWeight())
+}
+END_SECTION
+
+START_SECTION(([InternedAASequence] double getPrefixMonoWeight(Size length, Residue::ResidueType type = Residue::BIon, Int charge = 0) const))
+{
+  AASequencePool pool;
+  AASequence aas = AASequence::fromString(".(Acetyl)PEPTM(Oxidation)IDEK.(Amidated)");
+  InternedAASequence seq = pool.intern(aas);
+  for (Size length = 1; length <= aas.size(); ++length)
+  {
+    TEST_REAL_SIMILAR(seq.getPrefixMonoWeight(length), aas.getPrefix(length).getMonoWeight(Residue::BIon))
+    TEST_REAL_SIMILAR(seq.getPrefixMonoWeight(length, Residue::AIon, 2), aas.getPrefix(length).getMonoWeight(Residue::AIon, 2))
+    TEST_REAL_SIMILAR(seq.getPrefixMonoWeight(length, Residue::Full), aas.getPrefix(length).getMonoWeight(Residue::Full))
+  }
+  TEST_EXCEPTION(Exception::IndexOverflow, seq.getPrefixMonoWeight(aas.size() + 1))
+}
+END_SECTION
+
+START_SECTION(([InternedAASequence] double getSuffixMonoWeight(Size length, Residue::ResidueType type = Residue::YIon, Int charge = 0) const))
+{
+  AASequencePool pool;
+  AASequence aas = AASequence::fromString(".(Acetyl)PEPTM(Oxidation)IDEK.(Amidated)");
+  InternedAASequence seq = pool.intern(aas);
+  for (Size length = 1; length <= aas.size(); ++length)
+  {
+    TEST_REAL_SIMILAR(seq.getSuffixMonoWeight(length), aas.getSuffix(length).getMonoWeight(Residue::YIon))
+    TEST_REAL_SIMILAR(seq.getSuffixMonoWeight(length, Residue::XIon, 2), aas.getSuffix(length).getMonoWeight(Residue::XIon, 2))
+    TEST_REAL_SIMILAR(seq.getSuffixMonoWeight(length, Residue::Full), aas.getSuffix(length).getMonoWeight(Residue::Full))
+  }
+  TEST_EXCEPTION(Exception::IndexOverflow, seq.getSuffixMonoWeight(aas.size() + 1))
+}
+END_SECTION
+
+START_SECTION(([InternedAASequence] const EmpiricalFormula& getFormula() const))
+{
+  AASequencePool pool;
+  InternedAASequence seq = pool.fromString("PEPTM(Oxidation)IDE");
+  TEST_EQUAL(seq.getFormula(), AASequence::fromString("PEPTM(Oxidation)IDE").getFormula())
+  TEST_EXCEPTION(Exception::InvalidValue, pool.fromString("PEPTXDE").getFormula())
+}
+END_SECTION
+
+START_SECTION(([InternedAASequence] const std::vector<double>& getPrefixMasses() const))
+{
+  AASequencePool pool;
+  AASequence aas = AASequence::fromString(".(Acetyl)PEPTM(Oxidation)IDEK.(Amidated)");
+  const vector<double>& prefix_masses = pool.intern(aas).getPrefixMasses();
+  TEST_EQUAL(prefix_masses.size(), aas.size() + 1)
+  ABORT_IF(prefix_masses.size() != aas.size() + 1)
+  TEST_REAL_SIMILAR(prefix_masses[0], 0.0)
+  for (Size i = 0; i < aas.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(prefix_masses[i + 1] - prefix_masses[i], aas[i].getMonoWeight(Residue::Internal))
+  }
+
+  // no masses for residues of unknown mass
+  TEST_EQUAL(pool.fromString("PEPTXDE").getPrefixMasses().empty(), true)
+  TEST_EQUAL(InternedAASequence().getPrefixMasses().size(), 1)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -1506,6 +1506,22 @@ START_SECTION([EXTRA] multithreaded example)
     test += aa.size();
   }
   TEST_EQUAL(test, nr_iterations*11)
+
+  // the same unknown modifications parsed concurrently must resolve to a
+  // single registered instance each
+  int mismatches = 0;
+  const AASequence reference = AASequence::fromString(".[+1234.5]TEST[+2345.6]PEPTIDE.[+3456.7]");
+#pragma omp parallel for reduction (+: mismatches)
+  for (int k = 0; k < nr_iterations; k++)
+  {
+    auto aa = AASequence::fromString(".[+" + String(1000 + k % 7) + ".25]TEST[+" + String(2000 + k % 7) + ".25]PEPTIDE.[+" + String(3000 + k % 7) + ".25]");
+    auto again = AASequence::fromString(".[+" + String(1000 + k % 7) + ".25]TEST[+" + String(2000 + k % 7) + ".25]PEPTIDE.[+" + String(3000 + k % 7) + ".25]");
+    if (aa.getNTerminalModification() != again.getNTerminalModification()) ++mismatches;
+    if (aa.getCTerminalModification() != again.getCTerminalModification()) ++mismatches;
+    if (aa[3].getModification() != again[3].getModification()) ++mismatches;
+  }
+  TEST_EQUAL(mismatches, 0)
+  TEST_EQUAL(reference.getNTerminalModification() == AASequence::fromString(".[+1234.5]PEPTIDE").getNTerminalModification(), true)
 }
 END_SECTION
 
@@ -42,6 +42,11 @@
 ///////////////////////////
 
 #include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
+
+#include <QtCore/QByteArray>
+
+#include <cstdlib>
 
 using namespace std;
 
@@ -195,6 +200,152 @@ START_SECTION((template < typename ToType > void decode(const String &in, ByteOr
 }
 END_SECTION
 
+START_SECTION((template <typename FromType, typename ToType> void decodeAndConvert(const String &in, ByteOrder from_byte_order, std::vector<ToType> &out, bool zlib_compression=false)))
+  TOLERANCE_ABSOLUTE(0.001)
+{
+  Base64 b64;
+  String src;
+  std::vector<double> res;
+
+  b64.decodeAndConvert<float>(src, Base64::BYTEORDER_BIGENDIAN, res);
+  TEST_EQUAL(res.size(), 0)
+
+  // 32 bit big endian floats widened to double
+  src = "Q+vIuEec9YBD7TgoR/HTgEPt23hHA8UA";
+  b64.decodeAndConvert<float>(src, Base64::BYTEORDER_BIGENDIAN, res);
+  TEST_EQUAL(res.size(), 6)
+  TEST_REAL_SIMILAR(res[0], 471.568)
+  TEST_REAL_SIMILAR(res[1], 80363)
+  TEST_REAL_SIMILAR(res[2], 474.439)
+  TEST_REAL_SIMILAR(res[3], 123815)
+  TEST_REAL_SIMILAR(res[4], 475.715)
+  TEST_REAL_SIMILAR(res[5], 33733)
+
+  // 32 bit little endian floats widened to double
+  src = "JhOWQ8b/l0PMTJhD";
+  b64.decodeAndConvert<float>(src, Base64::BYTEORDER_LITTLEENDIAN, res);
+  TEST_EQUAL(res.size(), 3)
+  TEST_REAL_SIMILAR(res[0], 300.15)
+  TEST_REAL_SIMILAR(res[1], 303.998)
+  TEST_REAL_SIMILAR(res[2], 304.6)
+
+  // zlib compressed input
+  std::vector<float> data;
+  data.push_back(300.15f);
+  data.push_back(303.998f);
+  data.push_back(304.6f);
+  b64.encode(data, Base64::BYTEORDER_LITTLEENDIAN, src, true);
+  b64.decodeAndConvert<float>(src, Base64::BYTEORDER_LITTLEENDIAN, res, true);
+  TEST_EQUAL(res.size(), 3)
+  TEST_REAL_SIMILAR(res[0], 300.15)
+  TEST_REAL_SIMILAR(res[1], 303.998)
+  TEST_REAL_SIMILAR(res[2], 304.6)
+
+  // line breaks inside the data are skipped (slow path)
+  src = "JhOW\nQ8b/\nl0PM\nTJhD";
+  b64.decodeAndConvert<float>(src, Base64::BYTEORDER_LITTLEENDIAN, res);
+  TEST_EQUAL(res.size(), 3)
+  TEST_REAL_SIMILAR(res[0], 300.15)
+  TEST_REAL_SIMILAR(res[1], 303.998)
+  TEST_REAL_SIMILAR(res[2], 304.6)
+}
+END_SECTION
+
+START_SECTION([EXTRA] decoding of long arrays)
+{
+  // long enough to run through the vectorized decoder and the scalar tail
+  Base64 b64;
+  String str;
+  for (Size n = 1; n < 200; n += 7)
+  {
+    std::vector<double> data_double, res_double;
+    std::vector<float> data, res;
+    for (Size i = 0; i < n; ++i)
+    {
+      data_double.push_back(100.0 + i * 0.123456789);
+      data.push_back(100.0f + i * 0.5f);
+    }
+    b64.encode(data_double, Base64::BYTEORDER_LITTLEENDIAN, str);
+    b64.decode(str, Base64::BYTEORDER_LITTLEENDIAN, res_double);
+    TEST_EQUAL(res_double == data_double, true)
+    b64.encode(data_double, Base64::BYTEORDER_BIGENDIAN, str);
+    b64.decode(str, Base64::BYTEORDER_BIGENDIAN, res_double);
+    TEST_EQUAL(res_double == data_double, true)
+    b64.encode(data, Base64::BYTEORDER_LITTLEENDIAN, str);
+    b64.decode(str, Base64::BYTEORDER_LITTLEENDIAN, res);
+    TEST_EQUAL(res == data, true)
+  }
+}
+END_SECTION
+
+START_SECTION((static void setVectorizedDecoding(bool enabled)))
+{
+  // the scalar decoder has to give the same results as the vectorized one
+  Base64 b64;
+  String str;
+  std::vector<double> data, res_vectorized, res_scalar;
+  for (Size n = 1; n < 200; n += 7)
+  {
+    data.push_back(100.0 + n * 0.123456789);
+    b64.encode(data, Base64::BYTEORDER_LITTLEENDIAN, str);
+    Base64::setVectorizedDecoding(true);
+    b64.decode(str, Base64::BYTEORDER_LITTLEENDIAN, res_vectorized);
+    Base64::setVectorizedDecoding(false);
+    b64.decode(str, Base64::BYTEORDER_LITTLEENDIAN, res_scalar);
+    TEST_EQUAL(res_scalar == data, true)
+    TEST_EQUAL(res_scalar == res_vectorized, true)
+    b64.encode(data, Base64::BYTEORDER_BIGENDIAN, str);
+    b64.decode(str, Base64::BYTEORDER_BIGENDIAN, res_scalar);
+    TEST_EQUAL(res_scalar == data, true)
+  }
+  // padding and characters outside of the alphabet
+  std::vector<String> strings;
+  b64.decodeStrings("QUJDREU=", strings);
+  TEST_EQUAL(strings.size(), 1)
+  TEST_EQUAL(strings[0], "ABCDE")
+  b64.decodeStrings("QUJDRA==", strings);
+  TEST_EQUAL(strings.size(), 1)
+  TEST_EQUAL(strings[0], "ABCD")
+  b64.decodeStrings("QUJD\nREVG", strings);
+  TEST_EQUAL(strings.size(), 1)
+  TEST_EQUAL(strings[0], "ABCDEF")
+  Base64::setVectorizedDecoding(true);
+}
+END_SECTION
+
+START_SECTION([EXTRA] decoding throughput)
+{
+  // not a real test, but reports the decoding speed for large arrays;
+  // only run on request as it takes a while
+  if (getenv("OPENMS_TEST_BENCHMARKS") == nullptr)
+  {
+    STATUS("skipped, set OPENMS_TEST_BENCHMARKS to run")
+  }
+  else
+  {
+    Base64 b64;
+    String str;
+    std::vector<double> data(1000000), res;
+    for (Size i = 0; i < data.size(); ++i) data[i] = 100.0 + i * 0.001;
+    b64.encode(data, Base64::BYTEORDER_LITTLEENDIAN, str);
+
+    for (Size vectorized = 0; vectorized < 2; ++vectorized)
+    {
+      Base64::setVectorizedDecoding(vectorized == 1);
+      StopWatch sw;
+      sw.start();
+      for (Size i = 0; i < 10; ++i)
+      {
+        b64.decode(str, Base64::BYTEORDER_LITTLEENDIAN, res);
+      }
+      sw.stop();
+      STATUS("Base64::decode (" << (vectorized == 1 ? "vectorized" : "scalar") << "): " << (10.0 * str.size() / 1024.0 / 1024.0) / std::max(sw.getClockTime(), 1e-9) << " MB/s")
+      TEST_EQUAL(res == data, true)
+    }
+  }
+}
+END_SECTION
+
 START_SECTION([EXTRA] zlib functionality)
 {
   TOLERANCE_ABSOLUTE(0.001)
@@ -43,6 +43,9 @@
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
 
+#include <cstring>
+#include <limits>
+
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wshadow"
 
@@ -412,6 +415,95 @@ START_SECTION( static inline void readChromatogramFast(OpenSwath::BinaryDataArra
 }
 END_SECTION
 
+START_SECTION(( static std::vector<OpenSwath::BinaryDataArrayPtr> readSpectrumFast(const char* buffer, Size buffer_size, Size offset, int& ms_level, double& rt) ))
+{
+  std::ifstream ifs_(tmp_filename.c_str(), std::ios::binary);
+  std::string buffer((std::istreambuf_iterator<char>(ifs_)), std::istreambuf_iterator<char>());
+  std::vector<std::streampos> spectra_index = cache_.getSpectraIndex();
+
+  for (Size i = 0; i < spectra_index.size(); i++)
+  {
+    int ms_level = -1;
+    double rt = -1.0;
+    std::vector<OpenSwath::BinaryDataArrayPtr> darray = CachedMzMLHandler::readSpectrumFast(buffer.data(), buffer.size(), 
+        static_cast<std::streamoff>(spectra_index[i]), ms_level, rt);
+    TEST_EQUAL(darray.size(), 2 + exp.getSpectrum(i).getFloatDataArrays().size())
+    TEST_EQUAL(darray[0]->data.size(), exp.getSpectrum(i).size())
+    TEST_EQUAL(ms_level, exp.getSpectrum(i).getMSLevel())
+    TEST_REAL_SIMILAR(rt, exp.getSpectrum(i).getRT())
+    for (Size k = 0; k < darray[0]->data.size(); k++)
+    {
+      TEST_REAL_SIMILAR(darray[0]->data[k], exp.getSpectrum(i)[k].getMZ())
+      TEST_REAL_SIMILAR(darray[1]->data[k], exp.getSpectrum(i)[k].getIntensity())
+    }
+  }
+
+  // should not read after the buffer ends
+  int ms_level = -1;
+  double rt = -1.0;
+  TEST_EXCEPTION(Exception::ParseError, CachedMzMLHandler::readSpectrumFast(buffer.data(), buffer.size(), buffer.size() + 1, ms_level, rt))
+  TEST_EXCEPTION(Exception::ParseError, CachedMzMLHandler::readSpectrumFast(buffer.data(), buffer.size(), buffer.size() - 4, ms_level, rt))
+
+  // a corrupt peak count must be reported as a parse error (not a failed allocation)
+  std::string corrupt = buffer;
+  Size huge_size = std::numeric_limits<Size>::max() / 8;
+  std::memcpy(&corrupt[static_cast<std::streamoff>(spectra_index[0])], &huge_size, sizeof(huge_size));
+  TEST_EXCEPTION(Exception::ParseError, CachedMzMLHandler::readSpectrumFast(corrupt.data(), corrupt.size(),
+        static_cast<std::streamoff>(spectra_index[0]), ms_level, rt))
+  TEST_EXCEPTION(Exception::ParseError, CachedMzMLHandler::readSpectrumView(corrupt.data(), corrupt.size(),
+        static_cast<std::streamoff>(spectra_index[0])))
+}
+END_SECTION
+
+START_SECTION(( static SpectrumView readSpectrumView(const char* buffer, Size buffer_size, Size offset) ))
+{
+  std::ifstream ifs_(tmp_filename.c_str(), std::ios::binary);
+  std::string buffer((std::istreambuf_iterator<char>(ifs_)), std::istreambuf_iterator<char>());
+  std::vector<std::streampos> spectra_index = cache_.getSpectraIndex();
+
+  for (Size i = 0; i < spectra_index.size(); i++)
+  {
+    CachedMzMLHandler::SpectrumView view = CachedMzMLHandler::readSpectrumView(buffer.data(), buffer.size(),
+        static_cast<std::streamoff>(spectra_index[i]));
+    TEST_EQUAL(view.mz.getSize(), exp.getSpectrum(i).size())
+    TEST_EQUAL(view.intensity.getSize(), exp.getSpectrum(i).size())
+    TEST_EQUAL(view.ms_level, exp.getSpectrum(i).getMSLevel())
+    for (Size k = 0; k < view.mz.getSize(); k++)
+    {
+      TEST_REAL_SIMILAR(view.mz[k], exp.getSpectrum(i)[k].getMZ())
+      TEST_REAL_SIMILAR(view.intensity[k], exp.getSpectrum(i)[k].getIntensity())
+    }
+  }
+
+  TEST_EXCEPTION(Exception::ParseError, CachedMzMLHandler::readSpectrumView(buffer.data(), buffer.size(), buffer.size() - 4))
+}
+END_SECTION
+
+START_SECTION(( static ChromatogramView readChromatogramView(const char* buffer, Size buffer_size, Size offset) ))
+{
+  std::ifstream ifs_(tmp_filename.c_str(), std::ios::binary);
+  std::string buffer((std::istreambuf_iterator<char>(ifs_)), std::istreambuf_iterator<char>());
+  std::vector<std::streampos> chrom_index = cache_.getChromatogramIndex();
+
+  for (Size i = 0; i < chrom_index.size(); i++)
+  {
+    CachedMzMLHandler::ChromatogramView view = CachedMzMLHandler::readChromatogramView(buffer.data(), buffer.size(),
+        static_cast<std::streamoff>(chrom_index[i]));
+    TEST_EQUAL(view.rt.getSize(), exp.getChromatogram(i).size())
+    for (Size k = 0; k < view.rt.getSize(); k++)
+    {
+      TEST_REAL_SIMILAR(view.rt[k], exp.getChromatogram(i)[k].getRT())
+      TEST_REAL_SIMILAR(view.intensity[k], exp.getChromatogram(i)[k].getIntensity())
+    }
+
+    // the copying reader returns the same data
+    std::vector<OpenSwath::BinaryDataArrayPtr> darray = CachedMzMLHandler::readChromatogramFast(buffer.data(), buffer.size(),
+        static_cast<std::streamoff>(chrom_index[i]));
+    TEST_EQUAL(darray[0]->data.size(), view.rt.getSize())
+  }
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
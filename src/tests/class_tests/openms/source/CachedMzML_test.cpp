@@ -180,6 +180,84 @@ START_SECTION(( [EXTRA] testCaching))
 }
 END_SECTION
 
+START_SECTION(( CachedmzML(const String& filename, bool memory_map) ))
+{
+  CachedmzML cache(tmpf, true);
+  TEST_EQUAL(cache.isMemoryMapped(), true)
+  TEST_EQUAL(cache.getNrSpectra(), 4)
+  TEST_EQUAL(cache.getNrChromatograms(), 2)
+
+  for (int i = 0; i < 4; i++)
+  {
+    // identical except DataProcessing
+    auto tmp1 = cache.getSpectrum(i);
+    auto tmp2 = exp.getSpectrum(i);
+    tmp1.getDataProcessing().clear();
+    tmp2.getDataProcessing().clear();
+    tmp1.getFloatDataArrays().clear();
+    tmp2.getFloatDataArrays().clear();
+    TEST_EQUAL(tmp1 == tmp2, true)
+  }
+  TEST_EQUAL(cache.getSpectrum(1).getFloatDataArrays().size(), 2)
+  TEST_EQUAL(cache.getSpectrum(1).getFloatDataArrays()[1].getName(), "user-defined name")
+
+  for (int i = 0; i < 2; i++)
+  {
+    auto tmp1 = cache.getChromatogram(i);
+    auto tmp2 = exp.getChromatogram(i);
+    tmp1.getDataProcessing().clear();
+    tmp2.getDataProcessing().clear();
+    TEST_EQUAL(tmp1 == tmp2, true)
+  }
+
+  // copies share the mapping
+  CachedmzML cache_copy(cache);
+  TEST_EQUAL(cache_copy.isMemoryMapped(), true)
+  TEST_EQUAL(cache_copy.getSpectrum(0).size(), exp.getSpectrum(0).size())
+
+  TEST_EQUAL(cache_example.isMemoryMapped(), false)
+}
+END_SECTION
+
+START_SECTION(( Internal::CachedMzMLHandler::SpectrumView getSpectrumView(Size id) const ))
+{
+  CachedmzML cache(tmpf, true);
+  for (int i = 0; i < 4; i++)
+  {
+    Internal::CachedMzMLHandler::SpectrumView view = cache.getSpectrumView(i);
+    TEST_EQUAL(view.mz.getSize(), exp.getSpectrum(i).size())
+    TEST_EQUAL(view.intensity.getSize(), exp.getSpectrum(i).size())
+    TEST_EQUAL(view.ms_level, exp.getSpectrum(i).getMSLevel())
+    TEST_REAL_SIMILAR(view.rt, exp.getSpectrum(i).getRT())
+    for (Size k = 0; k < view.mz.getSize(); k++)
+    {
+      TEST_REAL_SIMILAR(view.mz[k], exp.getSpectrum(i)[k].getMZ())
+      TEST_REAL_SIMILAR(view.intensity[k], exp.getSpectrum(i)[k].getIntensity())
+    }
+  }
+
+  TEST_EXCEPTION(Exception::IllegalArgument, cache_example.getSpectrumView(0))
+}
+END_SECTION
+
+START_SECTION(( Internal::CachedMzMLHandler::ChromatogramView getChromatogramView(Size id) const ))
+{
+  CachedmzML cache(tmpf, true);
+  for (int i = 0; i < 2; i++)
+  {
+    Internal::CachedMzMLHandler::ChromatogramView view = cache.getChromatogramView(i);
+    TEST_EQUAL(view.rt.getSize(), exp.getChromatogram(i).size())
+    for (Size k = 0; k < view.rt.getSize(); k++)
+    {
+      TEST_REAL_SIMILAR(view.rt[k], exp.getChromatogram(i)[k].getRT())
+      TEST_REAL_SIMILAR(view.intensity[k], exp.getChromatogram(i)[k].getIntensity())
+    }
+  }
+
+  TEST_EXCEPTION(Exception::IllegalArgument, cache_example.getChromatogramView(0))
+}
+END_SECTION
+
 START_SECTION(( size_t getNrSpectra() const ))
     TEST_EQUAL(cache_example.getNrSpectra(), 4)
 END_SECTION
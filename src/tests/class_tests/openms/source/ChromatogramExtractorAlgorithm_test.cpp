@@ -38,6 +38,7 @@
 #include <OpenMS/test_config.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SimpleOpenMSSpectraAccessFactory.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
 
 using namespace OpenMS;
 using namespace std;
@@ -260,6 +261,104 @@ START_SECTION([EXTRA] void extractChromatograms(const OpenSwath::SpectrumAccessP
 }
 END_SECTION
 
+START_SECTION([EXTRA] void extractChromatograms(const OpenSwath::SpectrumAccessPtr input, std::vector< OpenSwath::ChromatogramPtr > &output, std::vector< ExtractionCoordinates >& extraction_coordinates, double mz_extraction_window, bool ppm, double im_extraction_window, String filter) with bartlett filter)
+{
+  boost::shared_ptr<PeakMap > exp(new PeakMap);
+  MSSpectrum s;
+  s.setRT(1.0);
+  for (int k = 0; k < 5; k++)
+  {
+    s.push_back(Peak1D(100.0 + k * 0.25, 10.0f));
+  }
+  exp->addSpectrum(s);
+  OpenSwath::SpectrumAccessPtr expptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+
+  std::vector< ChromatogramExtractorAlgorithm::ExtractionCoordinates > coordinates;
+  ChromatogramExtractorAlgorithm::ExtractionCoordinates coord;
+  coord.mz = 100.5; coord.rt_start = 0; coord.rt_end = -1; coord.id = "tr1"; coord.ion_mobility = -1;
+  coordinates.push_back(coord);
+
+  ChromatogramExtractorAlgorithm extractor;
+  std::vector< OpenSwath::ChromatogramPtr > out_exp(1, OpenSwath::ChromatogramPtr(new OpenSwath::Chromatogram));
+  extractor.extractChromatograms(expptr, out_exp, coordinates, 1.0, false, -1, "bartlett");
+  TEST_EQUAL(out_exp[0]->getIntensityArray()->data.size(), 1)
+  // peaks at 100.25, 100.5 and 100.75 with weights 0.5, 1.0 and 0.5
+  TEST_REAL_SIMILAR(out_exp[0]->getIntensityArray()->data[0], 20.0)
+
+  out_exp[0] = OpenSwath::ChromatogramPtr(new OpenSwath::Chromatogram);
+  extractor.extractChromatograms(expptr, out_exp, coordinates, 1.0, false, -1, "tophat");
+  TEST_REAL_SIMILAR(out_exp[0]->getIntensityArray()->data[0], 30.0)
+}
+END_SECTION
+
+START_SECTION([EXTRA] extractChromatograms with a large synthetic library)
+{
+  // Compares the merge-based extraction with extract_value_tophat on a
+  // synthetic library of 200k transitions (the results have to be
+  // bit-identical) and reports the run times.
+  const Size nr_transitions = 200000;
+  const Size nr_spectra = 5;
+  const Size nr_peaks = 20000;
+
+  boost::shared_ptr<PeakMap > exp(new PeakMap);
+  for (Size i = 0; i < nr_spectra; i++)
+  {
+    MSSpectrum s;
+    s.setRT(i);
+    for (Size k = 0; k < nr_peaks; k++)
+    {
+      s.push_back(Peak1D(400.0 + k * (800.0 / nr_peaks), (float)((k * 7 + i) % 100)));
+    }
+    exp->addSpectrum(s);
+  }
+  OpenSwath::SpectrumAccessPtr expptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+
+  std::vector< ChromatogramExtractorAlgorithm::ExtractionCoordinates > coordinates(nr_transitions);
+  for (Size k = 0; k < nr_transitions; k++)
+  {
+    coordinates[k].mz = 400.0 + k * (800.0 / nr_transitions) + 0.001 * (k % 3);
+    coordinates[k].rt_start = 0;
+    coordinates[k].rt_end = -1;
+    coordinates[k].ion_mobility = -1;
+  }
+  std::sort(coordinates.begin(), coordinates.end(), ChromatogramExtractorAlgorithm::ExtractionCoordinates::SortExtractionCoordinatesByMZ);
+
+  std::vector< OpenSwath::ChromatogramPtr > out_exp;
+  for (Size k = 0; k < nr_transitions; k++)
+  {
+    out_exp.push_back(OpenSwath::ChromatogramPtr(new OpenSwath::Chromatogram));
+  }
+
+  ChromatogramExtractorAlgorithm extractor;
+  StopWatch sw;
+  sw.start();
+  extractor.extractChromatograms(expptr, out_exp, coordinates, 20, true, -1, "tophat");
+  sw.stop();
+  STATUS("extractChromatograms: " << sw.getClockTime() << " s")
+
+  sw.reset();
+  sw.start();
+  bool all_equal = true;
+  for (Size i = 0; i < nr_spectra; i++)
+  {
+    OpenSwath::SpectrumPtr sptr = expptr->getSpectrumById(i);
+    const std::vector<double>& mz = sptr->getMZArray()->data;
+    const std::vector<double>& intensity = sptr->getIntensityArray()->data;
+    std::vector<double>::const_iterator mz_it = mz.begin();
+    std::vector<double>::const_iterator int_it = intensity.begin();
+    for (Size k = 0; k < nr_transitions; k++)
+    {
+      double integrated_intensity = 0;
+      extractor.extract_value_tophat(mz.begin(), mz_it, mz.end(), int_it, coordinates[k].mz, integrated_intensity, 20, true);
+      if (integrated_intensity != out_exp[k]->getIntensityArray()->data[i]) all_equal = false;
+    }
+  }
+  sw.stop();
+  STATUS("extract_value_tophat: " << sw.getClockTime() << " s")
+  TEST_EQUAL(all_equal, true)
+}
+END_SECTION
+
 ///////////////////////////////////////////////////////////////////////////
 /// Private functions
 ///////////////////////////////////////////////////////////////////////////
@@ -380,8 +479,8 @@ START_SECTION(void extract_value_tophat(const std::vector< double >::const_itera
   // print(sum([0 + i*100.0 for i in range(10)] + 8) )
   TEST_REAL_SIMILAR( integrated_intensity, 4508.0);
   extractor.extract_value_tophat(mz_start, mz_it, mz_it_end, int_it, 400.05,  integrated_intensity, extract_window, false);
-  //print(sum([0 + i*100.0 for i in range(10)]) + sum([900 - i*100.0 for i in range(6)])  )
-  TEST_REAL_SIMILAR( integrated_intensity, 8400.0);
+  //print(sum([0 + i*100.0 for i in range(10)]) + sum([900 - i*100.0 for i in range(6)]) + 8 )
+  TEST_REAL_SIMILAR( integrated_intensity, 8408.0);
   extractor.extract_value_tophat(mz_start, mz_it, mz_it_end, int_it, 400.1, integrated_intensity, extract_window, false);
   //print(sum([0 + i*100.0 for i in range(10)]) + sum([900 - i*100.0 for i in range(10)])  )
   TEST_REAL_SIMILAR( integrated_intensity, 9000.0);
@@ -392,6 +491,9 @@ START_SECTION(void extract_value_tophat(const std::vector< double >::const_itera
   // test the very last value
   extractor.extract_value_tophat(mz_start, mz_it, mz_it_end, int_it, 500.0, integrated_intensity, extract_window, false);
   TEST_REAL_SIMILAR( integrated_intensity, 10.0);
+  // behind the last value (which is still inside the window)
+  extractor.extract_value_tophat(mz_start, mz_it, mz_it_end, int_it, 500.05, integrated_intensity, extract_window, false);
+  TEST_REAL_SIMILAR( integrated_intensity, 10.0);
 
   // this is to document the situation of using m/z values that are not monotonically increasing:
   //  --> it might not give the correct result (9000) if we try to extract 400.1 AFTER 500.0 
@@ -415,9 +517,9 @@ START_SECTION(void extract_value_tophat(const std::vector< double >::const_itera
   extractor.extract_value_tophat(mz_start, mz_it, mz_it_end, int_it, 400.0, integrated_intensity, extract_window, true);
   TEST_REAL_SIMILAR( integrated_intensity,4508.0);
   extractor.extract_value_tophat(mz_start, mz_it, mz_it_end, int_it, 400.05, integrated_intensity, extract_window, true);
-  TEST_REAL_SIMILAR( integrated_intensity,8400.0);
+  TEST_REAL_SIMILAR( integrated_intensity,8408.0);
   extractor.extract_value_tophat(mz_start, mz_it, mz_it_end, int_it, 400.1, integrated_intensity, extract_window, true);
-  TEST_REAL_SIMILAR( integrated_intensity,9000.0);
+  TEST_REAL_SIMILAR( integrated_intensity,9008.0); // the window (399.999975 - 400.200025) includes the very first value
 
 }
 END_SECTION
@@ -462,8 +564,8 @@ START_SECTION([EXTRA IM]void extract_value_tophat(const std::vector< double >::c
   // sum([i for m,i,im in zip_a if im < 100.15 and m < 400.1]) + 8
   TEST_REAL_SIMILAR( integrated_intensity, 2008.0);
   extractor.extract_value_tophat(mz_start, mz_it, mz_it_end, int_it, im_it, 400.05,  100, integrated_intensity, extract_window, im_extract_window, false);
-  // sum([i for m,i,im in zip_a if im < 100.15 and m < 400.15])
-  TEST_REAL_SIMILAR( integrated_intensity, 4100.0);
+  // sum([i for m,i,im in zip_a if im < 100.15 and m < 400.15]) + 8
+  TEST_REAL_SIMILAR( integrated_intensity, 4108.0);
   extractor.extract_value_tophat(mz_start, mz_it, mz_it_end, int_it, im_it, 400.1, 100, integrated_intensity, extract_window, im_extract_window, false);
   // sum([i for m,i,im in zip_a if im < 100.15 and m < 400.2])
   TEST_REAL_SIMILAR( integrated_intensity, 4100.0);
@@ -211,6 +211,16 @@ START_SECTION(CoarseIsotopePatternGenerator& convolvePow_(Size factor))
       TEST_REAL_SIMILAR(id.getContainer()[i].getIntensity(), container[i].getIntensity())
     }
   }
+  {
+    // fewer isotopes requested than the elements have (Br: 79-81, S: 32-36)
+    IsotopeDistribution id = EmpiricalFormula("Br2").getIsotopeDistribution(CoarseIsotopePatternGenerator(1));
+    TEST_EQUAL(id.size(), 1)
+    TEST_EQUAL(round(id.getContainer()[0].getMZ()), 158)
+    id = EmpiricalFormula("CS2Br2").getIsotopeDistribution(CoarseIsotopePatternGenerator(2));
+    TEST_EQUAL(id.size(), 2)
+    TEST_EQUAL(round(id.getContainer()[0].getMZ()), 234)
+    TEST_EQUAL(round(id.getContainer()[1].getMZ()), 235)
+  }
 }
 END_SECTION
 
@@ -622,6 +632,50 @@ START_SECTION(IsotopeDistribution calcFragmentIsotopeDist(const CoarseIsotopePat
 }
 END_SECTION
 
+START_SECTION(([EXTRA] cached averagine estimates give the same result as run()))
+{
+  EmpiricalFormula ef;
+  ef.estimateFromWeightAndComp(2000.0, 4.9384, 7.7583, 1.3577, 1.4773, 0.0417, 0);
+  CoarseIsotopePatternGenerator gen(10, true);
+  IsotopeDistribution computed = gen.run(ef);
+  IsotopeDistribution first = gen.estimateFromPeptideWeight(2000.0); // computed
+  IsotopeDistribution cached = gen.estimateFromPeptideWeight(2000.0); // taken from the cache
+  TEST_EQUAL(first.size(), 10)
+  TEST_EQUAL(first == computed, true)
+  TEST_EQUAL(cached == computed, true)
+
+  // the cache is keyed by the maximal isotope and the mass rounding as well
+  CoarseIsotopePatternGenerator gen_short(3, true);
+  TEST_EQUAL(gen_short.estimateFromPeptideWeight(2000.0).size(), 3)
+  CoarseIsotopePatternGenerator gen_exact(10, false);
+  TEST_EQUAL(gen_exact.estimateFromPeptideWeight(2000.0) == CoarseIsotopePatternGenerator(10, false).run(ef), true)
+  TEST_EQUAL(gen.estimateFromPeptideWeight(2000.0) == computed, true)
+}
+END_SECTION
+
+START_SECTION(([EXTRA] concurrent lookups give the same result as serial ones))
+{
+  std::vector<IsotopeDistribution> serial(200), parallel(200);
+  for (Size i = 0; i < serial.size(); ++i)
+  {
+    serial[i] = CoarseIsotopePatternGenerator(5).estimateFromPeptideWeight(500.0 + 25.0 * i);
+  }
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (SignedSize i = 0; i < (SignedSize)parallel.size(); ++i)
+  {
+    // every weight is requested twice, in the same or in different threads
+    parallel[i] = CoarseIsotopePatternGenerator(5).estimateFromPeptideWeight(500.0 + 25.0 * (i / 2 * 2));
+  }
+  for (Size i = 0; i < parallel.size(); i += 2)
+  {
+    TEST_EQUAL(parallel[i] == serial[i], true)
+    TEST_EQUAL(parallel[i + 1] == serial[i], true)
+  }
+}
+END_SECTION
+
 delete solver;
 
 /////////////////////////////////////////////////////////////
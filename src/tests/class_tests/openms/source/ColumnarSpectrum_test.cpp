@@ -0,0 +1,246 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/KERNEL/ColumnarSpectrum.h>
+///////////////////////////
+
+#include <OpenMS/KERNEL/MSChromatogram.h>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(ColumnarSpectrum, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+ColumnarSpectrum<>* ptr = nullptr;
+ColumnarSpectrum<>* nullPointer = nullptr;
+START_SECTION(ColumnarSpectrum())
+{
+  ptr = new ColumnarSpectrum<>();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->size(), 0)
+  TEST_EQUAL(ptr->empty(), true)
+}
+END_SECTION
+
+START_SECTION(~ColumnarSpectrum())
+{
+  delete ptr;
+}
+END_SECTION
+
+MSSpectrum spec;
+spec.setRT(12.5);
+spec.setMSLevel(2);
+spec.push_back(Peak1D(100.5, 10.0f));
+spec.push_back(Peak1D(200.25, 20.0f));
+spec.push_back(Peak1D(300.125, 30.0f));
+spec.push_back(Peak1D(400.0, 40.0f));
+
+START_SECTION(explicit ColumnarSpectrum(const MSSpectrum& spectrum))
+{
+  ColumnarSpectrum<> cs(spec);
+  TEST_EQUAL(cs.size(), 4)
+  TEST_REAL_SIMILAR(cs.getRT(), 12.5)
+  TEST_EQUAL(cs.getMSLevel(), 2)
+  TEST_REAL_SIMILAR(cs.getMZ(1), 200.25)
+  TEST_REAL_SIMILAR(cs.getIntensity(3), 40.0)
+  TEST_EQUAL(cs.getMZArray().size(), 4)
+  TEST_EQUAL(cs.getIntensityArray().size(), 4)
+
+  ColumnarSpectrum<float> csf(spec);
+  TEST_EQUAL(csf.size(), 4)
+  TEST_REAL_SIMILAR(csf.getMZ(2), 300.125)
+}
+END_SECTION
+
+START_SECTION((template <typename PeakIteratorType> ColumnarSpectrum(PeakIteratorType first, PeakIteratorType last)))
+{
+  ColumnarSpectrum<> cs(spec.begin() + 1, spec.end());
+  TEST_EQUAL(cs.size(), 3)
+  TEST_REAL_SIMILAR(cs.getMZ(0), 200.25)
+  TEST_REAL_SIMILAR(cs.getIntensity(2), 40.0)
+
+  // chromatogram peaks keep their double precision intensities
+  MSChromatogram chrom;
+  chrom.push_back(ChromatogramPeak(10.0, 1.0 + 1e-12));
+  chrom.push_back(ChromatogramPeak(20.0, 2.0));
+  ColumnarSpectrum<double, double> csc(chrom.begin(), chrom.end());
+  TEST_EQUAL(csc.size(), 2)
+  TEST_EQUAL(csc.getMZ(1), 20.0)
+  TEST_EQUAL(csc.getIntensity(0), 1.0 + 1e-12)
+}
+END_SECTION
+
+START_SECTION(void toMSSpectrum(MSSpectrum& spectrum) const)
+{
+  ColumnarSpectrum<> cs(spec);
+  MSSpectrum out;
+  out.setNativeID("keep_me");
+  out.push_back(Peak1D(1.0, 1.0f));
+  cs.toMSSpectrum(out);
+  TEST_EQUAL(out.size(), 4)
+  TEST_EQUAL(out.getNativeID(), "keep_me")
+  TEST_EQUAL(out.getMSLevel(), 2)
+  TEST_REAL_SIMILAR(out.getRT(), 12.5)
+  for (Size i = 0; i < spec.size(); ++i)
+  {
+    TEST_EQUAL(out[i] == spec[i], true)
+  }
+}
+END_SECTION
+
+START_SECTION(bool operator==(const ColumnarSpectrum& rhs) const)
+{
+  ColumnarSpectrum<> a(spec), b(spec);
+  TEST_EQUAL(a == b, true)
+  TEST_EQUAL(a != b, false)
+  b.setIntensity(0, 11.0f);
+  TEST_EQUAL(a == b, false)
+}
+END_SECTION
+
+START_SECTION(void push_back(CoordinateType mz, IntensityType intensity))
+{
+  ColumnarSpectrum<> cs;
+  cs.push_back(10.0, 1.0f);
+  cs.push_back(Peak1D(20.0, 2.0f));
+  TEST_EQUAL(cs.size(), 2)
+  TEST_REAL_SIMILAR(cs[1].getMZ(), 20.0)
+  TEST_REAL_SIMILAR(cs[1].getIntensity(), 2.0)
+  cs.setMZ(1, 25.0);
+  TEST_REAL_SIMILAR(cs.getPeak(1).getMZ(), 25.0)
+  cs.clear();
+  TEST_EQUAL(cs.empty(), true)
+}
+END_SECTION
+
+START_SECTION(ConstIterator begin() const)
+{
+  ColumnarSpectrum<> cs(spec);
+  Size n = 0;
+  for (const Peak1D& p : cs)
+  {
+    TEST_EQUAL(p == spec[n], true)
+    ++n;
+  }
+  TEST_EQUAL(n, 4)
+  TEST_EQUAL(cs.end() - cs.begin(), 4)
+  TEST_REAL_SIMILAR((cs.begin() + 2)->getMZ(), 300.125)
+  TEST_REAL_SIMILAR(cs.begin()[3].getIntensity(), 40.0)
+
+  // works with standard algorithms
+  ColumnarSpectrum<>::ConstIterator it = std::max_element(cs.begin(), cs.end(), Peak1D::IntensityLess());
+  TEST_EQUAL(it.getIndex(), 3)
+}
+END_SECTION
+
+START_SECTION(void sortByPosition())
+{
+  ColumnarSpectrum<> cs;
+  cs.push_back(300.0, 3.0f);
+  cs.push_back(100.0, 1.0f);
+  cs.push_back(200.0, 2.0f);
+  TEST_EQUAL(cs.isSorted(), false)
+  cs.sortByPosition();
+  TEST_EQUAL(cs.isSorted(), true)
+  TEST_REAL_SIMILAR(cs.getMZ(0), 100.0)
+  TEST_REAL_SIMILAR(cs.getIntensity(0), 1.0)
+  TEST_REAL_SIMILAR(cs.getMZ(2), 300.0)
+  TEST_REAL_SIMILAR(cs.getIntensity(2), 3.0)
+}
+END_SECTION
+
+START_SECTION(Size findNearest(CoordinateType mz) const)
+{
+  ColumnarSpectrum<> cs(spec);
+  for (double mz = 50.0; mz < 450.0; mz += 3.7)
+  {
+    TEST_EQUAL(cs.findNearest(mz), spec.findNearest(mz))
+  }
+  TEST_EXCEPTION(Exception::Precondition, ColumnarSpectrum<>().findNearest(1.0))
+}
+END_SECTION
+
+START_SECTION(Int findNearest(CoordinateType mz, CoordinateType tolerance) const)
+{
+  ColumnarSpectrum<> cs(spec);
+  TEST_EQUAL(cs.findNearest(200.0, 1.0), 1)
+  TEST_EQUAL(cs.findNearest(250.0, 1.0), -1)
+  TEST_EQUAL(ColumnarSpectrum<>().findNearest(250.0, 1.0), -1)
+}
+END_SECTION
+
+START_SECTION(Size MZBegin(CoordinateType mz) const)
+{
+  ColumnarSpectrum<> cs(spec);
+  TEST_EQUAL(cs.MZBegin(0.0), 0)
+  TEST_EQUAL(cs.MZBegin(200.25), 1)
+  TEST_EQUAL(cs.MZBegin(200.3), 2)
+  TEST_EQUAL(cs.MZBegin(500.0), 4)
+}
+END_SECTION
+
+START_SECTION(Size MZEnd(CoordinateType mz) const)
+{
+  ColumnarSpectrum<> cs(spec);
+  TEST_EQUAL(cs.MZEnd(0.0), 0)
+  TEST_EQUAL(cs.MZEnd(200.25), 2)
+  TEST_EQUAL(cs.MZEnd(500.0), 4)
+}
+END_SECTION
+
+START_SECTION(double sumIntensity(CoordinateType mz_start, CoordinateType mz_end) const)
+{
+  ColumnarSpectrum<> cs(spec);
+  TEST_REAL_SIMILAR(cs.sumIntensity(0.0, 1000.0), 100.0)
+  TEST_REAL_SIMILAR(cs.sumIntensity(200.25, 300.125), 50.0)
+  TEST_REAL_SIMILAR(cs.sumIntensity(500.0, 1000.0), 0.0)
+
+  ColumnarSpectrum<> large;
+  for (Size i = 0; i < 1001; ++i) large.push_back(100.0 + i * 0.01, 1.0f);
+  TEST_REAL_SIMILAR(large.sumIntensity(100.0, 110.0), 1001.0)
+  TEST_REAL_SIMILAR(large.sumIntensity(100.005, 100.095), 9.0)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
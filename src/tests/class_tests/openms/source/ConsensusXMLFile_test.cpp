@@ -48,6 +48,19 @@
 using namespace OpenMS;
 using namespace std;
 
+// collects the consensus features passed to it
+class CollectingConsensusConsumer :
+  public Interfaces::IConsensusDataConsumer
+{
+public:
+  void consumeFeature(ConsensusFeature& feature) override { map.push_back(feature); }
+  void setExpectedSize(Size /* expected_features */) override {}
+  void setMapMetaData(const ConsensusMap& meta_data) override { map = meta_data; ++nr_meta_data_calls; }
+
+  ConsensusMap map;
+  Size nr_meta_data_calls = 0;
+};
+
 
 DRange<1> makeRange(double a, double b)
 {
@@ -228,6 +241,36 @@ START_SECTION((void store(const String &filename, const ConsensusMap &consensus_
 
 END_SECTION
 
+START_SECTION((void transform(const String& filename, Interfaces::IConsensusDataConsumer* consumer)))
+{
+  ConsensusMap map;
+  ConsensusXMLFile f;
+  f.load(OPENMS_GET_TEST_DATA_PATH("ConsensusXMLFile_1.consensusXML"), map);
+
+  CollectingConsensusConsumer consumer;
+  f.transform(OPENMS_GET_TEST_DATA_PATH("ConsensusXMLFile_1.consensusXML"), &consumer);
+  TEST_EQUAL(consumer.nr_meta_data_calls, 1)
+  TEST_EQUAL(consumer.map.size(), map.size())
+  TEST_EQUAL(consumer.map.getColumnHeaders().size(), map.getColumnHeaders().size())
+  TEST_EQUAL(consumer.map.getProteinIdentifications().size(), map.getProteinIdentifications().size())
+  TEST_EQUAL(consumer.map.getUnassignedPeptideIdentifications().size(), map.getUnassignedPeptideIdentifications().size())
+  ABORT_IF(consumer.map.size() != map.size())
+  for (Size i = 0; i < map.size(); ++i)
+  {
+    TEST_EQUAL(consumer.map[i] == map[i], true)
+  }
+
+  // options are applied
+  ConsensusXMLFile f2;
+  f2.getOptions().setRTRange(makeRange(815, 818));
+  CollectingConsensusConsumer consumer2;
+  f2.transform(OPENMS_GET_TEST_DATA_PATH("ConsensusXMLFile_2_options.consensusXML"), &consumer2);
+  TEST_EQUAL(consumer2.map.size(), 1)
+  ABORT_IF(consumer2.map.size() != 1)
+  TEST_REAL_SIMILAR(consumer2.map[0].getRT(), 817.266)
+}
+END_SECTION
+
 START_SECTION([EXTRA](bool isValid(const String &filename)))
   ConsensusXMLFile f;
   TEST_EQUAL(f.isValid(OPENMS_GET_TEST_DATA_PATH("ConsensusXMLFile_1.consensusXML"), std::cerr), true);
@@ -103,7 +103,7 @@ PeakMap mse;
   }
 }
 
-START_SECTION((static void convert(UInt64 const input_map_index, PeakMap & input_map, ConsensusMap& output_map, Size n = -1)))
+START_SECTION((static void convert(UInt64 const input_map_index, const PeakMap& input_map, ConsensusMap& output_map, Size n = -1)))
 {
 
   ConsensusMap cm;
@@ -267,12 +267,12 @@ START_SECTION((void getAllSearchModifications(std::vector<String>& modifications
 }
 END_SECTION
 
-START_SECTION((bool addModification(ResidueModification* modification)))
+START_SECTION((const ResidueModification* addModification(ResidueModification* new_mod)))
 {
   TEST_EQUAL(ptr->has("DSS (C-term)"), false);
   ResidueModification* modification = new ResidueModification();
   modification->setFullId("DSS (C-term)");
-  ptr->addModification(modification);
+  TEST_EQUAL(ptr->addModification(modification) == modification, true);
   TEST_EQUAL(ptr->has("DSS (C-term)"), true);
 }
 END_SECTION
@@ -606,6 +606,42 @@ START_SECTION(([EXTRA] Check correct charge semantics))
   TEST_EQUAL(ef11.getCharge(), 3)
 END_SECTION
 
+START_SECTION(([EXTRA] Formulae with more elements than fit into the inline storage))
+  // nine distinct elements, more than the inline capacity of the internal map
+  EmpiricalFormula big("C10H20N3O4S1P2Na1Cl2Fe1");
+  TEST_EQUAL(big.getNumberOf(db->getElement("Na")), 1)
+  TEST_EQUAL(big.getNumberOf(db->getElement("Cl")), 2)
+  TEST_EQUAL(big.getNumberOf(db->getElement("Fe")), 1)
+  TEST_EQUAL(big.getNumberOfAtoms(), 44)
+
+  // iteration is ordered and contains every element exactly once
+  Size count(0);
+  const Element* last = nullptr;
+  for (EmpiricalFormula::ConstIterator it = big.begin(); it != big.end(); ++it, ++count)
+  {
+    if (last != nullptr) TEST_EQUAL(std::less<const Element*>()(last, it->first), true)
+    last = it->first;
+  }
+  TEST_EQUAL(count, 9)
+
+  // copies and moves keep the content, independent of the storage used
+  EmpiricalFormula copy(big);
+  TEST_EQUAL(copy == big, true)
+  EmpiricalFormula moved(std::move(copy));
+  TEST_EQUAL(moved == big, true)
+  EmpiricalFormula small("C2H6O");
+  small = moved;
+  TEST_EQUAL(small == big, true)
+  moved = EmpiricalFormula("C2H6O");
+  TEST_EQUAL(moved.toString(), "C2H6O")
+
+  // removing the additional elements again
+  EmpiricalFormula diff = big - EmpiricalFormula("Na1Cl2Fe1");
+  TEST_EQUAL(diff, EmpiricalFormula("C10H20N3O4S1P2"))
+  diff += EmpiricalFormula("Na1Cl2Fe1");
+  TEST_EQUAL(diff, big)
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -306,6 +306,62 @@ START_SECTION((Size digestUnmodified(const StringView sequence, std::vector<Stri
 }
 END_SECTION
 
+START_SECTION((Size digestUnmodified(const StringView& sequence, std::vector<std::pair<Size,Size>>& output, Size min_length, Size max_length)))
+{
+    EnzymaticDigestion ed;
+    vector<pair<Size, Size> > out;
+
+    // products are (start, length)
+    std::string s = "ACDE";
+    ed.digestUnmodified(s, out);
+    TEST_EQUAL(out.size(), 1)
+    TEST_EQUAL(out[0].first, 0)
+    TEST_EQUAL(out[0].second, 4)
+
+    s = "ARCRDRE";
+    ed.digestUnmodified(s, out);
+    TEST_EQUAL(out.size(), 4)
+    TEST_EQUAL(out[0].first, 0)
+    TEST_EQUAL(out[0].second, 2)
+    TEST_EQUAL(out[1].first, 2)
+    TEST_EQUAL(out[1].second, 2)
+    TEST_EQUAL(out[2].first, 4)
+    TEST_EQUAL(out[2].second, 2)
+    TEST_EQUAL(out[3].first, 6)
+    TEST_EQUAL(out[3].second, 1)
+
+    ed.setMissedCleavages(1);
+    ed.digestUnmodified(s, out, 3);
+    TEST_EQUAL(out.size(), 3)
+    TEST_EQUAL(out[0].first, 0)
+    TEST_EQUAL(out[0].second, 4)
+    TEST_EQUAL(out[1].first, 2)
+    TEST_EQUAL(out[1].second, 4)
+    TEST_EQUAL(out[2].first, 4)
+    TEST_EQUAL(out[2].second, 3)
+    ed.setMissedCleavages(0);
+
+    // no cleavage site at all: the whole (here: empty) sequence, not one residue less
+    s = "";
+    ed.digestUnmodified(s, out, 0);
+    TEST_EQUAL(out.size(), 1)
+    TEST_EQUAL(out[0].first, 0)
+    TEST_EQUAL(out[0].second, 0)
+
+    // same products as the StringView version
+    s = "MKWVTFISLLLLFSSAYSRGVFRRDTHKSEIAHRFKDLGE";
+    vector<StringView> out_views;
+    ed.setMissedCleavages(2);
+    ed.digestUnmodified(s, out, 2, 10);
+    ed.digestUnmodified(s, out_views, 2, 10);
+    TEST_EQUAL(out.size(), out_views.size())
+    for (Size i = 0; i < out.size(); ++i)
+    {
+      TEST_EQUAL(s.substr(out[i].first, out[i].second), out_views[i].getString())
+    }
+}
+END_SECTION
+
 START_SECTION((bool isValidProduct(const String& sequence, int pos, int length, bool ignore_missed_cleavages)))
 {
     EnzymaticDigestion ed;
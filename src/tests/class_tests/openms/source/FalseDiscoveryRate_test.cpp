@@ -177,6 +177,53 @@ START_SECTION((void apply(std::vector<PeptideIdentification> &id)))
 }
 END_SECTION
 
+START_SECTION((void apply(PSMTable& psms)))
+{
+  vector<ProteinIdentification> prot_ids;
+  vector<PeptideIdentification> pep_ids;
+  IdXMLFile().load(OPENMS_GET_TEST_DATA_PATH("FalseDiscoveryRate_OMSSA.idXML"), prot_ids, pep_ids);
+
+  // same results as the variant for vectors of peptide identifications
+  FalseDiscoveryRate fdr;
+  PSMTable psms(pep_ids);
+  vector<PeptideIdentification> expected = pep_ids, result;
+  fdr.apply(expected);
+  fdr.apply(psms);
+  psms.getIdentifications(result);
+  TEST_EQUAL(result.size(), expected.size())
+  TEST_EQUAL(result == expected, true)
+  TEST_EQUAL(psms.getScoreType(0), "q-value")
+  TEST_REAL_SIMILAR(psms.getScore(0), 0.0730478589420655)
+
+  Param param = fdr.getParameters();
+  param.setValue("split_charge_variants", "true");
+  param.setValue("add_decoy_peptides", "true");
+  param.setValue("no_qvalues", "true");
+  fdr.setParameters(param);
+  psms = PSMTable(pep_ids);
+  expected = pep_ids;
+  fdr.apply(expected);
+  fdr.apply(psms);
+  psms.getIdentifications(result);
+  TEST_EQUAL(result == expected, true)
+  TEST_EQUAL(psms.getScoreType(0), "FDR")
+
+  // hits without target/decoy annotation
+  vector<PeptideIdentification> unannotated(1);
+  unannotated[0].setScoreType("score");
+  unannotated[0].getHits().resize(1);
+  unannotated[0].getHits()[0].setMetaValue("target_decoy", "");
+  psms = PSMTable(unannotated);
+  TEST_EXCEPTION(Exception::InvalidValue, fdr.apply(unannotated))
+  TEST_EXCEPTION(Exception::InvalidValue, fdr.apply(psms))
+
+  unannotated[0].getHits()[0].removeMetaValue("target_decoy");
+  psms = PSMTable(unannotated);
+  TEST_EXCEPTION(Exception::MissingInformation, fdr.apply(unannotated))
+  TEST_EXCEPTION(Exception::MissingInformation, fdr.apply(psms))
+}
+END_SECTION
+
 START_SECTION((void apply(std::vector<ProteinIdentification>& ids)))
 {
   vector<ProteinIdentification> fwd_prot_ids, rev_prot_ids, prot_ids;
@@ -41,6 +41,10 @@
 #include <OpenMS/FILTERING/DATAREDUCTION/ElutionPeakDetection.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 ///////////////////////////
 #include <OpenMS/FILTERING/DATAREDUCTION/FeatureFindingMetabo.h>
 ///////////////////////////
@@ -122,6 +126,38 @@ START_SECTION((void run(std::vector< MassTrace > &, FeatureMap &, chromatograms
 }
 END_SECTION
 
+START_SECTION([EXTRA] result does not depend on the number of threads)
+{
+    FeatureFindingMetabo test_ffm;
+    Param p = test_ffm.getParameters();
+    p.setValue("report_chromatograms", "true");
+    test_ffm.setParameters(p);
+
+    FeatureMap fm_parallel, fm_single;
+    std::vector<std::vector< OpenMS::MSChromatogram > > chroms_parallel, chroms_single;
+    test_ffm.run(splitted_mt, fm_parallel, chroms_parallel);
+#ifdef _OPENMP
+    int nr_threads = omp_get_max_threads();
+    omp_set_num_threads(1);
+#endif
+    test_ffm.run(splitted_mt, fm_single, chroms_single);
+#ifdef _OPENMP
+    omp_set_num_threads(nr_threads);
+#endif
+
+    TEST_EQUAL(fm_parallel.size(), 81)
+    TEST_EQUAL(fm_parallel.size(), fm_single.size())
+    TEST_EQUAL(chroms_parallel.size(), fm_parallel.size())
+    TEST_EQUAL(chroms_single.size(), fm_single.size())
+    for (Size i = 0; i < std::min(fm_parallel.size(), fm_single.size()); ++i)
+    {
+      TEST_EQUAL(fm_parallel[i].getMetaValue(3), fm_single[i].getMetaValue(3))
+      TEST_EQUAL(fm_parallel[i].getCharge(), fm_single[i].getCharge())
+      TEST_REAL_SIMILAR(fm_parallel[i].getIntensity(), fm_single[i].getIntensity())
+      TEST_REAL_SIMILAR(fm_parallel[i].getOverallQuality(), fm_single[i].getOverallQuality())
+    }
+}
+END_SECTION
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
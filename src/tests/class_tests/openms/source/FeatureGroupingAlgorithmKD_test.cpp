@@ -37,6 +37,8 @@
 
 #include <OpenMS/ANALYSIS/MAPMATCHING/FeatureGroupingAlgorithmKD.h>
 
+#include <OpenMS/KERNEL/FeatureMap.h>
+
 using namespace OpenMS;
 using namespace std;
 
@@ -72,6 +74,79 @@ START_SECTION((virtual void group(const std::vector<FeatureMap>& maps, Consensus
   NOT_TESTABLE;
 END_SECTION
 
+START_SECTION(([EXTRA] linking with tiles (link:tile_size)))
+{
+  // well-separated groups of corresponding features in three maps:
+  vector<FeatureMap> maps(3);
+  for (Size i = 0; i < 200; ++i)
+  {
+    for (Size m = 0; m < maps.size(); ++m)
+    {
+      Feature f;
+      f.setMZ(400.0 + i * 0.5 + m * 0.0005);
+      f.setRT(1000.0 + (i % 7) * 100.0 + m * 2.0);
+      f.setIntensity(1000.0);
+      f.setCharge(2);
+      maps[m].push_back(f);
+    }
+  }
+  // a dense region where groups are closer than the m/z tolerance:
+  for (Size i = 0; i < 100; ++i)
+  {
+    for (Size m = 0; m < maps.size(); ++m)
+    {
+      Feature f;
+      f.setMZ(600.0 + i * 0.002 + m * 0.0003);
+      f.setRT(2000.0 + (i % 3) * 5.0);
+      f.setIntensity(1000.0);
+      f.setCharge(2);
+      maps[m].push_back(f);
+    }
+  }
+  for (Size m = 0; m < maps.size(); ++m)
+  {
+    maps[m].updateRanges();
+  }
+
+  FeatureGroupingAlgorithmKD fga;
+  Param p = fga.getParameters();
+  p.setValue("warp:enabled", "false");
+  p.setValue("nr_partitions", 1);
+  fga.setParameters(p);
+  ConsensusMap untiled;
+  fga.group(maps, untiled);
+
+  p.setValue("link:tile_size", 50);
+  fga.setParameters(p);
+  ConsensusMap tiled;
+  fga.group(maps, tiled);
+
+  // every input feature is used exactly once:
+  set<pair<Size, UInt64> > handles;
+  Size n_handles = 0;
+  Size n_complete = 0;
+  for (ConsensusMap::const_iterator it = tiled.begin(); it != tiled.end(); ++it)
+  {
+    for (ConsensusFeature::const_iterator h_it = it->begin(); h_it != it->end(); ++h_it)
+    {
+      handles.insert(make_pair(h_it->getMapIndex(), UInt64(h_it->getMZ() * 1e6)));
+      ++n_handles;
+    }
+    if (it->size() == 3 && it->getMZ() < 600.0) ++n_complete;
+  }
+  TEST_EQUAL(n_handles, 3 * 300)
+  TEST_EQUAL(handles.size(), 3 * 300)
+  // separated groups are found independently of the tiling:
+  TEST_EQUAL(n_complete, 200)
+
+  // deterministic:
+  ConsensusMap tiled2;
+  fga.group(maps, tiled2);
+  TEST_EQUAL(tiled2.size(), tiled.size())
+  TEST_EQUAL(untiled.size() >= 200, true)
+}
+END_SECTION
+
 START_SECTION((virtual void group(const std::vector<ConsensusMap>& maps, ConsensusMap& out)))
   // This is tested in the UTILS test
   NOT_TESTABLE;
@@ -47,6 +47,19 @@
 using namespace OpenMS;
 using namespace std;
 
+// collects the features passed to it
+class CollectingFeatureConsumer :
+  public Interfaces::IFeatureDataConsumer
+{
+public:
+  void consumeFeature(Feature& feature) override { map.push_back(feature); }
+  void setExpectedSize(Size expected_features) override { expected_size = expected_features; }
+  void setMapMetaData(const FeatureMap& meta_data) override { map = meta_data; }
+
+  FeatureMap map;
+  Size expected_size = 0;
+};
+
 DRange<1> makeRange(double a, double b)
 {
   DPosition<1> pa(a), pb(b);
@@ -244,6 +257,44 @@ START_SECTION((void store(const String &filename, const FeatureMap&feature_map))
 }
 END_SECTION
 
+START_SECTION((void transform(const String& filename, Interfaces::IFeatureDataConsumer* consumer)))
+{
+  FeatureMap map;
+  FeatureXMLFile f;
+  f.load(OPENMS_GET_TEST_DATA_PATH("FeatureXMLFile_1.featureXML"), map);
+
+  CollectingFeatureConsumer consumer;
+  f.transform(OPENMS_GET_TEST_DATA_PATH("FeatureXMLFile_1.featureXML"), &consumer);
+  TEST_EQUAL(consumer.expected_size, map.size())
+  TEST_EQUAL(consumer.map.size(), map.size())
+  TEST_EQUAL(consumer.map.getIdentifier(), map.getIdentifier())
+  TEST_EQUAL(consumer.map.getProteinIdentifications().size(), map.getProteinIdentifications().size())
+  TEST_EQUAL(consumer.map.getUnassignedPeptideIdentifications().size(), map.getUnassignedPeptideIdentifications().size())
+  TEST_EQUAL(consumer.map.getDataProcessing().size(), map.getDataProcessing().size())
+  ABORT_IF(consumer.map.size() != map.size())
+  for (Size i = 0; i < map.size(); ++i)
+  {
+    TEST_EQUAL(consumer.map[i].getUniqueId(), map[i].getUniqueId())
+    TEST_REAL_SIMILAR(consumer.map[i].getRT(), map[i].getRT())
+    TEST_EQUAL(consumer.map[i].getSubordinates().size(), map[i].getSubordinates().size())
+    TEST_EQUAL(consumer.map[i].getConvexHulls().size(), map[i].getConvexHulls().size())
+    TEST_EQUAL(consumer.map[i].getPeptideIdentifications().size(), map[i].getPeptideIdentifications().size())
+  }
+
+  // options are applied
+  FeatureXMLFile f2;
+  f2.getOptions().setRTRange(makeRange(1.5, 4.5));
+  f2.getOptions().setMZRange(makeRange(1025.0, 2000.0));
+  CollectingFeatureConsumer consumer2;
+  f2.transform(OPENMS_GET_TEST_DATA_PATH("FeatureXMLFile_2_options.featureXML"), &consumer2);
+  TEST_EQUAL(consumer2.map.size(), 3)
+
+  // load() still works afterwards
+  f.load(OPENMS_GET_TEST_DATA_PATH("FeatureXMLFile_1.featureXML"), map);
+  TEST_EQUAL(map.size(), consumer.map.size())
+}
+END_SECTION
+
 START_SECTION((FeatureFileOptions & getOptions()))
 {
   FeatureXMLFile f;
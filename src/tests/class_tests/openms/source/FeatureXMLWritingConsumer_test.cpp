@@ -0,0 +1,149 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/FORMAT/DATAACCESS/FeatureXMLWritingConsumer.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(FeatureXMLWritingConsumer, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+FeatureXMLWritingConsumer* ptr = nullptr;
+FeatureXMLWritingConsumer* null_ptr = nullptr;
+START_SECTION((explicit FeatureXMLWritingConsumer(const String& filename)))
+{
+  String filename;
+  NEW_TMP_FILE(filename)
+  ptr = new FeatureXMLWritingConsumer(filename);
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EXCEPTION(Exception::UnableToCreateFile, FeatureXMLWritingConsumer("output.mzML"))
+}
+END_SECTION
+
+START_SECTION((~FeatureXMLWritingConsumer()))
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((void consumeFeature(Feature& feature)))
+{
+  FeatureMap map;
+  FeatureXMLFile().load(OPENMS_GET_TEST_DATA_PATH("FeatureXMLFile_1.featureXML"), map);
+
+  String filename;
+  NEW_TMP_FILE(filename)
+  {
+    FeatureXMLWritingConsumer consumer(filename);
+    FeatureMap meta_data = map;
+    meta_data.clear(false);
+    consumer.setExpectedSize(map.size());
+    consumer.setMapMetaData(meta_data);
+    for (Feature& feature : map)
+    {
+      consumer.consumeFeature(feature);
+    }
+    TEST_EQUAL(consumer.getNrFeaturesWritten(), map.size())
+  }
+  WHITELIST("?xml-stylesheet")
+  TEST_FILE_SIMILAR(OPENMS_GET_TEST_DATA_PATH("FeatureXMLFile_1.featureXML"), filename)
+}
+END_SECTION
+
+START_SECTION((void setExpectedSize(Size expected_features)))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((void setMapMetaData(const FeatureMap& map)))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((Size getNrFeaturesWritten() const))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((void close()))
+{
+  // streaming from file to file
+  String filename;
+  NEW_TMP_FILE(filename)
+  FeatureXMLWritingConsumer consumer(filename);
+  FeatureXMLFile().transform(OPENMS_GET_TEST_DATA_PATH("FeatureXMLFile_1.featureXML"), &consumer);
+  consumer.close();
+  consumer.close(); // no effect
+  WHITELIST("?xml-stylesheet")
+  TEST_FILE_SIMILAR(OPENMS_GET_TEST_DATA_PATH("FeatureXMLFile_1.featureXML"), filename)
+
+  // empty map
+  String empty_filename;
+  NEW_TMP_FILE(empty_filename)
+  FeatureXMLWritingConsumer empty_consumer(empty_filename);
+  empty_consumer.close();
+  FeatureMap map;
+  FeatureXMLFile().load(empty_filename, map);
+  TEST_EQUAL(map.size(), 0)
+
+  // the count attribute is the number of features written, not the expected number
+  FeatureXMLFile().load(OPENMS_GET_TEST_DATA_PATH("FeatureXMLFile_1.featureXML"), map);
+  String partial_filename;
+  NEW_TMP_FILE(partial_filename)
+  {
+    FeatureXMLWritingConsumer partial_consumer(partial_filename);
+    partial_consumer.setExpectedSize(map.size());
+    partial_consumer.consumeFeature(map[0]);
+  }
+  TEST_EQUAL(FeatureXMLFile().loadSize(partial_filename), 1)
+  FeatureMap partial_map;
+  FeatureXMLFile().load(partial_filename, partial_map);
+  TEST_EQUAL(partial_map.size(), 1)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -0,0 +1,365 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/ID/FragmentIndex.h>
+///////////////////////////
+
+#include <OpenMS/SYSTEM/File.h>
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(FragmentIndex, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+FragmentIndex* ptr = nullptr;
+FragmentIndex* null_ptr = nullptr;
+START_SECTION(FragmentIndex(double bin_size = 0.02))
+{
+  ptr = new FragmentIndex();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->size(), 0)
+  TEST_EQUAL(ptr->getNrFragments(), 0)
+  TEST_REAL_SIMILAR(ptr->getBinSize(), 0.02)
+  TEST_EQUAL(ptr->isMemoryMapped(), false)
+  TEST_EXCEPTION(Exception::InvalidValue, FragmentIndex(0.0))
+}
+END_SECTION
+
+START_SECTION(~FragmentIndex())
+{
+  delete ptr;
+}
+END_SECTION
+
+vector<FASTAFile::FASTAEntry> fasta_db(2);
+fasta_db[0].identifier = "P1";
+fasta_db[0].sequence = "AAAKMMRGGG"; // AAAK, MMR, GGG
+fasta_db[1].identifier = "P2";
+fasta_db[1].sequence = "GGGKAAAK"; // GGGK, AAAK
+
+ProteaseDigestion digestor;
+digestor.setEnzyme("Trypsin");
+digestor.setMissedCleavages(0);
+ModifiedPeptideGenerator::MapToResidueType fixed_mods = ModifiedPeptideGenerator::getModifications(StringList());
+ModifiedPeptideGenerator::MapToResidueType variable_mods = ModifiedPeptideGenerator::getModifications(ListUtils::create<String>("Oxidation (M)"));
+
+PeptideDatabase db;
+db.build(fasta_db, digestor, 1, 0, fixed_mods, variable_mods, 2);
+
+TheoreticalSpectrumGenerator spectrum_generator;
+Param param(spectrum_generator.getParameters());
+param.setValue("add_first_prefix_ion", "true");
+spectrum_generator.setParameters(param);
+
+// theoretical spectrum of entry e (as indexed)
+auto getTheoreticalSpectrum = [&](Size e)
+{
+  vector<AASequence> variants;
+  db.getModifiedVariants(fasta_db, db.getEntry(e).peptide, fixed_mods, variable_mods, 2, variants);
+  PeakSpectrum theo;
+  spectrum_generator.getSpectrum(theo, variants[db.getEntry(e).modification], 1, 1);
+  theo.sortByPosition();
+  return theo;
+};
+
+// entries of the unmodified peptides AAAK and MMR
+Size aaak = db.size(), mmr = db.size();
+for (Size e = 0; e < db.size(); ++e)
+{
+  const StringView sequence = db.getSequence(fasta_db, db.getEntry(e).peptide);
+  if (sequence.getString() == "AAAK") aaak = e;
+  if (sequence.getString() == "MMR" && fabs(db.getEntry(e).mass - AASequence::fromString("MMR").getMonoWeight()) < 1e-6) mmr = e;
+}
+
+FragmentIndex index(0.02);
+const UInt64 key = 42;
+
+START_SECTION((void build(const PeptideDatabase& peptide_db, const std::vector<FASTAFile::FASTAEntry>& fasta_db, const TheoreticalSpectrumGenerator& spectrum_generator, const ModifiedPeptideGenerator::MapToResidueType& fixed_modifications, const ModifiedPeptideGenerator::MapToResidueType& variable_modifications, Size max_variable_mods_per_peptide)))
+{
+  // queries need a built index
+  vector<FragmentIndex::Candidate> candidates;
+  vector<UInt32> workspace;
+  TEST_EXCEPTION(Exception::Precondition, index.query(getTheoreticalSpectrum(aaak), 0, db.size(), 0.01, false, 1, 10, candidates, workspace))
+
+  index.build(db, fasta_db, spectrum_generator, fixed_mods, variable_mods, 2);
+  TEST_EQUAL(index.size(), db.size())
+  Size nr_fragments = 0;
+  for (Size e = 0; e < db.size(); ++e)
+  {
+    nr_fragments += getTheoreticalSpectrum(e).size();
+  }
+  TEST_EQUAL(index.getNrFragments(), nr_fragments)
+}
+END_SECTION
+
+START_SECTION((Size size() const))
+{
+  TEST_EQUAL(index.size(), 7)
+}
+END_SECTION
+
+START_SECTION((Size getNrFragments() const))
+{
+  TEST_NOT_EQUAL(index.getNrFragments(), 0)
+}
+END_SECTION
+
+START_SECTION((double getBinSize() const))
+{
+  TEST_REAL_SIMILAR(index.getBinSize(), 0.02)
+}
+END_SECTION
+
+START_SECTION((void query(const PeakSpectrum& spectrum, Size entry_first, Size entry_last, double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm, Size min_shared_peaks, Size max_candidates, std::vector<Candidate>& candidates, std::vector<UInt32>& workspace) const))
+{
+  ABORT_IF(aaak == db.size() || mmr == db.size())
+  vector<FragmentIndex::Candidate> candidates;
+  vector<UInt32> workspace;
+
+  // the spectrum of AAAK shares all its peaks with AAAK (y1 also with GGGK)
+  const PeakSpectrum exp = getTheoreticalSpectrum(aaak);
+  index.query(exp, 0, db.size(), 0.01, false, 1, 10, candidates, workspace);
+  ABORT_IF(candidates.empty())
+  TEST_EQUAL(candidates[0].entry, aaak)
+  TEST_EQUAL(candidates[0].shared_peaks, exp.size())
+  for (Size i = 1; i < candidates.size(); ++i)
+  {
+    TEST_EQUAL(candidates[i].shared_peaks < exp.size(), true)
+    TEST_EQUAL(candidates[i - 1].shared_peaks >= candidates[i].shared_peaks, true)
+  }
+
+  // the workspace is reusable, results do not change
+  vector<FragmentIndex::Candidate> candidates2;
+  index.query(exp, 0, db.size(), 0.01, false, 1, 10, candidates2, workspace);
+  TEST_EQUAL(candidates2.size(), candidates.size())
+
+  // entry range
+  index.query(exp, aaak, aaak + 1, 0.01, false, 1, 10, candidates, workspace);
+  TEST_EQUAL(candidates.size(), 1)
+  index.query(exp, mmr, mmr + 1, 0.01, false, 1, 10, candidates, workspace);
+  TEST_EQUAL(candidates.size(), 0)
+  index.query(exp, aaak + 1, aaak + 1, 0.01, false, 1, 10, candidates, workspace);
+  TEST_EQUAL(candidates.size(), 0)
+
+  // minimum number of shared peaks and maximum number of candidates
+  index.query(exp, 0, db.size(), 0.01, false, exp.size(), 10, candidates, workspace);
+  TEST_EQUAL(candidates.size(), 1)
+  index.query(exp, 0, db.size(), 0.01, false, 1, 1, candidates, workspace);
+  TEST_EQUAL(candidates.size(), 1)
+  TEST_EQUAL(candidates[0].entry, aaak)
+
+  // a peak counts once per entry, even if several fragments are in tolerance
+  PeakSpectrum doubled;
+  doubled.push_back(exp[0]);
+  index.query(doubled, 0, db.size(), 100.0, false, 1, 10, candidates, workspace);
+  TEST_EQUAL(candidates.size(), db.size())
+  for (const FragmentIndex::Candidate& c : candidates)
+  {
+    TEST_EQUAL(c.shared_peaks, 1)
+  }
+
+  // fragment tolerance in ppm: all peaks shifted by 50 ppm
+  PeakSpectrum shifted(exp);
+  for (Peak1D& p : shifted)
+  {
+    p.setMZ(p.getMZ() * (1.0 + 50e-6));
+  }
+  index.query(shifted, aaak, aaak + 1, 10.0, true, 1, 10, candidates, workspace);
+  TEST_EQUAL(candidates.size(), 0)
+  index.query(shifted, aaak, aaak + 1, 100.0, true, 1, 10, candidates, workspace);
+  TEST_EQUAL(candidates.size(), 1)
+
+  // peaks beyond the largest fragment are ignored
+  PeakSpectrum heavy;
+  heavy.push_back(Peak1D(5000.0, 1.0));
+  index.query(heavy, 0, db.size(), 0.01, false, 1, 10, candidates, workspace);
+  TEST_EQUAL(candidates.size(), 0)
+
+  // the result does not depend on the index instance (e.g. on the number of threads used for building)
+  FragmentIndex index2(0.02);
+  index2.build(db, fasta_db, spectrum_generator, fixed_mods, variable_mods, 2);
+  index.query(exp, 0, db.size(), 0.01, false, 1, 10, candidates, workspace);
+  index2.query(exp, 0, db.size(), 0.01, false, 1, 10, candidates2, workspace);
+  TEST_EQUAL(candidates2.size(), candidates.size())
+  ABORT_IF(candidates2.size() != candidates.size())
+  for (Size i = 0; i < candidates.size(); ++i)
+  {
+    TEST_EQUAL(candidates2[i].entry, candidates[i].entry)
+    TEST_EQUAL(candidates2[i].shared_peaks, candidates[i].shared_peaks)
+  }
+}
+END_SECTION
+
+String filename;
+NEW_TMP_FILE(filename)
+
+START_SECTION((void store(const String& filename, UInt64 key) const))
+{
+  index.store(filename, key);
+  TEST_EQUAL(File::exists(filename), true)
+  TEST_EXCEPTION(Exception::UnableToCreateFile, index.store("/does/not/exist/index.fragments", key))
+}
+END_SECTION
+
+START_SECTION((bool load(const String& filename, UInt64 key, Size nr_entries, bool memory_map = true)))
+{
+  const PeakSpectrum exp = getTheoreticalSpectrum(aaak);
+  vector<FragmentIndex::Candidate> expected, candidates;
+  vector<UInt32> workspace;
+  index.query(exp, 0, db.size(), 0.01, false, 1, 10, expected, workspace);
+
+  // missing file, different key or bin size
+  FragmentIndex loaded(0.02);
+  TEST_EQUAL(loaded.load(filename + ".missing", key, db.size()), false)
+  TEST_EQUAL(loaded.load(filename, key + 1, db.size()), false)
+  FragmentIndex other_bins(0.05);
+  TEST_EQUAL(other_bins.load(filename, key, db.size()), false)
+  TEST_EQUAL(loaded.size(), 0)
+
+  for (bool memory_map : {true, false})
+  {
+    FragmentIndex from_file(0.02);
+    TEST_EQUAL(from_file.load(filename, key, db.size(), memory_map), true)
+    TEST_EQUAL(from_file.isMemoryMapped(), memory_map)
+    TEST_EQUAL(from_file.size(), index.size())
+    TEST_EQUAL(from_file.getNrFragments(), index.getNrFragments())
+    from_file.query(exp, 0, db.size(), 0.01, false, 1, 10, candidates, workspace);
+    TEST_EQUAL(candidates.size(), expected.size())
+    ABORT_IF(candidates.size() != expected.size())
+    for (Size i = 0; i < candidates.size(); ++i)
+    {
+      TEST_EQUAL(candidates[i].entry, expected[i].entry)
+      TEST_EQUAL(candidates[i].shared_peaks, expected[i].shared_peaks)
+    }
+
+    // copies share the mapping
+    FragmentIndex copy(from_file);
+    TEST_EQUAL(copy.isMemoryMapped(), memory_map)
+    copy.query(exp, 0, db.size(), 0.01, false, 1, 10, candidates, workspace);
+    TEST_EQUAL(candidates.size(), expected.size())
+  }
+
+  // index of a different peptide database with the same key
+  TEST_EXCEPTION(Exception::ParseError, loaded.load(filename, key, db.size() + 1))
+
+  // not an index
+  String text_file;
+  NEW_TMP_FILE(text_file)
+  {
+    ofstream ofs(text_file.c_str());
+    ofs << "not a fragment index, but long enough to contain a header" << endl;
+  }
+  TEST_EXCEPTION(Exception::ParseError, loaded.load(text_file, key, db.size()))
+
+  // truncated, or an entry index out of range (header: 56 bytes, followed by the bin offsets and the fragments)
+  String content;
+  {
+    ifstream ifs(filename.c_str(), ios::binary);
+    content = String((istreambuf_iterator<char>(ifs)), istreambuf_iterator<char>());
+  }
+  String truncated_file;
+  NEW_TMP_FILE(truncated_file)
+  {
+    ofstream ofs(truncated_file.c_str(), ios::binary);
+    ofs.write(content.c_str(), content.size() - 4);
+  }
+  TEST_EXCEPTION(Exception::ParseError, loaded.load(truncated_file, key, db.size()))
+
+  String corrupt_file;
+  NEW_TMP_FILE(corrupt_file)
+  {
+    String corrupt_content(content);
+    const UInt32 out_of_range = 1000;
+    memcpy(&corrupt_content[content.size() - sizeof(UInt32)], &out_of_range, sizeof(out_of_range)); // entry of the last fragment
+    ofstream ofs(corrupt_file.c_str(), ios::binary);
+    ofs.write(corrupt_content.c_str(), corrupt_content.size());
+  }
+  for (bool memory_map : {true, false})
+  {
+    FragmentIndex corrupt(0.02);
+    TEST_EXCEPTION(Exception::ParseError, corrupt.load(corrupt_file, key, db.size(), memory_map))
+    TEST_EQUAL(corrupt.size(), 0)
+  }
+}
+END_SECTION
+
+START_SECTION((bool isMemoryMapped() const))
+{
+  NOT_TESTABLE // see load()
+}
+END_SECTION
+
+START_SECTION((FragmentIndex(const FragmentIndex& rhs)))
+{
+  FragmentIndex copy(index);
+  TEST_EQUAL(copy.size(), index.size())
+  TEST_EQUAL(copy.getNrFragments(), index.getNrFragments())
+  TEST_REAL_SIMILAR(copy.getBinSize(), index.getBinSize())
+}
+END_SECTION
+
+START_SECTION((FragmentIndex& operator=(const FragmentIndex& rhs)))
+{
+  FragmentIndex copy;
+  copy = index;
+  TEST_EQUAL(copy.size(), index.size())
+  TEST_EQUAL(copy.getNrFragments(), index.getNrFragments())
+
+  // the copy does not depend on the original
+  vector<FragmentIndex::Candidate> candidates;
+  vector<UInt32> workspace;
+  {
+    FragmentIndex tmp(index);
+    copy = tmp;
+  }
+  copy.query(getTheoreticalSpectrum(aaak), 0, db.size(), 0.01, false, 1, 10, candidates, workspace);
+  TEST_EQUAL(candidates.empty(), false)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -1007,6 +1007,82 @@ START_SECTION((template<class PeakT> static void keepHitsMatchingProteins(MSExpe
 }
 END_SECTION
 
+START_SECTION((static void removeEmptyIdentifications(PSMTable& psms)))
+{
+  vector<PeptideIdentification> peptides = global_peptides;
+  peptides.resize(3);
+  peptides[2] = peptides[0];
+  peptides[1].getHits().clear();
+  PSMTable psms(peptides);
+  IDFilter::removeEmptyIdentifications(peptides);
+  IDFilter::removeEmptyIdentifications(psms);
+  vector<PeptideIdentification> result;
+  psms.getIdentifications(result);
+  TEST_EQUAL(result.size(), 2)
+  TEST_EQUAL(result == peptides, true)
+}
+END_SECTION
+
+START_SECTION((static void filterHitsByScore(PSMTable& psms, double threshold_score)))
+{
+  vector<PeptideIdentification> peptides = global_peptides;
+  // second identification with reversed score orientation
+  peptides.push_back(peptides[0]);
+  peptides[1].setHigherScoreBetter(false);
+  PSMTable psms(peptides);
+  IDFilter::filterHitsByScore(peptides, 33);
+  IDFilter::filterHitsByScore(psms, 33);
+  vector<PeptideIdentification> result;
+  psms.getIdentifications(result);
+  TEST_EQUAL(result[0].getHits().size(), 5)
+  TEST_EQUAL(result == peptides, true)
+
+  IDFilter::filterHitsByScore(peptides, 41);
+  IDFilter::filterHitsByScore(psms, 41);
+  psms.getIdentifications(result);
+  TEST_EQUAL(result[0].getHits().size(), 0)
+  TEST_EQUAL(result == peptides, true)
+}
+END_SECTION
+
+START_SECTION((static void keepNBestHits(PSMTable& psms, Size n)))
+{
+  vector<PeptideIdentification> peptides = global_peptides;
+  peptides.push_back(peptides[0]);
+  peptides[1].setHigherScoreBetter(false);
+  PSMTable psms(peptides);
+  IDFilter::keepNBestHits(peptides, 3);
+  IDFilter::keepNBestHits(psms, 3);
+  vector<PeptideIdentification> result;
+  psms.getIdentifications(result);
+  TEST_EQUAL(result[0].getHits().size(), 3)
+  TEST_EQUAL(result == peptides, true)
+}
+END_SECTION
+
+START_SECTION((static void removeDecoyHits(PSMTable& psms)))
+{
+  vector<PeptideIdentification> peptides(2);
+  peptides[0].getHits().resize(6);
+  peptides[0].getHits()[0].setMetaValue("target_decoy", "target");
+  peptides[0].getHits()[1].setMetaValue("target_decoy", "decoy");
+  peptides[0].getHits()[2].setMetaValue("target_decoy", "target+decoy");
+  // no meta value on hit 3
+  peptides[0].getHits()[4].setMetaValue("isDecoy", "true");
+  peptides[0].getHits()[5].setMetaValue("isDecoy", "false");
+  peptides[1].getHits().resize(1);
+  peptides[1].getHits()[0].setMetaValue("target_decoy", "decoy");
+  PSMTable psms(peptides);
+  IDFilter::removeDecoyHits(peptides);
+  IDFilter::removeDecoyHits(psms);
+  vector<PeptideIdentification> result;
+  psms.getIdentifications(result);
+  TEST_EQUAL(result[0].getHits().size(), 4)
+  TEST_EQUAL(result[1].getHits().size(), 0)
+  TEST_EQUAL(result == peptides, true)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 
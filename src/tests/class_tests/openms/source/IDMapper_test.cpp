@@ -405,6 +405,64 @@ START_SECTION((template < typename FeatureType > void annotate(FeatureMap< Featu
 END_SECTION
 
 
+START_SECTION((void annotate(FeatureMap& map, const PSMTable& psms, const std::vector<ProteinIdentification>& protein_ids, bool use_centroid_rt = false, bool use_centroid_mz = false)))
+{
+  vector<PeptideIdentification> identifications;
+  vector<ProteinIdentification> protein_identifications;
+  IdXMLFile().load(OPENMS_GET_TEST_DATA_PATH("IDMapper_2.idXML"), protein_identifications, identifications);
+  PSMTable psms(identifications);
+
+  IDMapper mapper;
+  Param p = mapper.getParameters();
+  p.setValue("rt_tolerance", 0.0);
+  p.setValue("mz_tolerance", 0.0);
+  p.setValue("mz_measure", "Da");
+  p.setValue("ignore_charge", "true");
+  mapper.setParameters(p);
+
+  // same results as the variant for vectors of peptide identifications:
+  // mapping to convex hulls
+  FeatureMap fm, fm_psms;
+  FeatureXMLFile().load(OPENMS_GET_TEST_DATA_PATH("IDMapper_2.featureXML"), fm);
+  fm_psms = fm;
+  mapper.annotate(fm, identifications, protein_identifications);
+  mapper.annotate(fm_psms, psms, protein_identifications);
+  TEST_EQUAL(fm_psms[0].getPeptideIdentifications().size(), 7)
+  TEST_EQUAL(fm_psms.getUnassignedPeptideIdentifications().size(), 3)
+  TEST_EQUAL(fm_psms == fm, true)
+
+  // mapping to centroids
+  p.setValue("rt_tolerance", 4.0);
+  p.setValue("mz_tolerance", 1.5);
+  mapper.setParameters(p);
+  FeatureXMLFile().load(OPENMS_GET_TEST_DATA_PATH("IDMapper_2.featureXML"), fm);
+  fm_psms = fm;
+  mapper.annotate(fm, identifications, protein_identifications, true, true);
+  mapper.annotate(fm_psms, psms, protein_identifications, true, true);
+  TEST_EQUAL(fm_psms[0].getPeptideIdentifications().size(), 2)
+  TEST_EQUAL(fm_psms == fm, true)
+
+  // charge-specific matching
+  p.setValue("rt_tolerance", 0.0);
+  p.setValue("mz_tolerance", 0.0);
+  p.setValue("ignore_charge", "false");
+  mapper.setParameters(p);
+  FeatureXMLFile().load(OPENMS_GET_TEST_DATA_PATH("IDMapper_2.featureXML"), fm);
+  fm_psms = fm;
+  mapper.annotate(fm, identifications, protein_identifications);
+  mapper.annotate(fm_psms, psms, protein_identifications);
+  TEST_EQUAL(fm_psms[0].getPeptideIdentifications().size(), 3)
+  TEST_EQUAL(fm_psms == fm, true)
+
+  // identifications without RT
+  identifications.resize(1);
+  identifications[0].setRT(std::numeric_limits<double>::quiet_NaN());
+  psms = PSMTable(identifications);
+  TEST_EXCEPTION(Exception::MissingInformation, mapper.annotate(fm, identifications, protein_identifications))
+  TEST_EXCEPTION(Exception::MissingInformation, mapper.annotate(fm_psms, psms, protein_identifications))
+}
+END_SECTION
+
 START_SECTION((void annotate(ConsensusMap& map, const std::vector<PeptideIdentification>& ids, const std::vector<ProteinIdentification>& protein_ids, bool measure_from_subelements=false)))
 {
   IDMapper mapper;
@@ -0,0 +1,318 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+
+#include <OpenMS/FORMAT/IdBinaryFile.h>
+#include <OpenMS/FORMAT/IdXMLFile.h>
+#include <OpenMS/FORMAT/FileHandler.h>
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+
+///////////////////////////
+
+START_TEST(IdBinaryFile, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+// test data
+vector<ProteinIdentification> protein_ids(1);
+protein_ids[0].setIdentifier("search");
+protein_ids[0].setSearchEngine("SearchEngine");
+protein_ids[0].setScoreType("score");
+protein_ids[0].getSearchParameters().db = "database.fasta";
+protein_ids[0].getSearchParameters().fixed_modifications.push_back("Carbamidomethyl (C)");
+protein_ids[0].getSearchParameters().precursor_mass_tolerance = 10.0;
+protein_ids[0].getSearchParameters().precursor_mass_tolerance_ppm = true;
+ProteinHit protein_hit(0.5, 1, "PROT1", "PEPTIDERPEPTIDEK");
+protein_hit.setMetaValue("description", "protein");
+protein_ids[0].insertHit(protein_hit);
+
+vector<PeptideIdentification> peptide_ids(10);
+for (Size i = 0; i < peptide_ids.size(); ++i)
+{
+  PeptideIdentification& id = peptide_ids[i];
+  id.setIdentifier("search");
+  id.setScoreType("score");
+  id.setRT(100.0 + i);
+  id.setMZ(500.0 + i);
+  id.setMetaValue("spectrum_reference", "scan=" + String(i));
+  for (Size j = 0; j < i % 3; ++j)
+  {
+    PeptideHit hit(10.0 - j, j + 1, 2, AASequence::fromString(j == 0 ? "PEPTIDER" : "PEPTM(Oxidation)IDEK"));
+    PeptideEvidence evidence("PROT1", 0, 7, '[', 'P');
+    hit.addPeptideEvidence(evidence);
+    hit.setMetaValue("target_decoy", "target");
+    hit.setMetaValue("list", ListUtils::create<double>("1.5,2.5"));
+    id.insertHit(hit);
+  }
+}
+
+IdBinaryFile* ptr = nullptr;
+IdBinaryFile* null_ptr = nullptr;
+START_SECTION((IdBinaryFile()))
+{
+  ptr = new IdBinaryFile();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->getSections(), IdBinaryFile::ALL_SECTIONS)
+}
+END_SECTION
+
+START_SECTION((~IdBinaryFile()))
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((void store(const String& filename, const std::vector<ProteinIdentification>& protein_ids, const std::vector<PeptideIdentification>& peptide_ids)))
+{
+  String filename;
+  NEW_TMP_FILE(filename)
+  IdBinaryFile().store(filename, protein_ids, peptide_ids);
+  TEST_EQUAL(IdBinaryFile::isIdBinaryFile(filename), true)
+  TEST_EXCEPTION(Exception::UnableToCreateFile, IdBinaryFile().store("/does/not/exist/file.idBin", protein_ids, peptide_ids))
+}
+END_SECTION
+
+START_SECTION((void load(const String& filename, std::vector<ProteinIdentification>& protein_ids, std::vector<PeptideIdentification>& peptide_ids)))
+{
+  String filename;
+  NEW_TMP_FILE(filename)
+  IdBinaryFile().store(filename, protein_ids, peptide_ids);
+
+  vector<ProteinIdentification> protein_result;
+  vector<PeptideIdentification> peptide_result;
+  IdBinaryFile().load(filename, protein_result, peptide_result);
+  TEST_EQUAL(protein_result.size(), 1)
+  TEST_EQUAL(protein_result == protein_ids, true)
+  TEST_EQUAL(peptide_result.size(), 10)
+  TEST_EQUAL(peptide_result == peptide_ids, true)
+  ABORT_IF(peptide_result.size() != 10)
+  TEST_EQUAL(peptide_result[5].getHits()[1].getSequence().toString(), "PEPTM(Oxidation)IDEK")
+  TEST_EQUAL(peptide_result[5].getHits()[1].getMetaValue("list").toDoubleList().size(), 2)
+
+  // empty file
+  IdBinaryFile().store(filename, vector<ProteinIdentification>(), vector<PeptideIdentification>());
+  IdBinaryFile().load(filename, protein_result, peptide_result);
+  TEST_EQUAL(protein_result.empty(), true)
+  TEST_EQUAL(peptide_result.empty(), true)
+
+  TEST_EXCEPTION(Exception::FileNotFound, IdBinaryFile().load("/does/not/exist/file.idBin", protein_result, peptide_result))
+  TEST_EXCEPTION(Exception::ParseError, IdBinaryFile().load(OPENMS_GET_TEST_DATA_PATH("IdXMLFile_whole.idXML"), protein_result, peptide_result))
+}
+END_SECTION
+
+START_SECTION((void setSections(UInt sections)))
+{
+  String filename;
+  NEW_TMP_FILE(filename)
+  IdBinaryFile().store(filename, protein_ids, peptide_ids);
+
+  IdBinaryFile file;
+  file.setSections(IdBinaryFile::POSITIONS | IdBinaryFile::HITS);
+  TEST_EQUAL(file.getSections(), IdBinaryFile::POSITIONS | IdBinaryFile::HITS)
+
+  vector<ProteinIdentification> protein_result;
+  vector<PeptideIdentification> peptide_result;
+  file.load(filename, protein_result, peptide_result);
+  TEST_EQUAL(protein_result == protein_ids, true)
+  ABORT_IF(peptide_result.size() != 10)
+  TEST_REAL_SIMILAR(peptide_result[4].getRT(), 104.0)
+  TEST_REAL_SIMILAR(peptide_result[4].getMZ(), 504.0)
+  TEST_EQUAL(peptide_result[4].getIdentifier(), "")
+  TEST_EQUAL(peptide_result[4].metaValueExists("spectrum_reference"), false)
+  ABORT_IF(peptide_result[4].getHits().size() != 1)
+  TEST_EQUAL(peptide_result[4].getHits()[0].getSequence().toString(), "PEPTIDER")
+  TEST_EQUAL(peptide_result[4].getHits()[0].getPeptideEvidences().empty(), true)
+  TEST_EQUAL(peptide_result[4].getHits()[0].metaValueExists("target_decoy"), false)
+
+  // hit meta values are only read together with hits
+  file.setSections(IdBinaryFile::META_VALUES);
+  file.load(filename, protein_result, peptide_result);
+  TEST_EQUAL(peptide_result[4].getMetaValue("spectrum_reference"), "scan=4")
+  TEST_EQUAL(peptide_result[4].getHits().empty(), true)
+}
+END_SECTION
+
+START_SECTION((UInt getSections() const))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((static bool isIdBinaryFile(const String& filename)))
+{
+  TEST_EQUAL(IdBinaryFile::isIdBinaryFile(OPENMS_GET_TEST_DATA_PATH("IdXMLFile_whole.idXML")), false)
+  TEST_EQUAL(IdBinaryFile::isIdBinaryFile("/does/not/exist/file.idBin"), false)
+
+  String filename;
+  NEW_TMP_FILE(filename)
+  IdBinaryFile().store(filename, protein_ids, peptide_ids);
+  TEST_EQUAL(IdBinaryFile::isIdBinaryFile(filename), true)
+  TEST_EQUAL(FileHandler::getTypeByContent(filename), FileTypes::IDBIN)
+}
+END_SECTION
+
+START_SECTION((Reader and Writer))
+{
+  String filename;
+  NEW_TMP_FILE(filename)
+  {
+    IdBinaryFile::Writer writer(filename, protein_ids, 3);
+    for (const PeptideIdentification& id : peptide_ids)
+    {
+      writer.add(id);
+    }
+    // file is finished by the destructor
+  }
+
+  IdBinaryFile::Reader reader(filename);
+  TEST_EQUAL(reader.getNrPeptideIdentifications(), 10)
+  TEST_EQUAL(reader.getProteinIdentifications() == protein_ids, true)
+  vector<PeptideIdentification> block, peptide_result;
+  vector<Size> block_sizes;
+  while (reader.readBlock(block))
+  {
+    block_sizes.push_back(block.size());
+    peptide_result.insert(peptide_result.end(), block.begin(), block.end());
+  }
+  TEST_EQUAL(block.empty(), true)
+  TEST_EQUAL(block_sizes.size(), 4)
+  ABORT_IF(block_sizes.size() != 4)
+  TEST_EQUAL(block_sizes[0], 3)
+  TEST_EQUAL(block_sizes[3], 1)
+  TEST_EQUAL(peptide_result == peptide_ids, true)
+}
+END_SECTION
+
+START_SECTION(([EXTRA] round trip of idXML data))
+{
+  vector<ProteinIdentification> protein_xml;
+  vector<PeptideIdentification> peptide_xml;
+  IdXMLFile().load(OPENMS_GET_TEST_DATA_PATH("IdXMLFile_whole.idXML"), protein_xml, peptide_xml);
+
+  String filename;
+  NEW_TMP_FILE(filename)
+  IdBinaryFile().store(filename, protein_xml, peptide_xml);
+  vector<ProteinIdentification> protein_result;
+  vector<PeptideIdentification> peptide_result;
+  IdBinaryFile().load(filename, protein_result, peptide_result);
+  TEST_EQUAL(protein_result.size(), protein_xml.size())
+  TEST_EQUAL(protein_result == protein_xml, true)
+  TEST_EQUAL(peptide_result.size(), peptide_xml.size())
+  TEST_EQUAL(peptide_result == peptide_xml, true)
+}
+END_SECTION
+
+START_SECTION(([EXTRA] round trip of many identifications))
+{
+  vector<PeptideIdentification> many_ids;
+  for (Size i = 0; i < 200; ++i)
+  {
+    many_ids.insert(many_ids.end(), peptide_ids.begin(), peptide_ids.end());
+  }
+
+  String xml_file, bin_file;
+  NEW_TMP_FILE(xml_file)
+  NEW_TMP_FILE(bin_file)
+  IdXMLFile().store(xml_file, protein_ids, many_ids);
+  IdBinaryFile().store(bin_file, protein_ids, many_ids);
+
+  vector<ProteinIdentification> protein_result;
+  vector<PeptideIdentification> xml_result, bin_result;
+  IdXMLFile().load(xml_file, protein_result, xml_result);
+  IdBinaryFile().load(bin_file, protein_result, bin_result);
+  TEST_EQUAL(bin_result.size(), many_ids.size())
+  TEST_EQUAL(bin_result == xml_result, true)
+}
+END_SECTION
+
+START_SECTION(([EXTRA] corrupt counts are reported as parse errors))
+{
+  String filename;
+  NEW_TMP_FILE(filename)
+  IdBinaryFile().store(filename, protein_ids, peptide_ids);
+  string content;
+  {
+    ifstream ifs(filename.c_str(), ios::in | ios::binary);
+    content.assign((istreambuf_iterator<char>(ifs)), istreambuf_iterator<char>());
+  }
+
+  // layout: file header (magic, version, #peptide IDs, #blocks, offset of meta value names),
+  // size of the protein data, protein data (starting with the number of protein IDs), blocks
+  const Size header_size = 8 + 4 * sizeof(UInt64);
+  UInt64 protein_size;
+  memcpy(&protein_size, &content[header_size], sizeof(protein_size));
+  const Size protein_pos = header_size + sizeof(UInt64);
+  const Size block_pos = protein_pos + protein_size;
+  const UInt64 huge = numeric_limits<UInt64>::max() / 4;
+
+  String corrupt_file;
+  NEW_TMP_FILE(corrupt_file)
+  vector<ProteinIdentification> protein_result;
+  vector<PeptideIdentification> peptide_result;
+
+  // number of protein identifications
+  string corrupt = content;
+  memcpy(&corrupt[protein_pos], &huge, sizeof(huge));
+  ofstream(corrupt_file.c_str(), ios::out | ios::binary).write(corrupt.data(), corrupt.size());
+  TEST_EXCEPTION(Exception::ParseError, IdBinaryFile().load(corrupt_file, protein_result, peptide_result))
+
+  // total number of peptide identifications
+  corrupt = content;
+  memcpy(&corrupt[8 + sizeof(UInt64)], &huge, sizeof(huge));
+  ofstream(corrupt_file.c_str(), ios::out | ios::binary).write(corrupt.data(), corrupt.size());
+  TEST_EXCEPTION(Exception::ParseError, IdBinaryFile().load(corrupt_file, protein_result, peptide_result))
+
+  // number of peptide identifications in the first block
+  corrupt = content;
+  memcpy(&corrupt[block_pos], &huge, sizeof(huge));
+  ofstream(corrupt_file.c_str(), ios::out | ios::binary).write(corrupt.data(), corrupt.size());
+  TEST_EXCEPTION(Exception::ParseError, IdBinaryFile().load(corrupt_file, protein_result, peptide_result))
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -132,6 +132,46 @@ START_SECTION(( void openFile(String filename) ))
 }
 END_SECTION
 
+START_SECTION(( bool isMemoryMapped() const ))
+{
+  IndexedMzMLHandler file;
+  TEST_EQUAL(file.isMemoryMapped(), false)
+  file.openFile(OPENMS_GET_TEST_DATA_PATH("MzMLFile_1.mzML"));
+  TEST_EQUAL(file.isMemoryMapped(), false)
+  file.openFile(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML"));
+  TEST_EQUAL(file.isMemoryMapped(), true)
+
+  // copies share the mapping
+  IndexedMzMLHandler file2(file);
+  TEST_EQUAL(file2.isMemoryMapped(), true)
+  TEST_EQUAL(file2.getSpectrumById(0)->getMZArray()->data.size(), file.getSpectrumById(0)->getMZArray()->data.size())
+}
+END_SECTION
+
+START_SECTION(([EXTRA] concurrent access to the same object))
+{
+  IndexedMzMLHandler file(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML"));
+  TEST_EQUAL(file.isMemoryMapped(), true)
+
+  PeakMap exp;
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML"),exp);
+
+  const int nr_reads = 100;
+  std::vector<Size> sizes(nr_reads);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (int i = 0; i < nr_reads; i++)
+  {
+    sizes[i] = file.getSpectrumById(i % 2)->getMZArray()->data.size();
+  }
+  for (int i = 0; i < nr_reads; i++)
+  {
+    TEST_EQUAL(sizes[i], exp.getSpectra()[i % 2].size())
+  }
+}
+END_SECTION
+
 START_SECTION(( size_t getNrSpectra() const ))
 {
   IndexedMzMLHandler file(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML"));
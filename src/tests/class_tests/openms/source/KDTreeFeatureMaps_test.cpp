@@ -114,6 +114,15 @@ START_SECTION((void addMaps(const std::vector<MapType>& maps)))
   TEST_EQUAL(kd_data_3.size(), 2);
 END_SECTION
 
+START_SECTION((void addMaps(const std::vector<MapType>& maps, UnaryPredicate accept)))
+  KDTreeFeatureMaps kd_filtered;
+  kd_filtered.addMaps(fmaps, [](const BaseFeature& f) { return f.getMZ() > 450; });
+  TEST_EQUAL(kd_filtered.size(), 1);
+  TEST_EQUAL(kd_filtered.numMaps(), 1);
+  // features are referenced, not copied:
+  TEST_EQUAL(kd_filtered.feature(0) == &fmaps[0][1], true);
+END_SECTION
+
 START_SECTION((void addFeature(Size mt_map_index, const BaseFeature* feature)))
   Feature f3;
   f3.setMZ(300);
@@ -97,6 +97,33 @@ START_SECTION((void align(const PeakMap& map, TransformationDescription& trafo))
 }
 END_SECTION
 
+START_SECTION((const ConsensusMap& getReference() const))
+{
+  MzMLFile f;
+  std::vector<PeakMap > maps(2);
+  f.load(OPENMS_GET_TEST_DATA_PATH("MapAlignmentAlgorithmPoseClustering_in1.mzML.gz"), maps[0]);
+  f.load(OPENMS_GET_TEST_DATA_PATH("MapAlignmentAlgorithmPoseClustering_in2.mzML.gz"), maps[1]);
+
+  MapAlignmentAlgorithmPoseClustering aligner;
+  TEST_EQUAL(aligner.getReference().size(), 0);
+  aligner.setReference(maps[0]);
+  TEST_EQUAL(aligner.getReference().size(), 1000); // "max_num_peaks_considered"
+
+  // aligning against a stored reference model gives the same result:
+  FeatureMap model;
+  MapConversion::convert(aligner.getReference(), true, model);
+  MapAlignmentAlgorithmPoseClustering aligner2;
+  aligner2.setReference(model);
+  TEST_EQUAL(aligner2.getReference().size(), 1000);
+
+  TransformationDescription trafo, trafo2;
+  aligner.align(maps[1], trafo);
+  aligner2.align(maps[1], trafo2);
+  TEST_EQUAL(trafo2.getModelType(), "linear");
+  TEST_EQUAL(trafo2.getDataPoints().size(), trafo.getDataPoints().size());
+}
+END_SECTION
+
 START_SECTION((void align(const FeatureMap& map, TransformationDescription& trafo)))
 {
   // Tested extensively in TEST/TOPP
@@ -175,6 +175,114 @@ START_SECTION((void run(const PeakMap &, std::vector< MassTrace > &)))
 }
 END_SECTION
 
+START_SECTION((void run(const PeakCollector& peaks, std::vector<MassTrace>& found_masstraces, const Size max_traces = 0)))
+{
+    MassTraceDetection mtd;
+    mtd.setParameters(p_mtd);
+
+    // stream the spectra (MS2 spectra are ignored)
+    MassTraceDetection::PeakCollector peaks(mtd);
+    peaks.setExpectedSize(input.size() + 1, 0);
+    MSSpectrum ms2;
+    ms2.setMSLevel(2);
+    ms2.push_back(Peak1D(500.0, 6000.0));
+    peaks.consumeSpectrum(ms2);
+    for (Size i = 0; i < input.size(); ++i)
+    {
+      MSSpectrum s = input[i];
+      peaks.consumeSpectrum(s);
+    }
+    TEST_EQUAL(peaks.getNrSpectra(), input.size())
+
+    std::vector<MassTrace> traces;
+    mtd.run(peaks, traces);
+    TEST_EQUAL(traces.size(), 3);
+    ABORT_IF(traces.size() != 3)
+    for (Size i = 0; i < traces.size(); ++i)
+    {
+        TEST_EQUAL(traces[i].getSize(), exp_mt_lengths[i]);
+        TEST_EQUAL(traces[i].getLabel(), "T" + String(i + 1));
+        TEST_REAL_SIMILAR(traces[i].getCentroidRT(), exp_mt_rts[i]);
+        TEST_REAL_SIMILAR(traces[i].getCentroidMZ(), exp_mt_mzs[i]);
+        TEST_REAL_SIMILAR(traces[i].computePeakArea(), exp_mt_ints[i]);
+    }
+
+    // maximum number of traces
+    mtd.run(peaks, traces, 2);
+    TEST_EQUAL(traces.size(), 2);
+
+    // too few spectra
+    MassTraceDetection::PeakCollector few_peaks(mtd);
+    MSSpectrum s = input[0];
+    few_peaks.consumeSpectrum(s);
+    TEST_EXCEPTION(Exception::InvalidValue, mtd.run(few_peaks, traces))
+}
+END_SECTION
+
+START_SECTION([EXTRA] partitioned detection)
+{
+    // the traces are about 1 Th apart and end up in different partitions;
+    // the result must be the same as for sequential detection
+    for (Size partitions : {2, 3, 4, 16})
+    {
+      Param p = p_mtd;
+      p.setValue("mz_partitions", (int)partitions);
+      MassTraceDetection mtd;
+      mtd.setParameters(p);
+
+      std::vector<MassTrace> traces;
+      mtd.run(input, traces);
+      TEST_EQUAL(traces.size(), 3);
+      ABORT_IF(traces.size() != 3)
+      for (Size i = 0; i < traces.size(); ++i)
+      {
+          TEST_EQUAL(traces[i].getSize(), exp_mt_lengths[i]);
+          TEST_EQUAL(traces[i].getLabel(), "T" + String(i + 1));
+          TEST_REAL_SIMILAR(traces[i].getCentroidRT(), exp_mt_rts[i]);
+          TEST_REAL_SIMILAR(traces[i].getCentroidMZ(), exp_mt_mzs[i]);
+          TEST_REAL_SIMILAR(traces[i].computePeakArea(), exp_mt_ints[i]);
+      }
+
+      mtd.run(input, traces, 1);
+      TEST_EQUAL(traces.size(), 1);
+      TEST_EQUAL(traces[0].getSize(), exp_mt_lengths[0]);
+    }
+
+    // without overlap, the partition borders split the traces (they lie at
+    // m/z quantiles of the apices), so most extensions need to be repeated
+    // when merging - the result must still be the one of sequential detection
+    for (double min_trace_length : {3.0, 5.0})
+    {
+      Param p = p_mtd;
+      p.setValue("min_trace_length", min_trace_length);
+      MassTraceDetection sequential;
+      sequential.setParameters(p);
+      std::vector<MassTrace> expected;
+      sequential.run(input, expected);
+
+      p.setValue("mz_partitions", 64);
+      p.setValue("mz_partition_overlap", 0.0);
+      MassTraceDetection mtd;
+      mtd.setParameters(p);
+      std::vector<MassTrace> traces;
+      mtd.run(input, traces);
+
+      TEST_EQUAL(traces.size(), expected.size());
+      ABORT_IF(traces.size() != expected.size())
+      for (Size i = 0; i < traces.size(); ++i)
+      {
+        TEST_EQUAL(traces[i].getSize(), expected[i].getSize());
+        TEST_EQUAL(traces[i].getLabel(), expected[i].getLabel());
+        TEST_REAL_SIMILAR(traces[i].getCentroidMZ(), expected[i].getCentroidMZ());
+        TEST_REAL_SIMILAR(traces[i].getCentroidRT(), expected[i].getCentroidRT());
+        TEST_REAL_SIMILAR(traces[i].begin()->getRT(), expected[i].begin()->getRT());
+        TEST_REAL_SIMILAR(traces[i].rbegin()->getRT(), expected[i].rbegin()->getRT());
+        TEST_REAL_SIMILAR(traces[i].computePeakArea(), expected[i].computePeakArea());
+      }
+    }
+}
+END_SECTION
+
 std::vector<MassTrace> filt;
 
 //START_SECTION((void filterByPeakWidth(std::vector< MassTrace > &, std::vector< MassTrace > &)))
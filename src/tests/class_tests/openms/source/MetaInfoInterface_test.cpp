@@ -345,6 +345,29 @@ START_SECTION((void removeMetaValue(const String& name)))
 	i.removeMetaValue("icon");
 END_SECTION
 
+START_SECTION((MetaValueKey(const String& name, const String& description = "", const String& unit = "")))
+{
+  // reserved names keep their index
+  MetaValueKey label("label");
+  TEST_EQUAL(label.getIndex(), 3)
+
+  MetaValueKey key("MetaValueKey_test", "a test key", "s");
+  TEST_EQUAL(key.getIndex(), MetaInfoInterface::metaRegistry().getIndex("MetaValueKey_test"))
+  TEST_STRING_EQUAL(MetaInfoInterface::metaRegistry().getDescription(key), "a test key")
+  TEST_STRING_EQUAL(MetaInfoInterface::metaRegistry().getUnit(key), "s")
+  // registering again yields the same index
+  TEST_EQUAL(MetaValueKey("MetaValueKey_test").getIndex(), key.getIndex())
+
+  // keys can be used wherever an index is accepted
+  MetaInfoInterface i;
+  i.setMetaValue(key, 42);
+  TEST_EQUAL(i.metaValueExists("MetaValueKey_test"), true)
+  TEST_EQUAL((Int)i.getMetaValue(key), 42)
+  i.removeMetaValue(key);
+  TEST_EQUAL(i.metaValueExists(key), false)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -43,6 +43,8 @@
 
 #include <OpenMS/METADATA/MetaInfoRegistry.h>
 
+#include <set>
+
 ///////////////////////////
 
 START_TEST(MetaInfoRegistry, "$Id$")
@@ -234,6 +236,41 @@ START_SECTION([EXTRA] multithreaded example)
 }
 END_SECTION
 
+START_SECTION([EXTRA] concurrent registration and lookup)
+{
+  // many threads register and look up the same set of names: every name
+  // must end up with exactly one index and lookups must never block
+  MetaInfoRegistry registry;
+  const int nr_names = 5000;
+  int inconsistent = 0;
+#pragma omp parallel for reduction(+: inconsistent)
+  for (int k = 0; k < 4 * nr_names; ++k)
+  {
+    String name = "concurrent_" + String(k % nr_names);
+    UInt index = registry.registerName(name);
+    if (registry.getIndex(name) != index) ++inconsistent;
+    if (registry.getName(index) != name) ++inconsistent;
+  }
+  TEST_EQUAL(inconsistent, 0)
+
+  std::set<UInt> indices;
+  for (int k = 0; k < nr_names; ++k)
+  {
+    indices.insert(registry.getIndex("concurrent_" + String(k)));
+  }
+  TEST_EQUAL(indices.size(), nr_names)
+  TEST_EQUAL(*indices.begin(), 1024)
+  TEST_EQUAL(*indices.rbegin(), 1024 + nr_names - 1)
+  TEST_EQUAL(registry.getIndex("concurrent_" + String(nr_names)), UInt(-1))
+
+  // the copy contains all names (more than there are hash buckets)
+  MetaInfoRegistry copy(registry);
+  TEST_EQUAL(copy.getIndex("concurrent_4999"), registry.getIndex("concurrent_4999"))
+  TEST_STRING_EQUAL(copy.getName(1024), registry.getName(1024))
+  TEST_EQUAL(copy.registerName("one more"), 1024 + nr_names)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -286,13 +286,19 @@ START_SECTION((void getAllSearchModifications(std::vector<String>& modifications
 }
 END_SECTION
 
-START_SECTION((bool addModification(ResidueModification* modification)))
+START_SECTION((const ResidueModification* addModification(ResidueModification* new_mod)))
 {
   TEST_EQUAL(ptr->has("Phospho (E)"), false);
   ResidueModification* modification = new ResidueModification();
   modification->setFullId("Phospho (E)");
-  ptr->addModification(modification);
+  TEST_EQUAL(ptr->addModification(modification) == modification, true);
   TEST_EQUAL(ptr->has("Phospho (E)"), true);
+
+  // an existing modification is returned, the duplicate stays with the caller
+  ResidueModification* duplicate = new ResidueModification();
+  duplicate->setFullId("Phospho (E)");
+  TEST_EQUAL(ptr->addModification(duplicate) == modification, true);
+  delete duplicate;
 }
 END_SECTION
 
@@ -347,6 +353,26 @@ START_SECTION([EXTRA] multithreaded example)
   }
   TEST_EQUAL(test, nr_iterations*1.0)
 
+  // Every thread adds the same modification without checking first - all
+  // must receive the single registered instance
+  const ResidueModification* first = nullptr;
+  int mismatches = 0;
+  #pragma omp parallel for reduction (+: mismatches)
+  for (int k = 1; k < nr_iterations + 1; k++)
+  {
+    ResidueModification * new_mod = new ResidueModification();
+    new_mod->setFullId("mod_race");
+    new_mod->setAverageMass(1.0);
+    const ResidueModification* registered = mdb->addModification(new_mod);
+    if (registered != new_mod) delete new_mod;
+    #pragma omp critical (test_first)
+    {
+      if (first == nullptr) first = registered;
+      if (registered != first) ++mismatches;
+    }
+  }
+  TEST_EQUAL(mismatches, 0)
+  TEST_EQUAL(first == mdb->getModification("mod_race"), true)
  }
 END_SECTION
 
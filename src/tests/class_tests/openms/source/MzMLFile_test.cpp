@@ -42,6 +42,10 @@
 #include <OpenMS/FORMAT/FileTypes.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace OpenMS;
 using namespace std;
 
@@ -53,6 +57,14 @@ DRange<1> makeRange(double a, double b)
   return DRange<1>(pa, pb);
 }
 
+/// exposes the parallel loader to check which code path is taken
+class MzMLFileParallelTest :
+  public MzMLFile
+{
+public:
+  using MzMLFile::loadParallel_;
+};
+
 ///////////////////////////
 
 START_TEST(MzMLFile, "$Id$")
@@ -896,6 +908,61 @@ START_SECTION((template <typename MapType> void load(const String& filename, Map
 }
 END_SECTION
 
+START_SECTION([EXTRA] parallel loading of indexed mzML)
+{
+  // a tiny chunk size forces the parallel code path (if OpenMP is enabled)
+  MzMLFile file;
+  StringList files = ListUtils::create<String>(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML") + "," +
+                                               OPENMS_GET_TEST_DATA_PATH("MzMLFile_4_indexed.mzML") + "," +
+                                               OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_2_broken.mzML"));
+  for (const auto& f : files)
+  {
+    PeakMap exp_serial, exp_parallel;
+    file.getOptions().setParallelChunkSize(0);
+    file.load(f, exp_serial);
+    file.getOptions().setParallelChunkSize(1);
+    file.load(f, exp_parallel);
+
+    TEST_EQUAL(exp_parallel.size(), exp_serial.size())
+    TEST_EQUAL(exp_parallel.getChromatograms().size(), exp_serial.getChromatograms().size())
+    TEST_EQUAL(exp_parallel == exp_serial, true)
+    ABORT_IF(exp_parallel.size() != exp_serial.size())
+    for (Size i = 0; i < exp_serial.size(); ++i)
+    {
+      TEST_EQUAL(exp_parallel[i].getNativeID(), exp_serial[i].getNativeID())
+    }
+  }
+
+  // compressed files are always parsed sequentially
+  MzMLFileParallelTest parallel_file;
+  parallel_file.getOptions().setParallelChunkSize(1);
+  PeakMap exp_compressed, exp_uncompressed;
+  TEST_EQUAL(parallel_file.loadParallel_(OPENMS_GET_TEST_DATA_PATH("MzMLFile_4_indexed.mzML.gz"), exp_compressed), false)
+  TEST_EQUAL(exp_compressed.empty(), true)
+#ifdef _OPENMP
+  if (omp_get_max_threads() > 1)
+  {
+    TEST_EQUAL(parallel_file.loadParallel_(OPENMS_GET_TEST_DATA_PATH("MzMLFile_4_indexed.mzML"), exp_uncompressed), true)
+  }
+#endif
+  parallel_file.load(OPENMS_GET_TEST_DATA_PATH("MzMLFile_4_indexed.mzML.gz"), exp_compressed);
+  file.getOptions().setParallelChunkSize(0);
+  file.load(OPENMS_GET_TEST_DATA_PATH("MzMLFile_4_indexed.mzML"), exp_uncompressed);
+  TEST_EQUAL(exp_compressed.size(), 4)
+  TEST_EQUAL(exp_compressed.size(), exp_uncompressed.size())
+  file.getOptions().setParallelChunkSize(1);
+
+  // filters are applied to each block
+  file.getOptions().addMSLevel(2);
+  PeakMap exp;
+  file.load(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML"), exp);
+  for (Size i = 0; i < exp.size(); ++i)
+  {
+    TEST_EQUAL(exp[i].getMSLevel(), 2)
+  }
+}
+END_SECTION
+
 START_SECTION([EXTRA] load only meta data)
 {
   MzMLFile file;
@@ -0,0 +1,313 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/METADATA/PSMTable.h>
+///////////////////////////
+
+#include <OpenMS/FORMAT/IdXMLFile.h>
+#include <OpenMS/METADATA/MetaInfoInterface.h>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(PSMTable, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+vector<PeptideIdentification> ids(3);
+ids[0].setRT(10.5);
+ids[0].setMZ(500.25);
+ids[0].setIdentifier("run_1");
+ids[0].setScoreType("score");
+ids[0].setHigherScoreBetter(true);
+ids[0].setSignificanceThreshold(0.5);
+ids[0].setMetaValue("spectrum_reference", "index=5");
+{
+  PeptideHit hit(10.0, 2, 2, AASequence::fromString("PEPTIDE"));
+  hit.addPeptideEvidence(PeptideEvidence("PROT_1", 3, 9, 'K', 'R'));
+  hit.addPeptideEvidence(PeptideEvidence("PROT_2", 10, 16, 'R', '-'));
+  hit.setMetaValue("target_decoy", "target");
+  hit.setMetaValue("some_int", 3);
+  hit.setMetaValue("some_double", 0.25);
+  ids[0].insertHit(hit);
+
+  hit = PeptideHit(20.0, 1, 2, AASequence::fromString("PEPM(Oxidation)IDE"));
+  hit.setMetaValue("target_decoy", "decoy");
+  hit.setMetaValue("some_list", ListUtils::create<Int>("1,2,3"));
+  vector<PeptideHit::PeakAnnotation> annotations(1);
+  annotations[0].annotation = "y3";
+  annotations[0].charge = 1;
+  annotations[0].mz = 375.2;
+  annotations[0].intensity = 100.0;
+  hit.setPeakAnnotations(annotations);
+  ids[0].insertHit(hit);
+}
+ids[1].setRT(20.5);
+ids[1].setMZ(600.75);
+ids[1].setIdentifier("run_1");
+ids[1].setScoreType("score");
+ids[1].setHigherScoreBetter(true);
+ids[2].setRT(30.5);
+ids[2].setMZ(700.0);
+ids[2].setIdentifier("run_2");
+ids[2].setScoreType("q-value");
+ids[2].setHigherScoreBetter(false);
+{
+  PeptideHit hit(0.05, 1, 3, AASequence::fromString("PEPTIDE"));
+  hit.setMetaValue("target_decoy", "target");
+  hit.setMetaValue("some_int", "not an int");
+  ids[2].insertHit(hit);
+  hit.setScore(0.01);
+  hit.setMetaValue("target_decoy", "target");
+  hit.removeMetaValue("some_int");
+  ids[2].insertHit(hit);
+}
+
+PSMTable* ptr = nullptr;
+PSMTable* null_ptr = nullptr;
+START_SECTION((PSMTable()))
+{
+  ptr = new PSMTable();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->empty(), true)
+  TEST_EQUAL(ptr->getNrIdentifications(), 0)
+  TEST_EQUAL(ptr->getNrHits(), 0)
+}
+END_SECTION
+
+START_SECTION((~PSMTable()))
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((explicit PSMTable(const std::vector<PeptideIdentification>& ids)))
+{
+  PSMTable psms(ids);
+  TEST_EQUAL(psms.empty(), false)
+  TEST_EQUAL(psms.getNrIdentifications(), 3)
+  TEST_EQUAL(psms.getNrHits(), 4)
+}
+END_SECTION
+
+START_SECTION((void getIdentifications(std::vector<PeptideIdentification>& ids) const))
+{
+  PSMTable psms(ids);
+  vector<PeptideIdentification> result;
+  psms.getIdentifications(result);
+  TEST_EQUAL(result.size(), ids.size())
+  for (Size i = 0; i < ids.size(); ++i)
+  {
+    TEST_EQUAL(result[i] == ids[i], true)
+  }
+  // mixed types in a meta value column:
+  TEST_EQUAL(result[0].getHits()[0].getMetaValue("some_int"), 3)
+  TEST_EQUAL(result[2].getHits()[0].getMetaValue("some_int"), "not an int")
+  TEST_EQUAL(result[2].getHits()[1].metaValueExists("some_int"), false)
+}
+END_SECTION
+
+START_SECTION((PeptideIdentification getIdentification(Size index) const))
+{
+  PSMTable psms;
+  psms.add(ids[2]);
+  psms.add(ids[0]);
+  TEST_EQUAL(psms.getIdentification(0) == ids[2], true)
+  TEST_EQUAL(psms.getIdentification(1) == ids[0], true)
+}
+END_SECTION
+
+START_SECTION((void getIdentification(Size index, PeptideIdentification& id) const))
+{
+  PSMTable psms(ids);
+  PeptideIdentification id = ids[2];
+  psms.getIdentification(1, id);
+  TEST_EQUAL(id == ids[1], true)
+}
+END_SECTION
+
+START_SECTION([EXTRA] round trip of idXML data)
+{
+  vector<ProteinIdentification> prot_ids;
+  vector<PeptideIdentification> pep_ids;
+  String document_id;
+  IdXMLFile().load(OPENMS_GET_TEST_DATA_PATH("IdXMLFile_whole.idXML"), prot_ids, pep_ids, document_id);
+  PSMTable psms(pep_ids);
+  vector<PeptideIdentification> result;
+  psms.getIdentifications(result);
+  TEST_EQUAL(result.size(), pep_ids.size())
+  TEST_EQUAL(result == pep_ids, true)
+}
+END_SECTION
+
+START_SECTION((void clear()))
+{
+  PSMTable psms(ids);
+  psms.clear();
+  TEST_EQUAL(psms.empty(), true)
+  TEST_EQUAL(psms.getNrHits(), 0)
+}
+END_SECTION
+
+START_SECTION((identification columns))
+{
+  PSMTable psms(ids);
+  TEST_REAL_SIMILAR(psms.getRT(1), 20.5)
+  TEST_REAL_SIMILAR(psms.getMZ(2), 700.0)
+  TEST_REAL_SIMILAR(psms.getSignificanceThreshold(0), 0.5)
+  TEST_STRING_EQUAL(psms.getIdentifier(2), "run_2")
+  TEST_STRING_EQUAL(psms.getScoreType(2), "q-value")
+  TEST_EQUAL(psms.isHigherScoreBetter(0), true)
+  TEST_EQUAL(psms.isHigherScoreBetter(2), false)
+  psms.setScoreType(0, "other");
+  psms.setHigherScoreBetter(0, false);
+  TEST_STRING_EQUAL(psms.getScoreType(0), "other")
+  TEST_EQUAL(psms.isHigherScoreBetter(0), false)
+
+  TEST_EQUAL(psms.getHitsBegin(0), 0)
+  TEST_EQUAL(psms.getHitsEnd(0), 2)
+  TEST_EQUAL(psms.getHitsBegin(1), 2)
+  TEST_EQUAL(psms.getHitsEnd(1), 2)
+  TEST_EQUAL(psms.getHitsEnd(2), 4)
+  TEST_EQUAL(psms.getIdentificationIndex(0), 0)
+  TEST_EQUAL(psms.getIdentificationIndex(1), 0)
+  TEST_EQUAL(psms.getIdentificationIndex(2), 2)
+  TEST_EQUAL(psms.getIdentificationIndex(3), 2)
+
+  UInt key = MetaInfoInterface::metaRegistry().registerName("spectrum_reference");
+  TEST_EQUAL(psms.identificationMetaValueExists(0, key), true)
+  TEST_EQUAL(psms.identificationMetaValueExists(1, key), false)
+  TEST_EQUAL(psms.getIdentificationMetaValue(0, key), "index=5")
+  psms.setIdentificationMetaValue(1, key, "index=6");
+  TEST_EQUAL(psms.getIdentificationMetaValue(1, key), "index=6")
+}
+END_SECTION
+
+START_SECTION((hit columns))
+{
+  PSMTable psms(ids);
+  TEST_REAL_SIMILAR(psms.getScore(1), 20.0)
+  TEST_EQUAL(psms.getRank(1), 1)
+  TEST_EQUAL(psms.getCharge(3), 3)
+  TEST_STRING_EQUAL(psms.getSequence(1), "PEPM(Oxidation)IDE")
+  // sequences are stored only once:
+  TEST_EQUAL(psms.getSequenceId(0), psms.getSequenceId(2))
+  TEST_NOT_EQUAL(psms.getSequenceId(0), psms.getSequenceId(1))
+  TEST_EQUAL(psms.getPeptideEvidences(0) == ids[0].getHits()[0].getPeptideEvidences(), true)
+  TEST_EQUAL(psms.getPeptideEvidences(1).empty(), true)
+
+  psms.setScore(0, 5.0);
+  psms.setRank(0, 7);
+  TEST_REAL_SIMILAR(psms.getScore(0), 5.0)
+  TEST_EQUAL(psms.getRank(0), 7)
+
+  UInt key = MetaInfoInterface::metaRegistry().registerName("some_double");
+  TEST_EQUAL(psms.hitMetaValueExists(0, key), true)
+  TEST_REAL_SIMILAR(psms.getHitMetaValue(0, key), 0.25)
+  TEST_EQUAL(psms.getHitMetaValue(1, key).isEmpty(), true)
+  psms.setHitMetaValue(1, key, 0.5);
+  TEST_REAL_SIMILAR(psms.getHitMetaValue(1, key), 0.5)
+  psms.removeHitMetaValue(0, key);
+  TEST_EQUAL(psms.hitMetaValueExists(0, key), false)
+  TEST_EQUAL(psms.getIdentification(0).getHits()[0].metaValueExists("some_double"), false)
+}
+END_SECTION
+
+START_SECTION((void sortHits()))
+{
+  PSMTable psms(ids);
+  psms.sortHits();
+  TEST_STRING_EQUAL(psms.getSequence(0), "PEPM(Oxidation)IDE")
+  TEST_REAL_SIMILAR(psms.getScore(0), 20.0)
+  TEST_REAL_SIMILAR(psms.getScore(1), 10.0)
+  TEST_REAL_SIMILAR(psms.getScore(2), 0.01)
+  TEST_REAL_SIMILAR(psms.getScore(3), 0.05)
+
+  // meta values, evidences and annotations move with the hits:
+  PeptideIdentification id = psms.getIdentification(0);
+  TEST_EQUAL(id.getHits()[0] == ids[0].getHits()[1], true)
+  TEST_EQUAL(id.getHits()[1] == ids[0].getHits()[0], true)
+}
+END_SECTION
+
+START_SECTION((void assignRanks()))
+{
+  PSMTable psms(ids);
+  psms.setScore(0, 20.0);
+  psms.assignRanks();
+  TEST_EQUAL(psms.getRank(0), 1)
+  TEST_EQUAL(psms.getRank(1), 1)
+  TEST_EQUAL(psms.getRank(2), 1)
+  TEST_EQUAL(psms.getRank(3), 2)
+}
+END_SECTION
+
+START_SECTION((void filterHits(const std::vector<bool>& keep)))
+{
+  PSMTable psms(ids);
+  vector<bool> keep(4, true);
+  keep[0] = false;
+  keep[3] = false;
+  psms.filterHits(keep);
+  TEST_EQUAL(psms.getNrIdentifications(), 3)
+  TEST_EQUAL(psms.getNrHits(), 2)
+  TEST_EQUAL(psms.getHitsEnd(0), 1)
+  TEST_EQUAL(psms.getHitsBegin(2), 1)
+  TEST_EQUAL(psms.getHitsEnd(2), 2)
+  TEST_EQUAL(psms.getIdentification(0).getHits()[0] == ids[0].getHits()[1], true)
+  TEST_EQUAL(psms.getIdentification(2).getHits()[0] == ids[2].getHits()[0], true)
+
+  TEST_EXCEPTION(Exception::InvalidSize, psms.filterHits(keep))
+}
+END_SECTION
+
+START_SECTION((void removeEmptyIdentifications()))
+{
+  PSMTable psms(ids);
+  psms.removeEmptyIdentifications();
+  TEST_EQUAL(psms.getNrIdentifications(), 2)
+  TEST_EQUAL(psms.getNrHits(), 4)
+  TEST_EQUAL(psms.getIdentification(0) == ids[0], true)
+  TEST_EQUAL(psms.getIdentification(1) == ids[2], true)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
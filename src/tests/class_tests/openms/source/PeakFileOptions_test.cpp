@@ -246,6 +246,23 @@ START_SECTION(void setMaxDataPoolSize(Size size))
 }
 END_SECTION
 
+START_SECTION(Size getParallelChunkSize() const)
+{
+	PeakFileOptions tmp;
+	TEST_EQUAL(tmp.getParallelChunkSize()!=0,true);
+}
+END_SECTION
+
+START_SECTION(void setParallelChunkSize(Size size))
+{
+	PeakFileOptions tmp;
+	tmp.setParallelChunkSize(1024);
+	TEST_EQUAL(tmp.getParallelChunkSize(),1024);
+	PeakFileOptions copy(tmp);
+	TEST_EQUAL(copy.getParallelChunkSize(),1024);
+}
+END_SECTION
+
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
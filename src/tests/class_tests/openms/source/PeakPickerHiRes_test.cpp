@@ -36,6 +36,10 @@
 #include <OpenMS/test_config.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 ///////////////////////////
 #include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerHiRes.h>
 ///////////////////////////
@@ -388,6 +392,39 @@ START_SECTION([EXTRA] test spectrum level selection)
   }
 END_SECTION
 
+START_SECTION([EXTRA] pickExperiment result is independent of the number of threads)
+{
+  PeakMap in_map;
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("PeakPickerHiRes_spectrum_selection.mzML"), in_map);
+
+  PeakPickerHiRes pp;
+  PeakMap out_parallel, out_serial;
+  std::vector<std::vector<PeakPickerHiRes::PeakBoundary> > bs_parallel, bc_parallel, bs_serial, bc_serial;
+  pp.pickExperiment(in_map, out_parallel, bs_parallel, bc_parallel);
+#ifdef _OPENMP
+  int threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+  pp.pickExperiment(in_map, out_serial, bs_serial, bc_serial);
+#ifdef _OPENMP
+  omp_set_num_threads(threads);
+#endif
+
+  ABORT_IF(out_parallel.size() != out_serial.size())
+  for (Size i = 0; i < out_serial.size(); ++i)
+  {
+    TEST_EQUAL(out_parallel[i] == out_serial[i], true)
+  }
+  TEST_EQUAL(out_parallel.getChromatograms().size(), out_serial.getChromatograms().size())
+  ABORT_IF(bs_parallel.size() != bs_serial.size())
+  for (Size i = 0; i < bs_serial.size(); ++i)
+  {
+    TEST_EQUAL(bs_parallel[i].size(), bs_serial[i].size())
+  }
+  TEST_EQUAL(bc_parallel.size(), bc_serial.size())
+}
+END_SECTION
+
 //////////////////////////////////////////////
 // check peak boundaries on simulation data //
 //////////////////////////////////////////////
@@ -0,0 +1,357 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/ID/PeptideDatabase.h>
+///////////////////////////
+
+#include <OpenMS/CHEMISTRY/AASequence.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(PeptideDatabase, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+PeptideDatabase* ptr = nullptr;
+PeptideDatabase* null_ptr = nullptr;
+START_SECTION(PeptideDatabase())
+{
+  ptr = new PeptideDatabase();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->size(), 0)
+  TEST_EQUAL(ptr->getNrPeptides(), 0)
+  TEST_EQUAL(ptr->isMemoryMapped(), false)
+}
+END_SECTION
+
+START_SECTION(~PeptideDatabase())
+{
+  delete ptr;
+}
+END_SECTION
+
+vector<FASTAFile::FASTAEntry> fasta_db(3);
+fasta_db[0].identifier = "P1";
+fasta_db[0].sequence = "AAAKMMRGGG"; // AAAK, MMR, GGG
+fasta_db[1].identifier = "P2";
+fasta_db[1].sequence = "GGGKAAAK"; // GGGK, AAAK
+fasta_db[2].identifier = "P3";
+fasta_db[2].sequence = "XAK"; // ambiguous, skipped
+
+ProteaseDigestion digestor;
+digestor.setEnzyme("Trypsin");
+digestor.setMissedCleavages(0);
+ModifiedPeptideGenerator::MapToResidueType fixed_mods = ModifiedPeptideGenerator::getModifications(StringList());
+ModifiedPeptideGenerator::MapToResidueType variable_mods = ModifiedPeptideGenerator::getModifications(ListUtils::create<String>("Oxidation (M)"));
+
+PeptideDatabase db;
+
+START_SECTION((void build(const std::vector<FASTAFile::FASTAEntry>& fasta_db, const ProteaseDigestion& digestor, Size min_size, Size max_size, const ModifiedPeptideGenerator::MapToResidueType& fixed_modifications, const ModifiedPeptideGenerator::MapToResidueType& variable_modifications, Size max_variable_mods_per_peptide, const String& peptide_motif = "")))
+{
+  db.build(fasta_db, digestor, 1, 0, fixed_mods, variable_mods, 2);
+  TEST_EQUAL(db.getNrPeptides(), 4)
+  TEST_EQUAL(db.size(), 7) // MMR has four modification variants
+
+  PeptideDatabase motif_db;
+  motif_db.build(fasta_db, digestor, 1, 0, fixed_mods, variable_mods, 2, ".*K");
+  TEST_EQUAL(motif_db.getNrPeptides(), 2)
+  TEST_EQUAL(motif_db.size(), 2)
+
+  PeptideDatabase length_db;
+  length_db.build(fasta_db, digestor, 4, 0, fixed_mods, variable_mods, 2);
+  TEST_EQUAL(length_db.getNrPeptides(), 2)
+}
+END_SECTION
+
+START_SECTION((Size getNrPeptides() const))
+{
+  TEST_EQUAL(db.getNrPeptides(), 4)
+}
+END_SECTION
+
+START_SECTION((const Peptide& getPeptide(Size peptide) const))
+{
+  // in order of first occurrence
+  TEST_EQUAL(db.getPeptide(0).protein, 0)
+  TEST_EQUAL(db.getPeptide(0).offset, 0)
+  TEST_EQUAL(db.getPeptide(0).length, 4)
+  TEST_EQUAL(db.getPeptide(2).protein, 0)
+  TEST_EQUAL(db.getPeptide(2).offset, 7)
+  TEST_EQUAL(db.getPeptide(2).length, 3)
+  TEST_EQUAL(db.getPeptide(3).protein, 1)
+}
+END_SECTION
+
+START_SECTION((StringView getSequence(const std::vector<FASTAFile::FASTAEntry>& fasta_db, Size peptide) const))
+{
+  TEST_STRING_EQUAL(db.getSequence(fasta_db, 0).getString(), "AAAK")
+  TEST_STRING_EQUAL(db.getSequence(fasta_db, 1).getString(), "MMR")
+  TEST_STRING_EQUAL(db.getSequence(fasta_db, 2).getString(), "GGG")
+  TEST_STRING_EQUAL(db.getSequence(fasta_db, 3).getString(), "GGGK")
+}
+END_SECTION
+
+START_SECTION((std::pair<const UInt32*, const UInt32*> getProteins(Size peptide) const))
+{
+  pair<const UInt32*, const UInt32*> proteins = db.getProteins(0);
+  TEST_EQUAL(proteins.second - proteins.first, 2)
+  TEST_EQUAL(proteins.first[0], 0)
+  TEST_EQUAL(proteins.first[1], 1)
+  proteins = db.getProteins(3);
+  TEST_EQUAL(proteins.second - proteins.first, 1)
+  TEST_EQUAL(proteins.first[0], 1)
+}
+END_SECTION
+
+START_SECTION((void getModifiedVariants(const std::vector<FASTAFile::FASTAEntry>& fasta_db, Size peptide, const ModifiedPeptideGenerator::MapToResidueType& fixed_modifications, const ModifiedPeptideGenerator::MapToResidueType& variable_modifications, Size max_variable_mods_per_peptide, std::vector<AASequence>& variants) const))
+{
+  // every entry is recreated by its modification index
+  vector<AASequence> variants;
+  for (Size i = 0; i < db.size(); ++i)
+  {
+    const PeptideDatabase::Entry& e = db.getEntry(i);
+    db.getModifiedVariants(fasta_db, e.peptide, fixed_mods, variable_mods, 2, variants);
+    ABORT_IF(e.modification >= variants.size())
+    TEST_EQUAL(variants[e.modification].toUnmodifiedString(), db.getSequence(fasta_db, e.peptide).getString())
+    TEST_REAL_SIMILAR(variants[e.modification].getMonoWeight(), e.mass)
+  }
+  db.getModifiedVariants(fasta_db, 1, fixed_mods, variable_mods, 2, variants); // MMR
+  TEST_EQUAL(variants.size(), 4)
+}
+END_SECTION
+
+START_SECTION((Size size() const))
+{
+  TEST_EQUAL(db.size(), 7)
+}
+END_SECTION
+
+START_SECTION((const Entry& getEntry(Size index) const))
+{
+  for (Size i = 1; i < db.size(); ++i)
+  {
+    TEST_EQUAL(db.getEntry(i - 1).mass <= db.getEntry(i).mass, true)
+  }
+
+  // the modification index enumerates the variants of a peptide
+  Size mmr_variants(0);
+  for (Size i = 0; i < db.size(); ++i)
+  {
+    const PeptideDatabase::Entry& e = db.getEntry(i);
+    if (e.peptide == 1)
+    {
+      TEST_EQUAL(e.modification < 4, true)
+      ++mmr_variants;
+    }
+    else
+    {
+      TEST_EQUAL(e.modification, 0)
+      TEST_REAL_SIMILAR(e.mass, AASequence::fromString(db.getSequence(fasta_db, e.peptide).getString()).getMonoWeight())
+    }
+  }
+  TEST_EQUAL(mmr_variants, 4)
+}
+END_SECTION
+
+START_SECTION((std::pair<Size, Size> getEntries(double mass_low, double mass_high) const))
+{
+  double mass = AASequence::fromString("GGG").getMonoWeight();
+  pair<Size, Size> range = db.getEntries(mass - 0.001, mass + 0.001);
+  TEST_EQUAL(range.second - range.first, 1)
+  TEST_EQUAL(db.getEntry(range.first).peptide, 2)
+
+  range = db.getEntries(0.0, 1e6);
+  TEST_EQUAL(range.first, 0)
+  TEST_EQUAL(range.second, 7)
+
+  range = db.getEntries(1e5, 1e6);
+  TEST_EQUAL(range.second - range.first, 0)
+}
+END_SECTION
+
+START_SECTION((static UInt64 computeKey(const std::vector<FASTAFile::FASTAEntry>& fasta_db, const StringList& settings)))
+{
+  StringList settings = ListUtils::create<String>("enzyme=Trypsin,missed_cleavages=0");
+  UInt64 key = PeptideDatabase::computeKey(fasta_db, settings);
+  TEST_EQUAL(PeptideDatabase::computeKey(fasta_db, settings), key)
+  TEST_NOT_EQUAL(PeptideDatabase::computeKey(fasta_db, ListUtils::create<String>("enzyme=Trypsin,missed_cleavages=1")), key)
+  TEST_NOT_EQUAL(PeptideDatabase::computeKey(fasta_db, ListUtils::create<String>("enzyme=Trypsinmissed_cleavages=0")), key)
+
+  vector<FASTAFile::FASTAEntry> other_db(fasta_db);
+  other_db[1].sequence = "GGGKAAAR";
+  TEST_NOT_EQUAL(PeptideDatabase::computeKey(other_db, settings), key)
+}
+END_SECTION
+
+UInt64 key = PeptideDatabase::computeKey(fasta_db, ListUtils::create<String>("enzyme=Trypsin"));
+String filename;
+NEW_TMP_FILE(filename)
+
+START_SECTION((void store(const String& filename, UInt64 key) const))
+{
+  db.store(filename, key);
+  TEST_EQUAL(File::exists(filename), true)
+  TEST_EXCEPTION(Exception::UnableToCreateFile, db.store("/this/directory/does/not/exist/db.peptides", key))
+}
+END_SECTION
+
+START_SECTION((bool load(const String& filename, UInt64 key, const std::vector<FASTAFile::FASTAEntry>& fasta_db, bool memory_map = true)))
+{
+  PeptideDatabase loaded;
+  TEST_EQUAL(loaded.load(filename + ".missing", key, fasta_db), false)
+  TEST_EQUAL(loaded.load(filename, key + 1, fasta_db), false)
+  TEST_EQUAL(loaded.size(), 0)
+
+  for (bool memory_map : {true, false})
+  {
+    TEST_EQUAL(loaded.load(filename, key, fasta_db, memory_map), true)
+    TEST_EQUAL(loaded.isMemoryMapped(), memory_map)
+    TEST_EQUAL(loaded.size(), db.size())
+    TEST_EQUAL(loaded.getNrPeptides(), db.getNrPeptides())
+    for (Size i = 0; i < db.size(); ++i)
+    {
+      TEST_REAL_SIMILAR(loaded.getEntry(i).mass, db.getEntry(i).mass)
+      TEST_EQUAL(loaded.getEntry(i).peptide, db.getEntry(i).peptide)
+      TEST_EQUAL(loaded.getEntry(i).modification, db.getEntry(i).modification)
+    }
+    for (Size i = 0; i < db.getNrPeptides(); ++i)
+    {
+      TEST_STRING_EQUAL(loaded.getSequence(fasta_db, i).getString(), db.getSequence(fasta_db, i).getString())
+      TEST_EQUAL(loaded.getProteins(i).second - loaded.getProteins(i).first, db.getProteins(i).second - db.getProteins(i).first)
+    }
+
+    // copies of a mapped database share the mapping
+    PeptideDatabase copy(loaded);
+    TEST_EQUAL(copy.isMemoryMapped(), memory_map)
+    TEST_EQUAL(copy.size(), db.size())
+    TEST_EQUAL(copy.getProteins(0).second - copy.getProteins(0).first, 2)
+  }
+
+  // not a peptide database
+  String text_file;
+  NEW_TMP_FILE(text_file)
+  {
+    ofstream ofs(text_file.c_str());
+    ofs << "this is not a peptide database, but long enough to contain a header" << endl;
+  }
+  TEST_EXCEPTION(Exception::ParseError, loaded.load(text_file, key, fasta_db))
+
+  // truncated file
+  String truncated_file;
+  NEW_TMP_FILE(truncated_file)
+  {
+    ifstream ifs(filename.c_str(), ios::binary);
+    String content((istreambuf_iterator<char>(ifs)), istreambuf_iterator<char>());
+    ofstream ofs(truncated_file.c_str(), ios::binary);
+    ofs.write(content.c_str(), content.size() - 4);
+  }
+  TEST_EXCEPTION(Exception::ParseError, loaded.load(truncated_file, key, fasta_db))
+
+  // indices out of range (header: 48 bytes, followed by the entries and the peptides)
+  String content;
+  {
+    ifstream ifs(filename.c_str(), ios::binary);
+    content = String((istreambuf_iterator<char>(ifs)), istreambuf_iterator<char>());
+  }
+  const UInt32 out_of_range = 1000;
+  const Size entry_peptide_pos = 48 + 8; // Entry::peptide of the first entry
+  const Size peptide_protein_pos = 48 + db.size() * sizeof(PeptideDatabase::Entry); // Peptide::protein of the first peptide
+  const Size peptide_length_pos = peptide_protein_pos + 8; // Peptide::length of the first peptide
+  for (Size pos : {entry_peptide_pos, peptide_protein_pos, peptide_length_pos})
+  {
+    String corrupt_file;
+    NEW_TMP_FILE(corrupt_file)
+    String corrupt_content(content);
+    memcpy(&corrupt_content[pos], &out_of_range, sizeof(out_of_range));
+    ofstream ofs(corrupt_file.c_str(), ios::binary);
+    ofs.write(corrupt_content.c_str(), corrupt_content.size());
+    ofs.close();
+    for (bool memory_map : {true, false})
+    {
+      PeptideDatabase corrupt;
+      TEST_EXCEPTION(Exception::ParseError, corrupt.load(corrupt_file, key, fasta_db, memory_map))
+      TEST_EQUAL(corrupt.size(), 0)
+    }
+  }
+
+  // a different protein database with the same key (e.g. shorter sequences)
+  vector<FASTAFile::FASTAEntry> short_db(fasta_db);
+  short_db[0].sequence = "A";
+  TEST_EXCEPTION(Exception::ParseError, loaded.load(filename, key, short_db))
+}
+END_SECTION
+
+START_SECTION((bool isMemoryMapped() const))
+{
+  TEST_EQUAL(db.isMemoryMapped(), false)
+  PeptideDatabase loaded;
+  loaded.load(filename, key, fasta_db);
+  TEST_EQUAL(loaded.isMemoryMapped(), true)
+}
+END_SECTION
+
+START_SECTION((PeptideDatabase(const PeptideDatabase& rhs)))
+{
+  PeptideDatabase copy(db);
+  TEST_EQUAL(copy.size(), db.size())
+  TEST_EQUAL(copy.getNrPeptides(), db.getNrPeptides())
+  TEST_NOT_EQUAL(&copy.getEntry(0), &db.getEntry(0))
+  TEST_STRING_EQUAL(copy.getSequence(fasta_db, 1).getString(), "MMR")
+}
+END_SECTION
+
+START_SECTION((PeptideDatabase& operator=(const PeptideDatabase& rhs)))
+{
+  PeptideDatabase copy;
+  copy = db;
+  TEST_EQUAL(copy.size(), db.size())
+  TEST_REAL_SIMILAR(copy.getEntry(6).mass, db.getEntry(6).mass)
+  TEST_EQUAL(copy.getProteins(0).second - copy.getProteins(0).first, 2)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -46,6 +46,10 @@
 #include <OpenMS/METADATA/PeptideHit.h>
 #include <OpenMS/METADATA/PeptideIdentification.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace OpenMS;
 using namespace std;
 
@@ -257,6 +261,60 @@ START_SECTION((void run(const std::vector<FeatureMap >& input_maps, ConsensusMap
 }
 END_SECTION
 
+START_SECTION(([EXTRA] result is independent of the number of threads))
+{
+  // many overlapping features (incl. exact duplicates -> ties in quality):
+  vector<FeatureMap> input(4);
+  UInt64 state = 42;
+  for (Size map_index = 0; map_index < input.size(); ++map_index)
+  {
+    for (Size i = 0; i < 500; ++i)
+    {
+      state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+      Feature feat;
+      feat.setRT(double(i % 100) * 3.0 + double((state >> 33) % 5));
+      feat.setMZ(400.0 + double(i / 100) * 50.0 + double((state >> 40) % 20) * 0.002);
+      feat.setIntensity(1000.0 + double((state >> 20) % 1000));
+      feat.setUniqueId(i);
+      input[map_index].push_back(feat);
+    }
+    input[map_index].updateRanges();
+  }
+
+  QTClusterFinder finder;
+  Param param = finder.getDefaults();
+  param.setValue("distance_RT:max_difference", 5.0);
+  param.setValue("distance_MZ:max_difference", 40.0);
+  param.setValue("distance_MZ:unit", "ppm");
+  param.setValue("nr_partitions", 1);
+  finder.setParameters(param);
+
+  ConsensusMap result_parallel, result_single;
+  finder.run(input, result_parallel);
+#ifdef _OPENMP
+  int nr_threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+  finder.run(input, result_single);
+#ifdef _OPENMP
+  omp_set_num_threads(nr_threads);
+#endif
+
+  TEST_EQUAL(result_parallel.size(), result_single.size())
+  ABORT_IF(result_parallel.size() != result_single.size())
+  bool identical = true;
+  for (Size i = 0; i < result_single.size(); ++i)
+  {
+    if (result_parallel[i].getQuality() != result_single[i].getQuality() ||
+        !(result_parallel[i].getFeatures() == result_single[i].getFeatures()))
+    {
+      identical = false;
+    }
+  }
+  TEST_EQUAL(identical, true)
+}
+END_SECTION
+
 START_SECTION((void run(const std::vector<ConsensusMap>& input_maps, ConsensusMap& result_map)))
 {
 	NOT_TESTABLE; // same as "run" for feature maps (tested above)
@@ -160,6 +160,29 @@ START_SECTION(Size getNumberOfModifiedResidues() const)
 	TEST_EQUAL(ptr->getNumberOfModifiedResidues(), 2)
 END_SECTION
 
+START_SECTION([EXTRA] concurrent creation of modified residues)
+{
+  const Residue* cam_c = ptr->getModifiedResidue("Carbamidomethyl (C)");
+  TEST_EQUAL(ptr->hasResidue(cam_c), true)
+
+  // all threads get the same (single) modified residue
+  std::vector<const Residue*> results(100, nullptr);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (SignedSize i = 0; i < (SignedSize)results.size(); ++i)
+  {
+    results[i] = ptr->getModifiedResidue(ptr->getResidue("S"), "Phospho");
+  }
+  for (Size i = 1; i < results.size(); ++i)
+  {
+    TEST_EQUAL(results[i] == results[0], true)
+  }
+  TEST_EQUAL(ptr->hasResidue(results[0]), true)
+  TEST_EQUAL(ptr->getNumberOfModifiedResidues(), 3)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
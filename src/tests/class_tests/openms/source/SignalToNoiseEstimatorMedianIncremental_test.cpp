@@ -0,0 +1,146 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+#include <OpenMS/FORMAT/DTAFile.h>
+
+///////////////////////////
+#include <OpenMS/FILTERING/NOISEESTIMATION/SignalToNoiseEstimatorMedianIncremental.h>
+///////////////////////////
+
+#include <cmath>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(SignalToNoiseEstimatorMedianIncremental, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+SignalToNoiseEstimatorMedianIncremental< >* ptr = nullptr;
+SignalToNoiseEstimatorMedianIncremental< >* nullPointer = nullptr;
+START_SECTION((SignalToNoiseEstimatorMedianIncremental()))
+  ptr = new SignalToNoiseEstimatorMedianIncremental<>;
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->getName(), "SignalToNoiseEstimatorMedianIncremental")
+END_SECTION
+
+START_SECTION((SignalToNoiseEstimatorMedianIncremental& operator=(const SignalToNoiseEstimatorMedianIncremental &source)))
+  MSSpectrum raw_data;
+  SignalToNoiseEstimatorMedianIncremental<> sne;
+  sne.init(raw_data);
+  SignalToNoiseEstimatorMedianIncremental<> sne2;
+  sne2 = sne;
+  NOT_TESTABLE
+END_SECTION
+
+START_SECTION((SignalToNoiseEstimatorMedianIncremental(const SignalToNoiseEstimatorMedianIncremental &source)))
+  MSSpectrum raw_data;
+  SignalToNoiseEstimatorMedianIncremental<> sne;
+  sne.init(raw_data);
+  SignalToNoiseEstimatorMedianIncremental<> sne2(sne);
+  NOT_TESTABLE
+END_SECTION
+
+START_SECTION((virtual ~SignalToNoiseEstimatorMedianIncremental()))
+  delete ptr;
+END_SECTION
+
+START_SECTION([EXTRA](virtual void init(const PeakIterator& it_begin, const PeakIterator& it_end)))
+{
+  MSSpectrum raw_data;
+  DTAFile dta_file;
+  dta_file.load(OPENMS_GET_TEST_DATA_PATH("SignalToNoiseEstimator_test.dta"), raw_data);
+
+  SignalToNoiseEstimatorMedianIncremental< MSSpectrum > sne;
+  Param p;
+  p.setValue("win_len", 40.0);
+  p.setValue("noise_for_empty_window", 2.0);
+  p.setValue("min_required_elements", 10);
+  sne.setParameters(p);
+  sne.init(raw_data.begin(), raw_data.end());
+
+  // same reference values as SignalToNoiseEstimatorMedian
+  MSSpectrum stn_data;
+  dta_file.load(OPENMS_GET_TEST_DATA_PATH("SignalToNoiseEstimatorMedian_test.out"), stn_data);
+  Size i = 0;
+  for (MSSpectrum::const_iterator it = raw_data.begin(); it != raw_data.end(); ++it)
+  {
+    TEST_REAL_SIMILAR(stn_data[i].getIntensity(), sne.getSignalToNoise(it));
+    ++i;
+  }
+}
+END_SECTION
+
+START_SECTION([EXTRA] identical to SignalToNoiseEstimatorMedian on a long profile spectrum)
+{
+  // synthetic profile spectrum: 200000 data points with peaks on a varying baseline
+  MSSpectrum raw_data;
+  for (Size i = 0; i < 200000; ++i)
+  {
+    double mz = 200.0 + i * 0.01;
+    double intensity = 50.0 + 40.0 * std::sin(mz / 25.0) + (i * 7919 % 101);
+    if (i % 997 < 5) intensity += 5000.0 * (5 - i % 997);
+    raw_data.push_back(Peak1D(mz, intensity));
+  }
+
+  Param p;
+  p.setValue("win_len", 20.0);
+  p.setValue("bin_count", 100);
+  p.setValue("write_log_messages", "false");
+
+  SignalToNoiseEstimatorMedian< MSSpectrum > sne_reference;
+  sne_reference.setParameters(p);
+  sne_reference.init(raw_data);
+
+  SignalToNoiseEstimatorMedianIncremental< MSSpectrum > sne;
+  sne.setParameters(p);
+  sne.init(raw_data);
+
+  Size mismatches = 0;
+  for (MSSpectrum::const_iterator it = raw_data.begin(); it != raw_data.end(); ++it)
+  {
+    if (sne.getSignalToNoise(it) != sne_reference.getSignalToNoise(it)) ++mismatches;
+  }
+  TEST_EQUAL(mismatches, 0)
+  TEST_REAL_SIMILAR(sne.getSparseWindowPercent(), sne_reference.getSparseWindowPercent())
+  TEST_REAL_SIMILAR(sne.getHistogramRightmostPercent(), sne_reference.getHistogramRightmostPercent())
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
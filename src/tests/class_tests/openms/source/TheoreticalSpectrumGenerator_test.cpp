@@ -42,6 +42,7 @@
 
 #include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
 #include <OpenMS/CHEMISTRY/AASequence.h>
+#include <OpenMS/CHEMISTRY/AASequencePool.h>
 #include <OpenMS/KERNEL/MSSpectrum.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/CONCEPT/Constants.h>
@@ -357,6 +358,42 @@ START_SECTION(void getSpectrum(PeakSpectrum& spec, const AASequence& peptide, In
 
 END_SECTION
 
+START_SECTION(void getSpectrum(PeakSpectrum& spec, const InternedAASequence& peptide, Int min_charge, Int max_charge) const)
+{
+  // same peaks and annotations as for the AASequence, with or without the first prefix ion
+  AASequencePool pool;
+  const char* sequences[] = {"PEPTIDEK", ".(Acetyl)PEPTM(Oxidation)IDEK.(Amidated)", "IFSQVGK"};
+  for (const String& first_prefix_ion : {"true", "false"})
+  {
+    TheoreticalSpectrumGenerator tsg;
+    Param param(tsg.getParameters());
+    param.setValue("add_first_prefix_ion", first_prefix_ion);
+    param.setValue("add_a_ions", "true");
+    param.setValue("add_c_ions", "true");
+    param.setValue("add_x_ions", "true");
+    param.setValue("add_z_ions", "true");
+    param.setValue("add_precursor_peaks", "true");
+    param.setValue("add_metainfo", "true");
+    tsg.setParameters(param);
+
+    for (const char* sequence : sequences)
+    {
+      PeakSpectrum expected, spec;
+      tsg.getSpectrum(expected, AASequence::fromString(sequence), 1, 2);
+      tsg.getSpectrum(spec, pool.fromString(sequence), 1, 2);
+      TEST_EQUAL(spec.size(), expected.size())
+      ABORT_IF(spec.size() != expected.size())
+      for (Size i = 0; i != spec.size(); ++i)
+      {
+        TEST_REAL_SIMILAR(spec[i].getMZ(), expected[i].getMZ())
+        TEST_EQUAL(spec.getStringDataArrays()[0][i], expected.getStringDataArrays()[0][i])
+        TEST_EQUAL(spec.getIntegerDataArrays()[0][i], expected.getIntegerDataArrays()[0][i])
+      }
+    }
+  }
+}
+END_SECTION
+
 START_SECTION(([EXTRA] bugfix test where losses lead to formulae with negative element frequencies))
 {
   AASequence tmp_aa = AASequence::fromString("RDAGGPALKK");
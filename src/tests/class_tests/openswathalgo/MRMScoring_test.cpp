@@ -38,6 +38,7 @@
 #include "OpenMS/OPENSWATHALGO/DATAACCESS/MockObjects.h"
 #include "OpenMS/OPENSWATHALGO/DATAACCESS/DataStructures.h"
 #include "OpenMS/OPENSWATHALGO/DATAACCESS/TransitionExperiment.h"
+#include <algorithm>
 
 #ifdef USE_BOOST_UNIT_TEST
 
@@ -315,6 +316,73 @@ BOOST_AUTO_TEST_CASE(initializeXCorrPrecursorCombinedMatrix)
 
   TEST_EQUAL(mrmscore.getXCorrPrecursorCombinedMatrix().size(), 5)
   TEST_EQUAL(mrmscore.getXCorrPrecursorCombinedMatrix()[0].size(), 5)
+
+  // the lower triangle holds the upper one at negated delays
+  const MRMScoring::XCorrMatrixType& combined = mrmscore.getXCorrPrecursorCombinedMatrix();
+  for (std::size_t i = 0; i < combined.size(); i++)
+  {
+    for (std::size_t j = 0; j < combined.size(); j++)
+    {
+      std::size_t n = combined[i][j].data.size();
+      TEST_EQUAL(combined[j][i].data.size(), n)
+      for (std::size_t k = 0; k < n; k++)
+      {
+        TEST_EQUAL(combined[i][j].data[k].first, -combined[j][i].data[n - 1 - k].first)
+        TEST_REAL_SIMILAR(combined[i][j].data[k].second, combined[j][i].data[n - 1 - k].second)
+      }
+    }
+  }
+
+  // matrices sharing the same (cached) traces agree with each other
+  mrmscore.initializeXCorrPrecursorContrastMatrix(imrmfeature, precursor_ids, native_ids);
+  const MRMScoring::XCorrMatrixType& contrast = mrmscore.getXCorrPrecursorContrastMatrix();
+  for (std::size_t i = 0; i < precursor_ids.size(); i++)
+  {
+    for (std::size_t j = 0; j < native_ids.size(); j++)
+    {
+      const OpenSwath::Scoring::XCorrArrayType& c = combined[i][precursor_ids.size() + j];
+      TEST_EQUAL(contrast[i][j].data.size(), c.data.size())
+      for (std::size_t k = 0; k < c.data.size(); k++)
+      {
+        TEST_EQUAL(contrast[i][j].data[k].first, c.data[k].first)
+        TEST_REAL_SIMILAR(contrast[i][j].data[k].second, c.data[k].second)
+      }
+    }
+  }
+
+  delete imrmfeature;
+}
+END_SECTION
+
+BOOST_AUTO_TEST_CASE(initializeXCorrMatrix_reused)
+{
+  // a feature at the same address but with different traces (e.g. allocated
+  // after the previous one was freed) must not be scored with stale traces
+  MockMRMFeature * imrmfeature = new MockMRMFeature();
+  MRMScoring mrmscore;
+
+  std::vector<std::string> precursor_ids;
+  std::vector<std::string> native_ids;
+  fill_mock_objects2(imrmfeature, precursor_ids, native_ids);
+  mrmscore.initializeXCorrMatrix(imrmfeature, native_ids);
+
+  std::vector<double>& intensity = imrmfeature->m_features["group1"]->m_intensity_vec;
+  std::reverse(intensity.begin(), intensity.end());
+  mrmscore.initializeXCorrMatrix(imrmfeature, native_ids);
+
+  MRMScoring mrmscore_new;
+  mrmscore_new.initializeXCorrMatrix(imrmfeature, native_ids);
+
+  const OpenSwath::Scoring::XCorrArrayType& reused = mrmscore.getXCorrMatrix()[0][1];
+  const OpenSwath::Scoring::XCorrArrayType& expected = mrmscore_new.getXCorrMatrix()[0][1];
+  TEST_EQUAL(reused.data.size(), expected.data.size())
+  for (std::size_t k = 0; k < expected.data.size(); k++)
+  {
+    TEST_EQUAL(reused.data[k].first, expected.data[k].first)
+    TEST_REAL_SIMILAR(reused.data[k].second, expected.data[k].second)
+  }
+
+  delete imrmfeature;
 }
 END_SECTION
 
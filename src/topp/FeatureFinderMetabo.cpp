@@ -32,6 +32,7 @@
 // $Authors: Erhan Kenar, Holger Franken $
 // --------------------------------------------------------------------------
 #include <OpenMS/FORMAT/MzMLFile.h>
+#include <OpenMS/INTERFACES/IMSDataConsumer.h>
 #include <OpenMS/FORMAT/FeatureXMLFile.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/KERNEL/FeatureMap.h>
@@ -116,6 +117,67 @@ public:
 
 protected:
 
+  /**
+    @brief Streams the MS1 spectra of the input into a MassTraceDetection::PeakCollector
+
+    Besides the peaks needed for mass trace detection, only the experimental
+    settings (for the primary MS run path), the type of the first spectrum
+    and the polarities of all spectra are kept, so the input map does not
+    have to be held in memory.
+  */
+  class FFMetaboMzMLConsumer :
+    public Interfaces::IMSDataConsumer
+  {
+  public:
+    explicit FFMetaboMzMLConsumer(MassTraceDetection::PeakCollector& collector) :
+      collector_(collector),
+      nr_spectra_(0),
+      spectrum_type_(SpectrumSettings::UNKNOWN)
+    {
+    }
+
+    void setExperimentalSettings(const ExperimentalSettings& settings) override
+    {
+      settings_ = settings;
+      collector_.setExperimentalSettings(settings);
+    }
+
+    void setExpectedSize(Size expected_spectra, Size expected_chromatograms) override
+    {
+      collector_.setExpectedSize(expected_spectra, expected_chromatograms);
+    }
+
+    void consumeSpectrum(SpectrumType& s) override
+    {
+      if (s.getMSLevel() != 1) return;
+      if (nr_spectra_ == 0) spectrum_type_ = s.getType();
+      ++nr_spectra_;
+      polarities_.insert(s.getInstrumentSettings().getPolarity());
+      collector_.consumeSpectrum(s);
+    }
+
+    void consumeChromatogram(ChromatogramType&) override {}
+
+    /// Experimental settings of the input (without spectra)
+    PeakMap& getSettings() { return settings_; }
+
+    /// Number of MS1 spectra
+    Size getNrSpectra() const { return nr_spectra_; }
+
+    /// Type of the first MS1 spectrum
+    SpectrumSettings::SpectrumType getSpectrumType() const { return spectrum_type_; }
+
+    /// Polarities of all MS1 spectra
+    const set<IonSource::Polarity>& getPolarities() const { return polarities_; }
+
+  private:
+    MassTraceDetection::PeakCollector& collector_;
+    PeakMap settings_;
+    Size nr_spectra_;
+    SpectrumSettings::SpectrumType spectrum_type_;
+    set<IonSource::Polarity> polarities_;
+  };
+
   void registerOptionsAndFlags_() override
   {
     registerInputFile_("in", "<file>", "", "Centroided mzML file");
@@ -177,17 +239,45 @@ protected:
     String out = getStringOption_("out");
     String out_chrom = getStringOption_("out_chrom");
 
+    //-------------------------------------------------------------
+    // set parameters
+    //-------------------------------------------------------------
+
+    Param common_param = getParam_().copy("algorithm:common:", true);
+    writeDebug_("Common parameters passed to sub-algorithms (mtd and ffm)", common_param, 3);
+
+    Param mtd_param = getParam_().copy("algorithm:mtd:", true);
+    writeDebug_("Parameters passed to MassTraceDetection", mtd_param, 3);
+
+    Param epd_param = getParam_().copy("algorithm:epd:", true);
+    writeDebug_("Parameters passed to ElutionPeakDetection", epd_param, 3);
+
+    Param ffm_param = getParam_().copy("algorithm:ffm:", true);
+    writeDebug_("Parameters passed to FeatureFindingMetabo", ffm_param, 3);
+
+    //-------------------------------------------------------------
+    // configure and run mass trace detection
+    //-------------------------------------------------------------
+
+    MassTraceDetection mtdet;
+    mtd_param.insert("", common_param);
+    mtd_param.remove("chrom_fwhm");
+    mtdet.setParameters(mtd_param);
+
     //-------------------------------------------------------------
     // loading input
     //-------------------------------------------------------------
+
+    // only the peaks above the noise threshold are kept (see MassTraceDetection::PeakCollector)
+    MassTraceDetection::PeakCollector peaks(mtdet);
+    FFMetaboMzMLConsumer consumer(peaks);
     MzMLFile mz_data_file;
     mz_data_file.setLogType(log_type_);
-    PeakMap ms_peakmap;
     std::vector<Int> ms_level(1, 1);
     mz_data_file.getOptions().setMSLevels(ms_level);
-    mz_data_file.load(in, ms_peakmap);
+    mz_data_file.transform(in, &consumer);
 
-    if (ms_peakmap.empty())
+    if (consumer.getNrSpectra() == 0)
     {
       OPENMS_LOG_WARN << "The given file does not contain any conventional peak data, but might"
                   " contain chromatograms. This tool currently cannot handle them, sorry.";
@@ -195,7 +285,7 @@ protected:
     }
 
     // determine type of spectral data (profile or centroided)
-    SpectrumSettings::SpectrumType spectrum_type = ms_peakmap[0].getType();
+    SpectrumSettings::SpectrumType spectrum_type = consumer.getSpectrumType();
 
     if (spectrum_type == SpectrumSettings::PROFILE)
     {
@@ -206,37 +296,8 @@ protected:
       }
     }
 
-    // make sure the spectra are sorted by m/z
-    ms_peakmap.sortSpectra(true);
-
     vector<MassTrace> m_traces;
-
-    //-------------------------------------------------------------
-    // set parameters
-    //-------------------------------------------------------------
-
-    Param common_param = getParam_().copy("algorithm:common:", true);
-    writeDebug_("Common parameters passed to sub-algorithms (mtd and ffm)", common_param, 3);
-
-    Param mtd_param = getParam_().copy("algorithm:mtd:", true);
-    writeDebug_("Parameters passed to MassTraceDetection", mtd_param, 3);
-
-    Param epd_param = getParam_().copy("algorithm:epd:", true);
-    writeDebug_("Parameters passed to ElutionPeakDetection", epd_param, 3);
-
-    Param ffm_param = getParam_().copy("algorithm:ffm:", true);
-    writeDebug_("Parameters passed to FeatureFindingMetabo", ffm_param, 3);
-
-    //-------------------------------------------------------------
-    // configure and run mass trace detection
-    //-------------------------------------------------------------
-
-    MassTraceDetection mtdet;
-    mtd_param.insert("", common_param);
-    mtd_param.remove("chrom_fwhm");
-    mtdet.setParameters(mtd_param);
-
-    mtdet.run(ms_peakmap, m_traces);
+    mtdet.run(peaks, m_traces);
 
     //-------------------------------------------------------------
     // configure and run elution peak detection
@@ -347,11 +408,7 @@ protected:
     // store ionization mode of spectra (useful for post-processing by AccurateMassSearch tool)
     if (!feat_map.empty())
     {
-      set<IonSource::Polarity> pols;
-      for (Size i = 0; i < ms_peakmap.size(); ++i)
-      {
-        pols.insert(ms_peakmap[i].getInstrumentSettings().getPolarity());
-      }
+      const set<IonSource::Polarity>& pols = consumer.getPolarities();
       // concat to single string
       StringList sl_pols;
       for (set<IonSource::Polarity>::const_iterator it = pols.begin(); it != pols.end(); ++it)
@@ -376,7 +433,7 @@ protected:
     }
     else
     {
-      feat_map.setPrimaryMSRunPath({in}, ms_peakmap);
+      feat_map.setPrimaryMSRunPath({in}, consumer.getSettings());
     }    
 
     FeatureXMLFile feature_xml_file;
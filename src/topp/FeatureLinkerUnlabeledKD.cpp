@@ -96,6 +96,12 @@ using namespace std;
  used connected components memory-wise. More stringent m/z or retention time
  tolerances might be required then.
 
+ For very large numbers of input files (or very dense data), the m/z
+ partitions may become too large to be linked at once. In this case, the
+ advanced parameter @p algorithm:link:tile_size can be set to split large
+ partitions into overlapping m/z tiles that are linked independently (and in
+ parallel), which bounds the memory needed for the internal kd-tree.
+
  <B>The command line parameters of this tool are:</B>
  @verbinclude TOPP_FeatureLinkerUnlabeledKD.cli
  <B>INI file documentation of this tool:</B>
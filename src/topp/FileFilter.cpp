@@ -43,6 +43,8 @@
 #include <OpenMS/FORMAT/MzMLFile.h>
 #include <OpenMS/FORMAT/FeatureXMLFile.h>
 #include <OpenMS/FORMAT/ConsensusXMLFile.h>
+#include <OpenMS/FORMAT/DATAACCESS/ConsensusXMLWritingConsumer.h>
+#include <OpenMS/FORMAT/DATAACCESS/FeatureXMLWritingConsumer.h>
 #include <OpenMS/FILTERING/NOISEESTIMATION/SignalToNoiseEstimatorMedian.h>
 #include <OpenMS/COMPARISON/SPECTRA/ZhangSimilarityScore.h>
 #include <OpenMS/CONCEPT/Factory.h>
@@ -128,6 +130,45 @@ using namespace std;
 // We do not want this class to show up in the docu:
 /// @cond TOPPCLASSES
 
+/// Passes (consensus) features for which @p keep returns true on to another consumer (for the 'f_and_c:low_memory' mode)
+template <typename ConsumerType>
+class FilteringConsumer :
+  public ConsumerType
+{
+public:
+  typedef typename ConsumerType::MapType MapType;
+  typedef typename ConsumerType::FeatureType FeatureType;
+
+  FilteringConsumer(ConsumerType& next, std::function<bool (FeatureType&)> keep, std::function<void (MapType&)> process_meta_data) :
+    next_(next),
+    keep_(keep),
+    process_meta_data_(process_meta_data)
+  {
+  }
+
+  void consumeFeature(FeatureType& feature) override
+  {
+    if (keep_(feature)) next_.consumeFeature(feature);
+  }
+
+  void setExpectedSize(Size expected_features) override
+  {
+    next_.setExpectedSize(expected_features);
+  }
+
+  void setMapMetaData(const MapType& map) override
+  {
+    MapType meta_data = map;
+    process_meta_data_(meta_data);
+    next_.setMapMetaData(meta_data);
+  }
+
+protected:
+  ConsumerType& next_;
+  std::function<bool (FeatureType&)> keep_;
+  std::function<void (MapType&)> process_meta_data_;
+};
+
 class TOPPFileFilter :
   public TOPPBase
 {
@@ -408,6 +449,7 @@ protected:
     registerStringOption_("f_and_c:charge", "[min]:[max]", ":", "Charge range to extract", false);
     registerStringOption_("f_and_c:size", "[min]:[max]", ":", "Size range to extract", false);
     registerStringList_("f_and_c:remove_meta", "<name> 'lt|eq|gt' <value>", StringList(), "Expects a 3-tuple (=3 entries in the list), i.e. <name> 'lt|eq|gt' <value>; the first is the name of meta value, followed by the comparison operator (equal, less or greater) and the value to compare to. All comparisons are done after converting the given value to the corresponding data value type of the meta value (for lists, this simply compares length, not content!)!", false);
+    registerFlag_("f_and_c:low_memory", "Filter featureXML/consensusXML input while reading it, without holding the whole map in memory (not possible together with 'sort' or 'consensus:map').", true);
 
     addEmptyLine_();
     // XXX: Change description
@@ -911,6 +953,72 @@ protected:
     {
       bool meta_ok = true; // assume true by default (as meta might not be checked below)
 
+      if (getFlag_("f_and_c:low_memory"))
+      {
+        if (sort || !maps.empty() || in_type != out_type)
+        {
+          writeLog_("Error: 'f_and_c:low_memory' cannot be combined with 'sort' or 'consensus:map' and requires input and output of the same type. Aborting!");
+          printUsage_();
+          return ILLEGAL_PARAMETERS;
+        }
+
+        // the same filters as below, applied to one (consensus) feature at a time while the input is read
+        auto check_ids_and_meta = [&](BaseFeature& feature)
+        {
+          if (remove_meta_enabled && !checkMetaOk(feature, meta_info)) return false;
+          return checkPeptideIdentification_(feature, remove_annotated_features, remove_unannotated_features, sequences, sequence_comparison_method, accessions, keep_best_score_id, remove_clashes);
+        };
+
+        if (in_type == FileTypes::FEATUREXML)
+        {
+          FeatureXMLFile f;
+          f.getOptions().setRTRange(DRange<1>(rt_l, rt_u));
+          f.getOptions().setMZRange(DRange<1>(mz_l, mz_u));
+          f.getOptions().setIntensityRange(DRange<1>(it_l, it_u));
+
+          FeatureXMLWritingConsumer writer(out);
+          FilteringConsumer<Interfaces::IFeatureDataConsumer> filter(writer,
+            [&](Feature& feature)
+            {
+              bool const charge_ok = ((charge_l <= feature.getCharge()) && (feature.getCharge() <= charge_u));
+              bool const size_ok = ((size_l <= feature.getSubordinates().size()) && (feature.getSubordinates().size() <= size_u));
+              bool const q_ok = ((q_l <= feature.getOverallQuality()) && (feature.getOverallQuality() <= q_u));
+              return charge_ok && size_ok && q_ok && check_ids_and_meta(feature);
+            },
+            [&](FeatureMap& meta_data)
+            {
+              if (remove_unassigned_ids) meta_data.getUnassignedPeptideIdentifications().clear();
+              addDataProcessing_(meta_data, getProcessingInfo_(DataProcessing::FILTERING));
+            });
+          f.transform(in, &filter);
+          writer.close();
+        }
+        else
+        {
+          ConsensusXMLFile f;
+          f.getOptions().setRTRange(DRange<1>(rt_l, rt_u));
+          f.getOptions().setMZRange(DRange<1>(mz_l, mz_u));
+          f.getOptions().setIntensityRange(DRange<1>(it_l, it_u));
+
+          ConsensusXMLWritingConsumer writer(out);
+          FilteringConsumer<Interfaces::IConsensusDataConsumer> filter(writer,
+            [&](ConsensusFeature& feature)
+            {
+              const bool charge_ok = ((charge_l <= feature.getCharge()) && (feature.getCharge() <= charge_u));
+              const bool size_ok = ((feature.size() >= size_l) && (feature.size() <= size_u));
+              return charge_ok && size_ok && check_ids_and_meta(feature);
+            },
+            [&](ConsensusMap& meta_data)
+            {
+              if (remove_unassigned_ids) meta_data.getUnassignedPeptideIdentifications().clear();
+              addDataProcessing_(meta_data, getProcessingInfo_(DataProcessing::FILTERING));
+            });
+          f.transform(in, &filter);
+          writer.close();
+        }
+        return EXECUTION_OK;
+      }
+
       if (in_type == FileTypes::FEATUREXML)
       {
         //-------------------------------------------------------------
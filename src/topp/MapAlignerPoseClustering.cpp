@@ -97,6 +97,13 @@ using namespace std;
   To speed up the alignment, consider reducing 'max_number_of_peaks_considered'.
   If your alignment is not good enough, consider increasing this number (the alignment will take longer though).
 
+  The reference is preprocessed once and shared by all (parallel) alignments.
+  It can be stored using @p reference:model_out (as featureXML, containing only
+  the data points used for alignment). Passing this file as @p
+  reference:model_in in a later call aligns new runs to the same reference,
+  e.g. to add a new batch of runs to an already aligned cohort without
+  re-aligning (or even providing) the previous runs.
+
   <B>The command line parameters of this tool are:</B> @n
   @verbinclude TOPP_MapAlignerPoseClustering.cli
   <B>INI file documentation of this tool:</B>
@@ -120,6 +127,10 @@ protected:
   {
     TOPPMapAlignerBase::registerOptionsAndFlags_("featureXML,mzML",
                                                  REF_RESTRICTED);
+    registerInputFile_("reference:model_in", "<file>", "", "Previously stored reference model (see 'model_out') to align all input files to (incremental alignment). Cannot be combined with 'file' or 'index'.", false, true);
+    setValidFormats_("reference:model_in", ListUtils::create<String>("featureXML"));
+    registerOutputFile_("reference:model_out", "<file>", "", "Store the reference model (the data points of the reference used for alignment), for aligning further files later via 'model_in'.", false, true);
+    setValidFormats_("reference:model_out", ListUtils::create<String>("featureXML"));
     registerSubsection_("algorithm", "Algorithm parameters section");
   }
 
@@ -149,10 +160,26 @@ protected:
 
     Size reference_index = getIntOption_("reference:index");
     String reference_file = getStringOption_("reference:file");
+    String model_in = getStringOption_("reference:model_in");
+    String model_out = getStringOption_("reference:model_out");
+
+    if (!model_in.empty() && (reference_index > 0 || !reference_file.empty()))
+    {
+      writeLog_("Error: Parameter 'reference:model_in' cannot be combined with 'reference:file' or 'reference:index'");
+      return ILLEGAL_PARAMETERS;
+    }
+
+    // only MS1 data is used for the alignment
+    MzMLFile f_mzml_ms1;
+    f_mzml_ms1.getOptions().addMSLevel(1);
 
     FileTypes::Type in_type = FileHandler::getType(in_files[0]);
     String file;
-    if (!reference_file.empty())
+    if (!model_in.empty())
+    {
+      reference_index = in_files.size(); // points to invalid index
+    }
+    else if (!reference_file.empty())
     {
       file = reference_file;
       reference_index = in_files.size(); // points to invalid index
@@ -177,7 +204,7 @@ protected:
         else if (in_type == FileTypes::MZML) // this is expensive!
         {
           PeakMap exp;
-          MzMLFile().load(in_files[i], exp);
+          f_mzml_ms1.load(in_files[i], exp);
           exp.updateRanges(1);
           s = exp.getSize();
         }
@@ -197,22 +224,30 @@ protected:
       f_fxml.getOptions().setLoadConvexHull(false);
       f_fxml.getOptions().setLoadSubordinates(false);
     }
-    if (in_type == FileTypes::FEATUREXML)
+    if (!model_in.empty() || in_type == FileTypes::FEATUREXML)
     {
       FeatureMap map_ref;
       FeatureXMLFile f_fxml_tmp; // for the reference, we never need CH or subordinates
       f_fxml_tmp.getOptions().setLoadConvexHull(false);
       f_fxml_tmp.getOptions().setLoadSubordinates(false);
-      f_fxml_tmp.load(file, map_ref);
+      f_fxml_tmp.load(model_in.empty() ? file : model_in, map_ref);
       algorithm.setReference(map_ref);
     }
     else if (in_type == FileTypes::MZML)
     {
       PeakMap map_ref;
-      MzMLFile().load(file, map_ref);
+      f_mzml_ms1.load(file, map_ref);
       algorithm.setReference(map_ref);
     }
 
+    if (!model_out.empty())
+    {
+      FeatureMap model;
+      MapConversion::convert(algorithm.getReference(), true, model);
+      addDataProcessing_(model, getProcessingInfo_(DataProcessing::ALIGNMENT));
+      FeatureXMLFile().store(model_out, model);
+    }
+
     ProgressLogger plog;
     plog.setLogType(log_type_);
 
@@ -245,7 +280,10 @@ protected:
       else if (in_type == FileTypes::MZML)
       {
         PeakMap map;
-        MzMLFile().load(in_files[i], map);
+        // if no output is written, only MS1 data is needed
+        MzMLFile f_mzml_tmp;
+        if (out_files.empty()) f_mzml_tmp.getOptions() = f_mzml_ms1.getOptions();
+        f_mzml_tmp.load(in_files[i], map);
         if (i == static_cast<int>(reference_index)) trafo.fitModel("identity");
         else algorithm.align(map, trafo);
         if (out_files.size())
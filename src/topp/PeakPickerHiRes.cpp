@@ -89,6 +89,10 @@ using namespace std;
 
   For the parameters of the algorithm section see the algorithm documentation: @ref OpenMS::PeakPickerHiRes "PeakPickerHiRes"
 
+  Spectra are picked in parallel (see @p -threads). With @p processOption 'lowmemory',
+  the input is streamed: blocks of spectra (100 per thread) are read, picked in parallel
+  and written in their original order, so memory usage stays bounded.
+
   Be aware that applying the algorithm to already picked data results in an error message and program exit or corrupted output data.
   Advanced users may skip the check for already centroided data using the flag "-force" (useful e.g. if spectrum annotations in the data files are wrong).
 
@@ -125,6 +129,11 @@ protected:
 
   /**
     @brief Helper class for the Low Memory peak-picking
+
+    Incoming spectra (and chromatograms) are buffered in blocks of bounded
+    size. Each block is picked in parallel and then written in input order.
+    finish() has to be called after the last spectrum to write the remaining
+    block.
   */
   class PPHiResMzMLConsumer :
     public MSDataWritingConsumer
@@ -132,33 +141,84 @@ protected:
 
   public:
 
-    PPHiResMzMLConsumer(String filename, const PeakPickerHiRes& pp) :
+    PPHiResMzMLConsumer(String filename, const PeakPickerHiRes& pp, Size block_size) :
       MSDataWritingConsumer(filename),
-      ms_levels_(pp.getParameters().getValue("ms_levels").toIntList())
+      ms_levels_(pp.getParameters().getValue("ms_levels").toIntList()),
+      block_size_(std::max(block_size, Size(1)))
     {
       pp_ = pp;
     }
 
-    void processSpectrum_(MapType::SpectrumType& s) override
+    /// pick and write the remaining data (before the destructor of the base class writes the footer)
+    void finish()
     {
-      if (!ListUtils::contains(ms_levels_, s.getMSLevel())) {return;}
+      flushSpectra_();
+      flushChromatograms_();
+    }
 
-      MapType::SpectrumType sout;
-      pp_.pick(s, sout);
-      s = sout;  // todo: swap? (requires implementation)
+    void consumeSpectrum(MapType::SpectrumType& s) override
+    {
+      spectra_.push_back(std::move(s));
+      if (spectra_.size() >= block_size_) flushSpectra_();
     }
 
-    void processChromatogram_(MapType::ChromatogramType & c) override
+    void consumeChromatogram(MapType::ChromatogramType& c) override
     {
-      MapType::ChromatogramType c_out;
-      pp_.pick(c, c_out);
-      c = c_out;
+      flushSpectra_(); // spectra are written before chromatograms
+      chromatograms_.push_back(std::move(c));
+      if (chromatograms_.size() >= block_size_) flushChromatograms_();
     }
 
+    // picking is done block-wise in flushSpectra_() / flushChromatograms_()
+    void processSpectrum_(MapType::SpectrumType&) override {}
+
+    void processChromatogram_(MapType::ChromatogramType&) override {}
+
   private:
 
+    void flushSpectra_()
+    {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 10)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)spectra_.size(); ++i)
+      {
+        if (!ListUtils::contains(ms_levels_, spectra_[i].getMSLevel())) {continue;}
+
+        MapType::SpectrumType sout;
+        pp_.pick(spectra_[i], sout);
+        spectra_[i] = std::move(sout);
+      }
+      for (Size i = 0; i < spectra_.size(); ++i)
+      {
+        MSDataWritingConsumer::consumeSpectrum(spectra_[i]);
+      }
+      spectra_.clear();
+    }
+
+    void flushChromatograms_()
+    {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 10)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)chromatograms_.size(); ++i)
+      {
+        MapType::ChromatogramType c_out;
+        pp_.pick(chromatograms_[i], c_out);
+        chromatograms_[i] = std::move(c_out);
+      }
+      for (Size i = 0; i < chromatograms_.size(); ++i)
+      {
+        MSDataWritingConsumer::consumeChromatogram(chromatograms_[i]);
+      }
+      chromatograms_.clear();
+    }
+
     PeakPickerHiRes pp_;
     std::vector<Int> ms_levels_;
+    Size block_size_;
+    std::vector<MapType::SpectrumType> spectra_;
+    std::vector<MapType::ChromatogramType> chromatograms_;
   };
 
   void registerOptionsAndFlags_() override
@@ -184,7 +244,9 @@ protected:
     ///////////////////////////////////
     // Create the consumer object, add data processing
     ///////////////////////////////////
-    PPHiResMzMLConsumer pp_consumer(out, pp);
+    // number of spectra buffered (and picked in parallel) at a time
+    Size block_size = 100 * getIntOption_("threads");
+    PPHiResMzMLConsumer pp_consumer(out, pp, block_size);
     pp_consumer.addDataProcessing(getProcessingInfo_(DataProcessing::PEAK_PICKING));
 
     ///////////////////////////////////
@@ -193,6 +255,7 @@ protected:
     MzMLFile mz_data_file;
     mz_data_file.setLogType(log_type_);
     mz_data_file.transform(in, &pp_consumer);
+    pp_consumer.finish();
 
     return EXECUTION_OK;
   }
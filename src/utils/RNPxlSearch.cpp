@@ -1865,17 +1865,12 @@ protected:
 
         const String unmodified_sequence = cit->getString();
 
-#ifdef _OPENMP
-#pragma omp critical (residuedb_access)
-#endif
+        // only process peptides without ambiguous amino acids (placeholder / any amino acid)
+        if (unmodified_sequence.find_first_of("XBZ") == std::string::npos)
         {
-           // only process peptides without ambiguous amino acids (placeholder / any amino acid)
-          if (unmodified_sequence.find_first_of("XBZ") == std::string::npos)
-          {
-            AASequence aas = AASequence::fromString(unmodified_sequence);
-            ModifiedPeptideGenerator::applyFixedModifications(fixed_modifications, aas);
-            ModifiedPeptideGenerator::applyVariableModifications(variable_modifications, aas, max_variable_mods_per_peptide, all_modified_peptides);
-          }
+          AASequence aas = AASequence::fromString(unmodified_sequence);
+          ModifiedPeptideGenerator::applyFixedModifications(fixed_modifications, aas);
+          ModifiedPeptideGenerator::applyVariableModifications(variable_modifications, aas, max_variable_mods_per_peptide, all_modified_peptides);
         }
 
         for (SignedSize mod_pep_idx = 0; mod_pep_idx < (SignedSize)all_modified_peptides.size(); ++mod_pep_idx)